@@ -14,6 +14,9 @@
 #include "lardataobj/RecoBase/OpFlash.h"
 #include "lardataobj/RecoBase/OpHit.h"
 
+#include <cstddef>
+#include <span>
+
 namespace calib {
   /// May want to swap in dummy charge and photon calibrations in various
   /// combinations.
@@ -31,6 +34,17 @@ namespace calib {
     virtual double PE(double adcs, int opchannel) const = 0;
     virtual bool UseArea() const = 0;
 
+    /// Batch version of PE(adcs, opchannel): pe[i] is computed from adcs[i]
+    /// on channel opchannels[i]. The three spans must have the same size.
+    /// Implementations should override it to avoid one virtual call per hit.
+    virtual void PE(std::span<const double> adcs,
+                    std::span<const int> opchannels,
+                    std::span<double> pe) const
+    {
+      for (std::size_t i = 0; i < adcs.size(); ++i)
+        pe[i] = PE(adcs[i], opchannels[i]);
+    }
+
     /// Need a 3D position because result depends on position along length of
     /// bar. This is going to be pretty imprecise even so.
     // virtual double GeV(double PE, int opchannel, TVector3 pos) = 0;
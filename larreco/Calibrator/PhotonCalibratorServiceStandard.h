@@ -46,6 +46,6 @@ namespace calib {
 
 DECLARE_ART_SERVICE_INTERFACE_IMPL(calib::PhotonCalibratorServiceStandard,
                                    calib::IPhotonCalibratorService,
-                                   LEGACY)
+                                   SHARED)
 
 #endif // PHOTONCALIBRATORSERVICESTANDARD
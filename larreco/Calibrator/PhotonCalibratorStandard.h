@@ -32,14 +32,26 @@ namespace calib {
       : fSPESize(size), fSPEShift(shift), fUseArea(useArea)
     {}
 
+    using IPhotonCalibrator::PE;
+
     // Override base class functions
     double PE(double adcs, int /* opchannel */) const override
     {
       return adcs / fSPESize + fSPEShift;
     }
+    void PE(std::span<const double> adcs,
+            std::span<const int> /* opchannels */,
+            std::span<double> pe) const override
+    {
+      const double size = fSPESize;
+      const double shift = fSPEShift;
+      for (std::size_t i = 0; i < adcs.size(); ++i)
+        pe[i] = adcs[i] / size + shift;
+    }
     bool UseArea() const override { return fUseArea; }
 
-    // Setters for this implementation
+    // Setters for this implementation; the provider is shared by all the
+    // threads, so these are only meant for its configuration
     void SetSPESize(float size) { fSPESize = size; }
     void SetSPEShift(float shift) { fSPEShift = shift; }
     void SetUseArea(bool useArea) { fUseArea = useArea; }
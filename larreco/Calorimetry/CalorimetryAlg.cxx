@@ -17,6 +17,9 @@
 #include "larevt/CalibrationDBI/Interface/ElectronLifetimeProvider.h"
 #include "larevt/CalibrationDBI/Interface/ElectronLifetimeService.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace calo {
 
   //--------------------------------------------------------------------
@@ -30,6 +33,7 @@ namespace calo {
     , fModBoxBF("ModBoxB", config.ModBoxBTF1().c_str(), 0, 90)
     , fBirksA{config.BirksA()}
     , fBirksKF("BirksK", config.BirksKTF1().c_str(), 0, 90)
+    , fRecombPhiStep{config.RecombPhiStep()}
   {
     if (fLifeTimeForm != 0 and fLifeTimeForm != 1) {
       throw cet::exception("CalorimetryAlg")
@@ -52,6 +56,31 @@ namespace calo {
     for (unsigned i = 0; i < birksk_param.size(); i++) {
       fBirksKF.SetParameter(i, birksk_param[i]);
     }
+
+    // Tabulate them, so that hits do not go through the ROOT formula evaluation
+    fModBoxBTable = TabulatePhi(fModBoxBF, fRecombPhiStep);
+    fBirksKTable = TabulatePhi(fBirksKF, fRecombPhiStep);
+  }
+
+  std::vector<double> CalorimetryAlg::TabulatePhi(TF1 const& f, double const step)
+  {
+    std::vector<double> table;
+    if (!(step > 0.)) return table;
+    std::size_t const n = static_cast<std::size_t>(std::ceil(90. / step)) + 1;
+    table.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+      table.push_back(f.Eval(i * step));
+    return table;
+  }
+
+  double CalorimetryAlg::EvalPhi(TF1 const& f,
+                                 std::vector<double> const& table,
+                                 double const phi) const
+  {
+    if (table.empty() || !(phi >= 0. && phi <= 90.)) return f.Eval(phi);
+    double const x = phi / fRecombPhiStep;
+    std::size_t const i = std::min(static_cast<std::size_t>(x), table.size() - 2);
+    return table[i] + (x - i) * (table[i + 1] - table[i]);
   }
 
   //------------------------------------------------------------------------------------//
@@ -188,6 +217,37 @@ namespace calo {
     return dEdx_from_dQdx_e(clock_data, det_prop, dQdx_e, time, T0, EField, phi);
   }
 
+  //------------------------------------------------------------------------------------//
+  // Batched versions, for all the hits of a plane at once
+  // ----------------------------------------------------------------------------------//
+  void CalorimetryAlg::dEdx_AMP(detinfo::DetectorClocksData const& clock_data,
+                                detinfo::DetectorPropertiesData const& det_prop,
+                                std::span<const double> const dQdx,
+                                std::span<const double> const time,
+                                unsigned int const plane,
+                                double const T0,
+                                std::span<const double> const EField,
+                                std::span<const double> const phi,
+                                std::span<double> const dEdx) const
+  {
+    dEdx_from_dQdx_e(
+      clock_data, det_prop, dQdx, fCalAmpConstants[plane], time, T0, EField, phi, dEdx);
+  }
+
+  void CalorimetryAlg::dEdx_AREA(detinfo::DetectorClocksData const& clock_data,
+                                 detinfo::DetectorPropertiesData const& det_prop,
+                                 std::span<const double> const dQdx,
+                                 std::span<const double> const time,
+                                 unsigned int const plane,
+                                 double const T0,
+                                 std::span<const double> const EField,
+                                 std::span<const double> const phi,
+                                 std::span<double> const dEdx) const
+  {
+    dEdx_from_dQdx_e(
+      clock_data, det_prop, dQdx, fCalAreaConstants[plane], time, T0, EField, phi, dEdx);
+  }
+
   // Apply Lifetime and recombination correction.
   double CalorimetryAlg::dEdx_from_dQdx_e(detinfo::DetectorClocksData const& clock_data,
                                           detinfo::DetectorPropertiesData const& det_prop,
@@ -213,6 +273,30 @@ namespace calo {
 
     return BirksCorrection(dQdx_e, phi, det_prop.Density(), EField);
   }
+  void CalorimetryAlg::dEdx_from_dQdx_e(detinfo::DetectorClocksData const& clock_data,
+                                        detinfo::DetectorPropertiesData const& det_prop,
+                                        std::span<const double> const dQdx,
+                                        double const ADCtoEl,
+                                        std::span<const double> const time,
+                                        double const T0,
+                                        std::span<const double> const EField,
+                                        std::span<const double> const phi,
+                                        std::span<double> const dEdx) const
+  {
+    // dEdx holds the lifetime corrections until it is overwritten hit by hit
+    if (fDoLifeTimeCorrection)
+      LifetimeCorrection(clock_data, det_prop, time, T0, dEdx);
+    else
+      std::fill(dEdx.begin(), dEdx.end(), 1.);
+
+    double const rho = det_prop.Density();
+    for (std::size_t i = 0; i < dEdx.size(); ++i) {
+      double dQdx_e = dQdx[i] / ADCtoEl; // Conversion from ADC/cm to e/cm
+      dQdx_e *= dEdx[i];
+      dEdx[i] = fUseModBox ? ModBoxCorrection(dQdx_e, phi[i], rho, EField[i]) :
+                             BirksCorrection(dQdx_e, phi[i], rho, EField[i]);
+    }
+  }
 
   //------------------------------------------------------------------------------------//
   // for the time being copying from Calorimetry.cxx - should be decided where
@@ -240,6 +324,35 @@ namespace calo {
     return elifetime_provider.Lifetime(adjusted_time);
   }
 
+  void calo::CalorimetryAlg::LifetimeCorrection(detinfo::DetectorClocksData const& clock_data,
+                                                detinfo::DetectorPropertiesData const& det_prop,
+                                                std::span<const double> const time,
+                                                double const T0,
+                                                std::span<double> const correction) const
+  {
+    auto const offset = trigger_offset(clock_data);
+    double const timetick = sampling_rate(clock_data) * 1.e-3; // time sample in microsec
+
+    assert(fLifeTimeForm < 2);
+    if (fLifeTimeForm == 0) {
+      // Exponential form
+      double const tau = det_prop.ElectronLifetime();
+      for (std::size_t i = 0; i < time.size(); ++i) {
+        float const t = time[i] - offset;
+        correction[i] = exp((t * timetick - T0 * 1e-3) / tau);
+      }
+      return;
+    }
+
+    // Exponential+constant form
+    auto const& elifetime_provider =
+      art::ServiceHandle<lariov::ElectronLifetimeService const>()->GetProvider();
+    for (std::size_t i = 0; i < time.size(); ++i) {
+      float const t = time[i] - offset;
+      correction[i] = elifetime_provider.Lifetime(t * timetick - T0 * 1e-3);
+    }
+  }
+
   // Reombination corrections
 
   // Modified box: allow for a general behavior of beta from phi, the angle between the track
@@ -252,7 +365,7 @@ namespace calo {
     // Modified Box model correction has better behavior than the Birks
     // correction at high values of dQ/dx.
     constexpr double Wion = 1000. / util::kGeVToElectrons; // 23.6 eV = 1e, Wion in MeV/e
-    double const Beta = fModBoxBF.Eval(phi) / (rho * E_field);
+    double const Beta = EvalPhi(fModBoxBF, fModBoxBTable, phi) / (rho * E_field);
     double const Alpha = fModBoxA;
     double const dEdx = (exp(Beta * Wion * dQdx) - Alpha) / Beta;
 
@@ -267,7 +380,7 @@ namespace calo {
     // from: S.Amoruso et al., NIM A 523 (2004) 275
 
     double A = fBirksA;
-    double K = fBirksKF.Eval(phi);                              // in KV/cm*(g/cm^2)/MeV
+    double K = EvalPhi(fBirksKF, fBirksKTable, phi);            // in KV/cm*(g/cm^2)/MeV
     constexpr double Wion = 1000. / util::kGeVToElectrons;      // 23.6 eV = 1e, Wion in MeV/e
     K /= rho;                                                   // KV/MeV
     double const dEdx = dQdx / (A / Wion - K / E_field * dQdx); // MeV/cm
@@ -21,6 +21,9 @@
 
 #include "TF1.h"
 
+#include <cstddef>
+#include <span>
+#include <string>
 #include <vector>
 
 namespace detinfo {
@@ -84,6 +87,12 @@ namespace calo {
       fhicl::OptionalSequence<double> BirksKParam{
         Name("BirksKParam"),
         Comment("Parameters for the BirksKTF1 function. List of doubles.")};
+
+      fhicl::Atom<double> RecombPhiStep{
+        Name("RecombPhiStep"),
+        Comment("Step [degrees] of the tables of Mod-Box beta and Birks k in phi, interpolated "
+                "linearly within 0-90 degrees. 0 evaluates the TF1s for every hit."),
+        0.1};
     };
 
     CalorimetryAlg(const fhicl::ParameterSet& pset)
@@ -147,6 +156,27 @@ namespace calo {
                      double EField,
                      double phi = 90) const;
 
+    /// Batched conversions of the dQ/dx [ADC/cm] of hits on one plane, from the pulse amplitude
+    /// or area; time, EField and phi hold the value for each dQdx, and dEdx must be as long.
+    void dEdx_AMP(detinfo::DetectorClocksData const& clock_data,
+                  detinfo::DetectorPropertiesData const& det_prop,
+                  std::span<const double> dQdx,
+                  std::span<const double> time,
+                  unsigned int plane,
+                  double T0,
+                  std::span<const double> EField,
+                  std::span<const double> phi,
+                  std::span<double> dEdx) const;
+    void dEdx_AREA(detinfo::DetectorClocksData const& clock_data,
+                   detinfo::DetectorPropertiesData const& det_prop,
+                   std::span<const double> dQdx,
+                   std::span<const double> time,
+                   unsigned int plane,
+                   double T0,
+                   std::span<const double> EField,
+                   std::span<const double> phi,
+                   std::span<double> dEdx) const;
+
     double ElectronsFromADCPeak(double adc, unsigned short plane) const
     {
       return adc / fCalAmpConstants[plane];
@@ -161,6 +191,12 @@ namespace calo {
                               detinfo::DetectorPropertiesData const& det_prop,
                               double time,
                               double T0 = 0) const;
+    /// Lifetime correction for each of the times, written to correction (as long as time)
+    void LifetimeCorrection(detinfo::DetectorClocksData const& clock_data,
+                            detinfo::DetectorPropertiesData const& det_prop,
+                            std::span<const double> time,
+                            double T0,
+                            std::span<double> correction) const;
 
     // Recombination corrections
     double BirksCorrection(double dQdx, double phi, double rho, double E_field) const;
@@ -181,6 +217,20 @@ namespace calo {
                             double T0,
                             double EField,
                             double phi = 90) const;
+    void dEdx_from_dQdx_e(detinfo::DetectorClocksData const& clock_data,
+                          detinfo::DetectorPropertiesData const& det_prop,
+                          std::span<const double> dQdx,
+                          double ADCtoEl,
+                          std::span<const double> time,
+                          double T0,
+                          std::span<const double> EField,
+                          std::span<const double> phi,
+                          std::span<double> dEdx) const;
+
+    /// Values of f at phi = 0, step, 2 step, ... up to at least 90 degrees
+    static std::vector<double> TabulatePhi(TF1 const& f, double step);
+    /// Value of f at phi from its table, or from f itself outside the tabulated range
+    double EvalPhi(TF1 const& f, std::vector<double> const& table, double phi) const;
 
     std::vector<double> const fCalAmpConstants;
     std::vector<double> const fCalAreaConstants;
@@ -194,6 +244,10 @@ namespace calo {
     double fBirksA;  // Birks A cosntant
     TF1 fBirksKF;    // Function of phi to get the Birks-k value
 
+    double fRecombPhiStep;             // step of the tables in phi [degrees]
+    std::vector<double> fModBoxBTable; // fModBoxBF at multiples of fRecombPhiStep
+    std::vector<double> fBirksKTable;  // fBirksKF at multiples of fRecombPhiStep
+
   }; // class CalorimetryAlg
 } // namespace calo
 #endif // UTIL_CALORIMETRYALG_H
@@ -55,6 +55,9 @@
 #include "fhiclcpp/types/DelegatedParameter.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 namespace {
   constexpr unsigned int int_max_as_unsigned_int{std::numeric_limits<int>::max()};
   typedef std::pair<unsigned, std::vector<unsigned>> OrganizedHits;
@@ -129,6 +132,11 @@ namespace calo {
       fhicl::DelegatedParameter NormTools{
         Name("NormTools"),
         Comment("List of INormalizeCharge tool configurations to use.")};
+
+      fhicl::Atom<bool> ParallelTracks{
+        Name("ParallelTracks"),
+        Comment("Process the tracks concurrently. The NormTools must then be thread-safe."),
+        false};
     };
 
     using Parameters = art::EDProducer::Table<Config>;
@@ -143,6 +151,17 @@ namespace calo {
     std::vector<std::unique_ptr<INormalizeCharge>> fNormTools;
 
     // helper functions
+    std::vector<anab::Calorimetry> TrackCalorimetry(
+      const art::Event& evt,
+      const detinfo::DetectorClocksData& clock_data,
+      const detinfo::DetectorPropertiesData& det_prop,
+      const geo::GeometryCore& geom,
+      const geo::WireReadoutGeom& wireReadoutGeom,
+      const spacecharge::SpaceCharge* sce,
+      const recob::Track& track,
+      const std::vector<art::Ptr<recob::Hit>>& hits,
+      const std::vector<const recob::TrackHitMeta*>& thms,
+      double T0);
     std::vector<std::vector<OrganizedHits>> OrganizeHits(
       const std::vector<art::Ptr<recob::Hit>>& hits,
       const std::vector<const recob::TrackHitMeta*>& thms,
@@ -159,28 +178,40 @@ namespace calo {
       const recob::Track& track,
       unsigned nplanes);
     bool HitIsValid(const recob::TrackHitMeta* thm, const recob::Track& track);
-    geo::Point_t GetLocation(const recob::Track& track,
+    geo::Point_t GetLocation(const spacecharge::SpaceCharge* sce,
+                             const recob::Track& track,
                              const art::Ptr<recob::Hit> hit,
                              const recob::TrackHitMeta* meta);
-    geo::Point_t GetLocationAtWires(const recob::Track& track,
+    geo::Point_t GetLocationAtWires(const geo::GeometryCore& geom,
+                                    const spacecharge::SpaceCharge* sce,
+                                    const recob::Track& track,
                                     const recob::Hit& hit,
                                     const recob::TrackHitMeta* meta);
-    geo::Point_t WireToTrajectoryPosition(const geo::Point_t& loc, const geo::TPCID& tpc);
-    geo::Point_t TrajectoryToWirePosition(const geo::Point_t& loc, const geo::TPCID& tpc);
-    double GetPitch(const recob::Track& track,
+    geo::Point_t WireToTrajectoryPosition(const spacecharge::SpaceCharge* sce,
+                                          const geo::Point_t& loc,
+                                          const geo::TPCID& tpc);
+    geo::Point_t TrajectoryToWirePosition(const geo::GeometryCore& geom,
+                                          const spacecharge::SpaceCharge* sce,
+                                          const geo::Point_t& loc,
+                                          const geo::TPCID& tpc);
+    double GetPitch(const geo::GeometryCore& geom,
+                    const geo::WireReadoutGeom& wireReadoutGeom,
+                    const spacecharge::SpaceCharge* sce,
+                    const recob::Track& track,
                     const recob::Hit& hit,
                     const recob::TrackHitMeta* meta);
     double GetCharge(const recob::Hit& hit, const std::vector<recob::Hit const*>& sharedHits);
     double GetEfield(const detinfo::DetectorPropertiesData& dprop,
+                     const spacecharge::SpaceCharge* sce,
                      const recob::Track& track,
                      const art::Ptr<recob::Hit> hit,
                      const recob::TrackHitMeta* meta);
-    double Normalize(double dQdx,
-                     const art::Event& e,
-                     const recob::Hit& h,
-                     const geo::Point_t& location,
-                     const geo::Vector_t& direction,
-                     double t0);
+    void Normalize(std::vector<double>& dQdx,
+                   const art::Event& e,
+                   const std::vector<recob::Hit const*>& hits,
+                   const std::vector<geo::Point_t>& locations,
+                   const std::vector<geo::Vector_t>& directions,
+                   double t0);
   };
 
 } // end namespace calo
@@ -203,9 +234,10 @@ void calo::GnocchiCalorimetry::produce(art::Event& evt)
   auto const clock_data = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(evt);
   auto const det_prop =
     art::ServiceHandle<detinfo::DetectorPropertiesService const>()->DataFor(evt, clock_data);
-
-  auto const& wireReadoutGeom = art::ServiceHandle<geo::WireReadout>()->Get();
-  size_t nplanes = wireReadoutGeom.Nplanes();
+  // the providers are passed down to the (possibly concurrent) track calorimetry
+  auto const& geom = *lar::providerFrom<geo::Geometry>();
+  auto const& wireReadoutGeom = art::ServiceHandle<geo::WireReadout const>()->Get();
+  auto const* sce = lar::providerFrom<spacecharge::SpaceChargeService>();
 
   // Define output collections
   std::unique_ptr<std::vector<anab::Calorimetry>> outputCalo(new std::vector<anab::Calorimetry>);
@@ -240,14 +272,8 @@ void calo::GnocchiCalorimetry::produce(art::Event& evt)
   for (auto const& nt : fNormTools)
     nt->setup(evt);
 
-  // iterate over all the tracks
-  for (unsigned trk_i = 0; trk_i < tracklist.size(); trk_i++) {
-    const recob::Track& track = *tracklist[trk_i];
-
-    // collect input for this track
-    const std::vector<art::Ptr<recob::Hit>>& hits = fmHits.at(trk_i);
-    const std::vector<const recob::TrackHitMeta*>& thms = fmHits.data(trk_i);
-
+  std::vector<std::vector<anab::Calorimetry>> trackCalo(tracklist.size());
+  auto fillTrackCalo = [&](size_t trk_i) {
     double T0 = 0;
     if (fConfig.T0ModuleLabel().size()) {
       if (fConfig.PFPModuleLabel().size()) {
@@ -259,163 +285,219 @@ void calo::GnocchiCalorimetry::produce(art::Event& evt)
         if (this_t0s.size()) T0 = this_t0s.at(0)->Time();
       }
     }
+    trackCalo[trk_i] = TrackCalorimetry(evt,
+                                        clock_data,
+                                        det_prop,
+                                        geom,
+                                        wireReadoutGeom,
+                                        sce,
+                                        *tracklist[trk_i],
+                                        fmHits.at(trk_i),
+                                        fmHits.data(trk_i),
+                                        T0);
+  };
 
-    // organize the hits by plane
-    std::vector<std::vector<OrganizedHits>> hit_indices = OrganizeHits(hits, thms, track, nplanes);
-
-    for (unsigned plane_i = 0; plane_i < nplanes; plane_i++) {
-
-      float kinetic_energy = 0.;
-      std::vector<float> dEdxs;
-      std::vector<float> dQdxs;
-      std::vector<float> resranges;
-      std::vector<float> deadwireresranges;
-      float range = 0.;
-      std::vector<float> pitches;
-      std::vector<geo::Point_t> xyzs;
-      std::vector<size_t> tp_indices;
-      geo::PlaneID plane;
-
-      // setup the plane ID
-      plane.Plane = plane_i;
-      plane.TPC = 0; // arbitrary -- tracks can cross TPC boundaries
-      plane.Cryostat = fConfig.Cryostat();
-      plane.isValid = true;
-
-      std::vector<float> lengths;
-      for (unsigned hit_i = 0; hit_i < hit_indices[plane_i].size(); hit_i++) {
-        unsigned hit_index = hit_indices[plane_i][hit_i].first;
-
-        std::vector<recob::Hit const*> sharedHits = {};
-        sharedHits.reserve(hit_indices[plane_i][hit_i].second.size());
-        for (const unsigned shared_hit_index : hit_indices[plane_i][hit_i].second)
-          sharedHits.push_back(hits[shared_hit_index].get());
-
-        // Get the location of this point
-        geo::Point_t location = GetLocation(track, hits[hit_index], thms[hit_index]);
-
-        // Get the pitch
-        double pitch = GetPitch(track, *hits[hit_index], thms[hit_index]);
-
-        // And the charge
-        double charge = GetCharge(*hits[hit_index], sharedHits);
-
-        // Get the EField
-        double EField = GetEfield(det_prop, track, hits[hit_index], thms[hit_index]);
-
-        // Angle to the drift electric field (in x direction), in units of degrees
-        geo::Vector_t direction = track.DirectionAtPoint(thms[hit_index]->Index());
-        double phi = acos(abs(direction.x())) * 180 / M_PI;
-
-        double dQdx = charge / pitch;
-
-        // Normalize out the detector response
-        dQdx = Normalize(dQdx,
-                         evt,
-                         *hits[hit_index],
-                         track.LocationAtPoint(thms[hit_index]->Index()),
-                         track.DirectionAtPoint(thms[hit_index]->Index()),
-                         T0);
-
-        // turn into dEdx
-        double dEdx = (fConfig.ChargeMethod() == calo::GnocchiCalorimetry::Config::cmAmplitude) ?
-                        fCaloAlg.dEdx_AMP(clock_data,
-                                          det_prop,
-                                          dQdx,
-                                          hits[hit_index]->PeakTime(),
-                                          hits[hit_index]->WireID().Plane,
-                                          T0,
-                                          EField,
-                                          phi) :
-                        fCaloAlg.dEdx_AREA(clock_data,
-                                           det_prop,
-                                           dQdx,
-                                           hits[hit_index]->PeakTime(),
-                                           hits[hit_index]->WireID().Plane,
-                                           T0,
-                                           EField,
-                                           phi);
-
-        // save the length between each pair of hits
-        if (xyzs.size() == 0) { lengths.push_back(0.); }
-        else {
-          lengths.push_back((location - xyzs.back()).r());
-        }
+  // iterate over all the tracks
+  if (fConfig.ParallelTracks()) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, tracklist.size()),
+                      [&](const tbb::blocked_range<size_t>& r) {
+                        for (size_t trk_i = r.begin(); trk_i != r.end(); ++trk_i)
+                          fillTrackCalo(trk_i);
+                      });
+  }
+  else {
+    for (size_t trk_i = 0; trk_i < tracklist.size(); trk_i++)
+      fillTrackCalo(trk_i);
+  }
 
-        // save stuff
-        dEdxs.push_back(dEdx);
-        dQdxs.push_back(dQdx);
-        pitches.push_back(pitch);
-        xyzs.push_back(location);
-        kinetic_energy += dEdx * pitch;
-
-        // TODO: FIXME
-        // It seems weird that the "trajectory-point-index" actually is the
-        // index of the hit... is this a bug in the documentation
-        // of anab::Calorimetry?
-        //
-        // i.e. -- I think this piece of code should actually be:
-        // tp_indices.push_back(thms[hit_index]->Index());
-        tp_indices.push_back(hits[hit_index].key());
-
-      } // end iterate over hits
-
-      // turn the lengths vector into a residual-range vector and total length
-      if (lengths.size() > 1) {
-        range = std::accumulate(lengths.begin(), lengths.end(), 0.);
-
-        // check the direction that the hits are going in the track:
-        // upstream (end-start) or downstream (start-end)
-        bool is_downstream =
-          (track.Trajectory().Start() - xyzs[0]).r() +
-            (track.Trajectory().End() - xyzs.back()).r() <
-          (track.Trajectory().End() - xyzs[0]).r() + (track.Trajectory().Start() - xyzs.back()).r();
-
-        resranges.resize(lengths.size());
-        if (is_downstream) {
-          resranges[lengths.size() - 1] = lengths.back() / 2.;
-          for (int i_len = lengths.size() - 2; i_len >= 0; i_len--) {
-            resranges[i_len] = resranges[i_len + 1] + lengths[i_len + 1];
-          }
-        }
-        else {
-          resranges[0] = lengths[1] / 2.;
-          for (unsigned i_len = 1; i_len < lengths.size(); i_len++) {
-            resranges[i_len] = resranges[i_len - 1] + lengths[i_len];
-          }
-        }
+  // save the output in the track order
+  for (unsigned trk_i = 0; trk_i < tracklist.size(); trk_i++) {
+    for (auto& calo : trackCalo[trk_i]) {
+      outputCalo->push_back(std::move(calo));
+      util::CreateAssn(evt, *outputCalo, tracklist[trk_i], *outputCaloAssn);
+    }
+  }
+
+  evt.put(std::move(outputCalo));
+  evt.put(std::move(outputCaloAssn));
+
+  return;
+}
+
+std::vector<anab::Calorimetry> calo::GnocchiCalorimetry::TrackCalorimetry(
+  const art::Event& evt,
+  const detinfo::DetectorClocksData& clock_data,
+  const detinfo::DetectorPropertiesData& det_prop,
+  const geo::GeometryCore& geom,
+  const geo::WireReadoutGeom& wireReadoutGeom,
+  const spacecharge::SpaceCharge* sce,
+  const recob::Track& track,
+  const std::vector<art::Ptr<recob::Hit>>& hits,
+  const std::vector<const recob::TrackHitMeta*>& thms,
+  double T0)
+{
+  size_t nplanes = wireReadoutGeom.Nplanes();
+
+  std::vector<anab::Calorimetry> result;
+
+  // organize the hits by plane
+  std::vector<std::vector<OrganizedHits>> hit_indices = OrganizeHits(hits, thms, track, nplanes);
+
+  for (unsigned plane_i = 0; plane_i < nplanes; plane_i++) {
+
+    float kinetic_energy = 0.;
+    std::vector<float> dEdxs;
+    std::vector<float> dQdxs;
+    std::vector<float> resranges;
+    std::vector<float> deadwireresranges;
+    float range = 0.;
+    std::vector<float> pitches;
+    std::vector<geo::Point_t> xyzs;
+    std::vector<size_t> tp_indices;
+    geo::PlaneID plane;
+
+    // setup the plane ID
+    plane.Plane = plane_i;
+    plane.TPC = 0; // arbitrary -- tracks can cross TPC boundaries
+    plane.Cryostat = fConfig.Cryostat();
+    plane.isValid = true;
+
+    // collect the input of all the hits first, so that the detector response is
+    // normalized for the whole plane at once
+    std::size_t const nhits = hit_indices[plane_i].size();
+    std::vector<recob::Hit const*> planeHits(nhits);
+    std::vector<geo::Point_t> locations(nhits);
+    std::vector<geo::Point_t> trajLocations(nhits);
+    std::vector<geo::Vector_t> trajDirections(nhits);
+    std::vector<double> planePitches(nhits);
+    std::vector<double> planedQdx(nhits);
+    std::vector<double> EFields(nhits);
+    std::vector<double> phis(nhits);
+    std::vector<double> times(nhits);
+    for (unsigned hit_i = 0; hit_i < nhits; hit_i++) {
+      unsigned hit_index = hit_indices[plane_i][hit_i].first;
+
+      std::vector<recob::Hit const*> sharedHits = {};
+      sharedHits.reserve(hit_indices[plane_i][hit_i].second.size());
+      for (const unsigned shared_hit_index : hit_indices[plane_i][hit_i].second)
+        sharedHits.push_back(hits[shared_hit_index].get());
+
+      planeHits[hit_i] = hits[hit_index].get();
+      times[hit_i] = hits[hit_index]->PeakTime();
+
+      // Get the location of this point
+      locations[hit_i] = GetLocation(sce, track, hits[hit_index], thms[hit_index]);
+
+      // Get the pitch
+      planePitches[hit_i] =
+        GetPitch(geom, wireReadoutGeom, sce, track, *hits[hit_index], thms[hit_index]);
+
+      // And the charge
+      double charge = GetCharge(*hits[hit_index], sharedHits);
+
+      // Get the EField
+      EFields[hit_i] = GetEfield(det_prop, sce, track, hits[hit_index], thms[hit_index]);
+
+      // Angle to the drift electric field (in x direction), in units of degrees
+      trajLocations[hit_i] = track.LocationAtPoint(thms[hit_index]->Index());
+      trajDirections[hit_i] = track.DirectionAtPoint(thms[hit_index]->Index());
+      phis[hit_i] = acos(abs(trajDirections[hit_i].x())) * 180 / M_PI;
+
+      planedQdx[hit_i] = charge / planePitches[hit_i];
+    }
+
+    // Normalize out the detector response
+    Normalize(planedQdx, evt, planeHits, trajLocations, trajDirections, T0);
+
+    // turn into dEdx, all the hits of the plane belong to plane_i
+    std::vector<double> planedEdx(nhits);
+    if (fConfig.ChargeMethod() == calo::GnocchiCalorimetry::Config::cmAmplitude)
+      fCaloAlg.dEdx_AMP(
+        clock_data, det_prop, planedQdx, times, plane_i, T0, EFields, phis, planedEdx);
+    else
+      fCaloAlg.dEdx_AREA(
+        clock_data, det_prop, planedQdx, times, plane_i, T0, EFields, phis, planedEdx);
+
+    std::vector<float> lengths;
+    for (unsigned hit_i = 0; hit_i < nhits; hit_i++) {
+      unsigned hit_index = hit_indices[plane_i][hit_i].first;
+      geo::Point_t const& location = locations[hit_i];
+      double const pitch = planePitches[hit_i];
+      double const dQdx = planedQdx[hit_i];
+      double const dEdx = planedEdx[hit_i];
+
+      // save the length between each pair of hits
+      if (xyzs.size() == 0) { lengths.push_back(0.); }
+      else {
+        lengths.push_back((location - xyzs.back()).r());
       }
 
-      // save the Calorimetry output
+      // save stuff
+      dEdxs.push_back(dEdx);
+      dQdxs.push_back(dQdx);
+      pitches.push_back(pitch);
+      xyzs.push_back(location);
+      kinetic_energy += dEdx * pitch;
+
+      // TODO: FIXME
+      // It seems weird that the "trajectory-point-index" actually is the
+      // index of the hit... is this a bug in the documentation
+      // of anab::Calorimetry?
       //
-      // Bogus if less than two hits on this plane
-      if (lengths.size() > 1) {
-        outputCalo->push_back(anab::Calorimetry(kinetic_energy,
-                                                dEdxs,
-                                                dQdxs,
-                                                resranges,
-                                                deadwireresranges,
-                                                range,
-                                                pitches,
-                                                xyzs,
-                                                tp_indices,
-                                                plane));
+      // i.e. -- I think this piece of code should actually be:
+      // tp_indices.push_back(thms[hit_index]->Index());
+      tp_indices.push_back(hits[hit_index].key());
+
+    } // end iterate over hits
+
+    // turn the lengths vector into a residual-range vector and total length
+    if (lengths.size() > 1) {
+      range = std::accumulate(lengths.begin(), lengths.end(), 0.);
+
+      // check the direction that the hits are going in the track:
+      // upstream (end-start) or downstream (start-end)
+      bool is_downstream =
+        (track.Trajectory().Start() - xyzs[0]).r() + (track.Trajectory().End() - xyzs.back()).r() <
+        (track.Trajectory().End() - xyzs[0]).r() + (track.Trajectory().Start() - xyzs.back()).r();
+
+      resranges.resize(lengths.size());
+      if (is_downstream) {
+        resranges[lengths.size() - 1] = lengths.back() / 2.;
+        for (int i_len = lengths.size() - 2; i_len >= 0; i_len--) {
+          resranges[i_len] = resranges[i_len + 1] + lengths[i_len + 1];
+        }
       }
       else {
-        outputCalo->push_back(
-          anab::Calorimetry(util::kBogusD, {}, {}, {}, {}, util::kBogusD, {}, {}, {}, plane));
+        resranges[0] = lengths[1] / 2.;
+        for (unsigned i_len = 1; i_len < lengths.size(); i_len++) {
+          resranges[i_len] = resranges[i_len - 1] + lengths[i_len];
+        }
       }
+    }
 
-      util::CreateAssn(evt, *outputCalo, tracklist[trk_i], *outputCaloAssn);
-
-    } // end iterate over planes
-
-  } // end iterate over tracks
+    // save the Calorimetry output
+    //
+    // Bogus if less than two hits on this plane
+    if (lengths.size() > 1) {
+      result.push_back(anab::Calorimetry(kinetic_energy,
+                                         dEdxs,
+                                         dQdxs,
+                                         resranges,
+                                         deadwireresranges,
+                                         range,
+                                         pitches,
+                                         xyzs,
+                                         tp_indices,
+                                         plane));
+    }
+    else {
+      result.push_back(
+        anab::Calorimetry(util::kBogusD, {}, {}, {}, {}, util::kBogusD, {}, {}, {}, plane));
+    }
 
-  evt.put(std::move(outputCalo));
-  evt.put(std::move(outputCaloAssn));
+  } // end iterate over planes
 
-  return;
+  return result;
 }
 
 std::vector<std::vector<OrganizedHits>> calo::GnocchiCalorimetry::OrganizeHits(
@@ -522,20 +604,21 @@ bool calo::GnocchiCalorimetry::HitIsValid(const recob::TrackHitMeta* thm, const
   return track.HasValidPoint(thm->Index());
 }
 
-geo::Point_t calo::GnocchiCalorimetry::GetLocation(const recob::Track& track,
+geo::Point_t calo::GnocchiCalorimetry::GetLocation(const spacecharge::SpaceCharge* sce,
+                                                   const recob::Track& track,
                                                    const art::Ptr<recob::Hit> hit,
                                                    const recob::TrackHitMeta* meta)
 {
   geo::Point_t loc = track.LocationAtPoint(meta->Index());
-  return !fConfig.TrackIsFieldDistortionCorrected() ? WireToTrajectoryPosition(loc, hit->WireID()) :
-                                                      loc;
+  return !fConfig.TrackIsFieldDistortionCorrected() ?
+           WireToTrajectoryPosition(sce, loc, hit->WireID()) :
+           loc;
 }
 
-geo::Point_t calo::GnocchiCalorimetry::WireToTrajectoryPosition(const geo::Point_t& loc,
+geo::Point_t calo::GnocchiCalorimetry::WireToTrajectoryPosition(const spacecharge::SpaceCharge* sce,
+                                                                const geo::Point_t& loc,
                                                                 const geo::TPCID& tpc)
 {
-  auto const* sce = lar::providerFrom<spacecharge::SpaceChargeService>();
-
   geo::Point_t ret = loc;
 
   if (sce->EnableCalSpatialSCE() && fConfig.FieldDistortion()) {
@@ -549,26 +632,28 @@ geo::Point_t calo::GnocchiCalorimetry::WireToTrajectoryPosition(const geo::Point
   return ret;
 }
 
-geo::Point_t calo::GnocchiCalorimetry::GetLocationAtWires(const recob::Track& track,
+geo::Point_t calo::GnocchiCalorimetry::GetLocationAtWires(const geo::GeometryCore& geom,
+                                                          const spacecharge::SpaceCharge* sce,
+                                                          const recob::Track& track,
                                                           const recob::Hit& hit,
                                                           const recob::TrackHitMeta* meta)
 {
   geo::Point_t loc = track.LocationAtPoint(meta->Index());
-  return fConfig.TrackIsFieldDistortionCorrected() ? TrajectoryToWirePosition(loc, hit.WireID()) :
-                                                     loc;
+  return fConfig.TrackIsFieldDistortionCorrected() ?
+           TrajectoryToWirePosition(geom, sce, loc, hit.WireID()) :
+           loc;
 }
 
-geo::Point_t calo::GnocchiCalorimetry::TrajectoryToWirePosition(const geo::Point_t& loc,
+geo::Point_t calo::GnocchiCalorimetry::TrajectoryToWirePosition(const geo::GeometryCore& geom,
+                                                                const spacecharge::SpaceCharge* sce,
+                                                                const geo::Point_t& loc,
                                                                 const geo::TPCID& tpc)
 {
-  auto const* sce = lar::providerFrom<spacecharge::SpaceChargeService>();
-  art::ServiceHandle<geo::Geometry> geom;
-
   geo::Point_t ret = loc;
 
   if (sce->EnableCalSpatialSCE() && fConfig.FieldDistortion()) {
     // Returned X is the drift -- multiply by the drift direction to undo this
-    int corr = geom->TPC(tpc).DriftDir().X();
+    int corr = geom.TPC(tpc).DriftDir().X();
 
     geo::Vector_t offset = sce->GetPosOffsets(ret);
 
@@ -580,13 +665,13 @@ geo::Point_t calo::GnocchiCalorimetry::TrajectoryToWirePosition(const geo::Point
   return ret;
 }
 
-double calo::GnocchiCalorimetry::GetPitch(const recob::Track& track,
+double calo::GnocchiCalorimetry::GetPitch(const geo::GeometryCore& geom,
+                                          const geo::WireReadoutGeom& wireReadoutGeom,
+                                          const spacecharge::SpaceCharge* sce,
+                                          const recob::Track& track,
                                           const recob::Hit& hit,
                                           const recob::TrackHitMeta* meta)
 {
-  auto const& wireReadoutGeom = art::ServiceHandle<geo::WireReadout>()->Get();
-  auto const* sce = lar::providerFrom<spacecharge::SpaceChargeService>();
-
   double angleToVert = wireReadoutGeom.WireAngleToVertical(hit.View(), hit.WireID().asPlaneID()) -
                        0.5 * ::util::pi<>();
 
@@ -605,8 +690,8 @@ double calo::GnocchiCalorimetry::GetPitch(const recob::Track& track,
     geo::Point_t loc_mdx = loc - track_dir * plane.WirePitch() / 2.;
     geo::Point_t loc_pdx = loc + track_dir * plane.WirePitch() / 2.;
 
-    loc_mdx = TrajectoryToWirePosition(loc_mdx, hit.WireID());
-    loc_pdx = TrajectoryToWirePosition(loc_pdx, hit.WireID());
+    loc_mdx = TrajectoryToWirePosition(geom, sce, loc_mdx, hit.WireID());
+    loc_pdx = TrajectoryToWirePosition(geom, sce, loc_pdx, hit.WireID());
 
     // Direction at wires
     dir = (loc_pdx - loc_mdx) / (loc_mdx - loc_pdx).r();
@@ -622,10 +707,10 @@ double calo::GnocchiCalorimetry::GetPitch(const recob::Track& track,
   if (cosgamma) { pitch = plane.WirePitch() / cosgamma; }
 
   // now take the pitch computed on the wires and correct it back to the particle trajectory
-  geo::Point_t loc_w = GetLocationAtWires(track, hit, meta);
+  geo::Point_t loc_w = GetLocationAtWires(geom, sce, track, hit, meta);
 
-  geo::Point_t locw_pdx_traj = WireToTrajectoryPosition(loc_w + pitch * dir, hit.WireID());
-  geo::Point_t loc = WireToTrajectoryPosition(loc_w, hit.WireID());
+  geo::Point_t locw_pdx_traj = WireToTrajectoryPosition(sce, loc_w + pitch * dir, hit.WireID());
+  geo::Point_t loc = WireToTrajectoryPosition(sce, loc_w, hit.WireID());
 
   pitch = (locw_pdx_traj - loc).R();
 
@@ -650,32 +735,28 @@ double calo::GnocchiCalorimetry::GetCharge(const recob::Hit& hit,
   return 0.;
 }
 
-double calo::GnocchiCalorimetry::Normalize(double dQdx,
-                                           const art::Event& e,
-                                           const recob::Hit& h,
-                                           const geo::Point_t& location,
-                                           const geo::Vector_t& direction,
-                                           double t0)
+void calo::GnocchiCalorimetry::Normalize(std::vector<double>& dQdx,
+                                         const art::Event& e,
+                                         const std::vector<recob::Hit const*>& hits,
+                                         const std::vector<geo::Point_t>& locations,
+                                         const std::vector<geo::Vector_t>& directions,
+                                         double t0)
 {
-  double ret = dQdx;
   for (auto const& nt : fNormTools) {
-    ret = nt->Normalize(ret, e, h, location, direction, t0);
+    nt->NormalizeBatch(dQdx, e, hits, locations, directions, t0);
   }
-
-  return ret;
 }
 
 double calo::GnocchiCalorimetry::GetEfield(const detinfo::DetectorPropertiesData& dprop,
+                                           const spacecharge::SpaceCharge* sce,
                                            const recob::Track& track,
                                            const art::Ptr<recob::Hit> hit,
                                            const recob::TrackHitMeta* meta)
 {
-  auto const* sce = lar::providerFrom<spacecharge::SpaceChargeService>();
-
   double EField = dprop.Efield();
   if (sce->EnableSimEfieldSCE() && fConfig.FieldDistortionEfield()) {
     // Gets relative E field Distortions
-    geo::Vector_t EFieldOffsets = sce->GetEfieldOffsets(GetLocation(track, hit, meta));
+    geo::Vector_t EFieldOffsets = sce->GetEfieldOffsets(GetLocation(sce, track, hit, meta));
     // Add 1 in X direction as this is the direction of the drift field
     EFieldOffsets = EFieldOffsets + geo::Vector_t{1, 0, 0};
     // Convert to Absolute E Field from relative
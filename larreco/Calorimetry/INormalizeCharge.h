@@ -16,6 +16,9 @@
 #include "lardataobj/RecoBase/Hit.h"
 #include "lardataobj/RecoBase/TrackingTypes.h"
 
+#include <cstddef>
+#include <span>
+
 /**
  *  @brief  INormalizeCharge interface class definiton
  */
@@ -34,6 +37,25 @@ public:
                            const geo::Point_t& location,
                            const geo::Vector_t& direction,
                            double t0) = 0;
+
+  /**
+     *  @brief  Normalizes in place the dQdx of a group of hits, e.g. all the hits
+     *          of a track on one plane
+     *
+     *  All the spans have the same size. The default implementation calls
+     *  Normalize() for each hit; tools which can share work between hits (table
+     *  lookups, per-call setup) should override it.
+     */
+  virtual void NormalizeBatch(std::span<double> dQdx,
+                              const art::Event& e,
+                              std::span<const recob::Hit* const> hits,
+                              std::span<const geo::Point_t> locations,
+                              std::span<const geo::Vector_t> directions,
+                              double t0)
+  {
+    for (std::size_t i = 0; i < dQdx.size(); ++i)
+      dQdx[i] = Normalize(dQdx[i], e, *hits[i], locations[i], directions[i], t0);
+  }
 };
 
 #endif
@@ -19,6 +19,7 @@
 #include "larreco/Genfit/GFKalman.h"
 
 #include <iostream>
+#include <type_traits>
 
 #include "TDatabasePDG.h"
 #include "TMath.h"
@@ -27,6 +28,7 @@
 #include "larreco/Genfit/GFAbsRecoHit.h"
 #include "larreco/Genfit/GFAbsTrackRep.h"
 #include "larreco/Genfit/GFException.h"
+#include "larreco/Genfit/GFMatrix.h"
 #include "larreco/Genfit/GFTrack.h"
 
 #include "art/Framework/Services/Registry/ServiceHandle.h"
@@ -35,6 +37,126 @@
 
 #define COVEXC "cov_is_zero"
 
+namespace {
+
+  using genf::GFMatrix;
+
+  template <unsigned int N, typename F>
+  auto dispatchMeasDim(int nMeas, F&& f)
+  {
+    using N_t = std::integral_constant<unsigned int, N>;
+    switch (nMeas) {
+    case 1: return f(N_t{}, std::integral_constant<unsigned int, 1>{});
+    case 2: return f(N_t{}, std::integral_constant<unsigned int, 2>{});
+    case 3: return f(N_t{}, std::integral_constant<unsigned int, 3>{});
+    case 4: return f(N_t{}, std::integral_constant<unsigned int, 4>{});
+    case 5: return f(N_t{}, std::integral_constant<unsigned int, 5>{});
+    }
+    throw genf::GFException("GFKalman: unsupported measurement dimension", __LINE__, __FILE__)
+      .setFatal();
+  }
+
+  /// Calls f with the state dimension N and measurement dimension D as
+  /// std::integral_constant arguments, so the algebra is instantiated on
+  /// fixed-size matrices. RKTrackRep has 5 parameters, SlTrackRep 4.
+  template <typename F>
+  auto dispatchDims(int nState, int nMeas, F&& f)
+  {
+    if (nState == 5) return dispatchMeasDim<5>(nMeas, f);
+    if (nState == 4) return dispatchMeasDim<4>(nMeas, f);
+    throw genf::GFException("GFKalman: unsupported state dimension", __LINE__, __FILE__)
+      .setFatal();
+  }
+
+  template <unsigned int N, unsigned int D>
+  GFMatrix<N, D> kalmanGain(const GFMatrix<N>& cov,
+                            const GFMatrix<D>& HitCov,
+                            const GFMatrix<D, N>& H)
+  {
+    // calculate covsum (V + HCH^T)
+    const GFMatrix<N, D> covsum1 = cov * ROOT::Math::Transpose(H);
+    GFMatrix<D> covsum = H * covsum1;
+    covsum += HitCov;
+
+    // invert
+    double det = 0;
+    covsum.Det2(det);
+    if (TMath::IsNaN(det)) {
+      throw genf::GFException("Kalman Gain: det of covsum is nan", __LINE__, __FILE__).setFatal();
+    }
+
+    if (det == 0 || !covsum.Invert()) {
+      genf::GFException exc("cannot invert covsum in Kalman Gain - det=0", __LINE__, __FILE__);
+      exc.setFatal();
+      std::vector<TMatrixT<Double_t>> matrices;
+      matrices.push_back(genf::toTMatrix(cov));
+      matrices.push_back(genf::toTMatrix(HitCov));
+      matrices.push_back(genf::toTMatrix(covsum1));
+      matrices.push_back(genf::toTMatrix(covsum));
+      exc.setMatrices("cov, HitCov, covsum1 and covsum", matrices);
+      throw exc;
+    }
+
+    // gain is CH^T/(V + HCH^T)
+    return covsum1 * covsum;
+  }
+
+  template <unsigned int N, unsigned int D>
+  double chi2Increment(const GFMatrix<D, 1>& r,
+                       const GFMatrix<D, N>& H,
+                       const GFMatrix<N>& cov,
+                       const GFMatrix<D>& V)
+  {
+    // residuals covariances:R=(V - HCH^T)
+    const GFMatrix<N, D> covsum1 = cov * ROOT::Math::Transpose(H);
+    GFMatrix<D> R = V;
+    R -= H * covsum1;
+
+    // chisq= r^TR^(-1)r
+    double det = 0.;
+    const GFMatrix<D> Rsave(R);
+    R.Det2(det);
+    if (!R.Invert()) {
+      // R is not even invertible. But keep plowing on ...
+    }
+    if (TMath::IsNaN(det)) {
+      throw genf::GFException("Kalman Chi2Increment: det of covsum is nan", __LINE__, __FILE__)
+        .setFatal();
+    }
+    const GFMatrix<D, 1> Rr = R * r;
+    const GFMatrix<1> chisq = ROOT::Math::Transpose(r) * Rr;
+
+    if (TMath::IsNaN(chisq[0][0])) {
+      genf::GFException exc("chi2 is nan", __LINE__, __FILE__);
+      exc.setFatal();
+      std::vector<double> numbers;
+      numbers.push_back(det);
+      exc.setNumbers("det", numbers);
+      std::vector<TMatrixT<Double_t>> matrices;
+      matrices.push_back(genf::toTMatrix(r));
+      matrices.push_back(genf::toTMatrix(V));
+      matrices.push_back(genf::toTMatrix(Rsave));
+      matrices.push_back(genf::toTMatrix(R));
+      matrices.push_back(genf::toTMatrix(cov));
+      exc.setMatrices("r, V, Rsave, R, cov", matrices);
+      throw exc;
+    }
+
+    return chisq[0][0];
+  }
+
+  /// Filtered covariance C - K H C.
+  template <unsigned int N, unsigned int D>
+  GFMatrix<N> filteredCov(const GFMatrix<N>& cov,
+                          const GFMatrix<N, D>& gain,
+                          const GFMatrix<D, N>& H)
+  {
+    const GFMatrix<D, N> Hcov = H * cov;
+    return cov - gain * Hcov;
+  }
+
+} // namespace
+
 genf::GFKalman::GFKalman()
   : fInitialDirection(1)
   , fNumIt(3)
@@ -229,54 +351,14 @@ double genf::GFKalman::chi2Increment(const TMatrixT<Double_t>& r,
                                      const TMatrixT<Double_t>& cov,
                                      const TMatrixT<Double_t>& V)
 {
-
-  // residuals covariances:R=(V - HCH^T)
-  TMatrixT<Double_t> R(V);
-  TMatrixT<Double_t> covsum1(cov, TMatrixT<Double_t>::kMultTranspose, H);
-  TMatrixT<Double_t> covsum(H, TMatrixT<Double_t>::kMult, covsum1);
-
-  R -= covsum;
-
-  // chisq= r^TR^(-1)r
-  double det = 0.;
-  TMatrixT<Double_t> Rsave(R);
-  R.SetTol(1.0e-30); // to avoid inversion problem, EC, 8-Aug-2011. Was23, 9-Jan-2012.
-
-  try {
-    R.Invert(&det);
-  }
-  catch (cet::exception&) {
-    GFException e("Kalman Chi2Increment: R is not even invertible. But keep plowing on ... ",
-                  __LINE__,
-                  __FILE__);
-    //e.setFatal();
-    //throw e;
-  }
-  if (TMath::IsNaN(det)) {
-    throw GFException("Kalman Chi2Increment: det of covsum is nan", __LINE__, __FILE__).setFatal();
-  }
-  TMatrixT<Double_t> residTranspose(r);
-  residTranspose.T();
-  TMatrixT<Double_t> chisq = residTranspose * (R * r);
-  assert(chisq.GetNoElements() == 1);
-
-  if (TMath::IsNaN(chisq[0][0])) {
-    GFException exc("chi2 is nan", __LINE__, __FILE__);
-    exc.setFatal();
-    std::vector<double> numbers;
-    numbers.push_back(det);
-    exc.setNumbers("det", numbers);
-    std::vector<TMatrixT<Double_t>> matrices;
-    matrices.push_back(r);
-    matrices.push_back(V);
-    matrices.push_back(Rsave);
-    matrices.push_back(R);
-    matrices.push_back(cov);
-    exc.setMatrices("r, V, Rsave, R, cov", matrices);
-    throw exc;
-  }
-
-  return chisq[0][0];
+  return dispatchDims(cov.GetNrows(), H.GetNrows(), [&](auto n, auto d) {
+    constexpr unsigned int N = decltype(n)::value;
+    constexpr unsigned int D = decltype(d)::value;
+    return ::chi2Increment<N, D>(toGFMatrix<D, 1>(r),
+                                 toGFMatrix<D, N>(H),
+                                 toGFMatrix<N, N>(cov),
+                                 toGFMatrix<D, D>(V));
+  });
 }
 
 double genf::GFKalman::getChi2Hit(GFAbsRecoHit* hit, GFAbsTrackRep* rep)
@@ -565,9 +647,13 @@ void genf::GFKalman::processHit(GFTrack* tr, int ihit, int irep, int direction)
     //      std::cout << "GFKalman:: Beginnings of a problem." << std::endl;
     Hnew[0][0] = Hnew[0][0] - eps / Gain[0][0];
   }
-  TMatrixT<Double_t> GHc(GH * cov);
 
-  cov -= Gain * (Hnew * cov);
+  cov = dispatchDims(cov.GetNrows(), Hnew.GetNrows(), [&](auto n, auto d) {
+    constexpr unsigned int N = decltype(n)::value;
+    constexpr unsigned int D = decltype(d)::value;
+    return toTMatrix(
+      filteredCov(toGFMatrix<N, N>(cov), toGFMatrix<N, D>(Gain), toGFMatrix<D, N>(Hnew)));
+  });
 
   // Below is protection required at end of contained track when
   // momentum is tiny and cov[0][0] gets huge.
@@ -669,7 +755,7 @@ TMatrixT<Double_t> genf::GFKalman::calcCov7x7(const TMatrixT<Double_t>& cov,
                                               const GFDetPlane& plane)
 {
   // This ends up, confusingly, as: 7 columns, 5 rows!
-  TMatrixT<Double_t> jac(7, 5); // X,Y,Z,UX,UY,UZ,Theta in detector coords
+  GFMatrix<7, 5> jac; // X,Y,Z,UX,UY,UZ,Theta in detector coords
 
   TVector3 u = plane.getU();
   TVector3 v = plane.getV();
@@ -681,7 +767,6 @@ TMatrixT<Double_t> genf::GFKalman::calcCov7x7(const TMatrixT<Double_t>& cov,
   TVector3 pTilde = w;
   double pTildeMag = pTilde.Mag();
 
-  jac.Zero();
   jac[6][0] = 1.; //  Should be C as in GFSpacepointHitPolicy. 16-Feb-2013.
 
   jac[0][3] = u[0];
@@ -705,75 +790,33 @@ TMatrixT<Double_t> genf::GFKalman::calcCov7x7(const TMatrixT<Double_t>& cov,
   // y = A.x => x = A^T.A.A^T.y
   // Thus, y's Jacobians Jac become for x (Jac^T.Jac)^(-1) Jac^T
 
-  TMatrixT<Double_t> jac_t(TMatrixT<Double_t>::kTransposed, jac);
-  TMatrixT<Double_t> jjInv(jac_t * jac);
-  //jInv.Zero();
+  GFMatrix<5> jjInv = ROOT::Math::Transpose(jac) * jac;
 
   double det(0.0);
-  try {
-    jjInv.Invert(&det); // this is all 1s on the diagonal, perhaps
-                        // to no one's surprise.
+  jjInv.Det2(det);
+  if (TMath::IsNaN(det)) {
+    throw GFException("GFKalman: det of Jac.T*Jac is nan", __LINE__, __FILE__).setFatal();
   }
-  catch (cet::exception&) {
+  // this is all 1s on the diagonal, perhaps to no one's surprise.
+  if (!jjInv.Invert()) {
     throw GFException(
       "GFKalman: Jac.T*Jac is not invertible. But keep plowing on ... ", __LINE__, __FILE__)
       .setFatal();
   }
-  if (TMath::IsNaN(det)) {
-    throw GFException("GFKalman: det of Jac.T*Jac is nan", __LINE__, __FILE__).setFatal();
-  }
 
-  TMatrixT<Double_t> j5x7 = jjInv * jac_t;
-  TMatrixT<Double_t> c7x7 = j5x7.T() * (cov * j5x7);
-  return c7x7;
+  const GFMatrix<5, 7> j5x7 = jjInv * ROOT::Math::Transpose(jac);
+  const GFMatrix<5, 7> covj5x7 = toGFMatrix<5, 5>(cov) * j5x7;
+  return toTMatrix(GFMatrix<7>(ROOT::Math::Transpose(j5x7) * covj5x7));
 }
 
 TMatrixT<Double_t> genf::GFKalman::calcGain(const TMatrixT<Double_t>& cov,
                                             const TMatrixT<Double_t>& HitCov,
                                             const TMatrixT<Double_t>& H)
 {
-
-  // calculate covsum (V + HCH^T)
-
-  // Comment next 3 out for normal running.
-  //cov.Print();
-  //H.Print();
-  //HitCov.Print();
-  TMatrixT<Double_t> covsum1(cov, TMatrixT<Double_t>::kMultTranspose, H);
-  //  covsum1.Print();
-  TMatrixT<Double_t> covsum(H, TMatrixT<Double_t>::kMult, covsum1);
-
-  //covsum.Print();
-
-  covsum += HitCov;
-  //covsum = (covsum,TMatrixT<Double_t>::kPlus,HitCov);
-  // covsum.Print();
-
-  // invert
-  double det = 0;
-  covsum.SetTol(1.0e-23); // to avoid inversion problem, EC, 8-Aug-2011.
-  covsum.Invert(&det);
-  //    std::cout << "GFKalman:: calGain(), det is  "<< det << std::endl;
-  if (TMath::IsNaN(det)) {
-    throw GFException("Kalman Gain: det of covsum is nan", __LINE__, __FILE__).setFatal();
-  }
-
-  if (det == 0) {
-    GFException exc("cannot invert covsum in Kalman Gain - det=0", __LINE__, __FILE__);
-    exc.setFatal();
-    std::vector<TMatrixT<Double_t>> matrices;
-    matrices.push_back(cov);
-    matrices.push_back(HitCov);
-    matrices.push_back(covsum1);
-    matrices.push_back(covsum);
-    exc.setMatrices("cov, HitCov, covsum1 and covsum", matrices);
-    throw exc;
-  }
-
-  // gain is CH^T/(V + HCH^T)
-  // calculate gain
-  TMatrixT<Double_t> gain1(H, TMatrixT<Double_t>::kTransposeMult, covsum);
-  TMatrixT<Double_t> gain(cov, TMatrixT<Double_t>::kMult, gain1);
-
-  return gain;
+  return dispatchDims(cov.GetNrows(), H.GetNrows(), [&](auto n, auto d) {
+    constexpr unsigned int N = decltype(n)::value;
+    constexpr unsigned int D = decltype(d)::value;
+    return toTMatrix(
+      kalmanGain<N, D>(toGFMatrix<N, N>(cov), toGFMatrix<D, D>(HitCov), toGFMatrix<D, N>(H)));
+  });
 }
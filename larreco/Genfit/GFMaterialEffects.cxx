@@ -28,9 +28,6 @@
 #include "TGeoMaterial.h"
 #include "TGeoMedium.h"
 #include "TGeoVolume.h"
-#include "TMatrixT.h"
-#include "TMatrixTBase.h"
-#include "TMatrixTUtils.h"
 #include "TParticlePDG.h"
 
 genf::GFMaterialEffects* genf::GFMaterialEffects::finstance = NULL;
@@ -93,8 +90,8 @@ double genf::GFMaterialEffects::effects(const std::vector<TVector3>& points,
                                         const double& mom,
                                         const int& pdg,
                                         const bool& doNoise,
-                                        TMatrixT<Double_t>* noise,
-                                        const TMatrixT<Double_t>* jacobian,
+                                        GFMatrix<7>* noise,
+                                        const GFMatrix<7>* jacobian,
                                         const TVector3* directionBefore,
                                         const TVector3* directionAfter)
 {
@@ -326,7 +323,7 @@ double genf::GFMaterialEffects::energyLossBetheBloch(const double& mom)
   return momLoss;
 }
 
-void genf::GFMaterialEffects::noiseBetheBloch(const double& mom, TMatrixT<double>* noise) const
+void genf::GFMaterialEffects::noiseBetheBloch(const double& mom, GFMatrix<7>* noise) const
 {
 
   // ENERGY LOSS FLUCTUATIONS; calculate sigma^2(E);
@@ -392,8 +389,8 @@ void genf::GFMaterialEffects::noiseBetheBloch(const double& mom, TMatrixT<double
 }
 
 void genf::GFMaterialEffects::noiseCoulomb(const double& mom,
-                                           TMatrixT<double>* noise,
-                                           const TMatrixT<double>* jacobian,
+                                           GFMatrix<7>* noise,
+                                           const GFMatrix<7>* jacobian,
                                            const TVector3* directionBefore,
                                            const TVector3* directionAfter) const
 {
@@ -410,7 +407,7 @@ void genf::GFMaterialEffects::noiseCoulomb(const double& mom,
         -0.5)); // sigma^2 = 225E-6/mom^2 * XX0/fbeta^2 * Z/(Z+1) * ln(159*Z^(-1/3))/ln(287*Z^(-1/2)
 
   // noiseBefore
-  TMatrixT<double> noiseBefore(7, 7);
+  GFMatrix<7> noiseBefore;
 
   // calculate euler angles theta, psi (so that directionBefore' points in z' direction)
   double psi = 0;
@@ -452,14 +449,11 @@ void genf::GFMaterialEffects::noiseCoulomb(const double& mom,
   noiseBefore[4][5] = noiseBefore45;
   noiseBefore[5][5] = sigma2 * sintheta * sintheta;
 
-  TMatrixT<double> jacobianT(7, 7);
-  jacobianT = (*jacobian);
-  jacobianT.T();
-
-  noiseBefore = jacobianT * noiseBefore * (*jacobian); //propagate
+  const GFMatrix<7> noiseJac = noiseBefore * (*jacobian);
+  noiseBefore = ROOT::Math::Transpose(*jacobian) * noiseJac; //propagate
 
   // noiseAfter
-  TMatrixT<double> noiseAfter(7, 7);
+  GFMatrix<7> noiseAfter;
 
   // calculate euler angles theta, psi (so that A' points in z' direction)
   psi = 0;
@@ -714,7 +708,7 @@ double genf::GFMaterialEffects::energyLossBrems(const double& mom) const
   return momLoss;
 }
 
-void genf::GFMaterialEffects::noiseBrems(const double& mom, TMatrixT<double>* noise) const
+void genf::GFMaterialEffects::noiseBrems(const double& mom, GFMatrix<7>* noise) const
 {
 
   if (fabs(fpdg) != 11) return; // only for electrons and positrons
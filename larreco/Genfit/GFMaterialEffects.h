@@ -28,6 +28,8 @@
 #include "TVector3.h"
 #include <vector>
 
+#include "larreco/Genfit/GFMatrix.h"
+
 class TGeoMaterial;
 
 /** @brief  Handles energy loss classes. Contains stepper and energy loss/noise matrix calculation
@@ -69,8 +71,8 @@ namespace genf {
                    const double& mom,
                    const int& pdg,
                    const bool& doNoise = false,
-                   TMatrixT<Double_t>* noise = NULL,
-                   const TMatrixT<Double_t>* jacobian = NULL,
+                   GFMatrix<7>* noise = NULL,
+                   const GFMatrix<7>* jacobian = NULL,
                    const TVector3* directionBefore = NULL,
                    const TVector3* directionAfter = NULL);
 
@@ -122,7 +124,7 @@ namespace genf {
     *
     *  Needs fdedx, which is calculated in energyLossBetheBloch, so it has to be calles afterwards!
     */
-    void noiseBetheBloch(const double& mom, TMatrixT<double>* noise) const;
+    void noiseBetheBloch(const double& mom, GFMatrix<7>* noise) const;
 
     //! calculation of multiple scattering
     /**  With the calculated multiple scattering angle, two noise matrices are calculated:
@@ -315,8 +317,8 @@ namespace genf {
     * \n
     */
     void noiseCoulomb(const double& mom,
-                      TMatrixT<double>* noise,
-                      const TMatrixT<double>* jacobian,
+                      GFMatrix<7>* noise,
+                      const GFMatrix<7>* jacobian,
                       const TVector3* directionBefore,
                       const TVector3* directionAfter) const;
 
@@ -331,7 +333,7 @@ namespace genf {
     /** Can be called with any pdg, but only calculates straggeling for electrons and positrons.
    *
    */
-    void noiseBrems(const double& mom, TMatrixT<double>* noise) const;
+    void noiseBrems(const double& mom, GFMatrix<7>* noise) const;
     double MeanExcEnergy_get(int Z);
     double MeanExcEnergy_get(TGeoMaterial*);
 
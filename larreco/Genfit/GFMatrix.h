@@ -0,0 +1,59 @@
+/** @addtogroup genfit
+ * @{
+ */
+
+#ifndef GFMATRIX_H
+#define GFMATRIX_H
+
+#include <algorithm>
+#include <cassert>
+
+#include "Math/SMatrix.h"
+#include "RtypesCore.h"
+#include "TMatrixT.h"
+
+/** @brief Fixed-size matrices for the internal Genfit algebra
+ *
+ * The track representations and reco hits exchange their states and
+ * covariances as TMatrixT objects, which are sized at run time and whose
+ * storage for anything larger than 5x5 lives on the heap. The propagation
+ * and filter algebra always works on a handful of known dimensions (5 track
+ * parameters, 7 global coordinates), so internally it uses these compile-time
+ * sized matrices and converts at the interface boundary only.
+ */
+
+namespace genf {
+
+  template <unsigned int R, unsigned int C = R>
+  using GFMatrix = ROOT::Math::SMatrix<Double_t, R, C>;
+
+  /// Copies a TMatrixT into a fixed-size matrix; dimensions must match.
+  template <unsigned int R, unsigned int C>
+  GFMatrix<R, C> toGFMatrix(const TMatrixT<Double_t>& m)
+  {
+    assert(m.GetNrows() == int(R) && m.GetNcols() == int(C));
+    // both layouts are row-major
+    return GFMatrix<R, C>(m.GetMatrixArray(), R * C);
+  }
+
+  /// Copies a fixed-size matrix into a TMatrixT, resizing it as needed.
+  template <unsigned int R, unsigned int C>
+  void toTMatrix(const GFMatrix<R, C>& m, TMatrixT<Double_t>& out)
+  {
+    out.ResizeTo(R, C);
+    std::copy(m.begin(), m.end(), out.GetMatrixArray());
+  }
+
+  template <unsigned int R, unsigned int C>
+  TMatrixT<Double_t> toTMatrix(const GFMatrix<R, C>& m)
+  {
+    TMatrixT<Double_t> out(R, C);
+    std::copy(m.begin(), m.end(), out.GetMatrixArray());
+    return out;
+  }
+
+} // namespace genf
+
+#endif
+
+/** @} */
@@ -22,6 +22,7 @@
 #include "TMath.h"
 
 #include "larreco/Genfit/GFAbsRecoHit.h"
+#include "larreco/Genfit/GFMatrix.h"
 
 const std::string genf::GFSpacepointHitPolicy::fPolicyName = "GFSpacepointHitPolicy";
 
@@ -135,18 +136,21 @@ TMatrixT<Double_t> genf::GFSpacepointHitPolicy::hitCov(GFAbsRecoHit* hit,
   static std::vector<double> oldRawCov(tmpRawCov);
   static std::vector<double> oldOldRawCov(tmpRawCov);
   static GFDetPlane planePrevPrev(planePrev);
-  rawCov.ResizeTo(7, 7); // this becomes used now for something else entirely:
-  // the 7x7 raw errors on x,y,z,px,py,pz,th, which sandwiched between 5x7
+  // rawCov7 is the 7x7 raw errors on x,y,z,px,py,pz,th, which sandwiched between 5x7
   // Jacobian converts it to the cov matrix for the 5x5 state space.
-  rawCov[0][0] = tmpRawCov[0]; // x
-  rawCov[1][1] = tmpRawCov[1]; // y
-  rawCov[2][2] = tmpRawCov[2]; // z
-  rawCov[1][2] = tmpRawCov[3]; // yz
-  rawCov[2][1] = tmpRawCov[3]; // yz
+  GFMatrix<7> rawCov7;
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      rawCov7[i][j] = rawCov[i][j];
+  rawCov7[0][0] = tmpRawCov[0]; // x
+  rawCov7[1][1] = tmpRawCov[1]; // y
+  rawCov7[2][2] = tmpRawCov[2]; // z
+  rawCov7[1][2] = tmpRawCov[3]; // yz
+  rawCov7[2][1] = tmpRawCov[3]; // yz
 
   // This Jacobian concerns the transfrom from planar to detector coords.
   //   TMatrixT<Double_t> jac(3,2);
-  TMatrixT<Double_t> jac(7, 5); // X,Y,Z,UX,UY,UZ,Theta in detector coords
+  GFMatrix<7, 5> jac; // X,Y,Z,UX,UY,UZ,Theta in detector coords
 
   // jac = dF_i/dx_j = s_unitvec * t_unitvec, with s=|q|/p,du/dw, dv/dw, u,v and t=th, x,y,z
 
@@ -167,7 +171,7 @@ TMatrixT<Double_t> genf::GFSpacepointHitPolicy::hitCov(GFAbsRecoHit* hit,
   //                (x1-x2)^2*(y1-y2)^2*sigma_y1^2/d^6 + ...
   //                (x1-x2)^2*(z1-z2)^2*sigma_z2^2/d^6 +
 
-  rawCov[3][3] =
+  rawCov7[3][3] =
     (oldRawCov[0] + tmpRawCov[0]) / pow(dist, 4.) *
       (pow((plane.getO() - planePrev.getO()).Y(), 2.) +
        pow((plane.getO() - planePrev.getO()).Z(), 2.)) +
@@ -179,7 +183,7 @@ TMatrixT<Double_t> genf::GFSpacepointHitPolicy::hitCov(GFAbsRecoHit* hit,
     + 3.0 * (plane.getO() - planePrev.getO()).X() * (plane.getO() - planePrev.getO()).Y() *
         (plane.getO() - planePrev.getO()).Z() / pow(dist, 5.) * (tmpRawCov[3] + oldRawCov[3]);
 
-  rawCov[4][4] =
+  rawCov7[4][4] =
     (oldRawCov[1] + tmpRawCov[1]) / pow(dist, 4.) *
       (pow((plane.getO() - planePrev.getO()).X(), 2.) +
        pow((plane.getO() - planePrev.getO()).Z(), 2.)) +
@@ -194,7 +198,7 @@ TMatrixT<Double_t> genf::GFSpacepointHitPolicy::hitCov(GFAbsRecoHit* hit,
          (plane.getO() - planePrev.getO()).Z() / pow(dist, 3.)) *
         (tmpRawCov[3] + oldRawCov[3]);
 
-  rawCov[5][5] =
+  rawCov7[5][5] =
     (oldRawCov[2] + tmpRawCov[2]) / pow(dist, 4.) *
       (pow((plane.getO() - planePrev.getO()).X(), 2.) +
        pow((plane.getO() - planePrev.getO()).Y(), 2.)) +
@@ -306,22 +310,22 @@ TMatrixT<Double_t> genf::GFSpacepointHitPolicy::hitCov(GFAbsRecoHit* hit,
   // That was delta(cos(theta))^2. I want delta(theta)^2. dTh^2 = d(cosTh)^2/sinTh^2
   Double_t theta(TMath::ACos((plane.getO() - planePrev.getO()).Unit() *
                              (planePrev.getO() - planePrevPrev.getO()).Unit()));
-  rawCov[6][6] =
+  rawCov7[6][6] =
     TMath::Min(pow(dcosTh, 2.) / pow(TMath::Sin(theta), 2.), pow(TMath::Pi() / 2.0, 2.));
 
   // This means I'm too close to the endpoints to have histories that allow
   // proper calculation of above rawCovs. Use below defaults instead.
   if (d1 == 0 || d2 == 0) {
-    rawCov[3][3] = pow(0.2, 2.0); // Unit Px
-    rawCov[4][4] = pow(0.2, 2.0); // Unit Py
-    rawCov[5][5] = pow(0.2, 2.0); // Unit Pz
-    rawCov[6][6] = pow(0.1, 2.0); // theta. 0.3/3mm, say.
+    rawCov7[3][3] = pow(0.2, 2.0); // Unit Px
+    rawCov7[4][4] = pow(0.2, 2.0); // Unit Py
+    rawCov7[5][5] = pow(0.2, 2.0); // Unit Pz
+    rawCov7[6][6] = pow(0.1, 2.0); // theta. 0.3/3mm, say.
     dist = 0.3;
     C = 0.0136 / beta * sqrt(dist / 14.0) * (1 + 0.038 * log(dist / 14.0));
   }
 
   // This forces a huge/tiny theta error, which effectively freezes/makes-us-sensitive theta, as is.
-  //rawCov[6][6] = /*9.99e9*/ 0.1;
+  //rawCov7[6][6] = /*9.99e9*/ 0.1;
 
   TVector3 u = plane.getU();
   TVector3 v = plane.getV();
@@ -333,7 +337,6 @@ TMatrixT<Double_t> genf::GFSpacepointHitPolicy::hitCov(GFAbsRecoHit* hit,
   TVector3 pTilde = w;
   double pTildeMag = pTilde.Mag();
 
-  jac.Zero();
   jac[6][0] = 1. / C; // Should be 1/C?; Had 1 until ... 12-Feb-2013
 
   jac[0][3] = _U[0];
@@ -354,10 +357,8 @@ TMatrixT<Double_t> genf::GFSpacepointHitPolicy::hitCov(GFAbsRecoHit* hit,
   jac[4][2] = 1.0 / pTildeMag * (v.Y() - pTilde.Y() / (pTildeMag * pTildeMag) * v * pTilde);
   jac[5][2] = 1.0 / pTildeMag * (v.Z() - pTilde.Z() / (pTildeMag * pTildeMag) * v * pTilde);
 
-  TMatrixT<Double_t> jac_orig = jac;
-  TMatrixT<Double_t> jac_t = jac.T();
-
-  TMatrixT<Double_t> result = jac_t * (rawCov * jac_orig);
+  const GFMatrix<7, 5> rawCovJac = rawCov7 * jac;
+  TMatrixT<Double_t> result = toTMatrix(GFMatrix<5>(ROOT::Math::Transpose(jac) * rawCovJac));
   //std::cout << "hitCov="<<std::endl;
   //result.Print();
 
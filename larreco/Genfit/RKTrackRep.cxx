@@ -364,7 +364,7 @@ void genf::RKTrackRep::extrapolateToPoint(const TVector3& pos, TVector3& poca, T
 
   TVector3 point = o + fState[3][0] * u + fState[4][0] * v;
 
-  TMatrixT<Double_t> state7(7, 1);
+  GFMatrix<7, 1> state7;
   state7[0][0] = point.X();
   state7[1][0] = point.Y();
   state7[2][0] = point.Z();
@@ -430,7 +430,7 @@ void genf::RKTrackRep::extrapolateToLine(const TVector3& point1,
 
   TVector3 point = o + fState[3][0] * u + fState[4][0] * v;
 
-  TMatrixT<Double_t> state7(7, 1);
+  GFMatrix<7, 1> state7;
   state7[0][0] = point.X();
   state7[1][0] = point.Y();
   state7[2][0] = point.Z();
@@ -470,8 +470,8 @@ double genf::RKTrackRep::extrapolate(const GFDetPlane& pl,
                                      TMatrixT<Double_t>& covPred)
 {
 
-  TMatrixT<Double_t> cov7x7(7, 7);
-  TMatrixT<Double_t> J_pM(7, 5);
+  GFMatrix<7> cov7x7;
+  GFMatrix<7, 5> J_pM;
 
   TVector3 o = fRefPlane.getO();
   TVector3 u = fRefPlane.getU();
@@ -502,29 +502,28 @@ double genf::RKTrackRep::extrapolate(const GFDetPlane& pl,
   // dqOp/dqOp
   J_pM[6][0] = 1.;
 
-  TMatrixT<Double_t> J_pM_transp(J_pM);
-  J_pM_transp.T();
-
-  cov7x7 = J_pM * (fCov * J_pM_transp);
+  GFMatrix<5, 7> covJ_pM_transp = toGFMatrix<5, 5>(fCov) * ROOT::Math::Transpose(J_pM);
+  cov7x7 = J_pM * covJ_pM_transp;
   if (cov7x7[0][0] >= 1000. || cov7x7[0][0] < 1.E-50) {
     if (pOut) {
       (*pOut) << "RKTrackRep::extrapolate(): cov7x7[0][0] is crazy. Rescale off-diags. Try again. "
                  "fCov, cov7x7 were: "
               << std::endl;
       PrintROOTobject(*pOut, fCov);
-      PrintROOTobject(*pOut, cov7x7);
+      (*pOut) << cov7x7 << std::endl;
     }
     rescaleCovOffDiags();
-    cov7x7 = J_pM * (fCov * J_pM_transp);
+    covJ_pM_transp = toGFMatrix<5, 5>(fCov) * ROOT::Math::Transpose(J_pM);
+    cov7x7 = J_pM * covJ_pM_transp;
     if (pOut) {
       (*pOut) << "New cov7x7 and fCov are ... " << std::endl;
-      PrintROOTobject(*pOut, cov7x7);
+      (*pOut) << cov7x7 << std::endl;
       PrintROOTobject(*pOut, fCov);
     }
   }
 
   TVector3 pos = o + fState[3][0] * u + fState[4][0] * v;
-  TMatrixT<Double_t> state7(7, 1);
+  GFMatrix<7, 1> state7;
   state7[0][0] = pos.X();
   state7[1][0] = pos.Y();
   state7[2][0] = pos.Z();
@@ -552,7 +551,7 @@ double genf::RKTrackRep::extrapolate(const GFDetPlane& pl,
   double QOP = state7[6][0];
   TVector3 A(AX, AY, AZ);
   TVector3 Point(X, Y, Z);
-  TMatrixT<Double_t> J_Mp(5, 7);
+  GFMatrix<5, 7> J_Mp;
 
   // J_Mp matrix is d(q/p,u',v',u,v) / d(x,y,z,ax,ay,az,q/p)
   J_Mp[0][6] = 1.;
@@ -574,11 +573,8 @@ double genf::RKTrackRep::extrapolate(const GFDetPlane& pl,
   J_Mp[4][1] = V.Y();
   J_Mp[4][2] = V.Z();
 
-  TMatrixT<Double_t> J_Mp_transp(J_Mp);
-  J_Mp_transp.T();
-
-  covPred.ResizeTo(5, 5);
-  covPred = J_Mp * (cov7x7 * J_Mp_transp);
+  const GFMatrix<7, 5> covJ_Mp_transp = cov7x7 * ROOT::Math::Transpose(J_Mp);
+  toTMatrix(GFMatrix<5>(J_Mp * covJ_Mp_transp), covPred);
 
   statePred.ResizeTo(5, 1);
   statePred[0][0] = QOP;
@@ -606,7 +602,7 @@ double genf::RKTrackRep::extrapolate(const GFDetPlane& pl, TMatrixT<Double_t>& s
 
   TVector3 pos = o + fState[3][0] * u + fState[4][0] * v;
 
-  TMatrixT<Double_t> state7(7, 1);
+  GFMatrix<7, 1> state7;
   state7[0][0] = pos.X();
   state7[1][0] = pos.Y();
   state7[2][0] = pos.Z();
@@ -1132,8 +1128,8 @@ bool genf::RKTrackRep::RKutta(const GFDetPlane& plane,
 }
 
 double genf::RKTrackRep::Extrap(const GFDetPlane& plane,
-                                TMatrixT<Double_t>* state,
-                                TMatrixT<Double_t>* cov) const
+                                GFMatrix<7, 1>* state,
+                                GFMatrix<7>* cov) const
 {
 
   static const int maxNumIt(2000);
@@ -1149,13 +1145,18 @@ double genf::RKTrackRep::Extrap(const GFDetPlane& plane,
     P[i] = (*state)[i][0];
   }
 
-  TMatrixT<Double_t> jac(7, 7);
-  TMatrixT<Double_t> jacT(7, 7);
-  TMatrixT<Double_t> oldCov(7, 7);
-  if (calcCov) oldCov = (*cov);
+  GFMatrix<7> jac;
+  GFMatrix<7> noise;
+  GFMatrix<7> covJac;
   double coveredDistance(0.);
   double sumDistance(0.);
 
+  // reused by every iteration; RKutta() clears points and pointPaths itself
+  std::vector<TVector3> points;
+  std::vector<double> pointPaths;
+  std::vector<TVector3> pointsFilt;
+  std::vector<double> pointPathsFilt;
+
   while (true) {
     if (numIt++ > maxNumIt) {
       throw GFException(
@@ -1188,8 +1189,6 @@ double genf::RKTrackRep::Extrap(const GFDetPlane& plane,
     directionBefore.SetMag(1.);
 
     // propagation
-    std::vector<TVector3> points;
-    std::vector<double> pointPaths;
     if (!this->RKutta(plane,
                       P,
                       coveredDistance,
@@ -1211,8 +1210,8 @@ double genf::RKTrackRep::Extrap(const GFDetPlane& plane,
     sumDistance += coveredDistance;
 
     // filter Points
-    std::vector<TVector3> pointsFilt(1, points.at(0));
-    std::vector<double> pointPathsFilt(1, 0.);
+    pointsFilt.assign(1, points.at(0));
+    pointPathsFilt.assign(1, 0.);
     // only if in right direction
     for (unsigned int i = 1; i < points.size(); ++i) {
       if (pointPaths.at(i) * coveredDistance > 0.) {
@@ -1254,11 +1253,9 @@ double genf::RKTrackRep::Extrap(const GFDetPlane& plane,
             jac[i][j] = P[(i + 1) * 7 + j] / P[6];
         }
       }
-      jacT = jac;
-      jacT.T();
     }
 
-    TMatrixT<Double_t> noise(7, 7); // zero everywhere by default
+    noise = GFMatrix<7>(); // zero everywhere
 
     // call MatEffects
     double momLoss; // momLoss has a sign - negative loss means momentum gain
@@ -1289,8 +1286,8 @@ double genf::RKTrackRep::Extrap(const GFDetPlane& plane,
     }
 
     if (calcCov) { //propagate cov and add noise
-      oldCov = *cov;
-      *cov = jacT * ((oldCov)*jac) + noise;
+      covJac = (*cov) * jac;
+      *cov = ROOT::Math::Transpose(jac) * covJac + noise;
     }
 
     //we arrived at the destination plane, if we point to the active area
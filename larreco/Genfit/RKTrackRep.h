@@ -29,6 +29,7 @@
 
 #include "larreco/Genfit/GFAbsTrackRep.h"
 #include "larreco/Genfit/GFDetPlane.h"
+#include "larreco/Genfit/GFMatrix.h"
 #include <TMatrixT.h>
 #include <stdexcept> // std::logic_error
 
@@ -203,10 +204,11 @@ namespace genf {
     * so that the direction doesn't change and tiny steps are filtered out. After the propagation the material effects in #fEffect are called.
     * Extrap() will loop until the plane is reached, unless the propagation fails or the maximum number of
     * iterations is exceeded.
+    * State and covariance are in global coordinates (x,y,z,ax,ay,az,q/p).
     */
     double Extrap(const GFDetPlane& plane,
-                  TMatrixT<Double_t>* state,
-                  TMatrixT<Double_t>* cov = NULL) const;
+                  GFMatrix<7, 1>* state,
+                  GFMatrix<7>* cov = NULL) const;
 
     //  void setData(const TMatrixT<Double_t>& /* st */, const GFDetPlane& /* pl */, const TMatrixT<Double_t>* cov=NULL, const TMatrixT<double>* aux=NULL);
     //    { throw std::logic_error(std::string(__func__) + "::setData(TMatrixT, GFDetPlane, TMatrixT) not available"); }
@@ -0,0 +1,179 @@
+#include "HitTruthIndex.h"
+
+#include "lardataalg/DetectorInfo/DetectorClocksData.h"
+
+#include "cetlib_except/exception.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace btutil {
+
+  void HitTruthIndex::Clear()
+  {
+    _hit_product_id = art::ProductID{};
+    _ides.clear();
+    _hit_offsets.clear();
+    _hit_planes.clear();
+    _dominant_id.clear();
+    _dominant_frac.clear();
+    _track_ids.clear();
+    _track_offsets.clear();
+    _track_hits.clear();
+    _track_energy.clear();
+    _track_plane_energy.clear();
+    _num_planes = 0;
+  }
+
+  void HitTruthIndex::Fill(detinfo::DetectorClocksData const& clockData,
+                           const std::vector<sim::SimChannel>& simch_v,
+                           const std::vector<recob::Hit>& hits,
+                           double hitTimeRMS)
+  {
+    std::vector<const sim::SimChannel*> channels;
+    channels.reserve(simch_v.size());
+    for (auto const& sch : simch_v)
+      channels.push_back(&sch);
+    std::sort(channels.begin(), channels.end(), [](auto const* a, auto const* b) {
+      return a->Channel() < b->Channel();
+    });
+
+    auto trackIDEsOf = [&](const recob::Hit& hit) {
+      std::vector<sim::TrackIDE> trackIDEs;
+
+      auto const ich = std::lower_bound(
+        channels.begin(), channels.end(), hit.Channel(), [](auto const* sch, raw::ChannelID_t ch) {
+          return sch->Channel() < ch;
+        });
+      if (ich == channels.end() || (*ich)->Channel() != hit.Channel()) return trackIDEs;
+
+      int start_tdc = clockData.TPCTick2TDC(hit.PeakTimeMinusRMS(hitTimeRMS));
+      int end_tdc = clockData.TPCTick2TDC(hit.PeakTimePlusRMS(hitTimeRMS));
+      if (start_tdc < 0) start_tdc = 0;
+      if (end_tdc < 0) end_tdc = 0;
+      auto const simides = (*ich)->TrackIDsAndEnergies(start_tdc, end_tdc);
+
+      double totalE = 0.;
+      for (auto const& ide : simides)
+        totalE += ide.energy;
+      // protect against a divide by zero below
+      if (totalE < 1.e-5) totalE = 1.;
+
+      for (auto const& ide : simides) {
+        if (ide.trackID == sim::NoParticleId) continue;
+        sim::TrackIDE info;
+        info.trackID = ide.trackID;
+        info.energyFrac = ide.energy / totalE;
+        info.energy = ide.energy;
+        info.numElectrons = ide.numElectrons;
+        trackIDEs.push_back(info);
+      }
+      return trackIDEs;
+    };
+
+    Fill(hits, trackIDEsOf);
+  }
+
+  void HitTruthIndex::CheckNextHit(const art::Ptr<recob::Hit>& hit)
+  {
+    if (!_hit_product_id.isValid()) _hit_product_id = hit.id();
+    if (hit.id() == _hit_product_id && hit.key() == NHits()) return;
+    throw cet::exception("HitTruthIndex")
+      << "Fill() got hit " << hit.id() << ":" << hit.key() << " as hit #" << NHits() << " of "
+      << _hit_product_id << "; the whole hit data product is needed, in its original order\n";
+  }
+
+  HitTruthIndex::Range_t<sim::TrackIDE> HitTruthIndex::HitTrackIDEs(
+    const art::Ptr<recob::Hit>& hit) const
+  {
+    if (_hit_product_id.isValid() && hit.id() != _hit_product_id) {
+      throw cet::exception("HitTruthIndex")
+        << "hit " << hit.id() << ":" << hit.key() << " is not from the indexed hit collection "
+        << _hit_product_id << "\n";
+    }
+    return (hit.key() < NHits()) ? HitTrackIDEs(hit.key()) : Range_t<sim::TrackIDE>{};
+  }
+
+  void HitTruthIndex::BuildTrackTable()
+  {
+    auto const nhits = NHits();
+
+    // per-hit summary; the first of equal contributions wins
+    _dominant_id.assign(nhits, sim::NoParticleId);
+    _dominant_frac.assign(nhits, 0.);
+    for (std::size_t ihit = 0; ihit < nhits; ++ihit) {
+      double max_e = -1.;
+      for (auto const& ide : HitTrackIDEs(ihit)) {
+        if (ide.energy <= max_e) continue;
+        max_e = ide.energy;
+        _dominant_id[ihit] = ide.trackID;
+        _dominant_frac[ihit] = ide.energyFrac;
+      }
+    }
+
+    for (auto const plane : _hit_planes)
+      _num_planes = std::max(_num_planes, plane + 1);
+
+    // (track ID, hit, contribution) sorted by track and then by hit
+    std::vector<std::tuple<int, std::size_t, std::size_t>> contrib;
+    contrib.reserve(_ides.size());
+    for (std::size_t ihit = 0; ihit < nhits; ++ihit)
+      for (std::size_t i = _hit_offsets[ihit]; i < _hit_offsets[ihit + 1]; ++i)
+        contrib.emplace_back(_ides[i].trackID, ihit, i);
+    std::sort(contrib.begin(), contrib.end());
+
+    for (auto const& [track_id, ihit, i] : contrib) {
+      bool const new_track = _track_ids.empty() || _track_ids.back() != track_id;
+      if (new_track) {
+        _track_ids.push_back(track_id);
+        _track_offsets.push_back(_track_hits.size());
+        _track_energy.push_back(0.);
+        _track_plane_energy.resize(_track_plane_energy.size() + _num_planes, 0.);
+      }
+      // a track may contribute more than once to the same hit
+      if (new_track || _track_hits.back() != ihit) _track_hits.push_back(ihit);
+      _track_energy.back() += _ides[i].energy;
+      _track_plane_energy[(_track_ids.size() - 1) * _num_planes + _hit_planes[ihit]] +=
+        _ides[i].energy;
+    }
+    _track_offsets.push_back(_track_hits.size());
+  }
+
+  std::size_t HitTruthIndex::TrackIndex(int track_id) const
+  {
+    auto const it = std::lower_bound(_track_ids.begin(), _track_ids.end(), track_id);
+    if (it == _track_ids.end() || *it != track_id) return _track_ids.size();
+    return it - _track_ids.begin();
+  }
+
+  HitTruthIndex::Range_t<std::size_t> HitTruthIndex::TrackHits(int track_id) const
+  {
+    auto const t = TrackIndex(track_id);
+    if (t == _track_ids.size()) return {};
+    return {_track_hits.data() + _track_offsets[t], _track_hits.data() + _track_offsets[t + 1]};
+  }
+
+  double HitTruthIndex::TrackEnergy(int track_id) const
+  {
+    auto const t = TrackIndex(track_id);
+    return (t == _track_ids.size()) ? 0. : _track_energy[t];
+  }
+
+  double HitTruthIndex::TrackEnergy(int track_id, unsigned int plane) const
+  {
+    auto const t = TrackIndex(track_id);
+    if (t == _track_ids.size() || plane >= _num_planes) return 0.;
+    return _track_plane_energy[t * _num_planes + plane];
+  }
+
+  std::map<int, double> HitTruthIndex::EnergyByTrackID(
+    const std::vector<art::Ptr<recob::Hit>>& hits) const
+  {
+    std::map<int, double> trkID_E;
+    for (auto const& hit : hits)
+      for (auto const& ide : HitTrackIDEs(hit))
+        trkID_E[ide.trackID] += ide.energy;
+    return trkID_E;
+  }
+
+}
@@ -0,0 +1,176 @@
+/**
+ * \file HitTruthIndex.h
+ *
+ * \ingroup MCComp
+ *
+ * \brief Class def header for a class HitTruthIndex
+ */
+
+/** \addtogroup MCComp
+
+    @{*/
+#ifndef RECOTOOL_HITTRUTHINDEX_H
+#define RECOTOOL_HITTRUTHINDEX_H
+
+#include "canvas/Persistency/Common/Ptr.h"
+#include "lardataobj/RecoBase/Hit.h"
+#include "lardataobj/Simulation/SimChannel.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace detinfo {
+  class DetectorClocksData;
+}
+
+/**
+   \class HitTruthIndex
+   HitTruthIndex is a per-event table of the true particle contributions to
+   the hits of a collection.
+
+   It is filled once per event, and then answers the usual back-tracking
+   questions (which particle dominates a hit, how much energy a particle left
+   in the hits, which hits it contributed to) from flat arrays, without going
+   back to the simulation for every hit.
+   Hits are identified by their position in the collection used to fill the
+   index, which is also the key of the art::Ptr pointing to them: the index
+   must be filled with the whole hit data product, in its original order.
+   The product ID of that collection is kept, and looking up an art::Ptr to a
+   hit of another collection throws a cet::exception.
+ */
+
+namespace btutil {
+
+  class HitTruthIndex {
+
+  public:
+    /// A contiguous range of elements of the index
+    template <typename T>
+    class Range_t {
+    public:
+      Range_t() = default;
+      Range_t(T const* b, T const* e) : _begin(b), _end(e) {}
+      T const* begin() const { return _begin; }
+      T const* end() const { return _end; }
+      std::size_t size() const { return _end - _begin; }
+      bool empty() const { return _begin == _end; }
+
+    private:
+      T const* _begin = nullptr;
+      T const* _end = nullptr;
+    };
+
+    HitTruthIndex() {}
+
+    /// Removes all the content of the index
+    void Clear();
+
+    /**
+       Fills the index from the contributions of the specified function.
+       The function is called once per hit with an element of hits (a
+       recob::Hit or an art::Ptr to it) and returns its std::vector of
+       sim::TrackIDE, e.g. BackTrackerService::HitToTrackIDEs().
+       The product ID of the hits is taken from the art::Ptr; when filling
+       from the recob::Hit it is hitProductID, and art::Ptr lookups are not
+       checked if that is left invalid.
+     */
+    template <typename Hits, typename TrackIDEsOf>
+    void Fill(Hits const& hits, TrackIDEsOf&& trackIDEsOf, art::ProductID hitProductID = {});
+
+    /**
+       Fills the index directly from the simulated channels.
+       The contribution to each hit is collected within hitTimeRMS times the
+       hit width around its peak, the same way BackTracker does.
+     */
+    void Fill(detinfo::DetectorClocksData const& clockData,
+              const std::vector<sim::SimChannel>& simch_v,
+              const std::vector<recob::Hit>& hits,
+              double hitTimeRMS = 1.);
+
+    /// Number of hits in the index
+    std::size_t NHits() const { return _hit_planes.size(); }
+
+    /// Contributions of all the particles to the specified hit
+    Range_t<sim::TrackIDE> HitTrackIDEs(std::size_t hit_index) const
+    {
+      return {_ides.data() + _hit_offsets[hit_index], _ides.data() + _hit_offsets[hit_index + 1]};
+    }
+    /// Contributions to the pointed hit (none if it is not in the index)
+    Range_t<sim::TrackIDE> HitTrackIDEs(const art::Ptr<recob::Hit>& hit) const;
+
+    /// Product ID of the indexed hits (invalid if unknown)
+    art::ProductID HitProductID() const { return _hit_product_id; }
+
+    /// Track ID with the largest energy in the hit (sim::NoParticleId if none)
+    int DominantTrackID(std::size_t hit_index) const { return _dominant_id[hit_index]; }
+
+    /// Fraction of the hit energy from its dominant track ID
+    float DominantFraction(std::size_t hit_index) const { return _dominant_frac[hit_index]; }
+
+    /// All the track IDs contributing to any hit, sorted
+    const std::vector<int>& TrackIDs() const { return _track_ids; }
+
+    /// Indices of the hits the specified track ID contributed to, sorted
+    Range_t<std::size_t> TrackHits(int track_id) const;
+
+    /// Energy deposited by the track ID in all the indexed hits
+    double TrackEnergy(int track_id) const;
+
+    /// Energy deposited by the track ID in the indexed hits on a plane
+    double TrackEnergy(int track_id, unsigned int plane) const;
+
+    /// Energy from each track ID summed over the specified hits
+    std::map<int, double> EnergyByTrackID(const std::vector<art::Ptr<recob::Hit>>& hits) const;
+
+  protected:
+    static unsigned int PlaneOf(const recob::Hit& hit) { return hit.WireID().Plane; }
+    static unsigned int PlaneOf(const art::Ptr<recob::Hit>& hit) { return hit->WireID().Plane; }
+
+    /// Checks that the pointed hit is the next one of the indexed product
+    void CheckNextHit(const recob::Hit&) const {}
+    void CheckNextHit(const art::Ptr<recob::Hit>& hit);
+
+    /// Position of the track ID in _track_ids, or _track_ids.size() if absent
+    std::size_t TrackIndex(int track_id) const;
+
+    /// Fills the per-hit summary and the per-track tables from _ides
+    void BuildTrackTable();
+
+    art::ProductID _hit_product_id;
+
+    // per hit: contributions are _ides[_hit_offsets[i], _hit_offsets[i+1])
+    std::vector<sim::TrackIDE> _ides;
+    std::vector<std::size_t> _hit_offsets;
+    std::vector<unsigned int> _hit_planes;
+    std::vector<int> _dominant_id;
+    std::vector<float> _dominant_frac;
+
+    // per track ID: hits are _track_hits[_track_offsets[t], _track_offsets[t+1])
+    std::vector<int> _track_ids;
+    std::vector<std::size_t> _track_offsets;
+    std::vector<std::size_t> _track_hits;
+    std::vector<double> _track_energy;       ///< total per track ID
+    std::vector<double> _track_plane_energy; ///< [track][plane]
+    unsigned int _num_planes = 0;
+  };
+
+  template <typename Hits, typename TrackIDEsOf>
+  void HitTruthIndex::Fill(Hits const& hits, TrackIDEsOf&& trackIDEsOf, art::ProductID hitProductID)
+  {
+    Clear();
+    _hit_product_id = hitProductID;
+    _hit_offsets.push_back(0);
+    for (auto const& hit : hits) {
+      CheckNextHit(hit);
+      for (auto const& ide : trackIDEsOf(hit))
+        _ides.push_back(ide);
+      _hit_offsets.push_back(_ides.size());
+      _hit_planes.push_back(PlaneOf(hit));
+    }
+    BuildTrackTable();
+  }
+
+}
+#endif
+/** @} */ // end of doxygen group
@@ -28,7 +28,10 @@
 #include "TGraph.h"
 #include "TH2F.h"
 #include "TMatrixD.h"
-#include "TVectorD.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
 
 namespace quad {
 
@@ -79,6 +82,7 @@ namespace quad {
     std::string fHitLabel;
 
     bool fSavePlots;
+    bool fParallel;
 
     const geo::WireReadoutGeom* wireReadoutGeom;
   };
@@ -90,6 +94,7 @@ namespace quad {
     : EDProducer(pset)
     , fHitLabel(pset.get<std::string>("HitLabel"))
     , fSavePlots(pset.get<bool>("SavePlots"))
+    , fParallel(pset.get<bool>("Parallel", false))
   {
     produces<std::vector<recob::Vertex>>();
   }
@@ -181,11 +186,17 @@ namespace quad {
   }
 
   // ---------------------------------------------------------------------------
-  void MapFromLines(const std::vector<Line2D>& lines, HeatMap& hm)
+  void MapFromLines(const std::vector<Line2D>& lines, HeatMap& hm, bool parallel)
   {
     // This maximum is driven by runtime
     constexpr size_t kMaxPts = 10 * 1000 * 1000;
 
+    if (lines.size() < 2) return;
+
+    // For each line, the partners [jlo, jhi) are the following lines (sorted
+    // by gradient) that are not too close in angle
+    std::vector<unsigned int> jlo(lines.size() - 1), jhi(lines.size() - 1);
+
     unsigned int j0 = 0;
     unsigned int jmax = 0;
 
@@ -200,6 +211,8 @@ namespace quad {
       while (jmax < lines.size() && !CloseAngles(a.m, lines[jmax].m))
         ++jmax;
 
+      jlo[i] = j0;
+      jhi[i] = jmax;
       npts += jmax - j0;
     }
 
@@ -210,40 +223,61 @@ namespace quad {
 
     mf::LogInfo() << npts << " cf " << product << " ie " << double(npts) / product << std::endl;
 
-    j0 = 0;
-    jmax = 0;
-
-    for (unsigned int i = 0; i + 1 < lines.size(); ++i) {
-      const Line2D a = lines[i];
-
-      j0 = std::max(j0, i + 1);
-      while (j0 < lines.size() && CloseAngles(a.m, lines[j0].m))
-        ++j0;
-      jmax = std::max(jmax, j0);
-      while (jmax < lines.size() && !CloseAngles(a.m, lines[jmax].m))
-        ++jmax;
-
-      for (unsigned int j = j0; j < jmax; j += stride) {
-        const Line2D& b = lines[j];
+    // The map only ever receives integer weights, so the per-thread maps sum
+    // back to exactly the serial result
+    auto fill = [&](unsigned int ibegin, unsigned int iend, std::vector<float>& map) {
+      std::vector<float> zs, xs;
+      for (unsigned int i = ibegin; i < iend; ++i) {
+        const Line2D a = lines[i];
+
+        // Intersections first, in a loop simple enough to vectorize
+        const unsigned int n = (jhi[i] > jlo[i]) ? (jhi[i] - jlo[i] - 1) / stride + 1 : 0;
+        zs.resize(n);
+        xs.resize(n);
+        for (unsigned int k = 0; k < n; ++k) {
+          const Line2D& b = lines[jlo[i] + k * stride];
+
+          // x = mA * z + cA = mB * z + cB
+          zs[k] = (b.c - a.c) / (a.m - b.m);
+          xs[k] = a.m * zs[k] + a.c;
+        }
 
-        // x = mA * z + cA = mB * z + cB
-        const float z = (b.c - a.c) / (a.m - b.m);
-        const float x = a.m * z + a.c;
+        for (unsigned int k = 0; k < n; ++k) {
+          const Line2D& b = lines[jlo[i] + k * stride];
+          const float z = zs[k];
 
-        // No solutions within a line
-        if ((z < a.minz || z > a.maxz) && (z < b.minz || z > b.maxz)) {
-          const int iz = hm.ZToBin(z);
-          const int ix = hm.XToBin(x);
-          if (iz >= 0 && iz < hm.Nz && ix >= 0 && ix < hm.Nx) { hm.map[iz * hm.Nx + ix] += stride; }
+          // No solutions within a line
+          if ((z < a.minz || z > a.maxz) && (z < b.minz || z > b.maxz)) {
+            const int iz = hm.ZToBin(z);
+            const int ix = hm.XToBin(xs[k]);
+            if (iz >= 0 && iz < hm.Nz && ix >= 0 && ix < hm.Nx) { map[iz * hm.Nx + ix] += stride; }
+          }
         }
       } // end for i
+    };
+
+    if (!parallel) {
+      fill(0, lines.size() - 1, hm.map);
+      return;
+    }
+
+    tbb::enumerable_thread_specific<std::vector<float>> maps(
+      std::vector<float>(hm.map.size(), 0));
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, lines.size() - 1),
+                      [&](const tbb::blocked_range<unsigned int>& r) {
+                        fill(r.begin(), r.end(), maps.local());
+                      });
+    for (const std::vector<float>& map : maps) {
+      for (unsigned int i = 0; i < map.size(); ++i)
+        hm.map[i] += map[i];
     }
   }
 
   // ---------------------------------------------------------------------------
   // Assumes that all three maps have the same vertical stride
   recob::tracking::Point_t FindPeak3D(const std::vector<HeatMap>& hs,
-                                      const std::vector<recob::tracking::Vector_t>& dirs) noexcept
+                                      const std::vector<recob::tracking::Vector_t>& dirs,
+                                      bool parallel) noexcept
   {
     assert(hs.size() == 3);
     assert(dirs.size() == 3);
@@ -261,8 +295,7 @@ namespace quad {
 
     M.Invert();
 
-    float bestscore = -1;
-    recob::tracking::Point_t bestr;
+    if (Nx < 3) return {};
 
     // Accumulate some statistics up front that will enable us to optimize
     std::vector<float> colMax[3];
@@ -273,42 +306,83 @@ namespace quad {
       }
     }
 
-    for (int iz = 0; iz < hs[0].Nz; ++iz) {
+    // The (y, z) point is linear in the z and u coordinates, so the y and v
+    // of each u bin are tabulated once, and only shifted for each z bin
+    std::vector<double> yu(hs[1].Nz), vu(hs[1].Nz);
+    for (int iu = 0; iu < hs[1].Nz; ++iu) {
+      const double u = float(hs[1].ZBinCenter(iu));
+      yu[iu] = M(0, 1) * u;
+      vu[iu] = M(1, 1) * u;
+    }
+
+    // Best score of each z bin that beats the record passed to the search,
+    // the first one wins in case of a tie
+    struct Peak {
+      float score = -1;
+      int iu = -1;
+      int ix = -1;
+    };
+    std::vector<Peak> peaks(hs[0].Nz);
+
+    auto searchZ = [&](int iz, float record, std::vector<float>& sum) {
       const float z = hs[0].ZBinCenter(iz);
       const float bonus = 1; // works badly... exp((hs[0].maxz-z)/1000.);
+      const double y0 = M(0, 0) * z;
+      const double v0 = M(1, 0) * z;
 
+      Peak best{record};
       for (int iu = 0; iu < hs[1].Nz; ++iu) {
-        const float u = hs[1].ZBinCenter(iu);
         // r.Dot(d0) = z && r.Dot(d1) = u
-        TVectorD p(2);
-        p(0) = z;
-        p(1) = u;
-        const TVectorD r = M * p;
-        const float v = r[0] * dirs[2].Y() + r[1] * dirs[2].Z();
+        const double ry = y0 + yu[iu];
+        const double rz = v0 + vu[iu];
+        const float v = ry * dirs[2].Y() + rz * dirs[2].Z();
         const int iv = hs[2].ZToBin(v);
         if (iv < 0 || iv >= hs[2].Nz) continue;
-        const double y = r(0);
 
         // Even if the maxes were all at the same x we couldn't beat the record
-        if (colMax[0][iz] + colMax[1][iu] + colMax[2][iv] < bestscore) continue;
+        if (colMax[0][iz] + colMax[1][iu] + colMax[2][iv] < best.score) continue;
 
         const float* h0 = &hs[0].map[Nx * iz];
         const float* h1 = &hs[1].map[Nx * iu];
         const float* h2 = &hs[2].map[Nx * iv];
 
-        int bestix = -1;
-        for (int ix = 1; ix < Nx - 1; ++ix) {
-          const float score = bonus * (h0[ix] + h1[ix] + h2[ix]);
-
-          if (score > bestscore) {
-            bestscore = score;
-            bestix = ix;
-          }
-        } // end for dx
+        for (int ix = 1; ix < Nx - 1; ++ix)
+          sum[ix] = bonus * (h0[ix] + h1[ix] + h2[ix]);
 
-        if (bestix != -1) { bestr.SetXYZ(hs[0].XBinCenter(bestix), y, z); }
+        // max_element returns the first of equal maxima, as the scan did
+        const int ix = std::max_element(sum.begin() + 1, sum.begin() + (Nx - 1)) - sum.begin();
+        if (sum[ix] > best.score) best = {sum[ix], iu, ix};
       } // end for u
-    }   // end for z
+
+      if (best.iu != -1) peaks[iz] = best;
+    };
+
+    if (parallel) {
+      tbb::parallel_for(tbb::blocked_range<int>(0, hs[0].Nz),
+                        [&](const tbb::blocked_range<int>& r) {
+                          std::vector<float> sum(Nx);
+                          for (int iz = r.begin(); iz != r.end(); ++iz)
+                            searchZ(iz, -1, sum);
+                        });
+    }
+    else {
+      // Serially, the best score so far also prunes the following z bins
+      std::vector<float> sum(Nx);
+      float record = -1;
+      for (int iz = 0; iz < hs[0].Nz; ++iz) {
+        searchZ(iz, record, sum);
+        record = std::max(record, peaks[iz].score);
+      }
+    }
+
+    float bestscore = -1;
+    recob::tracking::Point_t bestr;
+    for (int iz = 0; iz < hs[0].Nz; ++iz) {
+      if (peaks[iz].score <= bestscore) continue;
+      bestscore = peaks[iz].score;
+      const float z = hs[0].ZBinCenter(iz);
+      bestr.SetXYZ(hs[0].XBinCenter(peaks[iz].ix), M(0, 0) * z + yu[peaks[iz].iu], z);
+    } // end for z
 
     return bestr;
   }
@@ -429,10 +503,10 @@ namespace quad {
 
       // Approximately cm bins
       hms.emplace_back(maxz[view] - minz[view], minz[view], maxz[view], maxx - minx, minx, maxx);
-      MapFromLines(lines, hms.back());
+      MapFromLines(lines, hms.back(), fParallel);
     } // end for view
 
-    vtx = FindPeak3D(hms, dirs);
+    vtx = FindPeak3D(hms, dirs, fParallel);
 
     std::vector<HeatMap> hms_zoom;
     hms_zoom.reserve(3);
@@ -448,10 +522,10 @@ namespace quad {
       // mm granularity
       hms_zoom.emplace_back(50, z0 - 2.5, z0 + 2.5, 50, x0 - 2.5, x0 + 2.5);
 
-      MapFromLines(lines, hms_zoom.back());
+      MapFromLines(lines, hms_zoom.back(), fParallel);
     }
 
-    vtx = FindPeak3D(hms_zoom, dirs);
+    vtx = FindPeak3D(hms_zoom, dirs, fParallel);
 
     if (fSavePlots) {
       art::TFileDirectory evt_dir =
@@ -31,6 +31,7 @@
 
 #include "range/v3/view.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -52,7 +53,8 @@ cluster::BlurredClusteringAlg::BlurredClusteringAlg(fhicl::ParameterSet const& p
   , fChargeThreshold{pset.get<double>("ChargeThreshold")}
   , fKernelWidth{2 * fBlurWire + 1}
   , fKernelHeight{2 * fBlurTick * fMaxTickWidthBlur + 1}
-  , fAllKernels{MakeKernels()}
+  , fWireKernels{MakeKernels(fBlurWire, fSigmaWire)}
+  , fTickKernels{MakeKernels(fBlurTick * fMaxTickWidthBlur, fSigmaTick * fMaxTickWidthBlur)}
 {}
 
 cluster::BlurredClusteringAlg::~BlurredClusteringAlg()
@@ -106,7 +108,7 @@ void cluster::BlurredClusteringAlg::CreateDebugPDF(int run, int subrun, int even
 }
 
 void cluster::BlurredClusteringAlg::ConvertBinsToClusters(
-  std::vector<std::vector<double>> const& image,
+  Image const& image,
   std::vector<std::vector<int>> const& allClusterBins,
   std::vector<art::PtrVector<recob::Hit>>& clusters) const
 {
@@ -130,7 +132,7 @@ void cluster::BlurredClusteringAlg::ConvertBinsToClusters(
   }
 }
 
-std::vector<std::vector<double>> cluster::BlurredClusteringAlg::ConvertRecobHitsToVector(
+cluster::BlurredClusteringAlg::Image cluster::BlurredClusteringAlg::ConvertRecobHitsToVector(
   std::vector<art::Ptr<recob::Hit>> const& hits,
   int const readoutWindowSize)
 {
@@ -156,9 +158,8 @@ std::vector<std::vector<double>> cluster::BlurredClusteringAlg::ConvertRecobHits
   fHitMap.resize(fUpperWire - fLowerWire,
                  std::vector<art::Ptr<recob::Hit>>(fUpperTick - fLowerTick));
 
-  // Create a 2D vector
-  std::vector<std::vector<double>> image(fUpperWire - fLowerWire,
-                                         std::vector<double>(fUpperTick - fLowerTick));
+  // Create a 2D image
+  Image image(fUpperWire - fLowerWire, fUpperTick - fLowerTick);
 
   // Look through the hits
   for (auto const& hit : hits) {
@@ -167,8 +168,8 @@ std::vector<std::vector<double>> cluster::BlurredClusteringAlg::ConvertRecobHits
     float const charge = hit->Integral();
 
     // Fill hit map and keep a note of all real hits for later
-    if (charge > image.at(wire - fLowerWire).at(tick - fLowerTick)) {
-      image.at(wire - fLowerWire).at(tick - fLowerTick) = charge;
+    if (charge > image(wire - fLowerWire, tick - fLowerTick)) {
+      image(wire - fLowerWire, tick - fLowerTick) = charge;
       fHitMap[wire - fLowerWire][tick - fLowerTick] = hit;
     }
   }
@@ -186,12 +187,12 @@ std::vector<std::vector<double>> cluster::BlurredClusteringAlg::ConvertRecobHits
   return image;
 }
 
-int cluster::BlurredClusteringAlg::FindClusters(std::vector<std::vector<double>> const& blurred,
+int cluster::BlurredClusteringAlg::FindClusters(Image const& blurred,
                                                 std::vector<std::vector<int>>& allcluster) const
 {
   // Size of image in x and y
-  int const nbinsx = blurred.size();
-  int const nbinsy = blurred.at(0).size();
+  int const nbinsx = blurred.nWires;
+  int const nbinsy = blurred.nTicks;
   int const nbins = nbinsx * nbinsy;
 
   // Vectors to hold hit information
@@ -199,10 +200,12 @@ int cluster::BlurredClusteringAlg::FindClusters(std::vector<std::vector<double>>
   std::vector<std::pair<double, int>> values;
 
   // Place the bin number and contents as a pair in the values vector
+  // Only bins above the seed threshold can start a cluster
   for (int xbin = 0; xbin < nbinsx; ++xbin) {
     for (int ybin = 0; ybin < nbinsy; ++ybin) {
       int const bin = ConvertWireTickToBin(blurred, xbin, ybin);
-      values.emplace_back(ConvertBinToCharge(blurred, bin), bin);
+      double const blurred_binval = ConvertBinToCharge(blurred, bin);
+      if (blurred_binval >= fMinSeed) values.emplace_back(blurred_binval, bin);
     }
   }
 
@@ -215,15 +218,12 @@ int cluster::BlurredClusteringAlg::FindClusters(std::vector<std::vector<double>>
   // Clustering loops
   // First loop - considers highest charge hits in decreasing order, and puts them in a new cluster if they aren't already clustered (makes new cluster every iteration)
   // Second loop - looks at the direct neighbours of this seed and clusters to this if above charge/time thresholds. Runs recursively over all hits in cluster (inc. new ones)
-  while (true) {
+  while (niter < static_cast<int>(values.size())) {
 
     // Start a new cluster each time loop is executed
     std::vector<int> cluster;
     std::vector<double> times;
 
-    // Get the highest charge bin (go no further if below seed threshold)
-    if (double const blurred_binval = values[niter].first; blurred_binval < fMinSeed) break;
-
     // Iterate through the bins from highest charge down
     int const bin = values[niter++].second;
 
@@ -241,6 +241,7 @@ int cluster::BlurredClusteringAlg::FindClusters(std::vector<std::vector<double>>
     while (true) {
 
       bool added_cluster{false};
+      bool failed_time_cut{false};
 
       for (unsigned int clusBin = 0; clusBin < cluster.size(); ++clusBin) {
 
@@ -266,7 +267,10 @@ int cluster::BlurredClusteringAlg::FindClusters(std::vector<std::vector<double>>
               GetTimeOfBin(blurred, bin); // NB for 'fake' hits, time is defaulted to -10000
 
             // Check real hits pass time cut (ignores fake hits)
-            if (time > 0 && times.size() > 0 && !PassesTimeCut(times, time)) continue;
+            if (time > 0 && times.size() > 0 && !PassesTimeCut(times, time)) {
+              failed_time_cut = true;
+              continue;
+            }
 
             // Add to cluster if bin value is above threshold
             if (blurred_binval > fChargeThreshold) {
@@ -280,7 +284,9 @@ int cluster::BlurredClusteringAlg::FindClusters(std::vector<std::vector<double>>
 
       } // End of looping over bins already in this cluster
 
-      if (!added_cluster) break;
+      // Every bin around the cluster was looked at in this pass, so another pass can
+      // only add to it if a bin failed the time cut against fewer times than there are now
+      if (!added_cluster || !failed_time_cut) break;
 
     } // End of adding hits to this cluster
 
@@ -418,60 +424,63 @@ int cluster::BlurredClusteringAlg::GlobalWire(const geo::WireID& wireID) const
   return std::round(globalWire);
 }
 
-std::vector<std::vector<double>> cluster::BlurredClusteringAlg::GaussianBlur(
-  std::vector<std::vector<double>> const& image) const
+cluster::BlurredClusteringAlg::Image cluster::BlurredClusteringAlg::GaussianBlur(
+  Image const& image) const
 {
   if (fSigmaWire == 0 and fSigmaTick == 0) return image;
 
   auto const [blur_wire, blur_tick, sigma_wire, sigma_tick] = FindBlurringParameters();
 
   // Convolve the Gaussian
-  int width = 2 * blur_wire + 1;
-  int height = 2 * blur_tick + 1;
-  int nbinsx = image.size();
-  int nbinsy = image.at(0).size();
+  int nbinsx = image.nWires;
+  int nbinsy = image.nTicks;
+
+  // Blurred histogram
+  Image copy(nbinsx, nbinsy);
 
-  // Blurred histogram and normalisation for each bin
-  std::vector<std::vector<double>> copy(nbinsx, std::vector<double>(nbinsy, 0));
+  // The kernel is the product of a wire and a tick Gaussian, so each hit is smeared
+  // one wire at a time: a single wire weight scales the tick kernel along the
+  // contiguous ticks of that wire
+  auto const& wire_kernel = fWireKernels[sigma_wire];
+  int const wire_reach = std::min(blur_wire, fKernelWidth / 2);
 
   // Loop through all the bins in the histogram to blur
   for (int x = 0; x < nbinsx; ++x) {
     for (int y = 0; y < nbinsy; ++y) {
 
-      if (image[x][y] == 0) continue;
+      float const charge = image(x, y);
+      if (charge == 0) continue;
 
       // Scale the tick blurring based on the width of the hit
       int tick_scale =
         std::sqrt(cet::square(fHitMap[x][y]->RMS()) + cet::square(sigma_tick)) / (double)sigma_tick;
       tick_scale = std::max(std::min(tick_scale, fMaxTickWidthBlur), 1);
-      auto const& correct_kernel = fAllKernels[sigma_wire][sigma_tick * tick_scale];
-
-      // Find any dead wires in the potential blurring region
-      auto const [lower_bin_dead, upper_bin_dead] = DeadWireCount(x, width);
-
-      // Note of how many dead wires we have passed whilst blurring in the wire direction
-      // If blurring below the seed hit, need to keep a note of how many dead wires to come
-      // If blurring above, need to keep a note of how many dead wires have passed
-      auto dead_wires_passed{lower_bin_dead};
-
-      // Loop over the blurring region around this hit
-      for (int blurx = -(width / 2 + lower_bin_dead); blurx < (width + 1) / 2 + upper_bin_dead;
-           ++blurx) {
-        if (x + blurx < 0) continue;
-        for (int blury = -height / 2 * tick_scale;
-             blury < ((((height + 1) / 2) - 1) * tick_scale) + 1;
-             ++blury) {
-          if (blurx < 0 and fDeadWires[x + blurx]) dead_wires_passed -= 1;
-
-          // Smear the charge of this hit
-          double const weight = correct_kernel[fKernelWidth * (fKernelHeight / 2 + blury) +
-                                               (fKernelWidth / 2 + (blurx - dead_wires_passed))];
-          if (x + blurx >= 0 and x + blurx < nbinsx and y + blury >= 0 and y + blury < nbinsy)
-            copy[x + blurx][y + blury] += weight * image[x][y];
-
-          if (blurx > 0 and fDeadWires[x + blurx]) dead_wires_passed += 1;
+      auto const& tick_kernel = fTickKernels[sigma_tick * tick_scale];
+      int const tick_reach = std::min(blur_tick * tick_scale, fKernelHeight / 2);
+      int const first_tick = std::max(y - tick_reach, 0);
+      int const last_tick = std::min(y + tick_reach, nbinsy - 1);
+      float const* kernel = tick_kernel.data() + (fKernelHeight / 2 - y + first_tick);
+
+      auto smear = [&](int wire, int offset) {
+        float const weight = wire_kernel[fKernelWidth / 2 + offset] * charge;
+        float* out = &copy(wire, first_tick);
+        for (int i = 0; i <= last_tick - first_tick; ++i)
+          out[i] += weight * kernel[i];
+      };
+
+      smear(x, 0);
+
+      // Dead wires do not count towards the blurring distance: they take the weight
+      // of the wire beyond them and the blurring region extends past them
+      for (int direction : {-1, 1}) {
+        int dead_wires_passed = 0;
+        for (int wire = x + direction; wire >= 0 and wire < nbinsx; wire += direction) {
+          int const offset = std::abs(wire - x) - dead_wires_passed;
+          if (offset > wire_reach) break;
+          smear(wire, direction * offset);
+          if (fDeadWires[wire]) ++dead_wires_passed;
         }
-      } // blurring region
+      }
     }
   } // hits to blur
 
@@ -483,7 +492,7 @@ std::vector<std::vector<double>> cluster::BlurredClusteringAlg::GaussianBlur(
   return copy;
 }
 
-TH2F* cluster::BlurredClusteringAlg::MakeHistogram(std::vector<std::vector<double>> const& image,
+TH2F* cluster::BlurredClusteringAlg::MakeHistogram(Image const& image,
                                                    TString const name) const
 {
   auto hist = new TH2F(name,
@@ -498,11 +507,11 @@ TH2F* cluster::BlurredClusteringAlg::MakeHistogram(std::vector<std::vector<doubl
   hist->SetYTitle("Tick number");
   hist->SetZTitle("Charge");
 
-  for (unsigned int imageWireIt = 0; imageWireIt < image.size(); ++imageWireIt) {
+  for (int imageWireIt = 0; imageWireIt < image.nWires; ++imageWireIt) {
     int const wire = imageWireIt + fLowerWire;
-    for (unsigned int imageTickIt = 0; imageTickIt < image.at(imageWireIt).size(); ++imageTickIt) {
+    for (int imageTickIt = 0; imageTickIt < image.nTicks; ++imageTickIt) {
       int const tick = imageTickIt + fLowerTick;
-      hist->Fill(wire, tick, image.at(imageWireIt).at(imageTickIt));
+      hist->Fill(wire, tick, image(imageWireIt, imageTickIt));
     }
   }
 
@@ -602,7 +611,7 @@ void cluster::BlurredClusteringAlg::SaveImage(TH2F* image,
 // Private member functions
 
 art::PtrVector<recob::Hit> cluster::BlurredClusteringAlg::ConvertBinsToRecobHits(
-  std::vector<std::vector<double>> const& image,
+  Image const& image,
   std::vector<int> const& bins) const
 {
   // Create the vector of hits to output
@@ -622,52 +631,29 @@ art::PtrVector<recob::Hit> cluster::BlurredClusteringAlg::ConvertBinsToRecobHits
 }
 
 art::Ptr<recob::Hit> cluster::BlurredClusteringAlg::ConvertBinToRecobHit(
-  std::vector<std::vector<double>> const& image,
+  Image const& image,
   int const bin) const
 {
-  int const wire = bin % image.size();
-  int const tick = bin / image.size();
+  int const wire = bin % image.nWires;
+  int const tick = bin / image.nWires;
   return fHitMap[wire][tick];
 }
 
 int cluster::BlurredClusteringAlg::ConvertWireTickToBin(
-  std::vector<std::vector<double>> const& image,
+  Image const& image,
   int const xbin,
   int const ybin) const
 {
-  return ybin * image.size() + xbin;
+  return ybin * image.nWires + xbin;
 }
 
 double cluster::BlurredClusteringAlg::ConvertBinToCharge(
-  std::vector<std::vector<double>> const& image,
+  Image const& image,
   int const bin) const
 {
-  int const x = bin % image.size();
-  int const y = bin / image.size();
-  return image.at(x).at(y);
-}
-
-std::pair<int, int> cluster::BlurredClusteringAlg::DeadWireCount(int const wire_bin,
-                                                                 int const width) const
-{
-  auto deadWires = std::make_pair(0, 0);
-
-  int const lower_bin = width / 2;
-  int const upper_bin = (width + 1) / 2;
-
-  auto const offset = wire_bin + fLowerWire;
-  for (int wire = std::max(offset - lower_bin, fLowerWire);
-       wire < std::min(offset + upper_bin, fUpperWire);
-       ++wire) {
-    if (!fDeadWires[wire - fLowerWire]) continue;
-
-    if (wire < offset)
-      ++deadWires.first;
-    else if (wire > offset)
-      ++deadWires.second;
-  }
-
-  return deadWires;
+  int const x = bin % image.nWires;
+  int const y = bin / image.nWires;
+  return image(x, y);
 }
 
 std::array<int, 4> cluster::BlurredClusteringAlg::FindBlurringParameters() const
@@ -701,46 +687,32 @@ std::array<int, 4> cluster::BlurredClusteringAlg::FindBlurringParameters() const
   return {{blur_wire, blur_tick, sigma_wire, sigma_tick}};
 }
 
-double cluster::BlurredClusteringAlg::GetTimeOfBin(std::vector<std::vector<double>> const& image,
+double cluster::BlurredClusteringAlg::GetTimeOfBin(Image const& image,
                                                    int const bin) const
 {
   auto const hit = ConvertBinToRecobHit(image, bin);
   return hit.isNull() ? -10000. : hit->PeakTime();
 }
 
-std::vector<std::vector<std::vector<double>>> cluster::BlurredClusteringAlg::MakeKernels() const
+std::vector<std::vector<float>> cluster::BlurredClusteringAlg::MakeKernels(
+  int const radius,
+  double const max_sigma) const
 {
   // Kernel size is the largest possible given the hit width rescaling
-  std::vector<std::vector<std::vector<double>>> allKernels(
-    fSigmaWire + 1,
-    std::vector<std::vector<double>>(fSigmaTick * fMaxTickWidthBlur + 1,
-                                     std::vector<double>(fKernelWidth * fKernelHeight)));
+  std::vector<std::vector<float>> allKernels(max_sigma + 1);
 
-  // Ranges of kernels to make
   // Complete range of sigmas possible after dynamic fixing and hit width convolution
-  for (int sigma_wire = 1; sigma_wire <= fSigmaWire; ++sigma_wire) {
-    for (int sigma_tick = 1; sigma_tick <= fSigmaTick * fMaxTickWidthBlur; ++sigma_tick) {
-
-      // New kernel
-      std::vector<double> kernel(fKernelWidth * fKernelHeight, 0);
+  for (int sigma = 1; sigma <= max_sigma; ++sigma) {
 
-      // Smear out according to the blur radii in each direction
-      for (int i = -fBlurWire; i <= fBlurWire; i++) {
-        for (int j = -fBlurTick * fMaxTickWidthBlur; j <= fBlurTick * fMaxTickWidthBlur; j++) {
+    // New kernel
+    std::vector<float> kernel(2 * radius + 1, 0);
 
-          // Fill kernel
-          double const sig2i = 2. * sigma_wire * sigma_wire;
-          double const sig2j = 2. * sigma_tick * sigma_tick;
+    // Smear out according to the blur radius
+    double const sig2 = 2. * sigma * sigma;
+    for (int i = -radius; i <= radius; i++)
+      kernel[i + radius] = 1. / std::sqrt(sig2 * M_PI) * std::exp(-i * i / sig2);
 
-          int const key = (fKernelWidth * (j + fBlurTick * fMaxTickWidthBlur)) + (i + fBlurWire);
-          double const value = 1. / std::sqrt(sig2i * M_PI) * std::exp(-i * i / sig2i) * 1. /
-                               std::sqrt(sig2j * M_PI) * std::exp(-j * j / sig2j);
-          kernel.at(key) = value;
-        }
-      } // End loop over blurring region
-
-      allKernels[sigma_wire][sigma_tick] = move(kernel);
-    }
+    allKernels[sigma] = move(kernel);
   }
   return allKernels;
 }
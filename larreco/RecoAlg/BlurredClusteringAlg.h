@@ -49,6 +49,19 @@ namespace cluster {
 
 class cluster::BlurredClusteringAlg {
 public:
+  /// Charge image of a plane, stored wire by wire so that the ticks of a wire are contiguous
+  struct Image {
+    int nWires{};
+    int nTicks{};
+    std::vector<float> charge; ///< charge[wire * nTicks + tick]
+
+    Image() = default;
+    Image(int wires, int ticks) : nWires{wires}, nTicks{ticks}, charge(wires * ticks) {}
+
+    float& operator()(int wire, int tick) { return charge[wire * nTicks + tick]; }
+    float operator()(int wire, int tick) const { return charge[wire * nTicks + tick]; }
+  };
+
   BlurredClusteringAlg(fhicl::ParameterSet const& pset);
   ~BlurredClusteringAlg();
 
@@ -56,31 +69,28 @@ public:
   void CreateDebugPDF(int run, int subrun, int event);
 
   /// Takes a vector of clusters (itself a vector of hits) and turns them into clusters using the initial hit selection
-  void ConvertBinsToClusters(std::vector<std::vector<double>> const& image,
+  void ConvertBinsToClusters(Image const& image,
                              std::vector<std::vector<int>> const& allClusterBins,
                              std::vector<art::PtrVector<recob::Hit>>& clusters) const;
 
-  /// Takes hit map and returns a 2D vector representing wire and tick, filled with the charge
-  std::vector<std::vector<double>> ConvertRecobHitsToVector(
-    std::vector<art::Ptr<recob::Hit>> const& hits,
-    int readoutWindowSize);
+  /// Takes hit map and returns a 2D image representing wire and tick, filled with the charge
+  Image ConvertRecobHitsToVector(std::vector<art::Ptr<recob::Hit>> const& hits,
+                                 int readoutWindowSize);
 
   /// Find clusters in the histogram
-  int FindClusters(std::vector<std::vector<double>> const& image,
-                   std::vector<std::vector<int>>& allcluster) const;
+  int FindClusters(Image const& image, std::vector<std::vector<int>>& allcluster) const;
 
   /// Find the global wire position
   int GlobalWire(geo::WireID const& wireID) const;
 
   /// Applies Gaussian blur to image
-  std::vector<std::vector<double>> GaussianBlur(
-    std::vector<std::vector<double>> const& image) const;
+  Image GaussianBlur(Image const& image) const;
 
   /// Minimum size of cluster to save
   unsigned int GetMinSize() const noexcept { return fMinSize; }
 
   /// Converts a 2D vector in a histogram for the debug pdf
-  TH2F* MakeHistogram(std::vector<std::vector<double>> const& image, TString name) const;
+  TH2F* MakeHistogram(Image const& image, TString name) const;
 
   /// Save the images for debugging
   /// This version takes the final clusters and overlays on the hit map
@@ -103,31 +113,27 @@ public:
 
 private:
   /// Converts a vector of bins into a hit selection - not all the hits in the bins vector are real hits
-  art::PtrVector<recob::Hit> ConvertBinsToRecobHits(std::vector<std::vector<double>> const& image,
+  art::PtrVector<recob::Hit> ConvertBinsToRecobHits(Image const& image,
                                                     std::vector<int> const& bins) const;
 
   /// Converts a bin into a recob::Hit (not all of these bins correspond to recob::Hits - some are fake hits created by the blurring)
-  art::Ptr<recob::Hit> ConvertBinToRecobHit(std::vector<std::vector<double>> const& image,
-                                            int bin) const;
+  art::Ptr<recob::Hit> ConvertBinToRecobHit(Image const& image, int bin) const;
 
   /// Converts an xbin and a ybin to a global bin number
-  int ConvertWireTickToBin(std::vector<std::vector<double>> const& image, int xbin, int ybin) const;
+  int ConvertWireTickToBin(Image const& image, int xbin, int ybin) const;
 
   /// Returns the charge stored in the global bin value
-  double ConvertBinToCharge(std::vector<std::vector<double>> const& image, int bin) const;
-
-  /// Count how many dead wires there are in the blurring region for a particular hit
-  /// Returns a pair of counters representing how many dead wires there are below and above the hit respectively
-  std::pair<int, int> DeadWireCount(int wire_bin, int width) const;
+  double ConvertBinToCharge(Image const& image, int bin) const;
 
   /// Dynamically find the blurring radii and Gaussian sigma in each dimension
   std::array<int, 4> FindBlurringParameters() const;
 
   /// Returns the hit time of a hit in a particular bin
-  double GetTimeOfBin(std::vector<std::vector<double>> const& image, int bin) const;
+  double GetTimeOfBin(Image const& image, int bin) const;
 
-  /// Makes all the kernels which could be required given the tuned parameters
-  std::vector<std::vector<std::vector<double>>> MakeKernels() const;
+  /// Makes the 1D Gaussian kernels of the given radius for all sigmas up to max_sigma
+  /// The 2D blurring kernel is the product of a wire and a tick kernel
+  std::vector<std::vector<float>> MakeKernels(int radius, double max_sigma) const;
 
   /// Determines the number of clustered neighbours of a hit
   unsigned int NumNeighbours(int nx, std::vector<bool> const& used, int bin) const;
@@ -155,7 +161,8 @@ private:
 
   // Blurring stuff
   int fKernelWidth, fKernelHeight;
-  std::vector<std::vector<std::vector<double>>> fAllKernels;
+  std::vector<std::vector<float>> fWireKernels; // indexed by sigma, then by offset + radius
+  std::vector<std::vector<float>> fTickKernels;
 
   // Hit containers
   std::vector<std::vector<art::Ptr<recob::Hit>>> fHitMap;
@@ -19,7 +19,7 @@
 #include <cmath> // std::sqrt(), std::abs()
 #include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <limits>
 #include <utility> // std::pair<>, std::make_pair()
 
 // framework libraries
@@ -28,12 +28,11 @@
 // LArSoft Includes
 #include "larcore/Geometry/Geometry.h"
 #include "lardata/Utilities/SimpleFits.h" // lar::util::GaussianFit<>
-#include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
 #include "larevt/CalibrationDBI/Interface/ChannelStatusService.h"
 
-// ROOT Includes
-#include "TF1.h"
-#include "TGraph.h"
+// TBB
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
 namespace hit {
 
@@ -55,6 +54,7 @@ namespace hit {
     fChiNorms = pset.get<std::vector<float>>("ChiNorms");
     fUseFastFit = pset.get<bool>("UseFastFit", false);
     fUseChannelFilter = pset.get<bool>("UseChannelFilter", true);
+    fParallelWires = pset.get<bool>("ParallelWires", false);
     fStudyHits = pset.get<bool>("StudyHits", false);
     // The following variables are only used in StudyHits mode
     fUWireRange = pset.get<std::vector<short>>("UWireRange");
@@ -94,141 +94,190 @@ namespace hit {
     } // fStudyHits
   }
 
+  //------------------------------------------------------------------------------
+  CCHitFinderAlg::WireContext_t::WireContext_t(unsigned short maxticks) : signl(maxticks)
+  {
+    FinalFitStats.Reset(MaxGaussians);
+    TriedFitStats.Reset(MaxGaussians);
+  }
+
   //------------------------------------------------------------------------------
   void CCHitFinderAlg::RunCCHitFinder(std::vector<recob::Wire> const& Wires)
   {
     allhits.clear();
 
     constexpr unsigned short maxticks = 1000;
-    float* ticks = new float[maxticks];
     // define the ticks array used for fitting
+    std::vector<float> ticks(maxticks);
     for (unsigned short ii = 0; ii < maxticks; ++ii) {
       ticks[ii] = ii;
     }
-    float* signl = new float[maxticks];
-    float adcsum = 0;
     // initialize the vectors for the hit study
     if (fStudyHits) StudyHits(0);
-    bool first;
 
     lariov::ChannelStatusProvider const& channelStatus =
       art::ServiceHandle<lariov::ChannelStatusService const>()->GetProvider();
 
-    for (size_t wireIter = 0; wireIter < Wires.size(); wireIter++) {
-      recob::Wire const& theWire = Wires[wireIter];
-      theChannel = theWire.Channel();
-      // ignore bad channels
-      if (channelStatus.IsBad(theChannel)) continue;
-
-      std::vector<geo::WireID> wids = wireReadoutGeom->ChannelToWire(theChannel);
-      thePlane = wids[0].Plane;
-      if (thePlane > fMinPeak.size() - 1) {
-        mf::LogError("CCHF") << "MinPeak vector too small for plane " << thePlane;
-        return;
+    // the study accumulates over the wires in order, so it needs the serial loop
+    if (fParallelWires && !fStudyHits) {
+      // the wires are found in blocks, each with its own context; the hits are
+      // then collected in block order, which is the order of the serial loop
+      constexpr size_t wiresPerBlock = 64;
+      size_t const nBlocks = (Wires.size() + wiresPerBlock - 1) / wiresPerBlock;
+      std::vector<WireContext_t> contexts(nBlocks, WireContext_t(maxticks));
+      tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, nBlocks), [&](const tbb::blocked_range<size_t>& range) {
+          for (size_t iBlock = range.begin(); iBlock != range.end(); ++iBlock) {
+            WireContext_t& ctx = contexts[iBlock];
+            size_t const wireEnd = std::min(Wires.size(), (iBlock + 1) * wiresPerBlock);
+            for (size_t wireIter = iBlock * wiresPerBlock; wireIter < wireEnd; ++wireIter) {
+              if (!FindWireHits(Wires[wireIter], channelStatus, ticks.data(), maxticks, ctx)) break;
+            }
+          }
+        });
+      for (WireContext_t& ctx : contexts) {
+        allhits.insert(allhits.end(),
+                       std::make_move_iterator(ctx.hits.begin()),
+                       std::make_move_iterator(ctx.hits.end()));
+        FinalFitStats.Add(ctx.FinalFitStats);
+        TriedFitStats.Add(ctx.TriedFitStats);
+        if (ctx.stopped) break;
       }
-      theWireNum = wids[0].Wire;
-      HitChannelInfo_t WireInfo{&theWire, wids[0], wireReadoutGeom->SignalType(theWire.Channel())};
+      return;
+    } // fParallelWires
 
-      // minimum number of time samples
-      unsigned short minSamples = 2 * fMinRMS[thePlane];
+    WireContext_t ctx(maxticks);
+    for (size_t wireIter = 0; wireIter < Wires.size(); wireIter++) {
+      if (!FindWireHits(Wires[wireIter], channelStatus, ticks.data(), maxticks, ctx)) break;
+    } // wireIter
+    allhits = std::move(ctx.hits);
+    FinalFitStats.Add(ctx.FinalFitStats);
+    TriedFitStats.Add(ctx.TriedFitStats);
+    if (ctx.stopped) return;
 
-      // factor used to normalize the chi/dof fits for each plane
-      chinorm = fChiNorms[thePlane];
+    // print out
+    if (fStudyHits) StudyHits(4);
 
-      std::vector<float> signal(theWire.Signal());
+  } //RunCCHitFinder
 
-      unsigned short nabove = 0;
-      unsigned short tstart = 0;
-      unsigned short maxtime = signal.size() - 2;
-      // find the min time when the signal is below threshold
-      unsigned short mintime = 3;
-      for (unsigned short time = 3; time < maxtime; ++time) {
-        if (signal[time] < fMinPeak[thePlane]) {
-          mintime = time;
-          break;
-        }
-      }
-      for (unsigned short time = mintime; time < maxtime; ++time) {
-        if (signal[time] > fMinPeak[thePlane]) {
-          if (nabove == 0) tstart = time;
-          ++nabove;
-        }
-        else {
-          // check for a wide enough signal above threshold
-          if (nabove > minSamples) {
-            // skip this wire if the RAT is too long
-            if (nabove > maxticks)
-              mf::LogError("CCHitFinder")
-                << "Long RAT " << nabove << " " << maxticks << " No signal on wire " << theWireNum
-                << " after time " << time;
-            if (nabove > maxticks) break;
-            unsigned short npt = 0;
-            // look for bumps to inform the fit
-            bumps.clear();
-            adcsum = 0;
-            for (unsigned short ii = tstart; ii < time; ++ii) {
-              signl[npt] = signal[ii];
-              adcsum += signl[npt];
-              if (signal[ii] > signal[ii - 1] && signal[ii - 1] > signal[ii - 2] &&
-                  signal[ii] > signal[ii + 1] && signal[ii + 1] > signal[ii + 2])
-                bumps.push_back(npt);
-              ++npt;
-            }
-            // decide if this RAT should be studied
-            if (fStudyHits) StudyHits(1, npt, signl, tstart);
-            // just make a crude hit if too many bumps
-            if (bumps.size() > fMaxBumps) {
-              MakeCrudeHit(npt, ticks, signl);
-              StoreHits(tstart, npt, WireInfo, adcsum);
-              nabove = 0;
-              continue;
-            }
-            // start looking for hits with the found bumps
-            unsigned short nHitsFit = bumps.size();
-            unsigned short nfit = 0;
-            chidof = 0.;
-            dof = -1;
-            bool HitStored = false;
-            unsigned short nMaxFit = bumps.size() + fMaxXtraHits;
-            // only used in StudyHits mode
-            first = true;
-            while (nHitsFit <= nMaxFit) {
-
-              FitNG(nHitsFit, npt, ticks, signl);
-              if (fStudyHits && first && SelRAT) {
-                first = false;
-                StudyHits(2, npt, signl, tstart);
-              }
-              // good chisq so store it
-              if (chidof < fChiSplit) {
-                StoreHits(tstart, npt, WireInfo, adcsum);
-                HitStored = true;
-                break;
-              }
-              // the previous fit was better, so revert to it and store it
-              ++nHitsFit;
-              ++nfit;
-            } // nHitsFit < fMaxXtraHits
-            if (!HitStored && npt < maxticks) {
-              // failed all fitting. Make a crude hit
-              MakeCrudeHit(npt, ticks, signl);
-              StoreHits(tstart, npt, WireInfo, adcsum);
-            }
-            else if (nHitsFit > 0)
-              FinalFitStats.AddMultiGaus(nHitsFit);
-          } // nabove > minSamples
-          nabove = 0;
-        } // signal < fMinPeak
-      }   // time
-    }     // wireIter
+  //------------------------------------------------------------------------------
+  bool CCHitFinderAlg::FindWireHits(recob::Wire const& theWire,
+                                    lariov::ChannelStatusProvider const& channelStatus,
+                                    float const* ticks,
+                                    unsigned short maxticks,
+                                    WireContext_t& ctx)
+  {
+    float* signl = ctx.signl.data();
+    float adcsum = 0;
+    bool first;
 
-    // print out
-    if (fStudyHits) StudyHits(4);
+    ctx.theChannel = theWire.Channel();
+    // ignore bad channels
+    if (channelStatus.IsBad(ctx.theChannel)) return true;
 
-    delete[] ticks;
-    delete[] signl;
+    std::vector<geo::WireID> wids = wireReadoutGeom->ChannelToWire(ctx.theChannel);
+    ctx.thePlane = wids[0].Plane;
+    if (ctx.thePlane > fMinPeak.size() - 1) {
+      mf::LogError("CCHF") << "MinPeak vector too small for plane " << ctx.thePlane;
+      ctx.stopped = true;
+      return false;
+    }
+    ctx.theWireNum = wids[0].Wire;
+    HitChannelInfo_t WireInfo{&theWire, wids[0], wireReadoutGeom->SignalType(theWire.Channel())};
 
-  } //RunCCHitFinder
+    // minimum number of time samples
+    unsigned short minSamples = 2 * fMinRMS[ctx.thePlane];
+
+    // factor used to normalize the chi/dof fits for each plane
+    ctx.chinorm = fChiNorms[ctx.thePlane];
+
+    std::vector<float> signal(theWire.Signal());
+
+    unsigned short nabove = 0;
+    unsigned short tstart = 0;
+    unsigned short maxtime = signal.size() - 2;
+    // find the min time when the signal is below threshold
+    unsigned short mintime = 3;
+    for (unsigned short time = 3; time < maxtime; ++time) {
+      if (signal[time] < fMinPeak[ctx.thePlane]) {
+        mintime = time;
+        break;
+      }
+    }
+    for (unsigned short time = mintime; time < maxtime; ++time) {
+      if (signal[time] > fMinPeak[ctx.thePlane]) {
+        if (nabove == 0) tstart = time;
+        ++nabove;
+      }
+      else {
+        // check for a wide enough signal above threshold
+        if (nabove > minSamples) {
+          // skip this wire if the RAT is too long
+          if (nabove > maxticks)
+            mf::LogError("CCHitFinder")
+              << "Long RAT " << nabove << " " << maxticks << " No signal on wire "
+              << ctx.theWireNum << " after time " << time;
+          if (nabove > maxticks) break;
+          unsigned short npt = 0;
+          // look for bumps to inform the fit
+          ctx.bumps.clear();
+          adcsum = 0;
+          for (unsigned short ii = tstart; ii < time; ++ii) {
+            signl[npt] = signal[ii];
+            adcsum += signl[npt];
+            if (signal[ii] > signal[ii - 1] && signal[ii - 1] > signal[ii - 2] &&
+                signal[ii] > signal[ii + 1] && signal[ii + 1] > signal[ii + 2])
+              ctx.bumps.push_back(npt);
+            ++npt;
+          }
+          // decide if this RAT should be studied
+          if (fStudyHits) StudyHits(1, &ctx, npt, signl, tstart);
+          // just make a crude hit if too many bumps
+          if (ctx.bumps.size() > fMaxBumps) {
+            MakeCrudeHit(ctx, npt, ticks, signl);
+            StoreHits(ctx, tstart, npt, WireInfo, adcsum);
+            nabove = 0;
+            continue;
+          }
+          // start looking for hits with the found bumps
+          unsigned short nHitsFit = ctx.bumps.size();
+          unsigned short nfit = 0;
+          ctx.chidof = 0.;
+          ctx.dof = -1;
+          bool HitStored = false;
+          unsigned short nMaxFit = ctx.bumps.size() + fMaxXtraHits;
+          // only used in StudyHits mode
+          first = true;
+          while (nHitsFit <= nMaxFit) {
+
+            FitNG(ctx, nHitsFit, npt, ticks, signl);
+            if (fStudyHits && first && SelRAT) {
+              first = false;
+              StudyHits(2, &ctx, npt, signl, tstart);
+            }
+            // good chisq so store it
+            if (ctx.chidof < fChiSplit) {
+              StoreHits(ctx, tstart, npt, WireInfo, adcsum);
+              HitStored = true;
+              break;
+            }
+            // the previous fit was better, so revert to it and store it
+            ++nHitsFit;
+            ++nfit;
+          } // nHitsFit < fMaxXtraHits
+          if (!HitStored && npt < maxticks) {
+            // failed all fitting. Make a crude hit
+            MakeCrudeHit(ctx, npt, ticks, signl);
+            StoreHits(ctx, tstart, npt, WireInfo, adcsum);
+          }
+          else if (nHitsFit > 0)
+            ctx.FinalFitStats.AddMultiGaus(nHitsFit);
+        } // nabove > minSamples
+        nabove = 0;
+      } // signal < fMinPeak
+    }   // time
+    return true;
+  } // FindWireHits
 
   /////////////////////////////////////////
   bool CCHitFinderAlg::FastGaussianFit(unsigned short npt,
@@ -281,16 +330,169 @@ namespace hit {
   } // FastGaussianFit()
 
   /////////////////////////////////////////
-  void CCHitFinderAlg::FitNG(unsigned short nGaus, unsigned short npt, float* ticks, float* signl)
+  bool CCHitFinderAlg::BoundedGaussianFit(unsigned short nGaus,
+                                          unsigned short npt,
+                                          float const* ticks,
+                                          float const* signl,
+                                          std::vector<double>& params,
+                                          std::vector<double> const& parmin,
+                                          std::vector<double> const& parmax,
+                                          std::vector<double>& paramerrors,
+                                          double& chi2)
+  {
+    // parameters: amplitude, mean, sigma for each Gaussian
+    unsigned short const npar = 3 * nGaus;
+    if (npt <= npar) return false;
+
+    auto const clampToLimits = [&](std::vector<double>& p) {
+      for (unsigned short ipar = 0; ipar < npar; ++ipar)
+        p[ipar] = std::clamp(p[ipar], parmin[ipar], parmax[ipar]);
+    };
+
+    // chi^2 of the parameters p, and optionally the normal equations
+    // (J^T J and J^T r, with J the derivatives of the model)
+    std::vector<double> deriv(npar);
+    auto const computeChi2 = [&](std::vector<double> const& p,
+                                 std::vector<double>* alpha,
+                                 std::vector<double>* beta) {
+      if (alpha) {
+        std::fill(alpha->begin(), alpha->end(), 0.);
+        std::fill(beta->begin(), beta->end(), 0.);
+      }
+      double sum = 0.;
+      for (unsigned short ii = 0; ii < npt; ++ii) {
+        double const x = ticks[ii];
+        double model = 0.;
+        for (unsigned short ipar = 0; ipar < npar; ipar += 3) {
+          double const arg = (x - p[ipar + 1]) / p[ipar + 2];
+          double const gaus = std::exp(-0.5 * arg * arg);
+          model += p[ipar] * gaus;
+          deriv[ipar] = gaus;
+          deriv[ipar + 1] = p[ipar] * gaus * arg / p[ipar + 2];
+          deriv[ipar + 2] = deriv[ipar + 1] * arg;
+        }
+        double const resid = signl[ii] - model;
+        sum += resid * resid;
+        if (!alpha) continue;
+        for (unsigned short ipar = 0; ipar < npar; ++ipar) {
+          (*beta)[ipar] += deriv[ipar] * resid;
+          for (unsigned short jpar = 0; jpar <= ipar; ++jpar)
+            (*alpha)[ipar * npar + jpar] += deriv[ipar] * deriv[jpar];
+        }
+      }
+      if (alpha) {
+        for (unsigned short ipar = 0; ipar < npar; ++ipar)
+          for (unsigned short jpar = 0; jpar < ipar; ++jpar)
+            (*alpha)[jpar * npar + ipar] = (*alpha)[ipar * npar + jpar];
+      }
+      return sum;
+    };
+
+    // solves m x = b in place by Gaussian elimination with partial pivoting;
+    // with b empty, m is replaced by its inverse
+    auto const solve = [npar](std::vector<double> m, std::vector<double>& b, bool invert) {
+      std::vector<double> inv;
+      if (invert) {
+        inv.assign(npar * npar, 0.);
+        for (unsigned short i = 0; i < npar; ++i)
+          inv[i * npar + i] = 1.;
+      }
+      for (unsigned short col = 0; col < npar; ++col) {
+        unsigned short pivot = col;
+        for (unsigned short row = col + 1; row < npar; ++row)
+          if (std::abs(m[row * npar + col]) > std::abs(m[pivot * npar + col])) pivot = row;
+        if (!(std::abs(m[pivot * npar + col]) > 0.)) return false;
+        if (pivot != col) {
+          for (unsigned short k = 0; k < npar; ++k) {
+            std::swap(m[col * npar + k], m[pivot * npar + k]);
+            if (invert) std::swap(inv[col * npar + k], inv[pivot * npar + k]);
+          }
+          if (!invert) std::swap(b[col], b[pivot]);
+        }
+        double const diag = m[col * npar + col];
+        for (unsigned short row = 0; row < npar; ++row) {
+          if (row == col) continue;
+          double const factor = m[row * npar + col] / diag;
+          if (factor == 0.) continue;
+          for (unsigned short k = col; k < npar; ++k)
+            m[row * npar + k] -= factor * m[col * npar + k];
+          if (invert) {
+            for (unsigned short k = 0; k < npar; ++k)
+              inv[row * npar + k] -= factor * inv[col * npar + k];
+          }
+          else
+            b[row] -= factor * b[col];
+        }
+      }
+      for (unsigned short row = 0; row < npar; ++row) {
+        double const diag = m[row * npar + row];
+        if (invert) {
+          for (unsigned short k = 0; k < npar; ++k)
+            inv[row * npar + k] /= diag;
+        }
+        else
+          b[row] /= diag;
+      }
+      if (invert) b = std::move(inv);
+      return true;
+    };
+
+    clampToLimits(params);
+
+    std::vector<double> alpha(npar * npar), beta(npar);
+    std::vector<double> trial(npar), step(npar), damped(npar * npar);
+    chi2 = computeChi2(params, &alpha, &beta);
+    double lambda = 1e-3;
+    constexpr unsigned short maxIterations = 200;
+    for (unsigned short iter = 0; iter < maxIterations; ++iter) {
+      damped = alpha;
+      for (unsigned short ipar = 0; ipar < npar; ++ipar)
+        damped[ipar * npar + ipar] *= 1. + lambda;
+      step = beta;
+      if (!solve(damped, step, false)) return false;
+      for (unsigned short ipar = 0; ipar < npar; ++ipar)
+        trial[ipar] = params[ipar] + step[ipar];
+      clampToLimits(trial);
+      double const trialChi2 = computeChi2(trial, nullptr, nullptr);
+      if (trialChi2 < chi2) {
+        bool const converged = (chi2 - trialChi2) < 1e-6 * chi2 + 1e-12;
+        params = trial;
+        chi2 = computeChi2(params, &alpha, &beta);
+        lambda = std::max(lambda / 10., 1e-12);
+        if (converged) break;
+      }
+      else {
+        lambda *= 10.;
+        if (lambda > 1e10) break;
+      }
+    } // iter
+
+    // the errors from the covariance matrix, normalized to the fit quality
+    std::vector<double> cov;
+    if (!solve(alpha, cov, true)) return false;
+    double const errScale = chi2 / (npt - npar);
+    paramerrors.resize(npar);
+    for (unsigned short ipar = 0; ipar < npar; ++ipar)
+      paramerrors[ipar] = std::sqrt(std::abs(cov[ipar * npar + ipar]) * errScale);
+
+    return std::isfinite(chi2);
+  } // BoundedGaussianFit()
+
+  /////////////////////////////////////////
+  void CCHitFinderAlg::FitNG(WireContext_t& ctx,
+                             unsigned short nGaus,
+                             unsigned short npt,
+                             float const* ticks,
+                             float const* signl) const
   {
     // Fit the signal to n Gaussians
 
-    dof = npt - 3 * nGaus;
+    ctx.dof = npt - 3 * nGaus;
 
-    chidof = 9999.;
+    ctx.chidof = 9999.;
 
-    if (dof < 3) return;
-    if (bumps.size() == 0) return;
+    if (ctx.dof < 3) return;
+    if (ctx.bumps.size() == 0) return;
 
     // load the fit into a temp vector
     std::vector<double> partmp;
@@ -299,16 +501,16 @@ namespace hit {
     //
     // if it is possible, we try first with the quick single Gaussian fit
     //
-    TriedFitStats.AddMultiGaus(nGaus);
+    ctx.TriedFitStats.AddMultiGaus(nGaus);
 
-    bool bNeedROOTfit = (nGaus > 1) || !fUseFastFit;
-    if (!bNeedROOTfit) {
+    bool bNeedFullFit = (nGaus > 1) || !fUseFastFit;
+    if (!bNeedFullFit) {
       // so, we need only one puny Gaussian;
       std::array<double, 3> params, paramerrors;
 
-      TriedFitStats.AddFast();
+      ctx.TriedFitStats.AddFast();
 
-      if (FastGaussianFit(npt, ticks, signl, params, paramerrors, chidof)) {
+      if (FastGaussianFit(npt, ticks, signl, params, paramerrors, ctx.chidof)) {
         // success? copy the results in the proper structures
         partmp.resize(3);
         std::copy(params.begin(), params.end(), partmp.begin());
@@ -316,83 +518,83 @@ namespace hit {
         std::copy(paramerrors.begin(), paramerrors.end(), partmperr.begin());
       }
       else
-        bNeedROOTfit = true; // if we fail, let's schedule ROOT to back us up
+        bNeedFullFit = true; // if we fail, let's schedule the full fit to back us up
 
-      if (!bNeedROOTfit) FinalFitStats.AddFast();
+      if (!bNeedFullFit) ctx.FinalFitStats.AddFast();
 
-    } // if we don't need ROOT to fit
+    } // if we don't need the full fit
 
-    if (bNeedROOTfit) {
+    if (bNeedFullFit) {
       // we may land here either because the simple Gaussian fit did not work (either
       // failed, or we chose not to trust it) or because the fit is multi-Gaussian
 
-      // define the fit string to pass to TF1
-
-      std::stringstream numConv;
-      std::string eqn = "gaus";
-      if (nGaus > 1) eqn = "gaus(0)";
-      for (unsigned short ii = 3; ii < nGaus * 3; ii += 3) {
-        eqn.append(" + gaus(");
-        numConv.str("");
-        numConv << ii;
-        eqn.append(numConv.str());
-        eqn.append(")");
-      }
-
-      auto Gn = std::make_unique<TF1>("gn", eqn.c_str());
-      TGraph* fitn = new TGraph(npt, ticks, signl);
+      // parameters, lower and upper limits
+      std::vector<double> parmin(3 * nGaus), parmax(3 * nGaus);
+      partmp.assign(3 * nGaus, 0.);
 
       // put in the bump parameters. Assume that nGaus >= bumps.size()
-      for (unsigned short ii = 0; ii < bumps.size(); ++ii) {
+      for (unsigned short ii = 0; ii < ctx.bumps.size(); ++ii) {
         unsigned short index = ii * 3;
-        unsigned short bumptime = bumps[ii];
+        unsigned short bumptime = ctx.bumps[ii];
         double amp = signl[bumptime];
-        Gn->SetParameter(index, amp);
-        Gn->SetParLimits(index, 0., 9999.);
-        Gn->SetParameter(index + 1, (double)bumptime);
-        Gn->SetParLimits(index + 1, 0, (double)npt);
-        Gn->SetParameter(index + 2, (double)fMinRMS[thePlane]);
-        Gn->SetParLimits(index + 2, 1., 3 * (double)fMinRMS[thePlane]);
+        partmp[index] = amp;
+        parmin[index] = 0.;
+        parmax[index] = 9999.;
+        partmp[index + 1] = (double)bumptime;
+        parmin[index + 1] = 0.;
+        parmax[index + 1] = (double)npt;
+        partmp[index + 2] = (double)fMinRMS[ctx.thePlane];
+        parmin[index + 2] = 1.;
+        parmax[index + 2] = 3 * (double)fMinRMS[ctx.thePlane];
       } // ii bumps
 
       // search for other bumps that may be hidden by the already found ones
-      for (unsigned short ii = bumps.size(); ii < nGaus; ++ii) {
+      for (unsigned short ii = ctx.bumps.size(); ii < nGaus; ++ii) {
         // bump height must exceed fMinPeak
-        float big = fMinPeak[thePlane];
+        float big = fMinPeak[ctx.thePlane];
         unsigned short imbig = 0;
         for (unsigned short jj = 0; jj < npt; ++jj) {
-          float diff = signl[jj] - Gn->Eval((Double_t)jj, 0, 0, 0);
+          double model = 0.;
+          for (unsigned short index = 0; index < 3 * ii; index += 3) {
+            double const arg = (jj - partmp[index + 1]) / partmp[index + 2];
+            model += partmp[index] * std::exp(-0.5 * arg * arg);
+          }
+          float diff = signl[jj] - model;
           if (diff > big) {
             big = diff;
             imbig = jj;
           }
         } // jj
-        if (imbig > 0) {
-          // set the parameters for the bump
-          unsigned short index = ii * 3;
-          Gn->SetParameter(index, (double)big);
-          Gn->SetParLimits(index, 0., 9999.);
-          Gn->SetParameter(index + 1, (double)imbig);
-          Gn->SetParLimits(index + 1, 0, (double)npt);
-          Gn->SetParameter(index + 2, (double)fMinRMS[thePlane]);
-          Gn->SetParLimits(index + 2, 1., 5 * (double)fMinRMS[thePlane]);
-        } // imbig > 0
-      }   // ii
-
-      // W = set weights to 1, N = no drawing or storing, Q = quiet
-      // B = bounded parameters
-      fitn->Fit(&*Gn, "WNQB");
-
-      for (unsigned short ipar = 0; ipar < 3 * nGaus; ++ipar) {
-        partmp.push_back(Gn->GetParameter(ipar));
-        partmperr.push_back(Gn->GetParError(ipar));
-      }
-      chidof = Gn->GetChisquare() / (dof * chinorm);
+        // without a seed the extra Gaussian would stay empty and the fit
+        // would be rejected for its small amplitude
+        if (imbig == 0) {
+          ctx.chidof = 9999.;
+          ctx.dof = -1;
+          return;
+        }
+        // set the parameters for the bump
+        unsigned short index = ii * 3;
+        partmp[index] = (double)big;
+        parmin[index] = 0.;
+        parmax[index] = 9999.;
+        partmp[index + 1] = (double)imbig;
+        parmin[index + 1] = 0.;
+        parmax[index + 1] = (double)npt;
+        partmp[index + 2] = (double)fMinRMS[ctx.thePlane];
+        parmin[index + 2] = 1.;
+        parmax[index + 2] = 5 * (double)fMinRMS[ctx.thePlane];
+      } // ii
 
-      delete fitn;
-      //  delete Gn;
+      double chi2 = 0.;
+      if (!BoundedGaussianFit(
+            nGaus, npt, ticks, signl, partmp, parmin, parmax, partmperr, chi2)) {
+        ctx.chidof = 9999.;
+        ctx.dof = -1;
+        return;
+      }
+      ctx.chidof = chi2 / (ctx.dof * ctx.chinorm);
 
-    } // if ROOT fit
+    } // if full fit
 
     // Sort by increasing time if necessary
     if (nGaus > 1) {
@@ -440,13 +642,13 @@ namespace hit {
         break;
       }
       // ensure that the signal peak is large enough
-      if (partmp[index] < fMinPeak[thePlane]) {
+      if (partmp[index] < fMinPeak[ctx.thePlane]) {
         fitok = false;
         break;
       }
       // ensure that the RMS is large enough but not too large
       float rms = partmp[index + 2];
-      if (rms < 0.5 * fMinRMS[thePlane] || rms > 5 * fMinRMS[thePlane]) {
+      if (rms < 0.5 * fMinRMS[ctx.thePlane] || rms > 5 * fMinRMS[ctx.thePlane]) {
         fitok = false;
         break;
       }
@@ -464,17 +666,20 @@ namespace hit {
     }
 
     if (fitok) {
-      par = partmp;
-      parerr = partmperr;
+      ctx.par = partmp;
+      ctx.parerr = partmperr;
     }
     else {
-      chidof = 9999.;
-      dof = -1;
+      ctx.chidof = 9999.;
+      ctx.dof = -1;
     }
   } // FitNG
 
   /////////////////////////////////////////
-  void CCHitFinderAlg::MakeCrudeHit(unsigned short npt, float* ticks, float* signl)
+  void CCHitFinderAlg::MakeCrudeHit(WireContext_t& ctx,
+                                    unsigned short npt,
+                                    float const* ticks,
+                                    float const* signl) const
   {
     // make a single crude hit if fitting failed
     float sumS = 0.;
@@ -491,41 +696,42 @@ namespace hit {
     }
     rms = std::sqrt(rms / sumS);
     float amp = sumS / (Sqrt2Pi * rms);
-    par.clear();
-    par.push_back(amp);
-    par.push_back(mean);
-    par.push_back(rms);
+    ctx.par.clear();
+    ctx.par.push_back(amp);
+    ctx.par.push_back(mean);
+    ctx.par.push_back(rms);
     // need to do the errors better
-    parerr.clear();
+    ctx.parerr.clear();
     float amperr = npt;
     float meanerr = std::sqrt(1 / sumS);
     float rmserr = 0.2 * rms;
-    parerr.push_back(amperr);
-    parerr.push_back(meanerr);
-    parerr.push_back(rmserr);
-    chidof = 9999.;
-    dof = -1;
+    ctx.parerr.push_back(amperr);
+    ctx.parerr.push_back(meanerr);
+    ctx.parerr.push_back(rmserr);
+    ctx.chidof = 9999.;
+    ctx.dof = -1;
   } // MakeCrudeHit
 
   /////////////////////////////////////////
-  void CCHitFinderAlg::StoreHits(unsigned short TStart,
+  void CCHitFinderAlg::StoreHits(WireContext_t& ctx,
+                                 unsigned short TStart,
                                  unsigned short npt,
                                  HitChannelInfo_t info,
                                  float adcsum)
   {
     // store the hits in the struct
-    size_t nhits = par.size() / 3;
+    size_t nhits = ctx.par.size() / 3;
 
-    if (allhits.max_size() - allhits.size() < nhits) {
-      mf::LogError("CCHitFinder") << "Too many hits: existing " << allhits.size() << " plus new "
-                                  << nhits << " beyond the maximum " << allhits.max_size();
+    if (ctx.hits.max_size() - ctx.hits.size() < nhits) {
+      mf::LogError("CCHitFinder") << "Too many hits: existing " << ctx.hits.size() << " plus new "
+                                  << nhits << " beyond the maximum " << ctx.hits.max_size();
       return;
     }
 
     if (nhits == 0) return;
 
     // fill RMS for single hits
-    if (fStudyHits) StudyHits(3);
+    if (fStudyHits) StudyHits(3, &ctx);
 
     const float loTime = TStart;
     const float hiTime = TStart + npt;
@@ -534,41 +740,42 @@ namespace hit {
     float gsum = 0.;
     for (size_t hit = 0; hit < nhits; ++hit) {
       const unsigned short index = 3 * hit;
-      gsum += Sqrt2Pi * par[index] * par[index + 2];
+      gsum += Sqrt2Pi * ctx.par[index] * ctx.par[index + 2];
     }
     for (size_t hit = 0; hit < nhits; ++hit) {
       const size_t index = 3 * hit;
-      const float charge = Sqrt2Pi * par[index] * par[index + 2];
+      const float charge = Sqrt2Pi * ctx.par[index] * ctx.par[index + 2];
       const float charge_err =
-        SqrtPi * (parerr[index] * par[index + 2] + par[index] * parerr[index + 2]);
-
-      allhits.emplace_back(info.wire->Channel(),    // channel
-                           loTime,                  // start_tick
-                           hiTime,                  // end_tick
-                           par[index + 1] + TStart, // peak_time
-                           parerr[index + 1],       // sigma_peak_time
-                           par[index + 2],          // rms
-                           par[index],              // peak_amplitude
-                           parerr[index],           // sigma_peak_amplitude
-                           adcsum * charge / gsum,  // ROIsummedADC
-                           adcsum * charge / gsum,  // HitsummedADC  NOT CORRECTLY FILLED
-                           charge,                  // hit_integral
-                           charge_err,              // hit_sigma_integral
-                           nhits,                   // multiplicity
-                           hit,                     // local_index
-                           chidof,                  // goodness_of_fit
-                           dof,                     // dof
-                           info.wire->View(),       // view
-                           info.sigType,            // signal_type
-                           info.wireID              // wireID
+        SqrtPi * (ctx.parerr[index] * ctx.par[index + 2] + ctx.par[index] * ctx.parerr[index + 2]);
+
+      ctx.hits.emplace_back(info.wire->Channel(),        // channel
+                            loTime,                      // start_tick
+                            hiTime,                      // end_tick
+                            ctx.par[index + 1] + TStart, // peak_time
+                            ctx.parerr[index + 1],       // sigma_peak_time
+                            ctx.par[index + 2],          // rms
+                            ctx.par[index],              // peak_amplitude
+                            ctx.parerr[index],           // sigma_peak_amplitude
+                            adcsum * charge / gsum,      // ROIsummedADC
+                            adcsum * charge / gsum,      // HitsummedADC  NOT CORRECTLY FILLED
+                            charge,                      // hit_integral
+                            charge_err,                  // hit_sigma_integral
+                            nhits,                       // multiplicity
+                            hit,                         // local_index
+                            ctx.chidof,                  // goodness_of_fit
+                            ctx.dof,                     // dof
+                            info.wire->View(),           // view
+                            info.sigType,                // signal_type
+                            info.wireID                  // wireID
       );
     } // hit
   }   // StoreHits
 
   //////////////////////////////////////////////////
   void CCHitFinderAlg::StudyHits(unsigned short flag,
+                                 WireContext_t const* ctx,
                                  unsigned short npt,
-                                 float* signl,
+                                 float const* signl,
                                  unsigned short tstart)
   {
     // study hits in user-selected ranges of wires and ticks in each plane. The user should identify
@@ -610,27 +817,27 @@ namespace hit {
 
     if (flag == 1) {
       SelRAT = false;
-      if (thePlane == 0) {
-        if (theWireNum > fUWireRange[0] && theWireNum < fUWireRange[1] && tstart > fUTickRange[0] &&
-            tstart < fUTickRange[1]) {
+      if (ctx->thePlane == 0) {
+        if (ctx->theWireNum > fUWireRange[0] && ctx->theWireNum < fUWireRange[1] &&
+            tstart > fUTickRange[0] && tstart < fUTickRange[1]) {
           SelRAT = true;
-          RATCnt[thePlane] += 1;
+          RATCnt[ctx->thePlane] += 1;
         }
         return;
       } // thePlane == 0
-      if (thePlane == 1) {
-        if (theWireNum > fVWireRange[0] && theWireNum < fVWireRange[1] && tstart > fVTickRange[0] &&
-            tstart < fVTickRange[1]) {
+      if (ctx->thePlane == 1) {
+        if (ctx->theWireNum > fVWireRange[0] && ctx->theWireNum < fVWireRange[1] &&
+            tstart > fVTickRange[0] && tstart < fVTickRange[1]) {
           SelRAT = true;
-          RATCnt[thePlane] += 1;
+          RATCnt[ctx->thePlane] += 1;
         }
         return;
       } // thePlane == 1
-      if (thePlane == 2) {
-        if (theWireNum > fWWireRange[0] && theWireNum < fWWireRange[1] && tstart > fWTickRange[0] &&
-            tstart < fWTickRange[1]) {
+      if (ctx->thePlane == 2) {
+        if (ctx->theWireNum > fWWireRange[0] && ctx->theWireNum < fWWireRange[1] &&
+            tstart > fWTickRange[0] && tstart < fWTickRange[1]) {
           SelRAT = true;
-          RATCnt[thePlane] += 1;
+          RATCnt[ctx->thePlane] += 1;
         }
         return;
       } // thePlane == 2
@@ -651,19 +858,19 @@ namespace hit {
       // require a significant PH
       if (big > fMinPeak[0]) {
         // get the Lo info
-        if (theWireNum < loWire[thePlane]) {
-          loWire[thePlane] = theWireNum;
-          loTime[thePlane] = tstart + imbig;
+        if (ctx->theWireNum < loWire[ctx->thePlane]) {
+          loWire[ctx->thePlane] = ctx->theWireNum;
+          loTime[ctx->thePlane] = tstart + imbig;
         }
         // get the Hi info
-        if (theWireNum > hiWire[thePlane]) {
-          hiWire[thePlane] = theWireNum;
-          hiTime[thePlane] = tstart + imbig;
+        if (ctx->theWireNum > hiWire[ctx->thePlane]) {
+          hiWire[ctx->thePlane] = ctx->theWireNum;
+          hiTime[ctx->thePlane] = tstart + imbig;
         }
       } // big > fMinPeak[0]
-      if (bumps.size() == 1 && chidof < 9999.) {
-        bumpCnt[thePlane] += bumps.size();
-        bumpChi[thePlane] += chidof;
+      if (ctx->bumps.size() == 1 && ctx->chidof < 9999.) {
+        bumpCnt[ctx->thePlane] += ctx->bumps.size();
+        bumpChi[ctx->thePlane] += ctx->chidof;
         // calculate the average bin
         float sumt = 0.;
         float sum = 0.;
@@ -678,7 +885,7 @@ namespace hit {
           float dbin = (float)ii - aveb;
           sumt += signl[ii] * dbin * dbin;
         } // ii
-        bumpRMS[thePlane] += std::sqrt(sumt / sum);
+        bumpRMS[ctx->thePlane] += std::sqrt(sumt / sum);
       } // bumps.size() == 1 && chidof < 9999.
       return;
     } // flag == 2
@@ -686,9 +893,9 @@ namespace hit {
     // fill info for single hits
     if (flag == 3) {
       if (!SelRAT) return;
-      if (par.size() == 3) {
-        hitCnt[thePlane] += 1;
-        hitRMS[thePlane] += par[2];
+      if (ctx->par.size() == 3) {
+        hitCnt[ctx->thePlane] += 1;
+        hitRMS[ctx->thePlane] += ctx->par[2];
       }
       return;
     }
@@ -756,4 +963,11 @@ namespace hit {
     ++MultiGausFits[std::min(nGaus, (unsigned int)MultiGausFits.size()) - 1];
   }
 
+  void CCHitFinderAlg::FitStats_t::Add(FitStats_t const& other)
+  {
+    FastFits += other.FastFits;
+    for (size_t i = 0; i < std::min(MultiGausFits.size(), other.MultiGausFits.size()); ++i)
+      MultiGausFits[i] += other.MultiGausFits[i];
+  }
+
 } // namespace hit
@@ -24,6 +24,7 @@
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
 #include "lardataobj/RecoBase/Hit.h"
 #include "lardataobj/RecoBase/Wire.h"
+#include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
 #include "larreco/RecoAlg/GausFitCache.h"
 
 namespace hit {
@@ -89,6 +90,35 @@ namespace hit {
     template <typename Stream>
     void PrintStats(Stream& out) const;
 
+    /**
+     * @brief Fits a sum of Gaussians with bounded parameters
+     * @param nGaus number of Gaussians
+     * @param npt number of points to be fitted
+     * @param ticks tick coordinates
+     * @param signl signal amplitude
+     * @param params starting values, replaced by the fitted ones
+     *               (amplitude, mean, sigma for each Gaussian)
+     * @param parmin lower limits of the parameters
+     * @param parmax upper limits of the parameters
+     * @param paramerrors a vector where the fit parameter errors will be stored
+     * @param chi2 a variable where to store the chi^2, with unit weights
+     * @return whether the fit was successful or not
+     *
+     * This is a Levenberg-Marquardt least squares fit with the parameters
+     * projected onto their limits at each step. As in a ROOT fit of a graph
+     * without errors, the parameter errors are scaled by sqrt(chi^2/NDF).
+     * It uses no global state and it can run concurrently.
+     */
+    static bool BoundedGaussianFit(unsigned short nGaus,
+                                   unsigned short npt,
+                                   float const* ticks,
+                                   float const* signl,
+                                   std::vector<double>& params,
+                                   std::vector<double> const& parmin,
+                                   std::vector<double> const& parmax,
+                                   std::vector<double>& paramerrors,
+                                   double& chi2);
+
   private:
     std::vector<float> fMinPeak;
     std::vector<float> fMinRMS;
@@ -101,29 +131,24 @@ namespace hit {
     std::vector<float> fTimeOffsets;
     std::vector<float> fChgNorms;
 
-    raw::ChannelID_t theChannel;
-    unsigned short theWireNum;
-    unsigned short thePlane;
-
-    float chinorm;
     static constexpr float Sqrt2Pi = 2.5066;
     static constexpr float SqrtPi = 1.7725;
 
     bool fUseChannelFilter;
+    bool fParallelWires; ///< find the hits on different wires concurrently
 
     geo::WireReadoutGeom const* wireReadoutGeom{
       &art::ServiceHandle<geo::WireReadout const>()->Get()};
 
-    // fit n Gaussians possibly with bounds setting (parmin, parmax)
-    void FitNG(unsigned short nGaus, unsigned short npt, float* ticks, float* signl);
-    // parameters, errors, lower limit, upper limits for FitNG
-    std::vector<double> par;
-    std::vector<double> parerr;
-    std::vector<double> parmin;
-    std::vector<double> parmax;
-    float chidof;
-    int dof;
-    std::vector<unsigned short> bumps;
+    struct FitStats_t {
+      unsigned int FastFits;                   ///< count of single-Gaussian fast fits
+      std::vector<unsigned int> MultiGausFits; ///< multi-Gaussian stats
+
+      void Reset(unsigned int nGaus);
+      void AddMultiGaus(unsigned int nGaus);
+      void AddFast() { ++FastFits; }
+      void Add(FitStats_t const& other);
+    };
 
     /// exchange data about the originating wire
     struct HitChannelInfo_t {
@@ -132,10 +157,52 @@ namespace hit {
       geo::SigType_t sigType;
     };
 
+    /// Working state of the hit finding on one wire; each concurrent task owns one
+    struct WireContext_t {
+      raw::ChannelID_t theChannel;
+      unsigned short theWireNum;
+      unsigned short thePlane;
+      float chinorm;
+      // parameters and errors from FitNG
+      std::vector<double> par;
+      std::vector<double> parerr;
+      float chidof;
+      int dof;
+      std::vector<unsigned short> bumps;
+      std::vector<float> signl; ///< signal in the Region Above Threshold being fitted
+      std::vector<recob::Hit> hits;
+      FitStats_t FinalFitStats;
+      FitStats_t TriedFitStats;
+      bool stopped = false; ///< hit finding was aborted on a wire of this context
+
+      explicit WireContext_t(unsigned short maxticks);
+    };
+
+    /// Finds and stores in the context the hits on one wire; returns false to stop
+    bool FindWireHits(recob::Wire const& theWire,
+                      lariov::ChannelStatusProvider const& channelStatus,
+                      float const* ticks,
+                      unsigned short maxticks,
+                      WireContext_t& ctx);
+
+    // fit n Gaussians with bounds on the parameters
+    void FitNG(WireContext_t& ctx,
+               unsigned short nGaus,
+               unsigned short npt,
+               float const* ticks,
+               float const* signl) const;
+
     // make a cruddy hit if fitting fails
-    void MakeCrudeHit(unsigned short npt, float* ticks, float* signl);
+    void MakeCrudeHit(WireContext_t& ctx,
+                      unsigned short npt,
+                      float const* ticks,
+                      float const* signl) const;
     // store the hits
-    void StoreHits(unsigned short TStart, unsigned short npt, HitChannelInfo_t info, float adcsum);
+    void StoreHits(WireContext_t& ctx,
+                   unsigned short TStart,
+                   unsigned short npt,
+                   HitChannelInfo_t info,
+                   float adcsum);
 
     // study hit finding and fitting
     bool fStudyHits;
@@ -143,8 +210,9 @@ namespace hit {
     std::vector<short> fVWireRange, fVTickRange;
     std::vector<short> fWWireRange, fWTickRange;
     void StudyHits(unsigned short flag,
+                   WireContext_t const* ctx = nullptr,
                    unsigned short npt = 0,
-                   float* signl = nullptr,
+                   float const* signl = nullptr,
                    unsigned short tstart = 0);
     std::vector<int> bumpCnt;
     std::vector<int> RATCnt;
@@ -163,15 +231,6 @@ namespace hit {
 
     GausFitCache FitCache; ///< a set of functions ready to be used
 
-    struct FitStats_t {
-      unsigned int FastFits;                   ///< count of single-Gaussian fast fits
-      std::vector<unsigned int> MultiGausFits; ///< multi-Gaussian stats
-
-      void Reset(unsigned int nGaus);
-      void AddMultiGaus(unsigned int nGaus);
-      void AddFast() { ++FastFits; }
-    };
-
     FitStats_t FinalFitStats; ///< counts of the good fits
     FitStats_t TriedFitStats; ///< counts of the tried fits
 
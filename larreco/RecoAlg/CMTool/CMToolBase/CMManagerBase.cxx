@@ -4,8 +4,10 @@
 #include "TStopwatch.h"
 #include "TString.h" // Form()
 
+#include <algorithm>
 #include <cstddef>
 #include <iostream>
+#include <limits>
 #include <set>
 #include <string>
 #include <utility>
@@ -20,6 +22,8 @@ namespace cmtool {
     _priority_algo = nullptr;
     _min_nhits = 0;
     _merge_till_converge = false;
+    _parallel = false;
+    _box_margin = -1;
     Reset();
     _time_report = false;
   }
@@ -152,6 +156,38 @@ namespace cmtool {
                 << std::endl;
   }
 
+  std::vector<CMManagerBase::ClusterBox_t> CMManagerBase::ComputeBoxes(
+    const std::vector<cluster::ClusterParamsAlg>& clusters) const
+  {
+    std::vector<ClusterBox_t> boxes;
+    if (_box_margin < 0) return boxes;
+
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    boxes.reserve(clusters.size());
+    for (auto const& c : clusters) {
+      // a cluster without hits gets an empty box, which overlaps nothing
+      ClusterBox_t box{inf, -inf, inf, -inf};
+      for (auto const& hit : c.GetHitVector()) {
+        box.w_min = std::min(box.w_min, hit.w);
+        box.w_max = std::max(box.w_max, hit.w);
+        box.t_min = std::min(box.t_min, hit.t);
+        box.t_max = std::max(box.t_max, hit.t);
+      }
+      boxes.push_back(box);
+    }
+    return boxes;
+  }
+
+  bool CMManagerBase::BoxesOverlap(const ClusterBox_t& box1,
+                                   const ClusterBox_t& box2,
+                                   bool time_only) const
+  {
+    if (box1.t_min > box2.t_max + _box_margin || box2.t_min > box1.t_max + _box_margin)
+      return false;
+    if (time_only) return true;
+    return !(box1.w_min > box2.w_max + _box_margin || box2.w_min > box1.w_max + _box_margin);
+  }
+
   void CMManagerBase::ComputePriority(const std::vector<cluster::ClusterParamsAlg>& clusters)
   {
 
@@ -92,10 +92,41 @@ namespace cmtool {
     /// A setter for an analysis output file
     void SetAnaFile(TFile* fout) { _fout = fout; }
 
+    /**
+       Switch to evaluate the algorithm on the cluster pairs (or combinations) concurrently.
+       The results are booked in the same order as in the serial loop, but the algorithm's
+       Bool()/Float() must be safe to call concurrently. Ignored in kPerMerging debug mode.
+    */
+    void SetParallel(bool doit = true) { _parallel = doit; }
+
+    /**
+       Skip the cluster pairs whose hit bounding boxes, enlarged by margin [cm], do not
+       overlap, without running the algorithm on them. Clusters on different planes are
+       compared in time only. A negative margin (default) disables the prefilter.
+    */
+    void SetBoxPrefilter(double margin) { _box_margin = margin; }
+
   protected:
+    /// Hit extent of a cluster in wire and time [cm]
+    struct ClusterBox_t {
+      double w_min, w_max, t_min, t_max;
+    };
+
     /// Function to compute priority
     void ComputePriority(const std::vector<cluster::ClusterParamsAlg>& clusters);
 
+    /// Function to compute the hit bounding boxes of the clusters (empty unless prefiltering)
+    std::vector<ClusterBox_t> ComputeBoxes(
+      const std::vector<cluster::ClusterParamsAlg>& clusters) const;
+
+    /// Whether two boxes overlap within the prefilter margin (in time only if time_only)
+    bool BoxesOverlap(const ClusterBox_t& box1,
+                      const ClusterBox_t& box2,
+                      bool time_only = false) const;
+
+    /// Whether the pair (combination) loop runs concurrently
+    bool RunParallel() const { return _parallel && _debug_mode > kPerMerging; }
+
     /// FMWK function called @ beginning of Process()
     virtual void EventBegin() {}
 
@@ -138,6 +169,12 @@ namespace cmtool {
 
     /// A holder for # of unique planes in the clusters, computed in ComputePriority() function
     std::set<UChar_t> _planes;
+
+    /// Concurrent evaluation switch
+    bool _parallel;
+
+    /// Bounding box prefilter margin [cm], disabled if negative
+    double _box_margin;
   };
 }
 
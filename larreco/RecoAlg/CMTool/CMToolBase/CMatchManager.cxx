@@ -9,6 +9,9 @@
 #include <vector>
 
 #include "TStopwatch.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "larreco/RecoAlg/CMTool/CMToolBase/CFloatAlgoBase.h"
 #include "larreco/RecoAlg/CMTool/CMToolBase/CMManagerBase.h"
 #include "larreco/RecoAlg/CMTool/CMToolBase/CMTException.h"
@@ -214,41 +217,72 @@ namespace cmtool {
 
     auto const& combinations = PlaneClusterCombinations(seed);
 
-    // Loop over combinations and call algorithm
-    for (auto const& comb : combinations) {
+    auto const boxes = ComputeBoxes(_in_clusters);
 
-      std::vector<const cluster::ClusterParamsAlg*> ptr_v;
+    // Cluster indexes of each combination; the ones with clusters that do not
+    // overlap in time are skipped if the prefilter is on
+    std::vector<std::vector<unsigned int>> index_v;
+    index_v.reserve(combinations.size());
+    for (auto const& comb : combinations) {
 
       std::vector<unsigned int> tmp_index_v;
       tmp_index_v.reserve(comb.size());
 
-      ptr_v.reserve(comb.size());
+      for (auto const& plane_cluster : comb)
+        tmp_index_v.push_back(cluster_array.at(plane_cluster.first).at(plane_cluster.second));
 
-      for (auto const& plane_cluster : comb) {
-        auto const& in_cluster_index =
-          cluster_array.at(plane_cluster.first).at(plane_cluster.second);
+      bool overlap = true;
+      for (size_t i = 0; overlap && !boxes.empty() && i < tmp_index_v.size(); ++i)
+        for (size_t j = i + 1; overlap && j < tmp_index_v.size(); ++j)
+          overlap = BoxesOverlap(boxes[tmp_index_v[i]], boxes[tmp_index_v[j]], true);
+      if (!overlap) continue;
 
-        tmp_index_v.push_back(in_cluster_index);
+      index_v.push_back(std::move(tmp_index_v));
+    }
 
+    auto const score_of = [&](const std::vector<unsigned int>& tmp_index_v) {
+      std::vector<const cluster::ClusterParamsAlg*> ptr_v;
+      ptr_v.reserve(tmp_index_v.size());
+      for (auto const& in_cluster_index : tmp_index_v)
         ptr_v.push_back(&(_in_clusters.at(in_cluster_index)));
-      }
+      return _match_algo->Float(gser, ptr_v);
+    };
 
-      if (_debug_mode <= kPerMerging) {
-        std::cout << "    \033[93m"
-                  << "Inspecting a pair (";
-        for (auto const& index : tmp_index_v)
-          std::cout << index << " ";
-        std::cout << ") \033[00m" << std::flush;
+    if (RunParallel()) {
 
-        localWatch.Start();
-      }
+      // Score all the combinations concurrently, then book them in order
+      std::vector<float> score_v(index_v.size());
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, index_v.size()),
+                        [&](const tbb::blocked_range<size_t>& range) {
+                          for (size_t i = range.begin(); i != range.end(); ++i)
+                            score_v[i] = score_of(index_v[i]);
+                        });
 
-      auto const& score = _match_algo->Float(gser, ptr_v);
+      for (size_t i = 0; i < index_v.size(); ++i)
+        if (score_v[i] > 0) _book_keeper.Match(index_v[i], score_v[i]);
+    }
+    else {
+
+      // Loop over combinations and call algorithm
+      for (auto const& tmp_index_v : index_v) {
 
-      if (_debug_mode <= kPerMerging)
-        std::cout << " ... Time taken = " << localWatch.RealTime() << " [s]" << std::endl;
+        if (_debug_mode <= kPerMerging) {
+          std::cout << "    \033[93m"
+                    << "Inspecting a pair (";
+          for (auto const& index : tmp_index_v)
+            std::cout << index << " ";
+          std::cout << ") \033[00m" << std::flush;
+
+          localWatch.Start();
+        }
 
-      if (score > 0) _book_keeper.Match(tmp_index_v, score);
+        auto const score = score_of(tmp_index_v);
+
+        if (_debug_mode <= kPerMerging)
+          std::cout << " ... Time taken = " << localWatch.RealTime() << " [s]" << std::endl;
+
+        if (score > 0) _book_keeper.Match(tmp_index_v, score);
+      }
     }
 
     if (_debug_mode <= kPerIteration) {
@@ -6,6 +6,11 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
 
 #include "lardata/Utilities/PxUtils.h"
 #include "larreco/RecoAlg/CMTool/CMToolBase/CBoolAlgoBase.h"
@@ -197,23 +202,18 @@ namespace cmtool {
           continue;
         }
 
-        size_t tmp_hit_counts = 0;
+        // the merged cluster inherits the averages of its parents
+        std::vector<const ::cluster::ClusterParamsAlg*> parents;
+        parents.reserve(indexes_v.size());
         for (auto const& index : indexes_v)
-          tmp_hit_counts += _tmp_merged_clusters.at(index).GetHitVector().size();
-        //std::vector<larutil::PxHit> tmp_hits;
-        std::vector<util::PxHit> tmp_hits;
-        tmp_hits.reserve(tmp_hit_counts);
-
-        for (auto const& index : indexes_v) {
-          for (auto const& hit : _tmp_merged_clusters.at(index).GetHitVector())
-            tmp_hits.push_back(hit);
-        }
+          parents.push_back(&_tmp_merged_clusters.at(index));
+
         _out_clusters.push_back(::cluster::ClusterParamsAlg());
         (*_out_clusters.rbegin()).SetVerbose(false);
         (*_out_clusters.rbegin()).DisableFANN();
 
-        if ((*_out_clusters.rbegin()).SetHits(tmp_hits) < 1) continue;
-        (*_out_clusters.rbegin()).FillParams(gser, true, true, true, true, true, false);
+        if ((*_out_clusters.rbegin()).SetHits(parents) < 1) continue;
+        (*_out_clusters.rbegin()).FillParams(gser);
         (*_out_clusters.rbegin()).FillPolygon(gser);
       }
       _book_keeper_v.push_back(bk);
@@ -252,7 +252,10 @@ namespace cmtool {
     // Merging
     //
 
-    // Run over clusters and execute merging algorithms
+    auto const boxes = ComputeBoxes(in_clusters);
+
+    // Pairs to inspect, in the order of the priority loop
+    std::vector<std::pair<size_t, size_t>> pairs;
     for (auto citer1 = _priority.rbegin(); citer1 != _priority.rend(); ++citer1) {
 
       auto citer2 = citer1;
@@ -270,19 +273,51 @@ namespace cmtool {
         // Skip if this combination is not meant to be compared
         if (!(merge_flag.at((*citer2).second)) && !(merge_flag.at((*citer1).second))) continue;
 
+        // Skip if the clusters are too far apart to be merged
+        if (!boxes.empty() && !BoxesOverlap(boxes[(*citer1).second], boxes[(*citer2).second]))
+          continue;
+
+        pairs.emplace_back((*citer1).second, (*citer2).second);
+      }
+    }
+
+    if (RunParallel()) {
+
+      // Evaluate all the pairs first; a pair that becomes prohibited by an earlier merge
+      // is then skipped when booking, in the same order as the serial loop
+      std::vector<char> merge_v(pairs.size(), false);
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, pairs.size()),
+                        [&](const tbb::blocked_range<size_t>& range) {
+                          for (size_t i = range.begin(); i != range.end(); ++i) {
+                            if (!book_keeper.MergeAllowed(pairs[i].first, pairs[i].second))
+                              continue;
+                            merge_v[i] = _merge_algo->Bool(in_clusters.at(pairs[i].first),
+                                                           in_clusters.at(pairs[i].second));
+                          }
+                        });
+
+      for (size_t i = 0; i < pairs.size(); ++i) {
+        if (merge_v[i] && book_keeper.MergeAllowed(pairs[i].first, pairs[i].second))
+          book_keeper.Merge(pairs[i].first, pairs[i].second);
+      }
+    }
+    else {
+
+      // Run over clusters and execute merging algorithms
+      for (auto const& [index1, index2] : pairs) {
+
         // Skip if this combination is not allowed to merge
-        if (!(book_keeper.MergeAllowed((*citer1).second, (*citer2).second))) continue;
+        if (!(book_keeper.MergeAllowed(index1, index2))) continue;
 
         if (_debug_mode <= kPerMerging) {
 
           std::cout << Form("    \033[93mInspecting a pair (%zu, %zu) for merging... \033[00m",
-                            (*citer1).second,
-                            (*citer2).second)
+                            index1,
+                            index2)
                     << std::endl;
         }
 
-        bool merge =
-          _merge_algo->Bool(in_clusters.at((*citer1).second), in_clusters.at((*citer2).second));
+        bool merge = _merge_algo->Bool(in_clusters.at(index1), in_clusters.at(index2));
 
         if (_debug_mode <= kPerMerging) {
 
@@ -294,11 +329,10 @@ namespace cmtool {
 
         } // end looping over all sets of algorithms
 
-        if (merge) book_keeper.Merge((*citer1).second, (*citer2).second);
-
-      } // end looping over all cluster pairs for citer1
+        if (merge) book_keeper.Merge(index1, index2);
 
-    } // end looping over clusters
+      } // end looping over all cluster pairs
+    }
 
     if (_debug_mode <= kPerIteration && book_keeper.GetResult().size() != in_clusters.size()) {
 
@@ -336,6 +370,32 @@ namespace cmtool {
     // Separation
     //
 
+    if (RunParallel()) {
+
+      // Evaluate the pairs of each first cluster concurrently, then book the separations
+      // in the order of the serial loop
+      std::vector<std::vector<size_t>> separate_v(in_clusters.size());
+      auto const inspect = [&](size_t cindex1) {
+        UChar_t plane1 = in_clusters.at(cindex1).Plane();
+        for (size_t cindex2 = cindex1 + 1; cindex2 < in_clusters.size(); ++cindex2) {
+          if (plane1 != in_clusters.at(cindex2).Plane()) continue;
+          if (_separate_algo->Bool(in_clusters.at(cindex1), in_clusters.at(cindex2)))
+            separate_v[cindex1].push_back(cindex2);
+        }
+      };
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, in_clusters.size()),
+                        [&](const tbb::blocked_range<size_t>& range) {
+                          for (size_t cindex1 = range.begin(); cindex1 != range.end(); ++cindex1)
+                            inspect(cindex1);
+                        });
+
+      for (size_t cindex1 = 0; cindex1 < in_clusters.size(); ++cindex1)
+        for (auto const cindex2 : separate_v[cindex1])
+          book_keeper.ProhibitMerge(cindex1, cindex2);
+
+      return;
+    }
+
     // Run over clusters and execute merging algorithms
     for (size_t cindex1 = 0; cindex1 < in_clusters.size(); ++cindex1) {
 
@@ -14,6 +14,7 @@
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <iterator> // std::make_move_iterator()
 
 // framework libraries
 #include "canvas/Utilities/Exception.h"
@@ -37,6 +38,9 @@
 #include "larevt/CalibrationDBI/Interface/ChannelStatusService.h"
 #include "larreco/RecoAlg/ClusterCrawlerAlg.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 namespace {
   struct CluLen {
     int index;
@@ -97,6 +101,7 @@ namespace cluster {
     fVertex2DCut = pset.get<float>("Vertex2DCut", 5);
     fVertex2DWireErrCut = pset.get<float>("Vertex2DWireErrCut", 5);
     fVertex3DCut = pset.get<float>("Vertex3DCut", 5);
+    fParallelPlanes = pset.get<bool>("ParallelPlanes", false);
 
     fDebugPlane = pset.get<int>("DebugPlane", -1);
     fDebugWire = pset.get<int>("DebugWire", -1);
@@ -226,51 +231,17 @@ namespace cluster {
       mergeAvailable[iht] = false;
     }
 
-    // FIXME (KJK): The 'cstat', 'tpc', and 'plane' class variables should be removed.
-    for (geo::TPCID const& tpcid : geom->Iterate<geo::TPCID>()) {
-      cstat = tpcid.Cryostat;
-      tpc = tpcid.TPC;
-      for (geo::PlaneID const& planeid : wireReadoutGeom->Iterate<geo::PlaneID>(tpcid)) {
-        plane = planeid.Plane;
-        WireHitRange.clear();
-        // define a code to ensure clusters are compared within the same plane
-        clCTP = EncodeCTP(tpcid.Cryostat, tpcid.TPC, planeid.Plane);
-        cstat = tpcid.Cryostat;
-        tpc = tpcid.TPC;
-        // fill the WireHitRange vector with first/last hit on each wire
-        // dead wires and wires with no hits are flagged < 0
-        GetHitRange(clCTP);
-
-        // sanity check
-        if (WireHitRange.empty() || (fFirstWire == fLastWire)) continue;
-        raw::ChannelID_t channel = fHits[fFirstHit].Channel();
-        // get the scale factor to convert dTick/dWire to dX/dU. This is used
-        // to make the kink and merging cuts
-        float wirePitch = wireReadoutGeom->Plane(tpcid, wireReadoutGeom->View(channel)).WirePitch();
-        float tickToDist = det_prop.DriftVelocity(det_prop.Efield(), det_prop.Temperature());
-        tickToDist *= 1.e-3 * sampling_rate(clock_data); // 1e-3 is conversion of 1/us to 1/ns
-        fScaleF = tickToDist / wirePitch;
-        // convert Large Angle Cluster crawling cut to a slope cut
-        if (fLAClusAngleCut > 0)
-          fLAClusSlopeCut = std::tan(3.142 * fLAClusAngleCut / 180.) / fScaleF;
-        fMaxTime = det_prop.NumberTimeSamples();
-        fNumWires = wireReadoutGeom->Nwires(planeid);
-        // look for clusters
-        if (fNumPass > 0) ClusterLoop();
-      } // plane
-      if (fVertex3DCut > 0) {
-        // Match vertices in 3 planes
-        VtxMatch(det_prop, tpcid);
-        Vtx3ClusterMatch(det_prop, tpcid);
-        if (fFindHammerClusters) FindHammerClusters(det_prop);
-        // split clusters using 3D vertices
-        Vtx3ClusterSplit(det_prop, tpcid);
-      }
-      if (fDebugPlane >= 0) {
-        mf::LogVerbatim("CC") << "Clustering done in TPC ";
-        PrintClusters();
-      }
-    } // for all tpcs
+    if (fParallelPlanes && fDebugPlane < 0) { CrawlPlanesParallel(clock_data, det_prop); }
+    else {
+      // FIXME (KJK): The 'cstat', 'tpc', and 'plane' class variables should be removed.
+      for (geo::TPCID const& tpcid : geom->Iterate<geo::TPCID>()) {
+        for (geo::PlaneID const& planeid : wireReadoutGeom->Iterate<geo::PlaneID>(tpcid)) {
+          // look for clusters
+          if (InitPlane(clock_data, det_prop, planeid, fHits[0].Channel())) ClusterLoop();
+        } // plane
+        MatchTPC(det_prop, tpcid);
+      } // for all tpcs
+    }
 
     // clean up
     WireHitRange.clear();
@@ -284,6 +255,164 @@ namespace cluster {
 
   } // RunCrawler
 
+  //------------------------------------------------------------------------------
+  bool ClusterCrawlerAlg::InitPlane(detinfo::DetectorClocksData const& clock_data,
+                                    detinfo::DetectorPropertiesData const& det_prop,
+                                    geo::PlaneID const& planeid,
+                                    raw::ChannelID_t pitchChannel)
+  {
+    cstat = planeid.Cryostat;
+    tpc = planeid.TPC;
+    plane = planeid.Plane;
+    WireHitRange.clear();
+    // define a code to ensure clusters are compared within the same plane
+    clCTP = EncodeCTP(planeid);
+    // fill the WireHitRange vector with first/last hit on each wire
+    // dead wires and wires with no hits are flagged < 0
+    GetHitRange(clCTP);
+
+    // sanity check
+    if (WireHitRange.empty() || (fFirstWire == fLastWire)) return false;
+    // get the scale factor to convert dTick/dWire to dX/dU. This is used
+    // to make the kink and merging cuts
+    float wirePitch =
+      wireReadoutGeom->Plane(planeid.asTPCID(), wireReadoutGeom->View(pitchChannel)).WirePitch();
+    float tickToDist = det_prop.DriftVelocity(det_prop.Efield(), det_prop.Temperature());
+    tickToDist *= 1.e-3 * sampling_rate(clock_data); // 1e-3 is conversion of 1/us to 1/ns
+    fScaleF = tickToDist / wirePitch;
+    // convert Large Angle Cluster crawling cut to a slope cut
+    if (fLAClusAngleCut > 0) fLAClusSlopeCut = std::tan(3.142 * fLAClusAngleCut / 180.) / fScaleF;
+    fMaxTime = det_prop.NumberTimeSamples();
+    fNumWires = wireReadoutGeom->Nwires(planeid);
+    return true;
+  } // InitPlane
+
+  //------------------------------------------------------------------------------
+  void ClusterCrawlerAlg::CrawlPlanesParallel(detinfo::DetectorClocksData const& clock_data,
+                                              detinfo::DetectorPropertiesData const& det_prop)
+  {
+    // Each plane is crawled in a copy of this algorithm that holds only the
+    // hits of that plane. The hits are sorted by plane, so that is a contiguous
+    // slice. The crawls are folded back in the order of the serial loop, which
+    // gives the same cluster and vertex indices, and the 3D vertex matching of
+    // a TPC is done once all of its planes are in. Unlike the serial loop, the
+    // crawl of a plane does not see the 2D vertices found in the planes before.
+    struct PlaneCrawl {
+      geo::TPCID tpcid;
+      unsigned int firstHit;
+      ClusterCrawlerAlg alg;
+      bool doCrawl;
+    };
+
+    // keep the hits out of the copies
+    std::vector<recob::Hit> hits = std::move(fHits);
+    fHits.clear();
+    inClus.clear();
+    mergeAvailable.clear();
+    // the serial loop takes the wire pitch from the view of the first hit
+    raw::ChannelID_t const pitchChannel = hits[0].Channel();
+
+    std::vector<PlaneCrawl> crawls;
+    for (geo::TPCID const& tpcid : geom->Iterate<geo::TPCID>()) {
+      for (geo::PlaneID const& planeid : wireReadoutGeom->Iterate<geo::PlaneID>(tpcid)) {
+        auto const first =
+          std::partition_point(hits.begin(), hits.end(), [&planeid](recob::Hit const& hit) {
+            return hit.WireID().asPlaneID() < planeid;
+          });
+        auto const last = std::partition_point(first, hits.end(), [&planeid](recob::Hit const& hit) {
+          return hit.WireID().asPlaneID() == planeid;
+        });
+        crawls.push_back({tpcid, (unsigned int)(first - hits.begin()), *this, false});
+        ClusterCrawlerAlg& alg = crawls.back().alg;
+        alg.fHits.assign(first, last);
+        alg.inClus.assign(alg.fHits.size(), 0);
+        alg.mergeAvailable.assign(alg.fHits.size(), false);
+        // the channel status lookup is done here, on the calling thread
+        crawls.back().doCrawl = alg.InitPlane(clock_data, det_prop, planeid, pitchChannel);
+      } // plane
+    }   // tpcid
+
+    fHits = std::move(hits);
+    inClus.assign(fHits.size(), 0);
+    mergeAvailable.assign(fHits.size(), false);
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, crawls.size()),
+                      [&crawls](const tbb::blocked_range<size_t>& range) {
+                        for (size_t icr = range.begin(); icr != range.end(); ++icr) {
+                          if (crawls[icr].doCrawl) crawls[icr].alg.ClusterLoop();
+                        }
+                      });
+
+    for (size_t icr = 0; icr < crawls.size(); ++icr) {
+      FoldPlaneCrawl(crawls[icr].alg, crawls[icr].firstHit);
+      if (icr + 1 < crawls.size() && crawls[icr + 1].tpcid == crawls[icr].tpcid) continue;
+      MatchTPC(det_prop, crawls[icr].tpcid);
+    } // icr
+
+  } // CrawlPlanesParallel
+
+  //------------------------------------------------------------------------------
+  void ClusterCrawlerAlg::FoldPlaneCrawl(ClusterCrawlerAlg& planeAlg, unsigned int hitOffset)
+  {
+    // The plane-local cluster IDs, vertex indices and hit indices start at 0
+    short const clOffset = tcl.size();
+    short const vtxOffset = vtx.size();
+    for (auto& clstr : planeAlg.tcl) {
+      clstr.ID += (clstr.ID < 0) ? -clOffset : clOffset;
+      if (clstr.BeginVtx >= 0) clstr.BeginVtx += vtxOffset;
+      if (clstr.EndVtx >= 0) clstr.EndVtx += vtxOffset;
+      for (auto& iht : clstr.tclhits)
+        iht += hitOffset;
+    } // clstr
+    for (unsigned int iht = 0; iht < planeAlg.fHits.size(); ++iht) {
+      fHits[hitOffset + iht] = std::move(planeAlg.fHits[iht]);
+      short const clID = planeAlg.inClus[iht];
+      inClus[hitOffset + iht] = (clID > 0) ? clID + clOffset : clID;
+      mergeAvailable[hitOffset + iht] = planeAlg.mergeAvailable[iht];
+    } // iht
+    tcl.insert(tcl.end(),
+               std::make_move_iterator(planeAlg.tcl.begin()),
+               std::make_move_iterator(planeAlg.tcl.end()));
+    vtx.insert(vtx.end(), planeAlg.vtx.begin(), planeAlg.vtx.end());
+
+    // take over the crawl state this plane left behind, as the serial loop does
+    for (auto& range : planeAlg.WireHitRange) {
+      if (range.first < 0) continue;
+      range.first += hitOffset;
+      range.second += hitOffset;
+    } // range
+    for (auto& iht : planeAlg.fcl2hits)
+      iht += hitOffset;
+    planeAlg.NClusters += clOffset;
+    planeAlg.fHits = std::move(fHits);
+    planeAlg.inClus = std::move(inClus);
+    planeAlg.mergeAvailable = std::move(mergeAvailable);
+    planeAlg.tcl = std::move(tcl);
+    planeAlg.vtx = std::move(vtx);
+    planeAlg.vtx3 = std::move(vtx3);
+    *this = std::move(planeAlg);
+  } // FoldPlaneCrawl
+
+  //------------------------------------------------------------------------------
+  void ClusterCrawlerAlg::MatchTPC(detinfo::DetectorPropertiesData const& det_prop,
+                                   geo::TPCID const& tpcid)
+  {
+    cstat = tpcid.Cryostat;
+    tpc = tpcid.TPC;
+    if (fVertex3DCut > 0) {
+      // Match vertices in 3 planes
+      VtxMatch(det_prop, tpcid);
+      Vtx3ClusterMatch(det_prop, tpcid);
+      if (fFindHammerClusters) FindHammerClusters(det_prop);
+      // split clusters using 3D vertices
+      Vtx3ClusterSplit(det_prop, tpcid);
+    }
+    if (fDebugPlane >= 0) {
+      mf::LogVerbatim("CC") << "Clustering done in TPC ";
+      PrintClusters();
+    }
+  } // MatchTPC
+
   ////////////////////////////////////////////////
   void ClusterCrawlerAlg::ClusterLoop()
   {
@@ -2293,6 +2422,8 @@ namespace cluster {
         dwje = 999;
         for (jv = 0; jv < vtx.size(); ++jv) {
           if (iv == jv) continue;
+          // a plane crawled on its own does not see the vertices of the other planes
+          if (fParallelPlanes && vtx[jv].CTP != clCTP) continue;
           if (std::abs(vtx[jv].Time - tcl[it].BeginTim) < 50) {
             if (std::abs(vtx[jv].Wire - tcl[it].BeginWir) < dwjb)
               dwjb = std::abs(vtx[jv].Wire - tcl[it].BeginWir);
@@ -4854,6 +4985,8 @@ namespace cluster {
         hit.Multiplicity() == 2) {
       bool doMerge = true;
       for (unsigned short ivx = 0; ivx < vtx.size(); ++ivx) {
+        // a plane crawled on its own does not see the vertices of the other planes
+        if (fParallelPlanes && vtx[ivx].CTP != clCTP) continue;
         if (std::abs(kwire - vtx[ivx].Wire) < 10 &&
             std::abs(int(hit.PeakTime() - vtx[ivx].Time)) < 20) {
           doMerge = false;
@@ -20,6 +20,7 @@
 // LArSoft libraries
 #include "larcore/Geometry/Geometry.h"
 #include "larcore/Geometry/WireReadout.h"
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h"
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
 #include "lardataobj/RecoBase/Hit.h"
 #include "larreco/RecoAlg/LinFitAlg.h"
@@ -191,6 +192,8 @@ namespace cluster {
     float fVertex2DCut; ///< 2D vtx -> cluster matching cut (chisq/dof)
     float fVertex2DWireErrCut;
     float fVertex3DCut; ///< 2D vtx -> 3D vtx matching cut (chisq/dof)
+    bool fParallelPlanes; ///< crawl each plane in its own context, concurrently, blind
+                          ///< to the 2D vertices of the other planes
 
     int fDebugPlane;
     int fDebugWire; ///< set to the Begin Wire and Hit of a cluster to print
@@ -295,6 +298,19 @@ namespace cluster {
     std::string fhitsModuleLabel;
     // ******** crawling routines *****************
 
+    // Prepares the hit range and scale factors for crawling a plane. Returns
+    // false if there is nothing to crawl
+    bool InitPlane(detinfo::DetectorClocksData const& clock_data,
+                   detinfo::DetectorPropertiesData const& det_prop,
+                   geo::PlaneID const& planeid,
+                   raw::ChannelID_t pitchChannel);
+    // Crawls all planes concurrently and does the 3D vertex matching per TPC
+    void CrawlPlanesParallel(detinfo::DetectorClocksData const& clock_data,
+                             detinfo::DetectorPropertiesData const& det_prop);
+    // Appends the results of a plane-local crawl whose hits start at hitOffset
+    void FoldPlaneCrawl(ClusterCrawlerAlg& planeAlg, unsigned int hitOffset);
+    // Runs the 3D vertex matching for a TPC once all of its planes are crawled
+    void MatchTPC(detinfo::DetectorPropertiesData const& det_prop, geo::TPCID const& tpcid);
     // Loops over wires looking for seed clusters
     void ClusterLoop();
     // Returns true if the hits on a cluster have a consistent width
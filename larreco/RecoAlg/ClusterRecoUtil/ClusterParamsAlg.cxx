@@ -1,20 +1,19 @@
 #include "ClusterParamsAlg.h"
 
 // LArSoft includes
-#include "lardata/Utilities/SimpleFits.h"       // LinearFit<>
-#include "lardataalg/Utilities/StatCollector.h" // StatCollector<>
+#include "lardata/Utilities/SimpleFits.h" // LinearFit<>
 
 //-----Math-------
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <iterator>
 #include <vector>
 
 #include "TCanvas.h"
 #include "TH1.h"
 #include "TLegend.h"
 #include "TMath.h"
-#include "TPrincipal.h"
 #include "TStopwatch.h"
 
 #include "lardata/Utilities/GeometryUtilities.h"
@@ -72,6 +71,49 @@ namespace cluster {
     return fHitVector.size();
   }
 
+  int ClusterParamsAlg::SetHits(const std::vector<const ClusterParamsAlg*>& parents)
+  {
+    Initialize();
+
+    size_t nHits = 0;
+    bool combine = true;
+    for (auto const* parent : parents) {
+      nHits += parent->fHitVector.size();
+      combine = combine && parent->fFinishedGetAverages;
+    }
+    if (!nHits) {
+      throw CRUException("Provided empty hit list!");
+      return -1;
+    }
+
+    TStopwatch localWatch;
+    localWatch.Start();
+
+    fHitVector.reserve(nHits);
+    for (auto const* parent : parents) {
+      fHitVector.insert(fHitVector.end(), parent->fHitVector.begin(), parent->fHitVector.end());
+      if (combine) fMoments.Merge(parent->fMoments);
+    }
+
+    fPlane = fHitVector[0].plane;
+
+    if (combine) {
+      FillAverages();
+      fFinishedGetAverages = true;
+      fTimeRecord_ProcName.push_back("GetAverages");
+      fTimeRecord_ProcTime.push_back(localWatch.RealTime());
+    }
+
+    if (fHitVector.size() < fMinNHits) {
+      if (verbose)
+        std::cout << " the hitlist is too small. Continuing to run may result in crash!!! "
+                  << std::endl;
+      return -1;
+    }
+
+    return fHitVector.size();
+  }
+
   void ClusterParamsAlg::SetPlane(int p)
   {
     fPlane = p;
@@ -162,6 +204,7 @@ namespace cluster {
     fChargeCutoffThreshold.push_back(1000);
 
     fHitVector.clear();
+    fMoments = HitMoments_t();
 
     fParams.Clear();
 
@@ -202,66 +245,138 @@ namespace cluster {
     TStopwatch localWatch;
     localWatch.Start();
 
-    TPrincipal fPrincipal(2, "D");
+    fMoments = HitMoments_t();
+    fMoments.wires.reserve(fHitVector.size());
 
-    fParams.N_Hits = fHitVector.size();
+    for (auto& hit : fHitVector) {
+      // running means and centred moments of the coordinates (Welford)
+      fMoments.n += 1.;
+      const double dw = hit.w - fMoments.mean_w;
+      const double dt = hit.t - fMoments.mean_t;
+      fMoments.mean_w += dw / fMoments.n;
+      fMoments.mean_t += dt / fMoments.n;
+      fMoments.m2_ww += dw * (hit.w - fMoments.mean_w);
+      fMoments.m2_tt += dt * (hit.t - fMoments.mean_t);
+      fMoments.m2_wt += dw * (hit.t - fMoments.mean_t);
+
+      fMoments.sum_charge += hit.charge;
+      fMoments.sum_charge2 += hit.charge * hit.charge;
+      fMoments.sum_ADC += hit.sumADC;
+      fMoments.sum_ADC2 += hit.sumADC * hit.sumADC;
+      fMoments.sum_wq += hit.w * hit.charge;
+      fMoments.sum_tq += hit.t * hit.charge;
+      fMoments.wires.emplace_back(hit.w, 1);
+    }
 
-    std::map<double, int> wireMap;
+    // collapse the wire list into hit counts per wire
+    auto& wires = fMoments.wires;
+    std::sort(wires.begin(), wires.end());
+    if (!wires.empty()) {
+      auto iLast = wires.begin();
+      for (auto iWire = std::next(iLast); iWire != wires.end(); ++iWire) {
+        if (iWire->first == iLast->first)
+          ++(iLast->second);
+        else
+          *(++iLast) = *iWire;
+      }
+      wires.erase(std::next(iLast), wires.end());
+    }
 
-    lar::util::StatCollector<double> charge, sumADC;
+    FillAverages();
 
-    int uniquewires = 0;
-    int multi_hit_wires = 0;
-    for (auto& hit : fHitVector) {
-      double data[2];
-      data[0] = hit.w;
-      data[1] = hit.t;
-      fPrincipal.AddRow(data);
-      fParams.charge_wgt_x += hit.w * hit.charge;
-      fParams.charge_wgt_y += hit.t * hit.charge;
-      charge.add(hit.charge);
-      sumADC.add(hit.sumADC);
+    fFinishedGetAverages = true;
+
+    fTimeRecord_ProcName.push_back("GetAverages");
+    fTimeRecord_ProcTime.push_back(localWatch.RealTime());
+  }
+
+  void ClusterParamsAlg::HitMoments_t::Merge(const HitMoments_t& other)
+  {
+    if (other.n == 0.) return;
+    if (n == 0.) {
+      *this = other;
+      return;
+    }
 
-      if (wireMap[hit.w] == 0) { uniquewires++; }
-      if (wireMap[hit.w] == 1) { multi_hit_wires++; }
-      wireMap[hit.w]++;
+    // pairwise update of the centred moments (Chan et al.)
+    const double total = n + other.n;
+    const double dw = other.mean_w - mean_w;
+    const double dt = other.mean_t - mean_t;
+    const double f = n * other.n / total;
+    m2_ww += other.m2_ww + dw * dw * f;
+    m2_tt += other.m2_tt + dt * dt * f;
+    m2_wt += other.m2_wt + dw * dt * f;
+    mean_w += dw * other.n / total;
+    mean_t += dt * other.n / total;
+    n = total;
+
+    sum_charge += other.sum_charge;
+    sum_charge2 += other.sum_charge2;
+    sum_ADC += other.sum_ADC;
+    sum_ADC2 += other.sum_ADC2;
+    sum_wq += other.sum_wq;
+    sum_tq += other.sum_tq;
+
+    std::vector<std::pair<double, int>> merged;
+    merged.reserve(wires.size() + other.wires.size());
+    auto iWire = wires.cbegin(), iOther = other.wires.cbegin();
+    while (iWire != wires.cend() || iOther != other.wires.cend()) {
+      if (iOther == other.wires.cend() ||
+          (iWire != wires.cend() && iWire->first < iOther->first))
+        merged.push_back(*(iWire++));
+      else if (iWire == wires.cend() || iOther->first < iWire->first)
+        merged.push_back(*(iOther++));
+      else {
+        merged.emplace_back(iWire->first, iWire->second + iOther->second);
+        ++iWire;
+        ++iOther;
+      }
     }
+    wires = std::move(merged);
+  }
+
+  void ClusterParamsAlg::FillAverages()
+  {
+    const double n = fMoments.n;
 
-    fParams.sum_charge = charge.Sum();
-    fParams.mean_charge = charge.Average();
-    fParams.rms_charge = charge.RMS();
+    fParams.N_Hits = n;
 
-    fParams.sum_ADC = sumADC.Sum();
-    fParams.mean_ADC = sumADC.Average();
-    fParams.rms_ADC = sumADC.RMS();
+    fParams.sum_charge = fMoments.sum_charge;
+    fParams.mean_charge = fMoments.sum_charge / n;
+    fParams.rms_charge = std::sqrt(
+      std::max(0., (fMoments.sum_charge2 - cet::square(fMoments.sum_charge) / n) / n));
 
-    fParams.N_Wires = uniquewires;
-    fParams.multi_hit_wires = multi_hit_wires;
+    fParams.sum_ADC = fMoments.sum_ADC;
+    fParams.mean_ADC = fMoments.sum_ADC / n;
+    fParams.rms_ADC =
+      std::sqrt(std::max(0., (fMoments.sum_ADC2 - cet::square(fMoments.sum_ADC) / n) / n));
 
-    if (fPrincipal.GetMeanValues()->GetNrows() < 2) { throw cluster::CRUException(); }
+    fParams.N_Wires = fMoments.wires.size();
+    fParams.multi_hit_wires = std::count_if(fMoments.wires.begin(),
+                                            fMoments.wires.end(),
+                                            [](std::pair<double, int> const& w) {
+                                              return w.second > 1;
+                                            });
 
-    fParams.mean_x = (*fPrincipal.GetMeanValues())[0];
-    fParams.mean_y = (*fPrincipal.GetMeanValues())[1];
-    fParams.mean_charge = fParams.sum_charge / fParams.N_Hits;
+    fParams.mean_x = fMoments.mean_w;
+    fParams.mean_y = fMoments.mean_t;
 
     if (fParams.sum_charge != 0.) {
-      fParams.charge_wgt_x /= fParams.sum_charge;
-      fParams.charge_wgt_y /= fParams.sum_charge;
+      fParams.charge_wgt_x = fMoments.sum_wq / fParams.sum_charge;
+      fParams.charge_wgt_y = fMoments.sum_tq / fParams.sum_charge;
     }
     else { // "SNAFU"; use the mean
       fParams.charge_wgt_x = fParams.mean_x;
       fParams.charge_wgt_y = fParams.mean_y;
     }
 
-    fPrincipal.MakePrincipals();
-
-    fParams.eigenvalue_principal = (*fPrincipal.GetEigenValues())[0];
-    fParams.eigenvalue_secondary = (*fPrincipal.GetEigenValues())[1];
-
-    fFinishedGetAverages = true;
-
-    fTimeRecord_ProcName.push_back("GetAverages");
-    fTimeRecord_ProcTime.push_back(localWatch.RealTime());
+    // principal components of the (wire, time) covariance matrix,
+    // normalised to its trace as TPrincipal does
+    const double trace = fMoments.m2_ww + fMoments.m2_tt;
+    const double spread =
+      std::hypot(0.5 * (fMoments.m2_ww - fMoments.m2_tt), fMoments.m2_wt) / trace;
+    fParams.eigenvalue_principal = 0.5 + spread;
+    fParams.eigenvalue_secondary = std::abs(0.5 - spread);
   }
 
   // Also does the high hitlist
@@ -10,6 +10,7 @@
 #define CLUSTERPARAMSALG_H
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "lardata/Utilities/PxUtils.h"
@@ -34,6 +35,17 @@ namespace cluster {
 
     int SetHits(const std::vector<util::PxHit>&);
 
+    /**
+     * @brief Sets the hits as the union of the hits of the specified clusters
+     * @param parents the clusters being merged
+     * @return the number of hits, or -1 if they are fewer than MinNHits()
+     *
+     * If all the parents have already run GetAverages(), the averages of the
+     * merged cluster are combined from theirs rather than recomputed from the
+     * hits. All other quantities are left to be computed on demand.
+     */
+    int SetHits(const std::vector<const ClusterParamsAlg*>& parents);
+
     void SetRefineDirectionQMin(double qmin) { fQMinRefDir = qmin; }
 
     void SetVerbose(bool yes = true) { verbose = yes; }
@@ -92,6 +104,7 @@ namespace cluster {
        eigenvalue_secondary
        multi_hit_wires
        N_Wires
+       The result is cached until the hits change.
        @param override force recalculation of variables
     */
     void GetAverages(bool override = false);
@@ -232,6 +245,22 @@ namespace cluster {
     void SetPlane(int p);
 
   protected:
+    /// Hit sums behind GetAverages(), which can be combined across clusters
+    struct HitMoments_t {
+      double n = 0.;
+      double sum_charge = 0., sum_charge2 = 0.;
+      double sum_ADC = 0., sum_ADC2 = 0.;
+      double sum_wq = 0., sum_tq = 0.;           ///< charge weighted coordinates
+      double mean_w = 0., mean_t = 0.;           ///< coordinate means
+      double m2_ww = 0., m2_tt = 0., m2_wt = 0.; ///< centred second moments
+      std::vector<std::pair<double, int>> wires; ///< hits per wire, sorted by wire
+
+      void Merge(const HitMoments_t& other);
+    };
+
+    /// Fills the GetAverages() variables from fMoments
+    void FillAverages();
+
     /// Cut value for # hits: below this value clusters are not evaluated
     size_t fMinNHits;
 
@@ -241,6 +270,8 @@ namespace cluster {
     */
     std::vector<util::PxHit> fHitVector;
 
+    HitMoments_t fMoments;
+
     // bool to control debug/verbose mode defaults to off.
     bool verbose;
 
@@ -35,6 +35,11 @@
 #include "larcorealg/Geometry/TPCGeo.h"
 #include "larcorealg/Geometry/WireReadoutGeom.h"
 
+#include "TF2.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 // NOTE: In the .h file I assumed this would belong in the cluster class....if
 // we decide otherwise we will need to search and replace for this
 
@@ -67,25 +72,46 @@ corner::CornerFinderAlg::CornerFinderAlg(fhicl::ParameterSet const& pset)
                                fDerivative_BlurNeighborhood,
                                fCornerScore_neighborhood,
                                fMaxSuppress_neighborhood});
+
+  if (fDerivative_BlurNeighborhood > 10) {
+    mf::LogWarning("CornerFinderAlg")
+      << "WARNING...BlurNeighborhoods>10 not currently allowed. Shrinking to 10.";
+    fDerivative_BlurNeighborhood = 10;
+  }
+
+  // The conversion function is only evaluated at the integer offsets of the neighborhood.
+  // Tabulate it here, so that no named TF2 is created in ROOT's global list by the
+  // (concurrent) image conversions.
+  if (fConversion_algorithm.compare("function") == 0) {
+    const TF2 fConversion_TF2("fConversion_func", fConversion_func.c_str(), -20, 20, -20, 20);
+    const int n = fConversion_func_neighborhood;
+    fConversion_kernel.reserve((2 * n + 1) * (2 * n + 1));
+    for (int dx = -n; dx <= n; dx++) {
+      for (int dy = -n; dy <= n; dy++)
+        fConversion_kernel.push_back(fConversion_TF2.Eval(dx, dy));
+    }
+  }
 }
 
 //-----------------------------------------------------------------------------
 void corner::CornerFinderAlg::InitializeGeometry(geo::WireReadoutGeom const& wireReadoutGeom)
 {
   // Reset containers
-  WireData_histos.clear();
-  WireData_histos_ProjectionX.clear();
-  WireData_histos_ProjectionY.clear();
+  WireData_images.clear();
+  WireData_images_ProjectionX.clear();
+  WireData_images_ProjectionY.clear();
   WireData_IDs.clear();
+  WireData_histos.clear();
 
-  WireData_trimmed_histos.clear();
+  WireData_trimmed_images.clear();
 
-  // set the sizes of the WireData_histos and WireData_IDs
+  // set the sizes of the WireData_images and WireData_IDs
   constexpr geo::TPCID tpcid{0, 0};
   unsigned int nPlanes = wireReadoutGeom.Nplanes(tpcid);
+  WireData_images.resize(nPlanes);
+  WireData_images_ProjectionX.resize(nPlanes);
+  WireData_images_ProjectionY.resize(nPlanes);
   WireData_histos.resize(nPlanes);
-  WireData_histos_ProjectionX.resize(nPlanes);
-  WireData_histos_ProjectionY.resize(nPlanes);
 
   /* For now, we need something to associate each wire in the histogram with a wire_id.
      This is not a beautiful way of handling this, but for now it should work. */
@@ -93,7 +119,7 @@ void corner::CornerFinderAlg::InitializeGeometry(geo::WireReadoutGeom const& wir
   for (auto const& planeid : wireReadoutGeom.Iterate<geo::PlaneID>(tpcid))
     WireData_IDs[planeid.Plane].resize(wireReadoutGeom.Nwires(planeid));
 
-  WireData_trimmed_histos.resize(0);
+  WireData_trimmed_images.resize(0);
 }
 
 //-----------------------------------------------------------------------------
@@ -104,32 +130,13 @@ void corner::CornerFinderAlg::GrabWires(std::vector<recob::Wire> const& wireVec,
 
   const unsigned int nTimeTicks = wireVec.at(0).NSignal();
 
-  // Initialize the histograms.
-  // All of this should eventually be changed to not need to use histograms...
+  // Initialize the images, binned like the histograms they replace: wire and tick
+  // numbers are bin numbers, so wire 0 and tick 0 land in the underflow bins
   constexpr geo::TPCID tpcid{0, 0};
   for (auto const& planeid : wireReadoutGeom.Iterate<geo::PlaneID>(tpcid)) {
-    auto const i_plane = planeid.Plane;
-
-    std::stringstream ss_tmp_name, ss_tmp_title;
-    ss_tmp_name << "h_WireData_" << i_plane;
-    ss_tmp_title << fCalDataModuleLabel << " wire data for plane " << i_plane
-                 << ";Wire Number;Time Tick";
-
     auto const num_wires = wireReadoutGeom.Nwires(planeid);
-    if (static_cast<unsigned int>(WireData_histos[i_plane].GetNbinsX()) == num_wires) {
-      WireData_histos[i_plane].Reset();
-      WireData_histos[i_plane].SetName(ss_tmp_name.str().c_str());
-      WireData_histos[i_plane].SetTitle(ss_tmp_title.str().c_str());
-    }
-    else
-      WireData_histos[i_plane] = TH2F(ss_tmp_name.str().c_str(),
-                                      ss_tmp_title.str().c_str(),
-                                      num_wires,
-                                      0,
-                                      num_wires,
-                                      nTimeTicks,
-                                      0,
-                                      nTimeTicks);
+    WireData_images[planeid.Plane] =
+      WireDataImage(num_wires, 0, num_wires, nTimeTicks, 0, nTimeTicks);
   }
 
   /* Now do the loop over the wires. */
@@ -150,15 +157,28 @@ void corner::CornerFinderAlg::GrabWires(std::vector<recob::Wire> const& wireVec,
 
     WireData_IDs.at(i_plane).at(i_wire) = this_wireID;
 
+    WireDataImage& image = WireData_images.at(i_plane);
+    std::vector<float> const signal = wire.Signal();
     for (unsigned int i_time = 0; i_time < nTimeTicks; i_time++) {
-      WireData_histos.at(i_plane).SetBinContent(i_wire, i_time, wire.Signal().at(i_time));
+      image.SetBinContent(i_wire, i_time, signal.at(i_time));
     } //<---End time loop
 
   } //<-- End loop over wires
 
+  // Projections over all bins, under- and overflow included
   for (unsigned int i_plane = 0; i_plane < wireReadoutGeom.Nplanes(); i_plane++) {
-    WireData_histos_ProjectionX.at(i_plane) = *(WireData_histos.at(i_plane).ProjectionX());
-    WireData_histos_ProjectionY.at(i_plane) = *(WireData_histos.at(i_plane).ProjectionY());
+    WireDataImage const& image = WireData_images.at(i_plane);
+    std::vector<double>& projectionX = WireData_images_ProjectionX.at(i_plane);
+    std::vector<double>& projectionY = WireData_images_ProjectionY.at(i_plane);
+    projectionX.assign(image.GetNbinsX() + 2, 0.);
+    projectionY.assign(image.GetNbinsY() + 2, 0.);
+    for (int iy = 0; iy <= image.GetNbinsY() + 1; iy++) {
+      float const* row = image.Row(iy);
+      for (int ix = 0; ix <= image.GetNbinsX() + 1; ix++) {
+        projectionX[ix] += row[ix];
+        projectionY[iy] += row[ix];
+      }
+    }
   }
 }
 
@@ -167,12 +187,26 @@ void corner::CornerFinderAlg::GrabWires(std::vector<recob::Wire> const& wireVec,
 void corner::CornerFinderAlg::get_feature_points(std::vector<recob::EndPoint2D>& corner_vector,
                                                  geo::WireReadoutGeom const& wireReadoutGeom)
 {
-  for (auto const& pid : wireReadoutGeom.Iterate<geo::PlaneID>()) {
-    attach_feature_points(WireData_histos.at(pid.Plane),
-                          WireData_IDs.at(pid.Plane),
-                          wireReadoutGeom.Plane(pid).View(),
-                          corner_vector);
-  }
+  std::vector<geo::PlaneID> planes;
+  for (auto const& pid : wireReadoutGeom.Iterate<geo::PlaneID>())
+    planes.push_back(pid);
+
+  // the planes are independent
+  std::vector<std::vector<recob::EndPoint2D>> plane_corners(planes.size());
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, planes.size()),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t i = range.begin(); i < range.end(); ++i) {
+                        auto const& pid = planes[i];
+                        attach_feature_points(WireData_images.at(pid.Plane),
+                                              WireData_IDs.at(pid.Plane),
+                                              wireReadoutGeom.Plane(pid).View(),
+                                              plane_corners[i]);
+                      }
+                    });
+
+  // the points of all the planes, in plane order
+  for (auto const& corners : plane_corners)
+    corner_vector.insert(corner_vector.end(), corners.begin(), corners.end());
 }
 
 //-----------------------------------------------------------------------------------
@@ -183,28 +217,38 @@ void corner::CornerFinderAlg::get_feature_points_fast(std::vector<recob::EndPoin
 {
   create_smaller_histos(wireReadoutGeom);
 
+  // (trimmed image, view) pairs, processed in parallel and collected in this order
+  std::vector<std::pair<size_t, geo::View_t>> jobs;
   for (auto const& cryostat : my_geometry.Iterate<geo::CryostatGeo>()) {
     for (unsigned int tpc = 0; tpc < cryostat.NTPC(); ++tpc) {
-      for (size_t histos = 0; histos != WireData_trimmed_histos.size(); histos++) {
-
-        unsigned int plane = std::get<0>(WireData_trimmed_histos.at(histos));
-        int startx = std::get<2>(WireData_trimmed_histos.at(histos));
-        int starty = std::get<3>(WireData_trimmed_histos.at(histos));
+      for (size_t histos = 0; histos != WireData_trimmed_images.size(); histos++) {
+        unsigned int plane = std::get<0>(WireData_trimmed_images.at(histos));
+        jobs.emplace_back(histos,
+                          wireReadoutGeom.Plane({cryostat.ID().Cryostat, tpc, plane}).View());
+      }
+    }
+  }
 
-        MF_LOG_DEBUG("CornerFinderAlg") << "Doing histogram " << histos << ", of plane " << plane
-                                        << " with start points " << startx << " " << starty;
+  std::vector<std::vector<recob::EndPoint2D>> job_corners(jobs.size());
+  tbb::parallel_for(
+    tbb::blocked_range<size_t>(0, jobs.size()), [&](const tbb::blocked_range<size_t>& range) {
+      for (size_t i = range.begin(); i < range.end(); ++i) {
+        auto const& [plane, image, startx, starty] = WireData_trimmed_images.at(jobs[i].first);
 
-        attach_feature_points(std::get<1>(WireData_trimmed_histos.at(histos)),
-                              WireData_IDs.at(plane),
-                              wireReadoutGeom.Plane({cryostat.ID().Cryostat, tpc, plane}).View(),
-                              corner_vector,
-                              startx,
-                              starty);
+        MF_LOG_DEBUG("CornerFinderAlg") << "Doing histogram " << jobs[i].first << ", of plane "
+                                        << plane << " with start points " << startx << " "
+                                        << starty;
 
-        MF_LOG_DEBUG("CornerFinderAlg") << "Total feature points now is " << corner_vector.size();
+        attach_feature_points(
+          image, WireData_IDs.at(plane), jobs[i].second, job_corners[i], startx, starty);
       }
-    }
-  }
+    });
+
+  // the points of all the images, in image order
+  for (auto const& corners : job_corners)
+    corner_vector.insert(corner_vector.end(), corners.begin(), corners.end());
+
+  MF_LOG_DEBUG("CornerFinderAlg") << "Total feature points now is " << corner_vector.size();
 }
 
 //-----------------------------------------------------------------------------------
@@ -214,12 +258,24 @@ void corner::CornerFinderAlg::get_feature_points_LineIntegralScore(
   std::vector<recob::EndPoint2D>& corner_vector,
   geo::WireReadoutGeom const& wireReadoutGeom)
 {
-  for (auto const& pid : wireReadoutGeom.Iterate<geo::PlaneID>()) {
-    attach_feature_points_LineIntegralScore(WireData_histos.at(pid.Plane),
-                                            WireData_IDs.at(pid.Plane),
-                                            wireReadoutGeom.Plane(pid).View(),
-                                            corner_vector);
-  }
+  std::vector<geo::PlaneID> planes;
+  for (auto const& pid : wireReadoutGeom.Iterate<geo::PlaneID>())
+    planes.push_back(pid);
+
+  std::vector<std::vector<recob::EndPoint2D>> plane_corners(planes.size());
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, planes.size()),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t i = range.begin(); i < range.end(); ++i) {
+                        auto const& pid = planes[i];
+                        attach_feature_points_LineIntegralScore(WireData_images.at(pid.Plane),
+                                                                WireData_IDs.at(pid.Plane),
+                                                                wireReadoutGeom.Plane(pid).View(),
+                                                                plane_corners[i]);
+                      }
+                    });
+
+  for (auto const& corners : plane_corners)
+    corner_vector.insert(corner_vector.end(), corners.begin(), corners.end());
 }
 
 namespace {
@@ -238,22 +294,25 @@ void corner::CornerFinderAlg::create_smaller_histos(geo::WireReadoutGeom const&
 
     MF_LOG_DEBUG("CornerFinderAlg") << "Working plane " << pid.Plane << ".";
 
-    int x_bins = WireData_histos_ProjectionX.at(pid.Plane).GetNbinsX();
-    int y_bins = WireData_histos_ProjectionY.at(pid.Plane).GetNbinsX();
+    WireDataImage const& image = WireData_images.at(pid.Plane);
+    std::vector<double> const& projectionX = WireData_images_ProjectionX.at(pid.Plane);
+    std::vector<double> const& projectionY = WireData_images_ProjectionY.at(pid.Plane);
+    int x_bins = image.GetNbinsX();
+    int y_bins = image.GetNbinsY();
 
     std::vector<int> cut_points_x{0};
     std::vector<int> cut_points_y{0};
 
     for (int ix = 1; ix <= x_bins; ix++) {
 
-      float this_value = WireData_histos_ProjectionX.at(pid.Plane).GetBinContent(ix);
+      float this_value = projectionX[ix];
 
       if (ix < fTrimming_buffer || ix > (x_bins - fTrimming_buffer)) continue;
 
       int jx = ix - fTrimming_buffer;
       while (this_value < fTrimming_threshold) {
         if (jx == ix + fTrimming_buffer) break;
-        this_value = WireData_histos_ProjectionX.at(pid.Plane).GetBinContent(jx);
+        this_value = projectionX[jx];
         jx++;
       }
       if (this_value < fTrimming_threshold) { cut_points_x.push_back(ix); }
@@ -261,14 +320,14 @@ void corner::CornerFinderAlg::create_smaller_histos(geo::WireReadoutGeom const&
 
     for (int iy = 1; iy <= y_bins; iy++) {
 
-      float this_value = WireData_histos_ProjectionY.at(pid.Plane).GetBinContent(iy);
+      float this_value = projectionY[iy];
 
       if (iy < fTrimming_buffer || iy > (y_bins - fTrimming_buffer)) continue;
 
       int jy = iy - fTrimming_buffer;
       while (this_value < fTrimming_threshold) {
         if (jy == iy + fTrimming_buffer) break;
-        this_value = WireData_histos_ProjectionY.at(pid.Plane).GetBinContent(jy);
+        this_value = projectionY[jy];
         jy++;
       }
       if (this_value < fTrimming_threshold) { cut_points_y.push_back(iy); }
@@ -298,9 +357,9 @@ void corner::CornerFinderAlg::create_smaller_histos(geo::WireReadoutGeom const&
 
         if (cut_points_x.at(0) <= x_low.at(il) || cut_points_x.at(0) >= x_high.at(il)) continue;
 
-        double integral_low = WireData_histos.at(pid.Plane).Integral(
+        double integral_low = image.Integral(
           x_low.at(il), cut_points_x.at(0), y_low.at(il), y_high.at(il));
-        double integral_high = WireData_histos.at(pid.Plane).Integral(
+        double integral_high = image.Integral(
           cut_points_x.at(0), x_high.at(il), y_low.at(il), y_high.at(il));
         if (integral_low > fTrimming_totalThreshold && integral_high > fTrimming_totalThreshold) {
           x_low.push_back(cut_points_x.at(0));
@@ -332,9 +391,9 @@ void corner::CornerFinderAlg::create_smaller_histos(geo::WireReadoutGeom const&
 
         if (cut_points_y.at(0) <= y_low.at(il) || cut_points_y.at(0) >= y_high.at(il)) continue;
 
-        double integral_low = WireData_histos.at(pid.Plane).Integral(
+        double integral_low = image.Integral(
           x_low.at(il), x_high.at(il), y_low.at(il), cut_points_y.at(0));
-        double integral_high = WireData_histos.at(pid.Plane).Integral(
+        double integral_high = image.Integral(
           x_low.at(il), x_high.at(il), cut_points_y.at(0), y_high.at(il));
         if (integral_low > fTrimming_totalThreshold && integral_high > fTrimming_totalThreshold) {
           y_low.push_back(cut_points_y.at(0));
@@ -372,38 +431,32 @@ void corner::CornerFinderAlg::create_smaller_histos(geo::WireReadoutGeom const&
 
     MF_LOG_DEBUG("CornerFinderAlg")
       << "\nIntegral on the SW side is "
-      << WireData_histos.at(pid.Plane).Integral(1, cut_points_x.at(0), 1, cut_points_y.at(0))
+      << image.Integral(1, cut_points_x.at(0), 1, cut_points_y.at(0))
       << "\nIntegral on the SE side is "
-      << WireData_histos.at(pid.Plane).Integral(cut_points_x.at(0), x_bins, 1, cut_points_y.at(0))
+      << image.Integral(cut_points_x.at(0), x_bins, 1, cut_points_y.at(0))
       << "\nIntegral on the NW side is "
-      << WireData_histos.at(pid.Plane).Integral(1, cut_points_x.at(0), cut_points_y.at(0), y_bins)
+      << image.Integral(1, cut_points_x.at(0), cut_points_y.at(0), y_bins)
       << "\nIntegral on the NE side is "
-      << WireData_histos.at(pid.Plane).Integral(
+      << image.Integral(
            cut_points_x.at(0), x_bins, cut_points_y.at(0), y_bins);
 
     for (size_t il = 0; il < x_low.size(); il++) {
 
-      std::stringstream h_name;
-      h_name << "h_" << pid.Cryostat << "_" << pid.TPC << "_" << pid.Plane << "_sub" << il;
-      TH2F h_tmp((h_name.str()).c_str(),
-                 "",
-                 x_high.at(il) - x_low.at(il) + 1,
-                 x_low.at(il),
-                 x_high.at(il),
-                 y_high.at(il) - y_low.at(il) + 1,
-                 y_low.at(il),
-                 y_high.at(il));
+      WireDataImage h_tmp(x_high.at(il) - x_low.at(il) + 1,
+                          x_low.at(il),
+                          x_high.at(il),
+                          y_high.at(il) - y_low.at(il) + 1,
+                          y_low.at(il),
+                          y_high.at(il));
 
       for (int ix = 1; ix <= (x_high.at(il) - x_low.at(il) + 1); ix++) {
         for (int iy = 1; iy <= (y_high.at(il) - y_low.at(il) + 1); iy++) {
-          h_tmp.SetBinContent(ix,
-                              iy,
-                              WireData_histos.at(pid.Plane).GetBinContent(x_low.at(il) + (ix - 1),
-                                                                          y_low.at(il) + (iy - 1)));
+          h_tmp.SetBinContent(
+            ix, iy, image.GetBinContent(x_low.at(il) + (ix - 1), y_low.at(il) + (iy - 1)));
         }
       }
 
-      WireData_trimmed_histos.push_back(
+      WireData_trimmed_images.push_back(
         std::make_tuple(pid.Plane, h_tmp, x_low.at(il) - 1, y_low.at(il) - 1));
     }
 
@@ -412,183 +465,70 @@ void corner::CornerFinderAlg::create_smaller_histos(geo::WireReadoutGeom const&
 
 //-----------------------------------------------------------------------------
 // This puts on all the feature points in a given view, using a given data histogram
-void corner::CornerFinderAlg::attach_feature_points(TH2F const& h_wire_data,
+void corner::CornerFinderAlg::attach_feature_points(WireDataImage const& h_wire_data,
                                                     std::vector<geo::WireID> const& wireIDs,
                                                     geo::View_t view,
                                                     std::vector<recob::EndPoint2D>& corner_vector,
                                                     int startx,
-                                                    int starty)
+                                                    int starty) const
 {
   const int x_bins = h_wire_data.GetNbinsX();
-  const float x_min = h_wire_data.GetXaxis()->GetBinLowEdge(1);
-  const float x_max = h_wire_data.GetXaxis()->GetBinUpEdge(x_bins);
-
   const int y_bins = h_wire_data.GetNbinsY();
-  const float y_min = h_wire_data.GetYaxis()->GetBinLowEdge(1);
-  const float y_max = h_wire_data.GetYaxis()->GetBinUpEdge(y_bins);
 
   const int converted_y_bins = y_bins / fConversion_bins_per_input_y;
   const int converted_x_bins = x_bins / fConversion_bins_per_input_x;
 
-  std::stringstream conversion_name;
-  conversion_name << "h_conversion_" << view << "_" << run_number << "_" << event_number;
-  std::stringstream dx_name;
-  dx_name << "h_derivative_x_" << view << "_" << run_number << "_" << event_number;
-  std::stringstream dy_name;
-  dy_name << "h_derivative_y_" << view << "_" << run_number << "_" << event_number;
-  std::stringstream cornerScore_name;
-  cornerScore_name << "h_cornerScore_" << view << "_" << run_number << "_" << event_number;
-  std::stringstream maxSuppress_name;
-  maxSuppress_name << "h_maxSuppress_" << view << "_" << run_number << "_" << event_number;
-
-  TH2F conversion_histo(conversion_name.str().c_str(),
-                        "Image Conversion Histogram",
-                        converted_x_bins,
-                        x_min,
-                        x_max,
-                        converted_y_bins,
-                        y_min,
-                        y_max);
-
-  TH2F derivativeX_histo(dx_name.str().c_str(),
-                         "Partial Derivatives (x)",
-                         converted_x_bins,
-                         x_min,
-                         x_max,
-                         converted_y_bins,
-                         y_min,
-                         y_max);
-
-  TH2F derivativeY_histo(dy_name.str().c_str(),
-                         "Partial Derivatives (y)",
-                         converted_x_bins,
-                         x_min,
-                         x_max,
+  auto make_image = [&]() {
+    return WireDataImage(converted_x_bins,
+                         h_wire_data.GetXlow(),
+                         h_wire_data.GetXup(),
                          converted_y_bins,
-                         y_min,
-                         y_max);
-
-  TH2D cornerScore_histo(cornerScore_name.str().c_str(),
-                         "Corner Score",
-                         converted_x_bins,
-                         x_min,
-                         x_max,
-                         converted_y_bins,
-                         y_min,
-                         y_max);
-
-  TH2D maxSuppress_histo(maxSuppress_name.str().c_str(),
-                         "Corner Points (Maximum Suppressed)",
-                         converted_x_bins,
-                         x_min,
-                         x_max,
-                         converted_y_bins,
-                         y_min,
-                         y_max);
+                         h_wire_data.GetYlow(),
+                         h_wire_data.GetYup());
+  };
+  WireDataImage conversion_histo = make_image();
+  WireDataImage derivativeX_histo = make_image();
+  WireDataImage derivativeY_histo = make_image();
+  BinnedImage<double> cornerScore_histo(converted_x_bins,
+                                        h_wire_data.GetXlow(),
+                                        h_wire_data.GetXup(),
+                                        converted_y_bins,
+                                        h_wire_data.GetYlow(),
+                                        h_wire_data.GetYup());
 
   create_image_histo(h_wire_data, conversion_histo);
   create_derivative_histograms(conversion_histo, derivativeX_histo, derivativeY_histo);
   create_cornerScore_histogram(derivativeX_histo, derivativeY_histo, cornerScore_histo);
-  corner_vector = perform_maximum_suppression(
-    cornerScore_histo, wireIDs, view, maxSuppress_histo, startx, starty);
+  auto const corners =
+    perform_maximum_suppression(cornerScore_histo, wireIDs, view, startx, starty);
+  corner_vector.insert(corner_vector.end(), corners.begin(), corners.end());
 }
 
 //-----------------------------------------------------------------------------
 // This puts on all the feature points in a given view, using a given data histogram
 void corner::CornerFinderAlg::attach_feature_points_LineIntegralScore(
-  TH2F const& h_wire_data,
+  WireDataImage const& h_wire_data,
   std::vector<geo::WireID> const& wireIDs,
   geo::View_t view,
-  std::vector<recob::EndPoint2D>& corner_vector)
+  std::vector<recob::EndPoint2D>& corner_vector) const
 {
-  const int x_bins = h_wire_data.GetNbinsX();
-  const float x_min = h_wire_data.GetXaxis()->GetBinLowEdge(1);
-  const float x_max = h_wire_data.GetXaxis()->GetBinUpEdge(x_bins);
-
-  const int y_bins = h_wire_data.GetNbinsY();
-  const float y_min = h_wire_data.GetYaxis()->GetBinLowEdge(1);
-  const float y_max = h_wire_data.GetYaxis()->GetBinUpEdge(y_bins);
+  std::vector<recob::EndPoint2D> corner_vector_tmp;
+  attach_feature_points(h_wire_data, wireIDs, view, corner_vector_tmp);
 
-  const int converted_y_bins = y_bins / fConversion_bins_per_input_y;
-  const int converted_x_bins = x_bins / fConversion_bins_per_input_x;
-
-  std::stringstream conversion_name;
-  conversion_name << "h_conversion_" << view << "_" << run_number << "_" << event_number;
-  std::stringstream dx_name;
-  dx_name << "h_derivative_x_" << view << "_" << run_number << "_" << event_number;
-  std::stringstream dy_name;
-  dy_name << "h_derivative_y_" << view << "_" << run_number << "_" << event_number;
-  std::stringstream cornerScore_name;
-  cornerScore_name << "h_cornerScore_" << view << "_" << run_number << "_" << event_number;
-  std::stringstream maxSuppress_name;
-  maxSuppress_name << "h_maxSuppress_" << view << "_" << run_number << "_" << event_number;
-
-  TH2F h_conversion(conversion_name.str().c_str(),
-                    "Image Conversion Histogram",
-                    converted_x_bins,
-                    x_min,
-                    x_max,
-                    converted_y_bins,
-                    y_min,
-                    y_max);
-  TH2F h_derivative_x(dx_name.str().c_str(),
-                      "Partial Derivatives (x)",
-                      converted_x_bins,
-                      x_min,
-                      x_max,
-                      converted_y_bins,
-                      y_min,
-                      y_max);
-  TH2F h_derivative_y(dy_name.str().c_str(),
-                      "Partial Derivatives (y)",
-                      converted_x_bins,
-                      x_min,
-                      x_max,
-                      converted_y_bins,
-                      y_min,
-                      y_max);
-  TH2D h_cornerScore(cornerScore_name.str().c_str(),
-                     "Feature Point Corner Score",
-                     converted_x_bins,
-                     x_min,
-                     x_max,
-                     converted_y_bins,
-                     y_min,
-                     y_max);
-  TH2D h_maxSuppress(maxSuppress_name.str().c_str(),
-                     "Corner Points (Maximum Suppressed)",
-                     converted_x_bins,
-                     x_min,
-                     x_max,
-                     converted_y_bins,
-                     y_min,
-                     y_max);
-
-  create_image_histo(h_wire_data, h_conversion);
-  create_derivative_histograms(h_conversion, h_derivative_x, h_derivative_y);
-  create_cornerScore_histogram(h_derivative_x, h_derivative_y, h_cornerScore);
-
-  auto corner_vector_tmp = perform_maximum_suppression(h_cornerScore, wireIDs, view, h_maxSuppress);
-
-  std::stringstream LI_name;
-  LI_name << "h_lineIntegralScore_" << view << "_" << run_number << "_" << event_number;
-  TH2F h_lineIntegralScore(
-    LI_name.str().c_str(), "Line Integral Score", x_bins, x_min, x_max, y_bins, y_min, y_max);
-  calculate_line_integral_score(h_wire_data, corner_vector_tmp, corner_vector, h_lineIntegralScore);
+  calculate_line_integral_score(h_wire_data, corner_vector_tmp, corner_vector);
 }
 
 //-----------------------------------------------------------------------------
 // Convert to pixel
-void corner::CornerFinderAlg::create_image_histo(TH2F const& h_wire_data, TH2F& h_conversion) const
+void corner::CornerFinderAlg::create_image_histo(WireDataImage const& h_wire_data,
+                                                 WireDataImage& h_conversion) const
 {
   double temp_integral = 0;
 
-  const TF2 fConversion_TF2("fConversion_func", fConversion_func.c_str(), -20, 20, -20, 20);
-
   for (int ix = 1; ix <= h_conversion.GetNbinsX(); ix++) {
     for (int iy = 1; iy <= h_conversion.GetNbinsY(); iy++) {
 
-      temp_integral = h_wire_data.Integral(ix, ix, iy, iy);
+      temp_integral = h_wire_data.GetBinContent(ix, iy);
 
       if (temp_integral > fConversion_threshold) {
 
@@ -600,14 +540,12 @@ void corner::CornerFinderAlg::create_image_histo(TH2F const& h_wire_data, TH2F&
         else if (fConversion_algorithm.compare("function") == 0) {
 
           temp_integral = 0;
-          for (int jx = ix - fConversion_func_neighborhood;
-               jx <= ix + fConversion_func_neighborhood;
-               jx++) {
-            for (int jy = iy - fConversion_func_neighborhood;
-                 jy <= iy + fConversion_func_neighborhood;
-                 jy++) {
-              temp_integral +=
-                h_wire_data.GetBinContent(jx, jy) * fConversion_TF2.Eval(ix - jx, iy - jy);
+          const int n = fConversion_func_neighborhood;
+          for (int jx = ix - n; jx <= ix + n; jx++) {
+            for (int jy = iy - n; jy <= iy + n; jy++) {
+              // the function at (ix - jx, iy - jy)
+              temp_integral += h_wire_data.GetBinContent(jx, jy) *
+                               fConversion_kernel[(ix - jx + n) * (2 * n + 1) + (iy - jy + n)];
             }
           }
           h_conversion.SetBinContent(ix, iy, temp_integral);
@@ -646,112 +584,77 @@ void corner::CornerFinderAlg::create_image_histo(TH2F const& h_wire_data, TH2F&
 //-----------------------------------------------------------------------------
 // Derivative
 
-void corner::CornerFinderAlg::create_derivative_histograms(TH2F const& h_conversion,
-                                                           TH2F& h_derivative_x,
-                                                           TH2F& h_derivative_y)
+void corner::CornerFinderAlg::create_derivative_histograms(WireDataImage const& h_conversion,
+                                                           WireDataImage& h_derivative_x,
+                                                           WireDataImage& h_derivative_y) const
 {
   const int x_bins = h_conversion.GetNbinsX();
   const int y_bins = h_conversion.GetNbinsY();
 
-  for (int iy = 1 + fDerivative_neighborhood; iy <= (y_bins - fDerivative_neighborhood); iy++) {
-    for (int ix = 1 + fDerivative_neighborhood; ix <= (x_bins - fDerivative_neighborhood); ix++) {
-
-      if (fDerivative_method.compare("Sobel") == 0) {
-
-        if (fDerivative_neighborhood == 1) {
-          h_derivative_x.SetBinContent(ix,
-                                       iy,
-                                       0.5 * (h_conversion.GetBinContent(ix + 1, iy) -
-                                              h_conversion.GetBinContent(ix - 1, iy)) +
-                                         0.25 * (h_conversion.GetBinContent(ix + 1, iy + 1) -
-                                                 h_conversion.GetBinContent(ix - 1, iy + 1)) +
-                                         0.25 * (h_conversion.GetBinContent(ix + 1, iy - 1) -
-                                                 h_conversion.GetBinContent(ix - 1, iy - 1)));
-          h_derivative_y.SetBinContent(ix,
-                                       iy,
-                                       0.5 * (h_conversion.GetBinContent(ix, iy + 1) -
-                                              h_conversion.GetBinContent(ix, iy - 1)) +
-                                         0.25 * (h_conversion.GetBinContent(ix - 1, iy + 1) -
-                                                 h_conversion.GetBinContent(ix - 1, iy - 1)) +
-                                         0.25 * (h_conversion.GetBinContent(ix + 1, iy + 1) -
-                                                 h_conversion.GetBinContent(ix + 1, iy - 1)));
-        }
-        else if (fDerivative_neighborhood == 2) {
-          h_derivative_x.SetBinContent(
-            ix,
-            iy,
-            12 * (h_conversion.GetBinContent(ix + 1, iy) - h_conversion.GetBinContent(ix - 1, iy)) +
-              8 * (h_conversion.GetBinContent(ix + 1, iy + 1) -
-                   h_conversion.GetBinContent(ix - 1, iy + 1)) +
-              8 * (h_conversion.GetBinContent(ix + 1, iy - 1) -
-                   h_conversion.GetBinContent(ix - 1, iy - 1)) +
-              2 * (h_conversion.GetBinContent(ix + 1, iy + 2) -
-                   h_conversion.GetBinContent(ix - 1, iy + 2)) +
-              2 * (h_conversion.GetBinContent(ix + 1, iy - 2) -
-                   h_conversion.GetBinContent(ix - 1, iy - 2)) +
-              6 *
-                (h_conversion.GetBinContent(ix + 2, iy) - h_conversion.GetBinContent(ix - 2, iy)) +
-              4 * (h_conversion.GetBinContent(ix + 2, iy + 1) -
-                   h_conversion.GetBinContent(ix - 2, iy + 1)) +
-              4 * (h_conversion.GetBinContent(ix + 2, iy - 1) -
-                   h_conversion.GetBinContent(ix - 2, iy - 1)) +
-              1 * (h_conversion.GetBinContent(ix + 2, iy + 2) -
-                   h_conversion.GetBinContent(ix - 2, iy + 2)) +
-              1 * (h_conversion.GetBinContent(ix + 2, iy - 2) -
-                   h_conversion.GetBinContent(ix - 2, iy - 2)));
-          h_derivative_y.SetBinContent(
-            ix,
-            iy,
-            12 * (h_conversion.GetBinContent(ix, iy + 1) - h_conversion.GetBinContent(ix, iy - 1)) +
-              8 * (h_conversion.GetBinContent(ix - 1, iy + 1) -
-                   h_conversion.GetBinContent(ix - 1, iy - 1)) +
-              8 * (h_conversion.GetBinContent(ix + 1, iy + 1) -
-                   h_conversion.GetBinContent(ix + 1, iy - 1)) +
-              2 * (h_conversion.GetBinContent(ix - 2, iy + 1) -
-                   h_conversion.GetBinContent(ix - 2, iy - 1)) +
-              2 * (h_conversion.GetBinContent(ix + 2, iy + 1) -
-                   h_conversion.GetBinContent(ix + 2, iy - 1)) +
-              6 *
-                (h_conversion.GetBinContent(ix, iy + 2) - h_conversion.GetBinContent(ix, iy - 2)) +
-              4 * (h_conversion.GetBinContent(ix - 1, iy + 2) -
-                   h_conversion.GetBinContent(ix - 1, iy - 2)) +
-              4 * (h_conversion.GetBinContent(ix + 1, iy + 2) -
-                   h_conversion.GetBinContent(ix + 1, iy - 2)) +
-              1 * (h_conversion.GetBinContent(ix - 2, iy + 2) -
-                   h_conversion.GetBinContent(ix - 2, iy - 2)) +
-              1 * (h_conversion.GetBinContent(ix + 2, iy + 2) -
-                   h_conversion.GetBinContent(ix + 2, iy - 2)));
-        }
-        else {
-          mf::LogError("CornerFinderAlg")
-            << "Sobel derivative not supported for neighborhoods > 2.";
-          return;
-        }
-
-      } //end if Sobel
+  bool const sobel = fDerivative_method.compare("Sobel") == 0;
+  if (sobel) {
+    if (fDerivative_neighborhood != 1 && fDerivative_neighborhood != 2) {
+      mf::LogError("CornerFinderAlg") << "Sobel derivative not supported for neighborhoods > 2.";
+      return;
+    }
+  }
+  else if (fDerivative_method.compare("local") == 0) {
+    if (fDerivative_neighborhood != 1) {
+      mf::LogError("CornerFinderAlg")
+        << "Local derivative not yet supported for neighborhoods > 1.";
+      return;
+    }
+  }
+  else {
+    mf::LogError("CornerFinderAlg") << "Bad derivative algorithm! " << fDerivative_method;
+    return;
+  }
 
-      else if (fDerivative_method.compare("local") == 0) {
+  // The masks are applied a row at a time on contiguous bins; all the bins read stay
+  // inside the histogram range. The differences are taken in double precision, as before.
+  const int first_x = 1 + fDerivative_neighborhood;
+  const int last_x = x_bins - fDerivative_neighborhood;
+  for (int iy = 1 + fDerivative_neighborhood; iy <= (y_bins - fDerivative_neighborhood); iy++) {
 
-        if (fDerivative_neighborhood == 1) {
-          h_derivative_x.SetBinContent(
-            ix,
-            iy,
-            (h_conversion.GetBinContent(ix + 1, iy) - h_conversion.GetBinContent(ix - 1, iy)));
-          h_derivative_y.SetBinContent(
-            ix,
-            iy,
-            (h_conversion.GetBinContent(ix, iy + 1) - h_conversion.GetBinContent(ix, iy - 1)));
-        }
-        else {
-          mf::LogError("CornerFinderAlg")
-            << "Local derivative not yet supported for neighborhoods > 1.";
-          return;
-        }
-      } //end if local
+    float const* r = h_conversion.Row(iy);
+    float const* rp1 = h_conversion.Row(iy + 1);
+    float const* rm1 = h_conversion.Row(iy - 1);
+    float* dx = h_derivative_x.Row(iy);
+    float* dy = h_derivative_y.Row(iy);
 
-      else {
-        mf::LogError("CornerFinderAlg") << "Bad derivative algorithm! " << fDerivative_method;
-        return;
+    if (!sobel) {
+      for (int ix = first_x; ix <= last_x; ix++) {
+        dx[ix] = (double(r[ix + 1]) - double(r[ix - 1]));
+        dy[ix] = (double(rp1[ix]) - double(rm1[ix]));
+      }
+    }
+    else if (fDerivative_neighborhood == 1) {
+      for (int ix = first_x; ix <= last_x; ix++) {
+        dx[ix] = 0.5 * (double(r[ix + 1]) - r[ix - 1]) +
+                 0.25 * (double(rp1[ix + 1]) - rp1[ix - 1]) +
+                 0.25 * (double(rm1[ix + 1]) - rm1[ix - 1]);
+        dy[ix] = 0.5 * (double(rp1[ix]) - rm1[ix]) + 0.25 * (double(rp1[ix - 1]) - rm1[ix - 1]) +
+                 0.25 * (double(rp1[ix + 1]) - rm1[ix + 1]);
+      }
+    }
+    else {
+      float const* rp2 = h_conversion.Row(iy + 2);
+      float const* rm2 = h_conversion.Row(iy - 2);
+      for (int ix = first_x; ix <= last_x; ix++) {
+        dx[ix] = 12 * (double(r[ix + 1]) - r[ix - 1]) + 8 * (double(rp1[ix + 1]) - rp1[ix - 1]) +
+                 8 * (double(rm1[ix + 1]) - rm1[ix - 1]) +
+                 2 * (double(rp2[ix + 1]) - rp2[ix - 1]) +
+                 2 * (double(rm2[ix + 1]) - rm2[ix - 1]) + 6 * (double(r[ix + 2]) - r[ix - 2]) +
+                 4 * (double(rp1[ix + 2]) - rp1[ix - 2]) +
+                 4 * (double(rm1[ix + 2]) - rm1[ix - 2]) +
+                 1 * (double(rp2[ix + 2]) - rp2[ix - 2]) + 1 * (double(rm2[ix + 2]) - rm2[ix - 2]);
+        dy[ix] = 12 * (double(rp1[ix]) - rm1[ix]) + 8 * (double(rp1[ix - 1]) - rm1[ix - 1]) +
+                 8 * (double(rp1[ix + 1]) - rm1[ix + 1]) +
+                 2 * (double(rp1[ix - 2]) - rm1[ix - 2]) +
+                 2 * (double(rp1[ix + 2]) - rm1[ix + 2]) + 6 * (double(rp2[ix]) - rm2[ix]) +
+                 4 * (double(rp2[ix - 1]) - rm2[ix - 1]) +
+                 4 * (double(rp2[ix + 1]) - rm2[ix + 1]) +
+                 1 * (double(rp2[ix - 2]) - rm2[ix - 2]) + 1 * (double(rp2[ix + 2]) - rm2[ix + 2]);
       }
     }
   }
@@ -885,14 +788,8 @@ void corner::CornerFinderAlg::create_derivative_histograms(TH2F const& h_convers
 
   if (fDerivative_BlurNeighborhood > 0) {
 
-    if (fDerivative_BlurNeighborhood > 10) {
-      mf::LogWarning("CornerFinderAlg")
-        << "WARNING...BlurNeighborhoods>10 not currently allowed. Shrinking to 10.";
-      fDerivative_BlurNeighborhood = 10;
-    }
-
-    TH2F* h_clone_derivative_x = (TH2F*)h_derivative_x.Clone("h_clone_derivative_x");
-    TH2F* h_clone_derivative_y = (TH2F*)h_derivative_y.Clone("h_clone_derivative_y");
+    WireDataImage const h_clone_derivative_x = h_derivative_x;
+    WireDataImage const h_clone_derivative_y = h_derivative_y;
 
     temp_integral_x = 0;
     temp_integral_y = 0;
@@ -908,9 +805,9 @@ void corner::CornerFinderAlg::create_derivative_histograms(TH2F const& h_convers
           for (int jy = iy - fDerivative_BlurNeighborhood; jy <= iy + fDerivative_BlurNeighborhood;
                jy++) {
             temp_integral_x +=
-              h_clone_derivative_x->GetBinContent(jx, jy) * func_blur[(ix - jx) + 5][(iy - jy) + 5];
+              h_clone_derivative_x.GetBinContent(jx, jy) * func_blur[(ix - jx) + 5][(iy - jy) + 5];
             temp_integral_y +=
-              h_clone_derivative_y->GetBinContent(jx, jy) * func_blur[(ix - jx) + 5][(iy - jy) + 5];
+              h_clone_derivative_y.GetBinContent(jx, jy) * func_blur[(ix - jx) + 5][(iy - jy) + 5];
           }
         }
         h_derivative_x.SetBinContent(ix, iy, temp_integral_x);
@@ -918,81 +815,68 @@ void corner::CornerFinderAlg::create_derivative_histograms(TH2F const& h_convers
       }
     }
 
-    delete h_clone_derivative_x;
-    delete h_clone_derivative_y;
-
   } //end if blur
 }
 
 //-----------------------------------------------------------------------------
 // Corner Score
 
-void corner::CornerFinderAlg::create_cornerScore_histogram(TH2F const& h_derivative_x,
-                                                           TH2F const& h_derivative_y,
-                                                           TH2D& h_cornerScore)
+void corner::CornerFinderAlg::create_cornerScore_histogram(WireDataImage const& h_derivative_x,
+                                                           WireDataImage const& h_derivative_y,
+                                                           BinnedImage<double>& h_cornerScore) const
 {
   const int x_bins = h_derivative_x.GetNbinsX();
   const int y_bins = h_derivative_y.GetNbinsY();
+  const int n = fCornerScore_neighborhood;
 
-  //the structure tensor elements
-  double st_xx = 0., st_xy = 0., st_yy = 0.;
-
-  for (int iy = 1 + fCornerScore_neighborhood; iy <= (y_bins - fCornerScore_neighborhood); iy++) {
-    for (int ix = 1 + fCornerScore_neighborhood; ix <= (x_bins - fCornerScore_neighborhood); ix++) {
-
-      if (ix == 1 + fCornerScore_neighborhood) {
-        st_xx = 0.;
-        st_xy = 0.;
-        st_yy = 0.;
-
-        for (int jx = ix - fCornerScore_neighborhood; jx <= ix + fCornerScore_neighborhood; jx++) {
-          for (int jy = iy - fCornerScore_neighborhood; jy <= iy + fCornerScore_neighborhood;
-               jy++) {
+  bool const noble = fCornerScore_algorithm.compare("Noble") == 0;
+  if (!noble && fCornerScore_algorithm.compare("Harris") != 0) {
+    mf::LogError("CornerFinderAlg") << "BAD CORNER ALGORITHM: " << fCornerScore_algorithm;
+    return;
+  }
 
-            st_xx += h_derivative_x.GetBinContent(jx, jy) * h_derivative_x.GetBinContent(jx, jy);
-            st_yy += h_derivative_y.GetBinContent(jx, jy) * h_derivative_y.GetBinContent(jx, jy);
-            st_xy += h_derivative_x.GetBinContent(jx, jy) * h_derivative_y.GetBinContent(jx, jy);
-          }
-        }
+  // The structure tensor is summed over the neighbourhood in two passes: first along
+  // y, over whole rows of contiguous bins, then as a running sum along x.
+  std::vector<double> col_xx(x_bins + 2), col_yy(x_bins + 2), col_xy(x_bins + 2);
+
+  for (int iy = 1 + n; iy <= (y_bins - n); iy++) {
+
+    std::fill(col_xx.begin(), col_xx.end(), 0.);
+    std::fill(col_yy.begin(), col_yy.end(), 0.);
+    std::fill(col_xy.begin(), col_xy.end(), 0.);
+    for (int jy = iy - n; jy <= iy + n; jy++) {
+      float const* dx = h_derivative_x.Row(jy);
+      float const* dy = h_derivative_y.Row(jy);
+      for (int jx = 1; jx <= x_bins; jx++) {
+        col_xx[jx] += double(dx[jx]) * dx[jx];
+        col_yy[jx] += double(dy[jx]) * dy[jx];
+        col_xy[jx] += double(dx[jx]) * dy[jx];
       }
+    }
 
-      // we do it this way to reduce computation time
-      else {
-        for (int jy = iy - fCornerScore_neighborhood; jy <= iy + fCornerScore_neighborhood; jy++) {
-
-          st_xx -= h_derivative_x.GetBinContent(ix - fCornerScore_neighborhood - 1, jy) *
-                   h_derivative_x.GetBinContent(ix - fCornerScore_neighborhood - 1, jy);
-          st_xx += h_derivative_x.GetBinContent(ix + fCornerScore_neighborhood, jy) *
-                   h_derivative_x.GetBinContent(ix + fCornerScore_neighborhood, jy);
-
-          st_yy -= h_derivative_y.GetBinContent(ix - fCornerScore_neighborhood - 1, jy) *
-                   h_derivative_y.GetBinContent(ix - fCornerScore_neighborhood - 1, jy);
-          st_yy += h_derivative_y.GetBinContent(ix + fCornerScore_neighborhood, jy) *
-                   h_derivative_y.GetBinContent(ix + fCornerScore_neighborhood, jy);
-
-          st_xy -= h_derivative_x.GetBinContent(ix - fCornerScore_neighborhood - 1, jy) *
-                   h_derivative_y.GetBinContent(ix - fCornerScore_neighborhood - 1, jy);
-          st_xy += h_derivative_x.GetBinContent(ix + fCornerScore_neighborhood, jy) *
-                   h_derivative_y.GetBinContent(ix + fCornerScore_neighborhood, jy);
-        }
-      }
+    //the structure tensor elements
+    double st_xx = 0., st_xy = 0., st_yy = 0.;
+    for (int jx = 1; jx <= 2 * n; jx++) {
+      st_xx += col_xx[jx];
+      st_yy += col_yy[jx];
+      st_xy += col_xy[jx];
+    }
 
-      if (fCornerScore_algorithm.compare("Noble") == 0) {
-        h_cornerScore.SetBinContent(
-          ix, iy, (st_xx * st_yy - st_xy * st_xy) / (st_xx + st_yy + fCornerScore_Noble_epsilon));
-      }
-      else if (fCornerScore_algorithm.compare("Harris") == 0) {
-        h_cornerScore.SetBinContent(
-          ix,
-          iy,
-          (st_xx * st_yy - st_xy * st_xy) -
-            ((st_xx + st_yy) * (st_xx + st_yy) * fCornerScore_Harris_kappa));
-      }
-      else {
-        mf::LogError("CornerFinderAlg") << "BAD CORNER ALGORITHM: " << fCornerScore_algorithm;
-        return;
-      }
+    double* score = h_cornerScore.Row(iy);
+    for (int ix = 1 + n; ix <= (x_bins - n); ix++) {
+      st_xx += col_xx[ix + n];
+      st_yy += col_yy[ix + n];
+      st_xy += col_xy[ix + n];
+
+      if (noble)
+        score[ix] = (st_xx * st_yy - st_xy * st_xy) / (st_xx + st_yy + fCornerScore_Noble_epsilon);
+      else
+        score[ix] = (st_xx * st_yy - st_xy * st_xy) -
+                    ((st_xx + st_yy) * (st_xx + st_yy) * fCornerScore_Harris_kappa);
 
+      st_xx -= col_xx[ix - n];
+      st_yy -= col_yy[ix - n];
+      st_xy -= col_xy[ix - n];
     } // end for loop over x bins
   }   // end for loop over y bins
 }
@@ -1000,27 +884,50 @@ void corner::CornerFinderAlg::create_cornerScore_histogram(TH2F const& h_derivat
 //-----------------------------------------------------------------------------
 // Max Supress
 std::vector<recob::EndPoint2D> corner::CornerFinderAlg::perform_maximum_suppression(
-  TH2D const& h_cornerScore,
-  std::vector<geo::WireID> wireIDs,
+  BinnedImage<double> const& h_cornerScore,
+  std::vector<geo::WireID> const& wireIDs,
   geo::View_t view,
-  TH2D& h_maxSuppress,
   int startx,
   int starty) const
 {
   std::vector<recob::EndPoint2D> corner_vector;
   const int x_bins = h_cornerScore.GetNbinsX();
   const int y_bins = h_cornerScore.GetNbinsY();
+  const int n = fMaxSuppress_neighborhood;
+
+  // A bin can only be a corner if it is the maximum of its neighbourhood, which a
+  // separable maximum filter finds cheaply; the candidates are then checked with the
+  // exact scan, which settles ties in favour of the first bin in the scan order.
+  std::vector<double> col_max(x_bins + 2);
 
   for (int iy = 1; iy <= y_bins; iy++) {
+
+    double const* score = h_cornerScore.Row(iy);
+    std::copy(score, score + x_bins + 2, col_max.begin());
+    for (int jy = std::max(iy - n, 0); jy <= std::min(iy + n, y_bins + 1); jy++) {
+      double const* row = h_cornerScore.Row(jy);
+      for (int jx = 0; jx <= x_bins + 1; jx++)
+        col_max[jx] = std::max(col_max[jx], row[jx]);
+    }
+
     for (int ix = 1; ix <= x_bins; ix++) {
 
-      if (h_cornerScore.GetBinContent(ix, iy) < fMaxSuppress_threshold) continue;
+      if (score[ix] < fMaxSuppress_threshold) continue;
+
+      bool is_max = true;
+      for (int jx = std::max(ix - n, 0); jx <= std::min(ix + n, x_bins + 1); jx++) {
+        if (col_max[jx] > score[ix]) {
+          is_max = false;
+          break;
+        }
+      }
+      if (!is_max) continue;
 
       double temp_max = -1000;
       double temp_center_bin = false;
 
-      for (int jx = ix - fMaxSuppress_neighborhood; jx <= ix + fMaxSuppress_neighborhood; jx++) {
-        for (int jy = iy - fMaxSuppress_neighborhood; jy <= iy + fMaxSuppress_neighborhood; jy++) {
+      for (int jx = ix - n; jx <= ix + n; jx++) {
+        for (int jy = iy - n; jy <= iy + n; jy++) {
 
           if (h_cornerScore.GetBinContent(jx, jy) > temp_max) {
             temp_max = h_cornerScore.GetBinContent(jx, jy);
@@ -1042,8 +949,6 @@ std::vector<recob::EndPoint2D> corner::CornerFinderAlg::perform_maximum_suppress
         recob::EndPoint2D corner(
           time_tick, wireIDs[wire_number], h_cornerScore.GetBinContent(ix, iy), id, view, totalQ);
         corner_vector.push_back(corner);
-
-        h_maxSuppress.SetBinContent(ix, iy, h_cornerScore.GetBinContent(ix, iy));
       }
     }
   }
@@ -1051,17 +956,17 @@ std::vector<recob::EndPoint2D> corner::CornerFinderAlg::perform_maximum_suppress
 }
 
 /* Silly little function for doing a line integral type thing. Needs improvement. */
-float corner::CornerFinderAlg::line_integral(TH2F const& hist,
+float corner::CornerFinderAlg::line_integral(WireDataImage const& hist,
                                              int begin_x,
                                              float begin_y,
                                              int end_x,
                                              float end_y,
                                              float threshold) const
 {
-  int x1 = hist.GetXaxis()->FindBin(begin_x);
-  int y1 = hist.GetYaxis()->FindBin(begin_y);
-  int x2 = hist.GetXaxis()->FindBin(end_x);
-  int y2 = hist.GetYaxis()->FindBin(end_y);
+  int x1 = hist.FindBinX(begin_x);
+  int y1 = hist.FindBinY(begin_y);
+  int x2 = hist.FindBinX(end_x);
+  int y2 = hist.FindBinY(end_y);
 
   if (x1 == x2 && abs(y1 - y2) < 1e-5) return 0;
 
@@ -1112,10 +1017,9 @@ float corner::CornerFinderAlg::line_integral(TH2F const& hist,
 //-----------------------------------------------------------------------------
 // Do the silly little line integral score thing
 void corner::CornerFinderAlg::calculate_line_integral_score(
-  TH2F const& h_wire_data,
+  WireDataImage const& h_wire_data,
   std::vector<recob::EndPoint2D> const& corner_vector,
-  std::vector<recob::EndPoint2D>& corner_lineIntegralScore_vector,
-  TH2F& h_lineIntegralScore) const
+  std::vector<recob::EndPoint2D>& corner_lineIntegralScore_vector) const
 {
   for (auto const i_corner : corner_vector) {
 
@@ -1140,14 +1044,23 @@ void corner::CornerFinderAlg::calculate_line_integral_score(
                              i_corner.Charge());
 
     corner_lineIntegralScore_vector.push_back(corner);
-
-    h_lineIntegralScore.SetBinContent(h_wire_data.GetXaxis()->FindBin(i_corner.WireID().Wire),
-                                      h_wire_data.GetYaxis()->FindBin(i_corner.DriftTime()),
-                                      score);
   }
 }
 
+corner::WireDataImage const& corner::CornerFinderAlg::GetWireDataImage(unsigned int i_plane) const
+{
+  return WireData_images.at(i_plane);
+}
+
 TH2F const& corner::CornerFinderAlg::GetWireDataHist(unsigned int i_plane) const
 {
-  return WireData_histos.at(i_plane);
+  auto& hist = WireData_histos.at(i_plane);
+  if (!hist) {
+    std::stringstream ss_tmp_name, ss_tmp_title;
+    ss_tmp_name << "h_WireData_" << i_plane;
+    ss_tmp_title << fCalDataModuleLabel << " wire data for plane " << i_plane
+                 << ";Wire Number;Time Tick";
+    hist = WireData_images.at(i_plane).MakeHistogram<TH2F>(ss_tmp_name.str(), ss_tmp_title.str());
+  }
+  return *hist;
 }
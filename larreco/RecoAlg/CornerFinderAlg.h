@@ -15,16 +15,111 @@
 
 #include "fhiclcpp/fwd.h"
 
-#include "TF2.h"
-#include "TH1D.h"
 #include "TH2.h"
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 
 namespace corner { //<---Not sure if this is the right namespace
 
+  /// Contiguous 2D image binned like a TH2 with fixed bins: bins 1 ... nbins hold the
+  /// data and each axis has an underflow (0) and an overflow (nbins + 1) bin. Bin indices
+  /// outside of these are clamped onto them and contents are read as double, as in TH2F.
+  template <typename T>
+  class BinnedImage {
+  public:
+    BinnedImage() = default;
+    BinnedImage(int nbinsx, double xlow, double xup, int nbinsy, double ylow, double yup)
+      : fNbinsX{nbinsx}
+      , fNbinsY{nbinsy}
+      , fXlow{xlow}
+      , fXup{xup}
+      , fYlow{ylow}
+      , fYup{yup}
+      , fData((nbinsx + 2) * (nbinsy + 2), T(0))
+    {}
+
+    int GetNbinsX() const { return fNbinsX; }
+    int GetNbinsY() const { return fNbinsY; }
+    double GetXlow() const { return fXlow; }
+    double GetXup() const { return fXup; }
+    double GetYlow() const { return fYlow; }
+    double GetYup() const { return fYup; }
+
+    double GetBinContent(int ix, int iy) const { return fData[Bin(ix, iy)]; }
+    void SetBinContent(int ix, int iy, double value) { fData[Bin(ix, iy)] = value; }
+
+    /// Row iy, indexed by the x bin from 0 (underflow) to nbinsx + 1 (overflow)
+    T const* Row(int iy) const { return fData.data() + iy * (fNbinsX + 2); }
+    T* Row(int iy) { return fData.data() + iy * (fNbinsX + 2); }
+
+    int FindBinX(double x) const { return FindBin(x, fNbinsX, fXlow, fXup); }
+    int FindBinY(double y) const { return FindBin(y, fNbinsY, fYlow, fYup); }
+
+    /// Sum of the bins in the inclusive ranges, with the range conventions of TH2::Integral
+    double Integral(int ix1, int ix2, int iy1, int iy2) const;
+
+    void Reset() { std::fill(fData.begin(), fData.end(), T(0)); }
+
+    /// Copy into a ROOT histogram (TH2F or TH2D), for debugging
+    template <typename Hist>
+    std::unique_ptr<Hist> MakeHistogram(std::string const& name, std::string const& title) const;
+
+  private:
+    int fNbinsX{};
+    int fNbinsY{};
+    double fXlow{}, fXup{};
+    double fYlow{}, fYup{};
+    std::vector<T> fData;
+
+    int Bin(int ix, int iy) const
+    {
+      return std::clamp(iy, 0, fNbinsY + 1) * (fNbinsX + 2) + std::clamp(ix, 0, fNbinsX + 1);
+    }
+    static int FindBin(double x, int nbins, double low, double up)
+    {
+      if (x < low) return 0;
+      if (!(x < up)) return nbins + 1;
+      return 1 + int(nbins * (x - low) / (up - low));
+    }
+  };
+
+  using WireDataImage = BinnedImage<float>;
+
+  template <typename T>
+  double BinnedImage<T>::Integral(int ix1, int ix2, int iy1, int iy2) const
+  {
+    if (ix1 < 0) ix1 = 0;
+    if (ix2 > fNbinsX + 1 || ix2 < ix1) ix2 = fNbinsX + 1;
+    if (iy1 < 0) iy1 = 0;
+    if (iy2 > fNbinsY + 1 || iy2 < iy1) iy2 = fNbinsY + 1;
+
+    double integral = 0;
+    for (int iy = iy1; iy <= iy2; ++iy) {
+      T const* row = Row(iy);
+      for (int ix = ix1; ix <= ix2; ++ix)
+        integral += row[ix];
+    }
+    return integral;
+  }
+
+  template <typename T>
+  template <typename Hist>
+  std::unique_ptr<Hist> BinnedImage<T>::MakeHistogram(std::string const& name,
+                                                      std::string const& title) const
+  {
+    auto hist = std::make_unique<Hist>(
+      name.c_str(), title.c_str(), fNbinsX, fXlow, fXup, fNbinsY, fYlow, fYup);
+    hist->SetDirectory(nullptr);
+    for (int iy = 0; iy <= fNbinsY + 1; ++iy)
+      for (int ix = 0; ix <= fNbinsX + 1; ++ix)
+        hist->SetBinContent(ix, iy, GetBinContent(ix, iy));
+    return hist;
+  }
+
   class CornerFinderAlg {
   public:
     explicit CornerFinderAlg(fhicl::ParameterSet const& pset);
@@ -45,9 +140,16 @@ namespace corner { //<---Not sure if this is the right namespace
       geo::GeometryCore const&,
       geo::WireReadoutGeom const&); //here we get feature points with corner score
 
-    float line_integral(TH2F const& hist, int x1, float y1, int x2, float y2, float threshold)
-      const;
+    float line_integral(WireDataImage const& image,
+                        int x1,
+                        float y1,
+                        int x2,
+                        float y2,
+                        float threshold) const;
+
+    WireDataImage const& GetWireDataImage(unsigned int) const;
 
+    /// The wire data as a histogram, made on request for debugging
     TH2F const& GetWireDataHist(unsigned int) const;
 
   private:
@@ -78,46 +180,50 @@ namespace corner { //<---Not sure if this is the right namespace
     float fIntegral_bin_threshold;
     float fIntegral_fraction_threshold;
 
-    // Making a vector of histograms
-    std::vector<TH2F> WireData_histos;
-    std::vector<TH1D> WireData_histos_ProjectionX;
-    std::vector<TH1D> WireData_histos_ProjectionY;
-    std::vector<std::tuple<int, TH2F, int, int>> WireData_trimmed_histos;
+    /// Conversion_function at the (2n+1)x(2n+1) integer offsets of the neighborhood, x-major
+    std::vector<double> fConversion_kernel;
+
+    // Making a vector of images
+    std::vector<WireDataImage> WireData_images;
+    std::vector<std::vector<double>> WireData_images_ProjectionX; ///< including under/overflow
+    std::vector<std::vector<double>> WireData_images_ProjectionY;
+    std::vector<std::tuple<int, WireDataImage, int, int>> WireData_trimmed_images;
     std::vector<std::vector<geo::WireID>> WireData_IDs;
+    mutable std::vector<std::unique_ptr<TH2F>> WireData_histos; ///< made by GetWireDataHist()
 
     unsigned int event_number{};
     unsigned int run_number{};
 
-    void create_image_histo(TH2F const& h_wire_data, TH2F& h_conversion) const;
-    void create_derivative_histograms(TH2F const& h_conversion,
-                                      TH2F& h_derivative_x,
-                                      TH2F& h_derivative_y);
-    void create_cornerScore_histogram(TH2F const& h_derivative_x,
-                                      TH2F const& h_derivative_y,
-                                      TH2D& h_cornerScore);
-    std::vector<recob::EndPoint2D> perform_maximum_suppression(TH2D const& h_cornerScore,
-                                                               std::vector<geo::WireID> wireIDs,
-                                                               geo::View_t view,
-                                                               TH2D& h_maxSuppress,
-                                                               int startx = 0,
-                                                               int starty = 0) const;
+    void create_image_histo(WireDataImage const& h_wire_data,
+                            WireDataImage& h_conversion) const;
+    void create_derivative_histograms(WireDataImage const& h_conversion,
+                                      WireDataImage& h_derivative_x,
+                                      WireDataImage& h_derivative_y) const;
+    void create_cornerScore_histogram(WireDataImage const& h_derivative_x,
+                                      WireDataImage const& h_derivative_y,
+                                      BinnedImage<double>& h_cornerScore) const;
+    std::vector<recob::EndPoint2D> perform_maximum_suppression(
+      BinnedImage<double> const& h_cornerScore,
+      std::vector<geo::WireID> const& wireIDs,
+      geo::View_t view,
+      int startx = 0,
+      int starty = 0) const;
 
     void calculate_line_integral_score(
-      TH2F const& h_wire_data,
+      WireDataImage const& h_wire_data,
       std::vector<recob::EndPoint2D> const& corner_vector,
-      std::vector<recob::EndPoint2D>& corner_lineIntegralScore_vector,
-      TH2F& h_lineIntegralScore) const;
+      std::vector<recob::EndPoint2D>& corner_lineIntegralScore_vector) const;
 
-    void attach_feature_points(TH2F const& h_wire_data,
+    void attach_feature_points(WireDataImage const& h_wire_data,
                                std::vector<geo::WireID> const& wireIDs,
                                geo::View_t view,
                                std::vector<recob::EndPoint2D>&,
                                int startx = 0,
-                               int starty = 0);
-    void attach_feature_points_LineIntegralScore(TH2F const& h_wire_data,
+                               int starty = 0) const;
+    void attach_feature_points_LineIntegralScore(WireDataImage const& h_wire_data,
                                                  std::vector<geo::WireID> const& wireIDs,
                                                  geo::View_t view,
-                                                 std::vector<recob::EndPoint2D>&);
+                                                 std::vector<recob::EndPoint2D>&) const;
 
     void create_smaller_histos(geo::WireReadoutGeom const&);
 
@@ -28,8 +28,13 @@
 #include "lardataobj/RecoBase/Hit.h"
 #include "larreco/RecoAlg/DBScanAlg.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <limits>
 
 //----------------------------------------------------------
 // RStarTree stuff
@@ -273,6 +278,9 @@ void cluster::DBScanAlg::InitScan(const detinfo::DetectorClocksData& clockData,
   fsim3.clear();
   fclusters.clear();
   fWirePitch.clear();
+  fNeighborStart.clear();
+  fNeighbors.clear();
+  fPointBadWires.clear();
 
   fBadChannels = badChannels;
   fBadWireSum.clear();
@@ -347,7 +355,8 @@ void cluster::DBScanAlg::InitScan(const detinfo::DetectorClocksData& clockData,
 }
 
 //----------------------------------------------------------
-double cluster::DBScanAlg::getSimilarity(const std::vector<double> v1, const std::vector<double> v2)
+double cluster::DBScanAlg::getSimilarity(const std::vector<double>& v1,
+                                         const std::vector<double>& v2) const
 {
 
   //for Euclidean distance comment everything out except this-->>>
@@ -383,8 +392,8 @@ double cluster::DBScanAlg::getSimilarity(const std::vector<double> v1, const std
 }
 
 //----------------------------------------------------------------
-double cluster::DBScanAlg::getSimilarity2(const std::vector<double> v1,
-                                          const std::vector<double> v2)
+double cluster::DBScanAlg::getSimilarity2(const std::vector<double>& v1,
+                                          const std::vector<double>& v2) const
 {
 
   //-------------------------------------------
@@ -422,8 +431,8 @@ double cluster::DBScanAlg::getSimilarity2(const std::vector<double> v1,
 }
 
 //----------------------------------------------------------------
-double cluster::DBScanAlg::getWidthFactor(const std::vector<double> v1,
-                                          const std::vector<double> v2)
+double cluster::DBScanAlg::getWidthFactor(const std::vector<double>& v1,
+                                          const std::vector<double>& v2) const
 {
 
   //double k=0.13; //this number was determined by looking at flat muon hits' widths.
@@ -505,6 +514,143 @@ void cluster::DBScanAlg::computeWidthFactor()
   }
 }
 
+//------------------------------------------------------------------
+// The findNeighbors test for a pair of points, with the bad channels
+// counted from fPointBadWires instead of walking fBadChannels. Term by
+// term the same arithmetic as getSimilarity(), getSimilarity2() and
+// getWidthFactor(), so the decision is bit for bit the same.
+bool cluster::DBScanAlg::IsNeighbor(unsigned int p1, unsigned int p2) const
+{
+  std::vector<double> const& v1 = fps[p1];
+  std::vector<double> const& v2 = fps[p2];
+
+  /// \todo this code assumes that all planes have the same wire pitch
+  double wire_dist = fWirePitch[0];
+  double cmtobridge = lar::util::absDiff(fPointBadWires[p1], fPointBadWires[p2]) * wire_dist;
+
+  double sim = (std::abs(v2[0] - v1[0]) - cmtobridge) * (std::abs(v2[0] - v1[0]) - cmtobridge);
+
+  if (std::abs(v2[0] - v1[0]) > 1e-10) { cmtobridge *= std::abs((v2[1] - v1[1]) / (v2[0] - v1[0])); }
+  else
+    cmtobridge = 0;
+  double sim2 = (std::abs(v2[1] - v1[1]) - cmtobridge) * (std::abs(v2[1] - v1[1]) - cmtobridge);
+
+  return ((sim / (fEps * fEps)) + (sim2 / (fEps2 * fEps2 * getWidthFactor(v1, v2)))) < 1;
+}
+
+//------------------------------------------------------------------
+// Fill the neighbourhood of every point using a uniform grid.
+//
+// Bad wires are bridged, so the wire coordinate that enters the
+// ellipse is the position with the intervening bad wires squeezed out:
+// two points can only be neighbours if these differ by less than eps,
+// i.e. if they sit in the same or adjacent grid columns. In time there
+// is a bound only when no bad wire lies between the two points (then
+// the bridging term vanishes and |dt| < eps2 * sqrt(6.25), the clamp of
+// the width factor); each column is therefore split by the count of bad
+// wires below the points, and time sorted buckets with the same count
+// as the test point are binary searched while the others are scanned.
+void cluster::DBScanAlg::BuildNeighborhoods()
+{
+  size_t const nPoints = fps.size();
+  fNeighborStart.assign(nPoints + 1, 0);
+  fNeighbors.clear();
+  fPointBadWires.assign(nPoints, 0);
+  // a zero radius accepts nothing
+  if (nPoints == 0 || !(fEps > 0.) || !(fEps2 > 0.)) return;
+
+  double const wire_dist = fWirePitch[0];
+  std::vector<uint32_t> const badChannels(fBadChannels.begin(), fBadChannels.end());
+
+  // the grid; the widths get a little slack against rounding
+  double const cellWidth = fEps * (1. + 1e-6);
+  double const timeReach = 2.5 * fEps2 * (1. + 1e-6);
+  std::vector<long> column(nPoints);
+  double minPos = std::numeric_limits<double>::max();
+  std::vector<double> squeezedPos(nPoints);
+  for (size_t i = 0; i < nPoints; ++i) {
+    unsigned int wire = (unsigned int)(fps[i][0] / wire_dist + 0.5);
+    fPointBadWires[i] =
+      std::lower_bound(badChannels.begin(), badChannels.end(), wire) - badChannels.begin();
+    squeezedPos[i] = fps[i][0] - fPointBadWires[i] * wire_dist;
+    minPos = std::min(minPos, squeezedPos[i]);
+  }
+  for (size_t i = 0; i < nPoints; ++i)
+    column[i] = (long)std::floor((squeezedPos[i] - minPos) / cellWidth);
+
+  // points ordered by column, bad wire count and time
+  std::vector<unsigned int> order(nPoints);
+  for (size_t i = 0; i < nPoints; ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+    if (column[a] != column[b]) return column[a] < column[b];
+    if (fPointBadWires[a] != fPointBadWires[b]) return fPointBadWires[a] < fPointBadWires[b];
+    if (fps[a][1] != fps[b][1]) return fps[a][1] < fps[b][1];
+    return a < b;
+  });
+  std::vector<double> sortedTime(nPoints);
+  for (size_t k = 0; k < nPoints; ++k)
+    sortedTime[k] = fps[order[k]][1];
+
+  struct GridBucket {
+    long column;
+    unsigned int badWires;
+    unsigned int begin, end; ///< range in order
+  };
+  std::vector<GridBucket> buckets;
+  for (size_t k = 0; k < nPoints; ++k) {
+    unsigned int p = order[k];
+    if (buckets.empty() || buckets.back().column != column[p] ||
+        buckets.back().badWires != fPointBadWires[p])
+      buckets.push_back({column[p], fPointBadWires[p], (unsigned int)k, (unsigned int)k});
+    ++buckets.back().end;
+  }
+
+  // the rows are found in parallel in fixed chunks of points, and then
+  // laid out in point order
+  constexpr size_t chunkSize = 256;
+  size_t const nChunks = (nPoints + chunkSize - 1) / chunkSize;
+  std::vector<std::vector<unsigned int>> chunkNeighbors(nChunks);
+  tbb::parallel_for(
+    tbb::blocked_range<size_t>(0, nChunks), [&](const tbb::blocked_range<size_t>& range) {
+      for (size_t chunk = range.begin(); chunk < range.end(); ++chunk) {
+        std::vector<unsigned int>& rows = chunkNeighbors[chunk];
+        size_t const last = std::min(nPoints, (chunk + 1) * chunkSize);
+        for (size_t i = chunk * chunkSize; i < last; ++i) {
+          size_t const rowBegin = rows.size();
+          double const time = fps[i][1];
+          auto bucket = std::lower_bound(
+            buckets.begin(), buckets.end(), column[i] - 1, [](const GridBucket& b, long col) {
+              return b.column < col;
+            });
+          for (; bucket != buckets.end() && bucket->column <= column[i] + 1; ++bucket) {
+            auto first = sortedTime.begin() + bucket->begin;
+            auto end = sortedTime.begin() + bucket->end;
+            if (bucket->badWires == fPointBadWires[i]) {
+              first = std::lower_bound(first, end, time - timeReach);
+              end = std::upper_bound(first, end, time + timeReach);
+            }
+            for (auto k = first; k != end; ++k) {
+              unsigned int j = order[k - sortedTime.begin()];
+              if (j != i && IsNeighbor(i, j)) rows.push_back(j);
+            }
+          }
+          // findNeighbors returns them in index order
+          std::sort(rows.begin() + rowBegin, rows.end());
+          fNeighborStart[i + 1] = rows.size() - rowBegin;
+        }
+      }
+    });
+
+  for (size_t i = 0; i < nPoints; ++i)
+    fNeighborStart[i + 1] += fNeighborStart[i];
+  fNeighbors.resize(fNeighborStart[nPoints]);
+  for (size_t chunk = 0; chunk < nChunks; ++chunk)
+    std::copy(chunkNeighbors[chunk].begin(),
+              chunkNeighbors[chunk].end(),
+              fNeighbors.begin() + fNeighborStart[chunk * chunkSize]);
+}
+
 //----------------------------------------------------------------
 /////////////////////////////////////////////////////////////////
 // This is the algorithm that finds clusters:
@@ -515,9 +661,9 @@ void cluster::DBScanAlg::run_cluster()
   case 2: return run_dbscan_cluster();
   case 1: return run_FN_cluster();
   default:
-    computeSimilarity();  // watch out for this, they are *slow*
-    computeSimilarity2(); // "
-    computeWidthFactor(); // "
+    // same neighbourhoods as the compute*() + findNeighbors() pair, without
+    // the O(N^2) similarity matrices
+    BuildNeighborhoods();
     return run_FN_naive_cluster();
   }
 }
@@ -726,10 +872,18 @@ void cluster::DBScanAlg::run_FN_cluster()
 /////////////////////////////////////////////////////////////////
 // This is the algorithm that finds clusters:
 //
-// The original findNeighrbor-based code.
+// The original findNeighrbor-based code, running on the neighbourhoods
+// precomputed by BuildNeighborhoods(). Each point is queued at most
+// once per cluster: a point met again has already been visited and
+// assigned, so this expands exactly like the original list that kept
+// the duplicates.
 void cluster::DBScanAlg::run_FN_naive_cluster()
 {
 
+  std::vector<unsigned int> ne; // points queued for the current cluster
+  ne.reserve(fps.size());
+  std::vector<unsigned int> queuedIn(fps.size(), kNO_CLUSTER);
+
   unsigned int cid = 0;
   // foreach pid
   for (size_t pid = 0; pid < fps.size(); ++pid) {
@@ -738,10 +892,11 @@ void cluster::DBScanAlg::run_FN_naive_cluster()
 
       fvisited[pid] = true;
       // get the neighbors
-      std::vector<unsigned int> ne = findNeighbors(pid, fEps, fEps2);
+      unsigned int const* neBegin = fNeighbors.data() + fNeighborStart[pid];
+      unsigned int const* neEnd = fNeighbors.data() + fNeighborStart[pid + 1];
 
       // not enough support -> mark as noise
-      if (ne.size() < fMinPts) { fnoise[pid] = true; }
+      if ((unsigned int)(neEnd - neBegin) < fMinPts) { fnoise[pid] = true; }
       else {
         // Add p to current cluster
 
@@ -749,6 +904,10 @@ void cluster::DBScanAlg::run_FN_naive_cluster()
 
         c.push_back(pid); // assign pid to cluster
         fpointId_to_clusterId[pid] = cid;
+        queuedIn[pid] = cid;
+        ne.assign(neBegin, neEnd);
+        for (unsigned int nPid : ne)
+          queuedIn[nPid] = cid;
         // go to neighbors
         for (size_t i = 0; i < ne.size(); ++i) {
           unsigned int nPid = ne[i];
@@ -757,15 +916,18 @@ void cluster::DBScanAlg::run_FN_naive_cluster()
           if (!fvisited[nPid]) {
             fvisited[nPid] = true;
             // go to neighbors
-            std::vector<unsigned int> ne1 = findNeighbors(nPid, fEps, fEps2);
+            unsigned int const* ne1Begin = fNeighbors.data() + fNeighborStart[nPid];
+            unsigned int const* ne1End = fNeighbors.data() + fNeighborStart[nPid + 1];
             // enough support
-            if (ne1.size() >= fMinPts) {
+            if ((unsigned int)(ne1End - ne1Begin) >= fMinPts) {
 
               // join
 
-              for (unsigned int i = 0; i < ne1.size(); i++) {
+              for (unsigned int const* ne1 = ne1Begin; ne1 != ne1End; ++ne1) {
                 // join neighbord
-                ne.push_back(ne1[i]);
+                if (queuedIn[*ne1] == cid) continue;
+                queuedIn[*ne1] = cid;
+                ne.push_back(*ne1);
               }
             }
           }
@@ -58,13 +58,15 @@ namespace cluster {
       const std::vector<art::Ptr<recob::Hit>>& allhits,
       std::set<uint32_t> badChannels,
       const std::vector<geo::WireID>& wireids = std::vector<geo::WireID>()); //wireids is optional
-    double getSimilarity(const std::vector<double> v1, const std::vector<double> v2);
+    double getSimilarity(const std::vector<double>& v1, const std::vector<double>& v2) const;
+    /// O(N) scan of the fsim matrices; these have to be filled by the
+    /// compute*() methods first, which are O(N^2) in time and memory
     std::vector<unsigned int> findNeighbors(unsigned int pid, double threshold, double threshold2);
     void computeSimilarity();
     void run_cluster();
-    double getSimilarity2(const std::vector<double> v1, const std::vector<double> v2);
+    double getSimilarity2(const std::vector<double>& v1, const std::vector<double>& v2) const;
     void computeSimilarity2();
-    double getWidthFactor(const std::vector<double> v1, const std::vector<double> v2);
+    double getWidthFactor(const std::vector<double>& v1, const std::vector<double>& v2) const;
     void computeWidthFactor();
 
     std::vector<std::vector<unsigned int>> fclusters; ///< collection of something
@@ -99,11 +101,23 @@ namespace cluster {
                                        ///< dead wire counting ala
                                        ///< fBadChannelSum[m]-fBadChannelSum[n].
 
+    // Neighbourhoods of the findNeighbors ellipse for every point, in
+    // compressed row form: the neighbours of point i are
+    // fNeighbors[fNeighborStart[i]] ... fNeighbors[fNeighborStart[i+1]-1]
+    std::vector<unsigned int> fNeighborStart;
+    std::vector<unsigned int> fNeighbors;
+    std::vector<unsigned int> fPointBadWires; ///< bad channels below the wire of each point
+
     // Three differnt version of the clustering code
     void run_dbscan_cluster();
     void run_FN_cluster();
     void run_FN_naive_cluster();
 
+    // Helpers for run_FN_naive_cluster(): a grid search filling
+    // fNeighbors with exactly what findNeighbors() would return
+    void BuildNeighborhoods();
+    bool IsNeighbor(unsigned int p1, unsigned int p2) const;
+
     // Helper routined for run_dbscan_cluster() names and
     // responsibilities taken directly from the paper
     bool ExpandCluster(unsigned int point /* to be added */,
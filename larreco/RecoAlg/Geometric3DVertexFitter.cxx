@@ -1,5 +1,8 @@
 #include "larreco/RecoAlg/Geometric3DVertexFitter.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 trkf::VertexWrapper trkf::Geometric3DVertexFitter::fitPFP(
   detinfo::DetectorPropertiesData const& detProp,
   size_t iPF,
@@ -55,17 +58,20 @@ trkf::VertexWrapper trkf::Geometric3DVertexFitter::fitTracks(
     });
 
   //find pair with closest start positions and put them upfront
+  std::vector<recob::tracking::Point_t> starts;
+  starts.reserve(tracks.size());
+  for (auto const& tk : tracks)
+    starts.push_back(tk.get().Trajectory().Start());
   unsigned int tk0 = tracks.size();
   unsigned int tk1 = tracks.size();
   float mind = FLT_MAX;
   for (unsigned int i = 0; i < tracks.size() - 1; i++) {
     for (unsigned int j = i + 1; j < tracks.size(); j++) {
-      float d =
-        (tracks[i].get().Trajectory().Start() - tracks[j].get().Trajectory().Start()).Mag2();
+      float d = (starts[i] - starts[j]).Mag2();
       if (debugLevel > 1)
-        std::cout << "test i=" << i << " start=" << tracks[i].get().Trajectory().Start()
-                  << " j=" << j << " start=" << tracks[j].get().Trajectory().Start() << " d=" << d
-                  << " mind=" << mind << " tk0=" << tk0 << " tk1=" << tk1 << std::endl;
+        std::cout << "test i=" << i << " start=" << starts[i] << " j=" << j
+                  << " start=" << starts[j] << " d=" << d << " mind=" << mind << " tk0=" << tk0
+                  << " tk1=" << tk1 << std::endl;
       if (d < mind) {
         mind = d;
         tk0 = i;
@@ -89,12 +95,7 @@ trkf::VertexWrapper trkf::Geometric3DVertexFitter::fitTracks(
   if (vtx.isValid() == false || vtx.tracksSize() < 2) return vtx;
 
   // then add other tracks and update vertex measurement
-  for (auto tk = tracks.begin() + 2; tk < tracks.end(); ++tk) {
-    auto sipv = sip(detProp, vtx, *tk);
-    if (debugLevel > 1) std::cout << "sip=" << sipv << std::endl;
-    if (sipv > sipCut) continue;
-    addTrackToVertex(detProp, vtx, *tk);
-  }
+  addCompatibleTracks(detProp, vtx, tracks);
   return vtx;
 }
 
@@ -125,13 +126,22 @@ trkf::VertexWrapper trkf::Geometric3DVertexFitter::fitTracksWithVtx(
   if (vtx.isValid() == false || vtx.tracks().size() < 2) return vtx;
 
   // then add other tracks and update vertex measurement
+  addCompatibleTracks(detProp, vtx, tracks);
+  return vtx;
+}
+
+void trkf::Geometric3DVertexFitter::addCompatibleTracks(
+  detinfo::DetectorPropertiesData const& detProp,
+  VertexWrapper& vtx,
+  const TrackRefVec& tracks) const
+{
   for (auto tk = tracks.begin() + 2; tk < tracks.end(); ++tk) {
-    auto sipv = sip(detProp, vtx, *tk);
+    ParsCovsOnPlane pcp = getParsCovsOnPlane(detProp, vtx, *tk);
+    auto sipv = sip(pcp);
     if (debugLevel > 1) std::cout << "sip=" << sipv << std::endl;
     if (sipv > sipCut) continue;
-    addTrackToVertex(detProp, vtx, *tk);
+    addTrackToVertex(vtx, *tk, pcp);
   }
-  return vtx;
 }
 
 std::pair<trkf::TrackState, double> trkf::Geometric3DVertexFitter::weightedAverageState(
@@ -198,6 +208,21 @@ std::pair<trkf::TrackState, double> trkf::Geometric3DVertexFitter::weightedAvera
   return std::make_pair(vtxstate, chi2);
 }
 
+std::pair<double, double> trkf::Geometric3DVertexFitter::closestApproach(
+  const recob::tracking::Point_t& start1,
+  const recob::tracking::Vector_t& dir1,
+  const recob::tracking::Point_t& start2,
+  const recob::tracking::Vector_t& dir2)
+{
+  const auto dpos = start1 - start2;
+  const auto dotd1d2 = dir1.Dot(dir2);
+  const auto dotdpd1 = dpos.Dot(dir1);
+  const auto dotdpd2 = dpos.Dot(dir2);
+  const auto dist2 = (dotd1d2 * dotdpd1 - dotdpd2) / (dotd1d2 * dotd1d2 - 1);
+  const auto dist1 = (dotd1d2 * dist2 - dotdpd1);
+  return {dist1, dist2};
+}
+
 trkf::VertexWrapper trkf::Geometric3DVertexFitter::closestPointAlongTrack(
   detinfo::DetectorPropertiesData const& detProp,
   const recob::Track& track,
@@ -219,12 +244,7 @@ trkf::VertexWrapper trkf::Geometric3DVertexFitter::closestPointAlongTrack(
     std::cout << "covariance=\n" << other.VertexCovarianceGlobal6D() << std::endl;
   }
 
-  const auto dpos = start1 - start2;
-  const auto dotd1d2 = dir1.Dot(dir2);
-  const auto dotdpd1 = dpos.Dot(dir1);
-  const auto dotdpd2 = dpos.Dot(dir2);
-  const auto dist2 = (dotd1d2 * dotdpd1 - dotdpd2) / (dotd1d2 * dotd1d2 - 1);
-  const auto dist1 = (dotd1d2 * dist2 - dotdpd1);
+  const auto [dist1, dist2] = closestApproach(start1, dir1, start2, dir2);
 
   if (debugLevel > 0) {
     std::cout << "track1 pca=" << start1 + dist1 * dir1 << " dist=" << dist1 << std::endl;
@@ -279,14 +299,7 @@ trkf::VertexWrapper trkf::Geometric3DVertexFitter::fitTwoTracks(
     std::cout << "covariance=\n" << tk2.VertexCovarianceGlobal6D() << std::endl;
   }
 
-  auto dpos = start1 - start2;
-  auto dotd1d2 = dir1.Dot(dir2);
-
-  auto dotdpd1 = dpos.Dot(dir1);
-  auto dotdpd2 = dpos.Dot(dir2);
-
-  auto dist2 = (dotd1d2 * dotdpd1 - dotdpd2) / (dotd1d2 * dotd1d2 - 1);
-  auto dist1 = (dotd1d2 * dist2 - dotdpd1);
+  const auto [dist1, dist2] = closestApproach(start1, dir1, start2, dir2);
 
   //by construction both point of closest approach on the two lines lie on this plane
   recob::tracking::Plane target(start1 + dist1 * dir1, dir1);
@@ -426,14 +439,20 @@ void trkf::Geometric3DVertexFitter::addTrackToVertex(detinfo::DetectorProperties
                                                      trkf::VertexWrapper& vtx,
                                                      const recob::Track& tk) const
 {
+  ParsCovsOnPlane pcp = getParsCovsOnPlane(detProp, vtx, tk);
+  addTrackToVertex(vtx, tk, pcp);
+}
 
+void trkf::Geometric3DVertexFitter::addTrackToVertex(trkf::VertexWrapper& vtx,
+                                                     const recob::Track& tk,
+                                                     ParsCovsOnPlane& pcp) const
+{
   if (debugLevel > 0) {
     std::cout << "adding track with start=" << tk.Start() << " dir=" << tk.StartDirection()
               << " length=" << tk.Length() << " points=" << tk.CountValidPoints() << std::endl;
     std::cout << "covariance=\n" << tk.VertexCovarianceGlobal6D() << std::endl;
   }
 
-  ParsCovsOnPlane pcp = getParsCovsOnPlane(detProp, vtx, tk);
   std::pair<TrackState, double> was = weightedAverageState(pcp);
   if (was.second <= (util::kBogusD - 1.)) { return; }
 
@@ -611,48 +630,62 @@ std::vector<recob::VertexAssnMeta> trkf::Geometric3DVertexFitter::computeMeta(
   const VertexWrapper& vtx,
   const TrackRefVec& trks)
 {
-  std::vector<recob::VertexAssnMeta> result;
-  for (auto tk : trks) {
-    float d = util::kBogusF;
-    float i = util::kBogusF;
-    float e = util::kBogusF;
-    float c = util::kBogusF;
-    auto ittoerase = vtx.findTrack(tk);
+  std::vector<recob::VertexAssnMeta> result(trks.size());
+  // each track needs its own unbiased vertex fit; the fits only read the vertex and the tracks
+  if (parallelMeta && debugLevel == 0) {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, trks.size()),
+                      [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t itk = r.begin(); itk != r.end(); ++itk)
+                          result[itk] = trackMeta(detProp, vtx, trks[itk]);
+                      });
+  }
+  else {
+    for (std::size_t itk = 0; itk < trks.size(); ++itk)
+      result[itk] = trackMeta(detProp, vtx, trks[itk]);
+  }
+  return result;
+}
+
+recob::VertexAssnMeta trkf::Geometric3DVertexFitter::trackMeta(
+  detinfo::DetectorPropertiesData const& detProp,
+  const VertexWrapper& vtx,
+  const recob::Track& tk) const
+{
+  float d = util::kBogusF;
+  float i = util::kBogusF;
+  float e = util::kBogusF;
+  float c = util::kBogusF;
+  auto ittoerase = vtx.findTrack(tk);
+  if (debugLevel > 1)
+    std::cout << "computeMeta for vertex with ntracks=" << vtx.tracksSize() << std::endl;
+  auto ubvtx = unbiasedVertex(detProp, vtx, tk);
+  if (debugLevel > 1)
+    std::cout << "got unbiased vertex with ntracks=" << ubvtx.tracksSize()
+              << " isValid=" << ubvtx.isValid() << std::endl;
+  if (ubvtx.isValid()) {
+    d = pDist(ubvtx, tk);
+    auto pcop = getParsCovsOnPlane(detProp, ubvtx, tk);
+    i = ip(pcop);
+    e = ipErr(pcop);
+    c = chi2(pcop);
     if (debugLevel > 1)
-      std::cout << "computeMeta for vertex with ntracks=" << vtx.tracksSize() << std::endl;
-    auto ubvtx = unbiasedVertex(detProp, vtx, tk.get());
+      std::cout << "unbiasedVertex d=" << d << " i=" << i << " e=" << e << " c=" << c << std::endl;
+  }
+  else if (vtx.tracksSize() == 2 && ittoerase != vtx.tracksSize()) {
+    auto tks = vtx.tracksWithoutElement(ittoerase);
+    auto fakevtx = closestPointAlongTrack(detProp, tks[0], tk);
+    d = pDist(fakevtx, tk);
+    // these will be identical for the two tracks (modulo numerical instabilities in the matrix inversion for the chi2)
+    auto pcop = getParsCovsOnPlane(detProp, fakevtx, tk);
+    i = ip(pcop);
+    e = ipErr(pcop);
+    c = chi2(pcop);
     if (debugLevel > 1)
-      std::cout << "got unbiased vertex with ntracks=" << ubvtx.tracksSize()
-                << " isValid=" << ubvtx.isValid() << std::endl;
-    if (ubvtx.isValid()) {
-      d = pDist(ubvtx, tk.get());
-      auto pcop = getParsCovsOnPlane(detProp, ubvtx, tk.get());
-      i = ip(pcop);
-      e = ipErr(pcop);
-      c = chi2(pcop);
-      if (debugLevel > 1)
-        std::cout << "unbiasedVertex d=" << d << " i=" << i << " e=" << e << " c=" << c
-                  << std::endl;
-    }
-    else if (vtx.tracksSize() == 2 && ittoerase != vtx.tracksSize()) {
-      auto tks = vtx.tracksWithoutElement(ittoerase);
-      auto fakevtx = closestPointAlongTrack(detProp, tks[0], tk);
-      d = pDist(fakevtx, tk.get());
-      // these will be identical for the two tracks (modulo numerical instabilities in the matrix inversion for the chi2)
-      auto pcop = getParsCovsOnPlane(detProp, fakevtx, tk.get());
-      i = ip(pcop);
-      e = ipErr(pcop);
-      c = chi2(pcop);
-      if (debugLevel > 1)
-        std::cout << "closestPointAlongTrack d=" << d << " i=" << i << " e=" << e << " c=" << c
-                  << std::endl;
-    }
-    if (ittoerase == vtx.tracksSize()) {
-      result.push_back(recob::VertexAssnMeta(d, i, e, c, recob::VertexAssnMeta::NotUsedInFit));
-    }
-    else {
-      result.push_back(recob::VertexAssnMeta(d, i, e, c, recob::VertexAssnMeta::IncludedInFit));
-    }
+      std::cout << "closestPointAlongTrack d=" << d << " i=" << i << " e=" << e << " c=" << c
+                << std::endl;
   }
-  return result;
+  if (ittoerase == vtx.tracksSize()) {
+    return recob::VertexAssnMeta(d, i, e, c, recob::VertexAssnMeta::NotUsedInFit);
+  }
+  return recob::VertexAssnMeta(d, i, e, c, recob::VertexAssnMeta::IncludedInFit);
 }
@@ -69,6 +69,10 @@ namespace trkf {
         Name("sipCut"),
         Comment(
           "Cut on maximum impact parameter significance to use the track in the vertex fit.")};
+      fhicl::Atom<bool> parallelMeta{
+        Name("parallelMeta"),
+        Comment("Compute the association metadata (unbiased vertex) of the tracks in parallel."),
+        false};
     };
 
     struct TracksFromVertexSorter {
@@ -100,7 +104,7 @@ namespace trkf {
     // Constructor
     Geometric3DVertexFitter(const fhicl::Table<Config>& o,
                             const fhicl::Table<TrackStatePropagator::Config>& p)
-      : debugLevel(o().debugLevel()), sipCut(o().sipCut())
+      : debugLevel(o().debugLevel()), sipCut(o().sipCut()), parallelMeta(o().parallelMeta())
     {
       prop = std::make_unique<TrackStatePropagator>(p);
     }
@@ -177,6 +181,22 @@ namespace trkf {
     std::unique_ptr<TrackStatePropagator> prop;
     int debugLevel;
     double sipCut;
+    bool parallelMeta;
+
+    /// Adds the tracks after the first two to vtx if their impact parameter significance passes
+    /// sipCut; the track state on the plane is propagated once for both the cut and the update
+    void addCompatibleTracks(detinfo::DetectorPropertiesData const& detProp,
+                             VertexWrapper& vtx,
+                             const TrackRefVec& tracks) const;
+    void addTrackToVertex(VertexWrapper& vtx, const recob::Track& tk, ParsCovsOnPlane& pcp) const;
+    recob::VertexAssnMeta trackMeta(detinfo::DetectorPropertiesData const& detProp,
+                                    const VertexWrapper& vtx,
+                                    const recob::Track& tk) const;
+    /// Signed distances from the two starts to the points of closest approach of the start lines
+    static std::pair<double, double> closestApproach(const recob::tracking::Point_t& start1,
+                                                     const recob::tracking::Vector_t& dir1,
+                                                     const recob::tracking::Point_t& start2,
+                                                     const recob::tracking::Vector_t& dir2);
 
     double chi2(const ParsCovsOnPlane& pcp) const;
     double ip(const ParsCovsOnPlane& pcp) const;
@@ -27,6 +27,10 @@
 #include <stdint.h> // uint32_t
 #include <vector>
 
+// TBB libraries
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 // ROOT/CLHEP libraries
 #include "CLHEP/Random/RandFlat.h"
 #include <TStopwatch.h>
@@ -72,16 +76,80 @@ constexpr double PI = M_PI; // or CLHEP::pi in CLHEP/Units/PhysicalConstants.h
 #define _cos(x) _sin(TMath::Pi() * 0.5 - (x))
 
 namespace cluster {
+
+  /**
+   * @brief Hough accumulator made of dense tiles of counters
+   *
+   * Each angle row holds a window of tile slots that grows to cover the
+   * distances touched so far, and a tile of TileSize contiguous counters is
+   * allocated the first time one of its counters is changed. Counters that
+   * were never touched read as 0, like in HoughTransformCounters.
+   * The angle range is split in bands of BandSize rows; each band owns the
+   * storage of its tiles, so different bands can be filled concurrently.
+   */
+  class DenseHoughAccumulator {
+  public:
+    using Counter_t = signed char;
+    static constexpr int TileSize = 64;
+    static constexpr unsigned int BandSize = 1024;
+
+    void Init(unsigned int numAngles);
+
+    unsigned int NBands() const { return m_bands.size(); }
+    /// Returns the first and the last + 1 angle of the band
+    std::pair<unsigned int, unsigned int> BandAngles(unsigned int band) const;
+
+    int Get(int angle, int dist) const;
+    void Set(int angle, int dist, int value);
+
+    /**
+     * @brief Adds delta to the counters [first_dist, end_dist [ of an angle
+     * @return the largest counter after the change and its distance
+     *
+     * Only counters strictly larger than min_max are considered, and the
+     * lowest distance is returned among equal ones; if there is none, the
+     * value is min_max and the distance is -1.
+     */
+    std::pair<int, int> AddRange(int angle, int first_dist, int end_dist, int delta, int min_max);
+
+    /// Returns the largest counter (lowest angle, then lowest distance first)
+    int GetMax(int& angle, int& dist) const;
+
+  private:
+    struct Row_t {
+      int firstTile = 0;
+      std::vector<unsigned int> slots; ///< tile index + 1 in the band; 0 if none
+    };
+    using Tile_t = std::array<Counter_t, TileSize>;
+
+    std::vector<Row_t> m_rows;
+    std::vector<std::vector<Tile_t>> m_bands; ///< tile storage of each band
+
+    static int TileOf(int dist) { return (dist >= 0) ? dist / TileSize : (dist + 1) / TileSize - 1; }
+    Counter_t const* FindTile(int angle, int tile) const;
+    Counter_t* GetTile(int angle, int tile);
+  }; // class DenseHoughAccumulator
+
   class HoughTransform {
   public:
-    void Init(unsigned int dx, unsigned int dy, float rhores, unsigned int numACells);
+    void Init(unsigned int dx,
+              unsigned int dy,
+              float rhores,
+              unsigned int numACells,
+              bool dense = false);
     std::array<int, 3> AddPointReturnMax(int x, int y);
     bool SubtractPoint(int x, int y);
     int GetCell(int row, int col) const;
-    void SetCell(int row, int col, int value) { m_accum[row].set(col, value); }
+    void SetCell(int row, int col, int value)
+    {
+      if (m_dense)
+        m_denseAccum.Set(row, col, value);
+      else
+        m_accum[row].set(col, value);
+    }
     void GetAccumSize(int& numRows, int& numCols)
     {
-      numRows = m_accum.size();
+      numRows = m_dense ? (int)m_numAngleCells : (int)m_accum.size();
       numCols = (int)m_rowLength;
     }
     int NumAccumulated() { return m_numAccumulated; }
@@ -107,11 +175,14 @@ namespace cluster {
     // the vector elements are called by rho, theta is the container key,
     // the number of hits is the value corresponding to the key
     HoughImage_t m_accum; ///< column (map key)=rho, row (vector index)=theta
+    bool m_dense = false; ///< use m_denseAccum instead of m_accum
+    DenseHoughAccumulator m_denseAccum;
     int m_numAccumulated;
     std::vector<double> m_cosTable;
     std::vector<double> m_sinTable;
 
     std::array<int, 3> DoAddPointReturnMax(int x, int y, bool bSubtract = false);
+    std::array<int, 3> DoAddPointReturnMaxDense(int x, int y, bool bSubtract);
   }; // class HoughTransform
 }
 
@@ -248,6 +319,120 @@ cluster::HoughTransformCounters<K, C, S, A, SC>::unchecked_add_range_max(
                                  min_max);
 } // cluster::HoughTransformCounters<>::unchecked_add_range_max(no hint)
 
+//------------------------------------------------------------------------------
+void cluster::DenseHoughAccumulator::Init(unsigned int numAngles)
+{
+  m_rows.clear();
+  m_rows.resize(numAngles);
+  m_bands.clear();
+  m_bands.resize((numAngles + BandSize - 1) / BandSize);
+} // cluster::DenseHoughAccumulator::Init()
+
+//------------------------------------------------------------------------------
+std::pair<unsigned int, unsigned int> cluster::DenseHoughAccumulator::BandAngles(
+  unsigned int band) const
+{
+  unsigned int const first = band * BandSize;
+  return {first, std::min<unsigned int>(first + BandSize, m_rows.size())};
+} // cluster::DenseHoughAccumulator::BandAngles()
+
+//------------------------------------------------------------------------------
+cluster::DenseHoughAccumulator::Counter_t const* cluster::DenseHoughAccumulator::FindTile(
+  int angle,
+  int tile) const
+{
+  Row_t const& row = m_rows[angle];
+  int const slot = tile - row.firstTile;
+  if (slot < 0 || slot >= (int)row.slots.size() || row.slots[slot] == 0) return nullptr;
+  return m_bands[angle / BandSize][row.slots[slot] - 1].data();
+} // cluster::DenseHoughAccumulator::FindTile()
+
+//------------------------------------------------------------------------------
+cluster::DenseHoughAccumulator::Counter_t* cluster::DenseHoughAccumulator::GetTile(int angle,
+                                                                                   int tile)
+{
+  Row_t& row = m_rows[angle];
+  // grow the window of slots to include this tile
+  if (row.slots.empty())
+    row.firstTile = tile;
+  else if (tile < row.firstTile) {
+    row.slots.insert(row.slots.begin(), row.firstTile - tile, 0);
+    row.firstTile = tile;
+  }
+  unsigned int const slot = tile - row.firstTile;
+  if (slot >= row.slots.size()) row.slots.resize(slot + 1, 0);
+
+  std::vector<Tile_t>& tiles = m_bands[angle / BandSize];
+  if (row.slots[slot] == 0) {
+    tiles.emplace_back();
+    tiles.back().fill(0);
+    row.slots[slot] = tiles.size();
+  }
+  return tiles[row.slots[slot] - 1].data();
+} // cluster::DenseHoughAccumulator::GetTile()
+
+//------------------------------------------------------------------------------
+int cluster::DenseHoughAccumulator::Get(int angle, int dist) const
+{
+  int const tile = TileOf(dist);
+  Counter_t const* counters = FindTile(angle, tile);
+  return counters ? counters[dist - tile * TileSize] : 0;
+} // cluster::DenseHoughAccumulator::Get()
+
+//------------------------------------------------------------------------------
+void cluster::DenseHoughAccumulator::Set(int angle, int dist, int value)
+{
+  int const tile = TileOf(dist);
+  // an untouched counter is already 0
+  if (value == 0 && !FindTile(angle, tile)) return;
+  GetTile(angle, tile)[dist - tile * TileSize] = value;
+} // cluster::DenseHoughAccumulator::Set()
+
+//------------------------------------------------------------------------------
+std::pair<int, int> cluster::DenseHoughAccumulator::AddRange(int angle,
+                                                             int first_dist,
+                                                             int end_dist,
+                                                             int delta,
+                                                             int min_max)
+{
+  std::pair<int, int> max{min_max, -1};
+  int dist = first_dist;
+  while (dist < end_dist) {
+    int const tile = TileOf(dist);
+    int const tileStart = tile * TileSize;
+    int const stop = std::min(end_dist, tileStart + TileSize);
+    Counter_t* counters = GetTile(angle, tile);
+    // the counters of a tile are contiguous; this loop is vectorizable
+    for (int i = dist - tileStart; i < stop - tileStart; ++i)
+      counters[i] += delta;
+    for (int i = dist - tileStart; i < stop - tileStart; ++i) {
+      if (counters[i] > max.first) max = {counters[i], tileStart + i};
+    }
+    dist = stop;
+  } // while
+  return max;
+} // cluster::DenseHoughAccumulator::AddRange()
+
+//------------------------------------------------------------------------------
+int cluster::DenseHoughAccumulator::GetMax(int& angle, int& dist) const
+{
+  int maxVal = -1;
+  for (unsigned int iAngle = 0; iAngle < m_rows.size(); ++iAngle) {
+    Row_t const& row = m_rows[iAngle];
+    for (unsigned int slot = 0; slot < row.slots.size(); ++slot) {
+      if (row.slots[slot] == 0) continue;
+      Tile_t const& tile = m_bands[iAngle / BandSize][row.slots[slot] - 1];
+      int const tileMax = *std::max_element(tile.begin(), tile.end());
+      if (tileMax <= maxVal) continue;
+      maxVal = tileMax;
+      angle = iAngle;
+      dist = (row.firstTile + (int)slot) * TileSize +
+             (std::find(tile.begin(), tile.end(), tileMax) - tile.begin());
+    } // slot
+  }   // iAngle
+  return maxVal;
+} // cluster::DenseHoughAccumulator::GetMax()
+
 //------------------------------------------------------------------------------
 cluster::HoughBaseAlg::HoughBaseAlg(fhicl::ParameterSet const& pset)
 {
@@ -264,6 +449,7 @@ cluster::HoughBaseAlg::HoughBaseAlg(fhicl::ParameterSet const& pset)
   fMissedHits = pset.get<int>("MissedHits");
   fMissedHitsDistance = pset.get<float>("MissedHitsDistance");
   fMissedHitsToLineSize = pset.get<float>("MissedHitsToLineSize");
+  fDenseAccumulator = pset.get<bool>("DenseAccumulator", false);
 }
 
 //------------------------------------------------------------------------------
@@ -377,7 +563,7 @@ size_t cluster::HoughBaseAlg::Transform(
 
   ///Init specifies the size of the two-dimensional accumulator
   ///(based on the arguments, number of wires and number of time samples).
-  c.Init(dx, dy, fRhoResolutionFactor, fNumAngleCells);
+  c.Init(dx, dy, fRhoResolutionFactor, fNumAngleCells, fDenseAccumulator);
   /// Adds all of the hits to the accumulator
 
   c.GetAccumSize(accDy, accDx);
@@ -638,6 +824,7 @@ size_t cluster::HoughBaseAlg::Transform(
 //------------------------------------------------------------------------------
 inline int cluster::HoughTransform::GetCell(int row, int col) const
 {
+  if (m_dense) return m_denseAccum.Get(row, col);
   return m_accum[row][col];
 } // cluster::HoughTransform::GetCell()
 
@@ -666,10 +853,12 @@ inline bool cluster::HoughTransform::SubtractPoint(int x, int y)
 void cluster::HoughTransform::Init(unsigned int dx,
                                    unsigned int dy,
                                    float rhores,
-                                   unsigned int numACells)
+                                   unsigned int numACells,
+                                   bool dense /* = false */)
 {
   m_numAngleCells = numACells;
   m_rhoResolutionFactor = rhores;
+  m_dense = dense;
 
   m_accum.clear();
   //--- BEGIN issue #19494 -----------------------------------------------------
@@ -697,7 +886,10 @@ void cluster::HoughTransform::Init(unsigned int dx,
   m_dx = dx;
   m_dy = dy;
   m_rowLength = (unsigned int)(m_rhoResolutionFactor * 2 * std::sqrt(dx * dx + dy * dy));
-  m_accum.resize(m_numAngleCells);
+  if (m_dense)
+    m_denseAccum.Init(m_numAngleCells);
+  else
+    m_accum.resize(m_numAngleCells);
 
   // this math must be coherent with the one in GetEquation()
   double angleStep = PI / m_numAngleCells;
@@ -720,6 +912,7 @@ void cluster::HoughTransform::GetEquation(float row, float col, float& rho, floa
 //------------------------------------------------------------------------------
 int cluster::HoughTransform::GetMax(int& xmax, int& ymax) const
 {
+  if (m_dense) return m_denseAccum.GetMax(xmax, ymax);
   int maxVal = -1;
   for (unsigned int i = 0; i < m_accum.size(); i++) {
 
@@ -741,6 +934,8 @@ std::array<int, 3> cluster::HoughTransform::DoAddPointReturnMax(int x,
                                                                 int y,
                                                                 bool bSubtract /* = false */)
 {
+  if (m_dense) return DoAddPointReturnMaxDense(x, y, bSubtract);
+
   std::array<int, 3> max;
   max.fill(-1);
 
@@ -829,6 +1024,70 @@ std::array<int, 3> cluster::HoughTransform::DoAddPointReturnMax(int x,
   return max;
 } // cluster::HoughTransform::DoAddPointReturnMax()
 
+//------------------------------------------------------------------------------
+// Same as DoAddPointReturnMax() on the dense accumulator. Each band of angles
+// is filled by its own task, and the band maxima are combined in angle order,
+// which gives the same maximum as the serial loop over the angles.
+std::array<int, 3> cluster::HoughTransform::DoAddPointReturnMaxDense(int x, int y, bool bSubtract)
+{
+  const int distCenter = (int)(m_rowLength / 2.);
+  auto distAt = [&](size_t iAngleStep) {
+    return (int)(distCenter + m_rhoResolutionFactor *
+                                (m_cosTable[iAngleStep] * x + m_sinTable[iAngleStep] * y));
+  };
+
+  std::vector<std::array<int, 3>> bandMax(m_denseAccum.NBands());
+  tbb::parallel_for(
+    tbb::blocked_range<unsigned int>(0, m_denseAccum.NBands()),
+    [&](const tbb::blocked_range<unsigned int>& range) {
+      for (unsigned int band = range.begin(); band != range.end(); ++band) {
+        std::array<int, 3>& max = bandMax[band];
+        max.fill(-1);
+        // lines with just two aligned hits are ignored
+        int max_val = 2;
+        auto const [firstAngle, endAngle] = m_denseAccum.BandAngles(band);
+        size_t const startAngle = std::max(firstAngle, 1U);
+        // the distance the previous angle ended at, as in the serial loop
+        int lastDist = (startAngle == 1) ? (int)(distCenter + (m_rhoResolutionFactor * x)) :
+                                           distAt(startAngle - 1);
+        for (size_t iAngleStep = startAngle; iAngleStep < endAngle; ++iAngleStep) {
+          const int dist = distAt(iAngleStep);
+          int first_dist;
+          int end_dist;
+          if (lastDist == dist) {
+            first_dist = dist;
+            end_dist = dist + 1;
+          }
+          else {
+            first_dist = dist > lastDist ? lastDist : dist + 1;
+            end_dist = dist > lastDist ? dist : lastDist + 1;
+          }
+          std::pair<int, int> const max_counter = m_denseAccum.AddRange(
+            iAngleStep, first_dist, end_dist, bSubtract ? -1 : +1, max_val);
+          if (!bSubtract && max_counter.first > max_val) {
+            max = {{max_counter.first, max_counter.second, (int)iAngleStep}};
+            max_val = max_counter.first;
+          }
+          lastDist = dist;
+        } // iAngleStep
+      }   // band
+    });
+
+  std::array<int, 3> max;
+  max.fill(-1);
+  int max_val = 2;
+  for (auto const& band : bandMax) {
+    if (band[0] <= max_val) continue;
+    max = band;
+    max_val = band[0];
+  } // band
+  if (bSubtract)
+    --m_numAccumulated;
+  else
+    ++m_numAccumulated;
+  return max;
+} // cluster::HoughTransform::DoAddPointReturnMaxDense()
+
 //------------------------------------------------------------------------------
 //this method saves a BMP image of the Hough Accumulator, which can be viewed with gimp
 void cluster::HoughBaseAlg::HLSSaveBMPFile(const char* fileName, unsigned char* pix, int dx, int dy)
@@ -1092,7 +1351,7 @@ size_t cluster::HoughBaseAlg::FastTransform(detinfo::DetectorClocksData const& c
   //Init specifies the size of the two-dimensional accumulator
   //(based on the arguments, number of wires and number of time samples).
   //adds all of the hits (that have not yet been associated with a line) to the accumulator
-  c.Init(dx, dy, fRhoResolutionFactor, fNumAngleCells);
+  c.Init(dx, dy, fRhoResolutionFactor, fNumAngleCells, fDenseAccumulator);
 
   // count is how many points are left to randomly insert
   unsigned int count = hit.size();
@@ -1364,7 +1623,7 @@ size_t cluster::HoughBaseAlg::Transform(detinfo::DetectorPropertiesData const& d
   int dx = wireReadoutGeom.Nwires(geo::PlaneID{0, 0, 0}); // number of wires
   const int dy = detProp.ReadOutWindowSize();             // number of time samples.
 
-  c.Init(dx, dy, fRhoResolutionFactor, fNumAngleCells);
+  c.Init(dx, dy, fRhoResolutionFactor, fNumAngleCells, fDenseAccumulator);
 
   for (unsigned int i = 0; i < hits.size(); ++i) {
     c.AddPointReturnMax(hits[i]->WireID().Wire, (int)(hits[i]->PeakTime()));
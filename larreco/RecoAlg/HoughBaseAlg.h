@@ -120,6 +120,12 @@
 // architectures. No check is performed for overflow; that can also be
 // implemented at a small cost.
 //
+// Alternatively (DenseAccumulator parameter), each angle keeps a flat window
+// of dense tiles of 64 counters, allocated when first touched, and the angle
+// range is split in bands that are filled concurrently for each hit; the
+// maximum is tracked per band and combined in angle order, so that the result
+// is the same as with the map.
+//
 //
 ////////////////////////////////////////////////////////////////////////
 #ifndef HOUGHBASEALG_H
@@ -542,6 +548,7 @@ namespace cluster {
       fMissedHitsDistance; ///< Distance between hits in a hough line before a hit is considered missed
     float
       fMissedHitsToLineSize; ///< Ratio of missed hits to line size for a line to be considered a fake
+    bool fDenseAccumulator;  ///< Use the dense tiled accumulator, filled in parallel over angles
   };
 
 } // namespace
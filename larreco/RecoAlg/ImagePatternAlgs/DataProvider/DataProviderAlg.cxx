@@ -22,7 +22,7 @@ namespace detinfo {
 #include "CLHEP/Random/RandGauss.h"
 
 #include <algorithm>
-#include <optional>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -108,34 +108,31 @@ img::DataProviderAlg::DataProviderAlg(const Config& config)
 img::DataProviderAlg::~DataProviderAlg() = default;
 // ------------------------------------------------------
 
-img::DataProviderAlgView img::DataProviderAlg::resizeView(
-  detinfo::DetectorClocksData const& clock_data,
-  detinfo::DetectorPropertiesData const& det_prop,
-  size_t wires,
-  size_t drifts)
+void img::DataProviderAlg::resizeView(detinfo::DetectorClocksData const& clock_data,
+                                      detinfo::DetectorPropertiesData const& det_prop,
+                                      size_t wires,
+                                      size_t drifts)
 {
-  img::DataProviderAlgView result;
-  result.fNWires = wires;
-  result.fNDrifts = drifts;
-  result.fNScaledDrifts = drifts / fDriftWindow;
-  result.fNCachedDrifts = fDownscaleFullView ? result.fNScaledDrifts : drifts;
+  // assign() keeps the capacity, so the buffers are allocated only when the plane grows
+  fAlgView.fNWires = wires;
+  fAlgView.fNDrifts = drifts;
+  fAlgView.fNScaledDrifts = drifts / fDriftWindow;
+  fAlgView.fNCachedDrifts = fDownscaleFullView ? fAlgView.fNScaledDrifts : drifts;
 
-  result.fWireChannels.resize(wires, raw::InvalidChannelID);
+  fAlgView.fWireChannels.assign(wires, raw::InvalidChannelID);
 
-  result.fWireDriftData.resize(wires, std::vector<float>(result.fNCachedDrifts, fAdcZero));
+  fAlgView.fWireDriftData.assign(wires * fAlgView.fNCachedDrifts, fAdcZero);
 
-  result.fLifetimeCorrFactors.resize(drifts);
+  fAlgView.fLifetimeCorrFactors.resize(drifts);
   if (fCalibrateLifetime) {
-    for (size_t t = 0; t < drifts; ++t) {
-      result.fLifetimeCorrFactors[t] = fCalorimetryAlg.LifetimeCorrection(clock_data, det_prop, t);
-    }
+    std::vector<double> ticks(drifts), factors(drifts);
+    std::iota(ticks.begin(), ticks.end(), 0.);
+    fCalorimetryAlg.LifetimeCorrection(clock_data, det_prop, ticks, 0., factors);
+    std::copy(factors.begin(), factors.end(), fAlgView.fLifetimeCorrFactors.begin());
   }
   else {
-    for (size_t t = 0; t < drifts; ++t) {
-      result.fLifetimeCorrFactors[t] = 1.0;
-    }
+    std::fill(fAlgView.fLifetimeCorrFactors.begin(), fAlgView.fLifetimeCorrFactors.end(), 1.0F);
   }
-  return result;
 }
 // ------------------------------------------------------
 
@@ -157,7 +154,7 @@ float img::DataProviderAlg::poolMax(int wire, int drift, size_t r) const
 
   float adc, max_adc = 0;
   for (int w = w0; w <= w1; ++w) {
-    auto const* col = fAlgView.fWireDriftData[w].data();
+    auto const* col = wireData(w);
     for (int d = d0; d <= d1; ++d) {
       adc = col[d];
       if (adc > max_adc) { max_adc = adc; }
@@ -190,40 +187,61 @@ float img::DataProviderAlg::poolMax(int wire, int drift, size_t r) const
 //    return sum;
 //}
 // ------------------------------------------------------
-std::vector<float> img::DataProviderAlg::downscaleMax(std::size_t dst_size,
-                                                      std::vector<float> const& adc,
-                                                      size_t tick0) const
+// Samples without a lifetime correction factor are beyond the readout window and do not
+// contribute to the downscaled pixels.
+size_t img::DataProviderAlg::validSamples(std::size_t adc_size, size_t tick0) const
+{
+  size_t const nFactors = fAlgView.fLifetimeCorrFactors.size();
+  return (tick0 < nFactors) ? std::min(adc_size, nFactors - tick0) : 0;
+}
+
+void img::DataProviderAlg::downscaleMax(float* dst,
+                                        std::size_t dst_size,
+                                        float const* adc,
+                                        std::size_t adc_size,
+                                        size_t tick0) const
 {
-  size_t kStop = dst_size;
-  std::vector<float> result(dst_size);
-  if (adc.size() < kStop) { kStop = adc.size(); }
+  size_t kStop = std::min(dst_size, adc_size);
+  size_t const nValid = validSamples(adc_size, tick0);
+  auto const* lf = fAlgView.fLifetimeCorrFactors.data() + tick0;
   for (size_t i = 0, k0 = 0; i < kStop; ++i, k0 += fDriftWindow) {
-    size_t k1 = k0 + fDriftWindow;
+    size_t k1 = std::min(k0 + fDriftWindow, nValid);
+    if (k0 >= k1) {
+      dst[i] = 0;
+      continue;
+    }
 
-    float max_adc = adc[k0] * fAlgView.fLifetimeCorrFactors[k0 + tick0];
+    float max_adc = adc[k0] * lf[k0];
     for (size_t k = k0 + 1; k < k1; ++k) {
-      float ak = adc[k] * fAlgView.fLifetimeCorrFactors[k + tick0];
-      if (ak > max_adc) max_adc = ak;
+      float ak = adc[k] * lf[k];
+      max_adc = (ak > max_adc) ? ak : max_adc;
     }
-    result[i] = max_adc;
+    dst[i] = max_adc;
   }
-  scaleAdcSamples(result);
-  return result;
+  std::fill(dst + kStop, dst + dst_size, 0.0F);
+  scaleAdcSamples(dst, dst_size);
 }
 
-std::vector<float> img::DataProviderAlg::downscaleMaxMean(std::size_t dst_size,
-                                                          std::vector<float> const& adc,
-                                                          size_t tick0) const
+void img::DataProviderAlg::downscaleMaxMean(float* dst,
+                                            std::size_t dst_size,
+                                            float const* adc,
+                                            std::size_t adc_size,
+                                            size_t tick0) const
 {
-  size_t kStop = dst_size;
-  std::vector<float> result(dst_size);
-  if (adc.size() < kStop) { kStop = adc.size(); }
+  size_t kStop = std::min(dst_size, adc_size);
+  size_t const nValid = validSamples(adc_size, tick0);
+  auto const* lf = fAlgView.fLifetimeCorrFactors.data() + tick0;
   for (size_t i = 0, k0 = 0; i < kStop; ++i, k0 += fDriftWindow) {
-    size_t k1 = k0 + fDriftWindow;
+    size_t k1 = std::min(k0 + fDriftWindow, nValid);
+    if (k0 >= k1) {
+      dst[i] = 0;
+      continue;
+    }
+
     size_t max_idx = k0;
-    float max_adc = adc[k0] * fAlgView.fLifetimeCorrFactors[k0 + tick0];
+    float max_adc = adc[k0] * lf[k0];
     for (size_t k = k0 + 1; k < k1; ++k) {
-      float ak = adc[k] * fAlgView.fLifetimeCorrFactors[k + tick0];
+      float ak = adc[k] * lf[k];
       if (ak > max_adc) {
         max_adc = ak;
         max_idx = k;
@@ -232,54 +250,54 @@ std::vector<float> img::DataProviderAlg::downscaleMaxMean(std::size_t dst_size,
 
     size_t n = 1;
     if (max_idx > 0) {
-      max_adc += adc[max_idx - 1] * fAlgView.fLifetimeCorrFactors[max_idx - 1 + tick0];
+      max_adc += adc[max_idx - 1] * lf[max_idx - 1];
       n++;
     }
-    if (max_idx + 1 < adc.size()) {
-      max_adc += adc[max_idx + 1] * fAlgView.fLifetimeCorrFactors[max_idx + 1 + tick0];
+    if (max_idx + 1 < nValid) {
+      max_adc += adc[max_idx + 1] * lf[max_idx + 1];
       n++;
     }
 
-    result[i] = max_adc / n;
+    dst[i] = max_adc / n;
   }
-  scaleAdcSamples(result);
-  return result;
+  std::fill(dst + kStop, dst + dst_size, 0.0F);
+  scaleAdcSamples(dst, dst_size);
 }
 
-std::vector<float> img::DataProviderAlg::downscaleMean(std::size_t dst_size,
-                                                       std::vector<float> const& adc,
-                                                       size_t tick0) const
+void img::DataProviderAlg::downscaleMean(float* dst,
+                                         std::size_t dst_size,
+                                         float const* adc,
+                                         std::size_t adc_size,
+                                         size_t tick0) const
 {
-  size_t kStop = dst_size;
-  std::vector<float> result(dst_size);
-  if (adc.size() < kStop) { kStop = adc.size(); }
+  size_t kStop = std::min(dst_size, adc_size);
+  size_t const nValid = validSamples(adc_size, tick0);
+  auto const* lf = fAlgView.fLifetimeCorrFactors.data() + tick0;
   for (size_t i = 0, k0 = 0; i < kStop; ++i, k0 += fDriftWindow) {
-    size_t k1 = k0 + fDriftWindow;
+    size_t k1 = std::min(k0 + fDriftWindow, nValid);
 
     float sum_adc = 0;
     for (size_t k = k0; k < k1; ++k) {
-      if (k + tick0 < fAlgView.fLifetimeCorrFactors.size())
-        sum_adc += adc[k] * fAlgView.fLifetimeCorrFactors[k + tick0];
+      sum_adc += adc[k] * lf[k];
     }
-    result[i] = sum_adc * fDriftWindowInv;
+    dst[i] = sum_adc * fDriftWindowInv;
   }
-  scaleAdcSamples(result);
-  return result;
+  std::fill(dst + kStop, dst + dst_size, 0.0F);
+  scaleAdcSamples(dst, dst_size);
 }
 
-std::optional<std::vector<float>> img::DataProviderAlg::setWireData(std::vector<float> const& adc,
-                                                                    size_t wireIdx) const
+bool img::DataProviderAlg::setWireData(std::vector<float> const& adc, size_t wireIdx)
 {
-  if (wireIdx >= fAlgView.fWireDriftData.size()) { return std::nullopt; }
-  auto& wData = fAlgView.fWireDriftData[wireIdx];
+  if ((wireIdx >= fAlgView.fNWires) || adc.empty()) { return false; }
+  auto* wData = fAlgView.fWireDriftData.data() + wireIdx * fAlgView.fNCachedDrifts;
 
   if (fDownscaleFullView) {
-    if (!adc.empty()) { return downscale(wData.size(), adc, 0); }
-    return std::nullopt;
+    downscale(wData, fAlgView.fNCachedDrifts, adc.data(), adc.size(), 0);
   }
-  if (adc.empty()) { return std::nullopt; }
-  if (adc.size() <= wData.size()) { return adc; }
-  return std::vector<float>(adc.begin(), adc.begin() + wData.size());
+  else {
+    std::copy_n(adc.begin(), std::min<size_t>(adc.size(), fAlgView.fNCachedDrifts), wData);
+  }
+  return true;
 }
 // ------------------------------------------------------
 
@@ -303,7 +321,7 @@ bool img::DataProviderAlg::setWireDriftData(detinfo::DetectorClocksData const& c
   size_t nwires = fWireReadoutGeom->Nwires({cryo, tpc, plane});
   size_t ndrifts = det_prop.NumberTimeSamples();
 
-  fAlgView = resizeView(clock_data, det_prop, nwires, ndrifts);
+  resizeView(clock_data, det_prop, nwires, ndrifts);
 
   auto const& channelStatus =
     art::ServiceHandle<lariov::ChannelStatusService const>()->GetProvider();
@@ -323,12 +341,10 @@ bool img::DataProviderAlg::setWireDriftData(detinfo::DetectorClocksData const& c
           mf::LogWarning("DataProviderAlg") << "Wire ADC vector size lower than NumberTimeSamples.";
           continue; // not critical, maybe other wires are OK, so continue
         }
-        auto wire_data = setWireData(adc, w_idx);
-        if (!wire_data) {
+        if (!setWireData(adc, w_idx)) {
           mf::LogWarning("DataProviderAlg") << "Wire data not set.";
           continue; // also not critical, try to set other wires
         }
-        fAlgView.fWireDriftData[w_idx] = *wire_data;
         for (auto v : adc) {
           if (v >= fAdcSumThr) {
             fAdcSumOverThr += v;
@@ -369,12 +385,11 @@ float img::DataProviderAlg::scaleAdcSample(float val) const
            (val - fAdcMin); // shift and scale to the output range, shift to the output min
 }
 // ------------------------------------------------------
-void img::DataProviderAlg::scaleAdcSamples(std::vector<float>& values) const
+void img::DataProviderAlg::scaleAdcSamples(float* data, size_t size) const
 {
   float calib = fAmplCalibConst[fPlane];
-  auto* data = values.data();
 
-  size_t k = 0, size4 = values.size() >> 2, size = values.size();
+  size_t k = 0, size4 = size >> 2;
   for (size_t i = 0; i < size4; ++i) // vectorize if you can
   {
     data[k] *= calib; // prescale by plane-to-plane calibration factors
@@ -415,29 +430,64 @@ void img::DataProviderAlg::applyBlur()
   size_t margin_left = (fBlurKernel.size() - 1) >> 1,
          margin_right = fBlurKernel.size() - margin_left - 1;
 
-  std::vector<std::vector<float>> src(fAlgView.fWireDriftData.size());
-  for (size_t w = 0; w < fAlgView.fWireDriftData.size(); ++w) {
-    src[w] = fAlgView.fWireDriftData[w];
-  }
-
-  for (size_t w = margin_left; w < fAlgView.fWireDriftData.size() - margin_right; ++w) {
-    for (size_t d = 0; d < fAlgView.fWireDriftData[w].size(); ++d) {
-      float sum = 0;
-      for (size_t i = 0; i < fBlurKernel.size(); ++i) {
-        sum += fBlurKernel[i] * src[w + i - margin_left][d];
+  size_t const nwires = fAlgView.fNWires, ndrifts = fAlgView.fNCachedDrifts;
+  fBlurBuffer.assign(fAlgView.fWireDriftData.begin(), fAlgView.fWireDriftData.end());
+
+  // accumulate whole wires, kernel element after kernel element: same summation order
+  // per pixel as a per-pixel loop, but the inner loop runs over contiguous drift samples
+  for (size_t w = margin_left; w + margin_right < nwires; ++w) {
+    auto* dst = fAlgView.fWireDriftData.data() + w * ndrifts;
+    std::fill(dst, dst + ndrifts, 0.0F);
+    for (size_t i = 0; i < fBlurKernel.size(); ++i) {
+      float const k = fBlurKernel[i];
+      auto const* src = fBlurBuffer.data() + (w + i - margin_left) * ndrifts;
+      for (size_t d = 0; d < ndrifts; ++d) {
+        dst[d] += k * src[d];
       }
-      fAlgView.fWireDriftData[w][d] = sum;
     }
   }
 }
 // ------------------------------------------------------
 
+void img::DataProviderAlg::getPatches(std::vector<std::pair<size_t, float>> const& centers,
+                                      size_t patchSizeW,
+                                      size_t patchSizeD,
+                                      float* dst) const
+{
+  size_t const patchSize = patchSizeW * patchSizeD;
+  std::vector<float> tmp;
+  for (auto const& [wire, drift] : centers) {
+    fillPatch(wire, drift, patchSizeW, patchSizeD, dst, tmp);
+    dst += patchSize;
+  }
+}
+
+void img::DataProviderAlg::fillPatch(size_t wire,
+                                     float drift,
+                                     size_t size_w,
+                                     size_t size_d,
+                                     float* patch,
+                                     std::vector<float>& tmp) const
+{
+  std::fill(patch, patch + size_w * size_d, 0.0F);
+
+  bool ok = false;
+  if (fDownscaleFullView) { ok = patchFromDownsampledView(wire, drift, size_w, size_d, patch); }
+  else {
+    ok = patchFromOriginalView(wire, drift, size_w, size_d, patch, tmp);
+  }
+
+  if (!ok) {
+    throw cet::exception("img::DataProviderAlg") << "Patch filling failed." << std::endl;
+  }
+}
+
 // MUST give the same result as get_patch() in scripts/utils.py
 bool img::DataProviderAlg::patchFromDownsampledView(size_t wire,
                                                     float drift,
                                                     size_t size_w,
                                                     size_t size_d,
-                                                    std::vector<std::vector<float>>& patch) const
+                                                    float* patch) const
 {
   int halfSizeW = size_w / 2;
   int halfSizeD = size_d / 2;
@@ -449,21 +499,21 @@ bool img::DataProviderAlg::patchFromDownsampledView(size_t wire,
   int d0 = sd - halfSizeD;
   int d1 = sd + halfSizeD;
 
-  int wsize = fAlgView.fWireDriftData.size();
+  // the part of the drift range inside the view is copied as a block, the rest is padded
+  int wsize = fAlgView.fNWires;
+  int dsize = fAlgView.fNCachedDrifts;
+  int dIn0 = std::min(std::max(d0, 0), d1);
+  int dIn1 = std::max(std::min(d1, dsize), dIn0);
   for (int w = w0, wpatch = 0; w < w1; ++w, ++wpatch) {
-    auto& dst = patch[wpatch];
+    auto* dst = patch + wpatch * size_d;
     if ((w >= 0) && (w < wsize)) {
-      auto& src = fAlgView.fWireDriftData[w];
-      int dsize = src.size();
-      for (int d = d0, dpatch = 0; d < d1; ++d, ++dpatch) {
-        if ((d >= 0) && (d < dsize)) { dst[dpatch] = src[d]; }
-        else {
-          dst[dpatch] = fAdcZero;
-        }
-      }
+      auto const* src = wireData(w);
+      std::fill(dst, dst + (dIn0 - d0), fAdcZero);
+      std::copy(src + dIn0, src + dIn1, dst + (dIn0 - d0));
+      std::fill(dst + (dIn1 - d0), dst + (d1 - d0), fAdcZero);
     }
     else {
-      std::fill(dst.begin(), dst.end(), fAdcZero);
+      std::fill(dst, dst + size_d, fAdcZero);
     }
   }
 
@@ -474,7 +524,8 @@ bool img::DataProviderAlg::patchFromOriginalView(size_t wire,
                                                  float drift,
                                                  size_t size_w,
                                                  size_t size_d,
-                                                 std::vector<std::vector<float>>& patch) const
+                                                 float* patch,
+                                                 std::vector<float>& tmp) const
 {
   int dsize = fDriftWindow * size_d;
   int halfSizeW = size_w / 2;
@@ -487,24 +538,22 @@ bool img::DataProviderAlg::patchFromOriginalView(size_t wire,
   int d1 = int(drift) + halfSizeD;
 
   if (d0 < 0) d0 = 0;
+  if (d1 < d0) d1 = d0; // the patch is entirely before the first tick
 
-  std::vector<float> tmp(dsize);
-  int wsize = fAlgView.fWireDriftData.size();
+  tmp.assign(dsize, 0.0F);
+  int wsize = fAlgView.fNWires;
+  int src_size = fAlgView.fNCachedDrifts;
+  int dIn1 = std::clamp(d1, d0, std::max(src_size, d0));
   for (int w = w0, wpatch = 0; w < w1; ++w, ++wpatch) {
     if ((w >= 0) && (w < wsize)) {
-      auto& src = fAlgView.fWireDriftData[w];
-      int src_size = src.size();
-      for (int d = d0, dpatch = 0; d < d1; ++d, ++dpatch) {
-        if ((d >= 0) && (d < src_size)) { tmp[dpatch] = src[d]; }
-        else {
-          tmp[dpatch] = fAdcZero;
-        }
-      }
+      auto const* src = wireData(w);
+      std::copy(src + d0, src + dIn1, tmp.begin());
+      std::fill(tmp.begin() + (dIn1 - d0), tmp.begin() + (d1 - d0), fAdcZero);
     }
     else {
       std::fill(tmp.begin(), tmp.end(), fAdcZero);
     }
-    patch[wpatch] = downscale(patch[wpatch].size(), tmp, d0);
+    downscale(patch + wpatch * size_d, size_d, tmp.data(), tmp.size(), d0);
   }
 
   return true;
@@ -520,9 +569,10 @@ void img::DataProviderAlg::addWhiteNoise()
 
   CLHEP::RandGauss gauss(fRndEngine);
   std::vector<double> noise(fAlgView.fNCachedDrifts);
-  for (auto& wire : fAlgView.fWireDriftData) {
+  for (size_t w = 0; w < fAlgView.fNWires; ++w) {
     gauss.fireArray(fAlgView.fNCachedDrifts, noise.data(), 0., effectiveSigma);
-    for (size_t d = 0; d < wire.size(); ++d) {
+    auto* wire = fAlgView.fWireDriftData.data() + w * fAlgView.fNCachedDrifts;
+    for (size_t d = 0; d < fAlgView.fNCachedDrifts; ++d) {
       wire[d] += noise[d];
     }
   }
@@ -537,21 +587,21 @@ void img::DataProviderAlg::addCoherentNoise()
   if (fDownscaleFullView) effectiveSigma /= fDriftWindow;
 
   CLHEP::RandGauss gauss(fRndEngine);
-  std::vector<double> amps1(fAlgView.fWireDriftData.size());
-  std::vector<double> amps2(1 + (fAlgView.fWireDriftData.size() / 32));
+  std::vector<double> amps1(fAlgView.fNWires);
+  std::vector<double> amps2(1 + (fAlgView.fNWires / 32));
   gauss.fireArray(amps1.size(), amps1.data(), 1., 0.1); // 10% wire-wire ampl. variation
   gauss.fireArray(amps2.size(), amps2.data(), 1., 0.1); // 10% group-group ampl. variation
 
   double group_amp = 1.0;
   std::vector<double> noise(fAlgView.fNCachedDrifts);
-  for (size_t w = 0; w < fAlgView.fWireDriftData.size(); ++w) {
+  for (size_t w = 0; w < fAlgView.fNWires; ++w) {
     if ((w & 31) == 0) {
       group_amp = amps2[w >> 5]; // div by 32
       gauss.fireArray(fAlgView.fNCachedDrifts, noise.data(), 0., effectiveSigma);
     } // every 32 wires
 
-    auto& wire = fAlgView.fWireDriftData[w];
-    for (size_t d = 0; d < wire.size(); ++d) {
+    auto* wire = fAlgView.fWireDriftData.data() + w * fAlgView.fNCachedDrifts;
+    for (size_t d = 0; d < fAlgView.fNCachedDrifts; ++d) {
       wire[d] += group_amp * amps1[w] * noise[d];
     }
   }
@@ -32,7 +32,7 @@
 // ROOT & C++
 #include <iostream>
 #include <memory>
-#include <optional>
+#include <utility>
 #include <vector>
 
 namespace detinfo {
@@ -48,7 +48,7 @@ namespace img {
     unsigned int fNScaledDrifts;
     unsigned int fNCachedDrifts;
     std::vector<raw::ChannelID_t> fWireChannels;
-    std::vector<std::vector<float>> fWireDriftData;
+    std::vector<float> fWireDriftData; ///< fNWires x fNCachedDrifts, wire after wire
     std::vector<float> fLifetimeCorrFactors;
   };
 }
@@ -112,7 +112,11 @@ public:
                         unsigned int tpc,
                         unsigned int cryo);
 
-  std::vector<float> const& wireData(size_t widx) const { return fAlgView.fWireDriftData[widx]; }
+  /// Pointer to the NCachedDrifts() values of the wire; the wires are stored one after the other.
+  float const* wireData(size_t widx) const
+  {
+    return fAlgView.fWireDriftData.data() + widx * fAlgView.fNCachedDrifts;
+  }
 
   /// Return patch of data centered on the wire and drift, witht the size in (downscaled) pixels givent
   /// with patchSizeW and patchSizeD.  Pad with the zero-level calue if patch extends beyond the event
@@ -122,27 +126,34 @@ public:
                                            size_t patchSizeW,
                                            size_t patchSizeD) const
   {
-    bool ok = false;
-    std::vector<std::vector<float>> patch;
-    if (fDownscaleFullView) {
-      ok = patchFromDownsampledView(wire, drift, patchSizeW, patchSizeD, patch);
-    }
-    else {
-      ok = patchFromOriginalView(wire, drift, patchSizeW, patchSizeD, patch);
+    std::vector<float> flat(patchSizeW * patchSizeD);
+    std::vector<float> tmp;
+    fillPatch(wire, drift, patchSizeW, patchSizeD, flat.data(), tmp);
+
+    std::vector<std::vector<float>> patch(patchSizeW);
+    for (size_t w = 0; w < patchSizeW; ++w) {
+      auto const* row = flat.data() + w * patchSizeD;
+      patch[w].assign(row, row + patchSizeD);
     }
-
-    if (ok) return patch;
-    throw cet::exception("img::DataProviderAlg") << "Patch filling failed." << std::endl;
+    return patch;
   }
 
+  /// Fill the patches centered on each (wire, drift) point straight into dst, which must hold
+  /// centers.size() * patchSizeW * patchSizeD values. Each patch is stored wire after wire, with
+  /// the same content as the rows of getPatch().
+  void getPatches(std::vector<std::pair<size_t, float>> const& centers,
+                  size_t patchSizeW,
+                  size_t patchSizeD,
+                  float* dst) const;
+
   /// Return value from the ADC buffer, or zero if coordinates are out of the view;
   /// will scale the drift according to the downscale settings.
   float getPixelOrZero(int wire, int drift) const
   {
     size_t didx = getDriftIndex(drift), widx = (size_t)wire;
 
-    if ((widx < fAlgView.fWireDriftData.size()) && (didx < fAlgView.fNCachedDrifts)) {
-      return fAlgView.fWireDriftData[widx][didx];
+    if ((widx < fAlgView.fNWires) && (didx < fAlgView.fNCachedDrifts)) {
+      return fAlgView.fWireDriftData[widx * fAlgView.fNCachedDrifts + didx];
     }
     return 0;
   }
@@ -184,23 +195,36 @@ protected:
   bool fDownscaleFullView;
   float fDriftWindowInv;
 
-  std::vector<float> downscaleMax(std::size_t dst_size,
-                                  std::vector<float> const& adc,
-                                  size_t tick0) const;
-  std::vector<float> downscaleMaxMean(std::size_t dst_size,
-                                      std::vector<float> const& adc,
-                                      size_t tick0) const;
-  std::vector<float> downscaleMean(std::size_t dst_size,
-                                   std::vector<float> const& adc,
-                                   size_t tick0) const;
-  std::vector<float> downscale(std::size_t dst_size,
-                               std::vector<float> const& adc,
-                               size_t tick0) const
+  size_t validSamples(std::size_t adc_size, size_t tick0) const;
+
+  /// Downscaling kernels: write dst_size pixels to dst from the adc_size samples of adc, which
+  /// start at the tick0 drift tick.
+  void downscaleMax(float* dst,
+                    std::size_t dst_size,
+                    float const* adc,
+                    std::size_t adc_size,
+                    size_t tick0) const;
+  void downscaleMaxMean(float* dst,
+                        std::size_t dst_size,
+                        float const* adc,
+                        std::size_t adc_size,
+                        size_t tick0) const;
+  void downscaleMean(float* dst,
+                     std::size_t dst_size,
+                     float const* adc,
+                     std::size_t adc_size,
+                     size_t tick0) const;
+  void downscale(float* dst,
+                 std::size_t dst_size,
+                 float const* adc,
+                 std::size_t adc_size,
+                 size_t tick0) const
   {
     switch (fDownscaleMode) {
-    case img::DataProviderAlg::kMean: return downscaleMean(dst_size, adc, tick0);
-    case img::DataProviderAlg::kMaxMean: return downscaleMaxMean(dst_size, adc, tick0);
-    case img::DataProviderAlg::kMax: return downscaleMax(dst_size, adc, tick0);
+    case img::DataProviderAlg::kMean: return downscaleMean(dst, dst_size, adc, adc_size, tick0);
+    case img::DataProviderAlg::kMaxMean:
+      return downscaleMaxMean(dst, dst_size, adc, adc_size, tick0);
+    case img::DataProviderAlg::kMax: return downscaleMax(dst, dst_size, adc, adc_size, tick0);
     }
     throw cet::exception("img::DataProviderAlg") << "Downscale mode not supported." << std::endl;
   }
@@ -213,24 +237,33 @@ protected:
       return (size_t)drift;
   }
 
-  std::optional<std::vector<float>> setWireData(std::vector<float> const& adc,
-                                                size_t wireIdx) const;
+  bool setWireData(std::vector<float> const& adc, size_t wireIdx);
 
+  /// Fill size_w x size_d values of patch (zeroed first); tmp is a scratch buffer which can be
+  /// reused between calls.
+  void fillPatch(size_t wire,
+                 float drift,
+                 size_t size_w,
+                 size_t size_d,
+                 float* patch,
+                 std::vector<float>& tmp) const;
   bool patchFromDownsampledView(size_t wire,
                                 float drift,
                                 size_t size_w,
                                 size_t size_d,
-                                std::vector<std::vector<float>>& patch) const;
+                                float* patch) const;
   bool patchFromOriginalView(size_t wire,
                              float drift,
                              size_t size_w,
                              size_t size_d,
-                             std::vector<std::vector<float>>& patch) const;
+                             float* patch,
+                             std::vector<float>& tmp) const;
 
-  virtual DataProviderAlgView resizeView(detinfo::DetectorClocksData const& clock_data,
-                                         detinfo::DetectorPropertiesData const& det_prop,
-                                         size_t wires,
-                                         size_t drifts);
+  /// Set up fAlgView for the new plane size, reusing the buffers of the previous one.
+  virtual void resizeView(detinfo::DetectorClocksData const& clock_data,
+                          detinfo::DetectorPropertiesData const& det_prop,
+                          size_t wires,
+                          size_t drifts);
 
   // Calorimetry needed to equalize ADC amplitude along drift:
   calo::CalorimetryAlg fCalorimetryAlg;
@@ -241,7 +274,7 @@ protected:
 
 private:
   float scaleAdcSample(float val) const;
-  void scaleAdcSamples(std::vector<float>& values) const;
+  void scaleAdcSamples(float* data, size_t size) const;
   std::vector<float> fAmplCalibConst;
   bool fCalibrateAmpl, fCalibrateLifetime;
   unsigned int fCryo = 9999, fTPC = 9999, fPlane = 9999;
@@ -253,6 +286,7 @@ private:
 
   void applyBlur();
   std::vector<float> fBlurKernel; // blur not applied if empty
+  std::vector<float> fBlurBuffer; // copy of the view, kept between events
 
   void addWhiteNoise();
   float fNoiseSigma; // noise not added if sigma=0
@@ -521,6 +521,7 @@ bool trkf::KalmanFilterAlg::buildTrack(const KTrack& trk,
   int nsame = 0;               // Number of consecutive measurements in same plane.
   int last_plane = -1;         // Last plane.
   bool has_pref_plane = false; // Set to true when first preferred plane hit is added to track.
+  const int prefplane = trg.getPrefPlane(); // Preferred view plane.
 
   // Make a copy of the starting track, in the form of a KFitTrack,
   // which we will update as we go.
@@ -573,7 +574,7 @@ bool trkf::KalmanFilterAlg::buildTrack(const KTrack& trk,
 
     std::shared_ptr<const Surface> psurf = trf.getSurface();
     if (gr.getPlane() < 0) throw cet::exception("KalmanFilterAlg") << "negative plane?\n";
-    if (fPlane < 0 || gr.getPlane() < 0 || fPlane == gr.getPlane()) psurf = gr.getSurface();
+    if (prefplane < 0 || gr.getPlane() < 0 || prefplane == gr.getPlane()) psurf = gr.getSurface();
 
     // Propagate track to the prediction surface.
 
@@ -719,7 +720,7 @@ bool trkf::KalmanFilterAlg::buildTrack(const KTrack& trk,
 
           KHitTrack trh(trf, best_hit);
           trg.addTrack(trh);
-          if (fPlane == gr.getPlane()) has_pref_plane = true;
+          if (prefplane == gr.getPlane()) has_pref_plane = true;
 
           // Decide if we want to kill the reference track.
 
@@ -1158,6 +1159,7 @@ bool trkf::KalmanFilterAlg::extendTrack(KGTrack& trg,
   // Remember the original number of measurement.
 
   unsigned int nhits0 = trg.numHits();
+  const int prefplane = trg.getPrefPlane(); // Preferred view plane.
 
   // It is an error if the KGTrack is not valid.
 
@@ -1354,7 +1356,8 @@ bool trkf::KalmanFilterAlg::extendTrack(KGTrack& trg,
         if (gr.getPlane() < 0)
           throw cet::exception("KalmanFilterAlg")
             << "KalmanFilterAlg::extendTrack(): negative plane?\n";
-        if (fPlane < 0 || gr.getPlane() < 0 || fPlane == gr.getPlane()) psurf = gr.getSurface();
+        if (prefplane < 0 || gr.getPlane() < 0 || prefplane == gr.getPlane())
+          psurf = gr.getSurface();
 
         // Propagate track to the prediction surface.
 
@@ -71,14 +71,18 @@ namespace trkf {
 
     // Accessors.
 
-    bool getTrace() const { return fTrace; } ///< Trace config parameters.
-    int getPlane() const { return fPlane; }  ///< Preferred view plane.
+    bool getTrace() const { return fTrace; }   ///< Trace config parameters.
+    bool getGTrace() const { return fGTrace; } ///< Graphical trace flag.
+    int getPlane() const { return fPlane; }    ///< Preferred view plane.
 
     // Modifiers.
 
     void setTrace(bool trace) { fTrace = trace; } ///< Set trace config parameter.
     void setPlane(int plane) { fPlane = plane; }  ///< Set preferred view plane.
 
+    // buildTrack and extendTrack take the preferred view plane from the
+    // KGTrack they fill, so concurrent fits do not depend on setPlane.
+
     // Methods.
 
     /// Make a new track.
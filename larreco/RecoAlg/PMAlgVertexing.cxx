@@ -12,6 +12,9 @@
 
 #include "TMath.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 pma::PMAlgVertexing::PMAlgVertexing(const pma::PMAlgVertexing::Config& config)
 {
   fMinTrackLength = config.MinTrackLength();
@@ -19,6 +22,8 @@ pma::PMAlgVertexing::PMAlgVertexing(const pma::PMAlgVertexing::Config& config)
   fFindKinks = config.FindKinks();
   fKinkMinDeg = config.KinkMinDeg();
   fKinkMinStd = config.KinkMinStd();
+
+  fParallelCandidates = config.ParallelCandidates();
 }
 // ------------------------------------------------------
 
@@ -120,42 +125,63 @@ void pma::PMAlgVertexing::sortTracks(const pma::TrkCandidateColl& trk_input)
 }
 // ------------------------------------------------------
 
-std::vector<pma::VtxCandidate> pma::PMAlgVertexing::firstPassCandidates() const
+std::vector<pma::VtxCandidate> pma::PMAlgVertexing::pairCandidates(
+  const std::vector<pma::VtxCandidate>& seeds,
+  const pma::TrkCandidateColl& others,
+  const std::vector<std::pair<size_t, size_t>>& pairs) const
 {
+  // pairs are tested independently, accepted ones are kept in the order of the pair list
+  std::vector<pma::VtxCandidate> tested(pairs.size());
+  std::vector<char> accepted(pairs.size(), 0);
+  auto test = [&](size_t i) {
+    tested[i] = seeds[pairs[i].first];
+    // **************************** try Mse2D / or only Mse ************************************
+    accepted[i] = tested[i].Add(others[pairs[i].second]) && (sqrt(tested[i].Mse()) < 1.0);
+    //accepted[i] = tested[i].Add(others[pairs[i].second]) && (sqrt(tested[i].Mse()) < 2.0) && (tested[i].Mse2D() < 1.0);
+  };
+  if (fParallelCandidates) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, pairs.size()),
+                      [&](const tbb::blocked_range<size_t>& r) {
+                        for (size_t i = r.begin(); i != r.end(); ++i)
+                          test(i);
+                      });
+  }
+  else {
+    for (size_t i = 0; i < pairs.size(); ++i)
+      test(i);
+  }
+
   std::vector<pma::VtxCandidate> candidates;
+  for (size_t i = 0; i < pairs.size(); ++i)
+    if (accepted[i]) candidates.push_back(tested[i]);
+  return candidates;
+}
+
+std::vector<pma::VtxCandidate> pma::PMAlgVertexing::firstPassCandidates() const
+{
+  std::vector<pma::VtxCandidate> seeds(fOutTracks.size());
+  std::vector<std::pair<size_t, size_t>> pairs;
   for (size_t t = 0; t < fOutTracks.size() - 1; t++) {
-    for (size_t u = t + 1; u < fOutTracks.size(); u++) {
-      pma::VtxCandidate candidate;
-      if (!candidate.Add(fOutTracks[t])) break; // no segments with length > thr
-
-      // **************************** try Mse2D / or only Mse ************************************
-      if (candidate.Add(fOutTracks[u]) && (sqrt(candidate.Mse()) < 1.0))
-      //if (candidate.Add(fOutTracks[u]) && (sqrt(candidate.Mse()) < 2.0) && (candidate.Mse2D() < 1.0))
-      {
-        candidates.push_back(candidate);
-      }
-    }
+    if (!seeds[t].Add(fOutTracks[t])) continue; // no segments with length > thr
+    for (size_t u = t + 1; u < fOutTracks.size(); u++)
+      pairs.emplace_back(t, u);
   }
-  return candidates;
+  return pairCandidates(seeds, fOutTracks, pairs);
 }
 
 std::vector<pma::VtxCandidate> pma::PMAlgVertexing::secondPassCandidates() const
 {
-  std::vector<pma::VtxCandidate> candidates;
+  std::vector<pma::VtxCandidate> seeds(fOutTracks.size());
+  std::vector<std::pair<size_t, size_t>> pairs;
   for (size_t t = 0; t < fOutTracks.size(); t++)
     if (fOutTracks[t].Track()->Length() > fMinTrackLength) {
+      if (!seeds[t].Add(fOutTracks[t])) continue; // no segments with length > thr
       for (size_t u = 0; u < fEmTracks.size(); u++) {
-        pma::VtxCandidate candidate;
-        if (!candidate.Add(fOutTracks[t])) break; // no segments with length > thr
-
         if (fOutTracks[t].Track() == fEmTracks[u].Track()) continue;
-
-        if (candidate.Add(fEmTracks[u]) && (sqrt(candidate.Mse()) < 1.0)) {
-          candidates.push_back(candidate);
-        }
+        pairs.emplace_back(t, u);
       }
     }
-  return candidates;
+  return pairCandidates(seeds, fEmTracks, pairs);
 }
 
 size_t pma::PMAlgVertexing::makeVertices(detinfo::DetectorPropertiesData const& detProp,
@@ -51,6 +51,11 @@ public:
     fhicl::Atom<double> KinkMinStd{
       Name("KinkMinStd"),
       Comment("threshold in no. of stdev of all segment angles needed to tag a kink")};
+
+    fhicl::Atom<bool> ParallelCandidates{
+      Name("ParallelCandidates"),
+      Comment("evaluate the track pairs of the vtx candidate search in parallel"),
+      false};
   };
 
   PMAlgVertexing(const Config& config);
@@ -91,6 +96,12 @@ private:
 
   std::vector<pma::VtxCandidate> firstPassCandidates() const;
   std::vector<pma::VtxCandidate> secondPassCandidates() const;
+  /// Candidates made of fOutTracks[pair.first] and others[pair.second] with sqrt(Mse) < 1.0;
+  /// seeds[t] is the candidate with only fOutTracks[t], tracks that cannot seed are not paired.
+  std::vector<pma::VtxCandidate> pairCandidates(
+    const std::vector<pma::VtxCandidate>& seeds,
+    const pma::TrkCandidateColl& others,
+    const std::vector<std::pair<size_t, size_t>>& pairs) const;
   size_t makeVertices(detinfo::DetectorPropertiesData const& detProp,
                       std::vector<pma::VtxCandidate>& candidates);
 
@@ -131,6 +142,8 @@ private:
   double fKinkMinDeg; // min. angle [deg] in XY of a kink
   double fKinkMinStd; // threshold in no. of stdev of all segment angles needed to tag a kink
 
+  bool fParallelCandidates; // evaluate track pairs of the vtx candidate search in parallel
+
   // just to remember:
   //double fInputVtxDist2D; // use vtx given at input if dist. [cm] to track in all 2D projections is below this max. value
   //double fInputVtxDistY;  // use vtx given at input if dist. [cm] to track in 3D-Y is below this max. value
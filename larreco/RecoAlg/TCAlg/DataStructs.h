@@ -607,15 +607,25 @@ namespace tca {
       0}; // ID of the trajectory this hit is used in, 0 = none, < 0 = Tj under construction
   };
 
+  /// Columnar copy of the hits on one plane of the current TPCID. The hits are
+  /// grouped by wire and sorted by peak time on each wire so that a time window
+  /// can be found by binary search without touching the recob::Hit objects
+  struct TCPlaneHits {
+    std::vector<unsigned int> wireStart; ///< first hit on each wire; size = nwires + 1
+    std::vector<float> maxRMS;           ///< largest hit RMS on each wire
+    std::vector<float> peakTime;
+    std::vector<float> rms;
+    std::vector<unsigned int> allHitsIndex;
+  };
+
   // hit collection for all slices, TPCs and cryostats + event information
   // Note: Ideally this hit collection would be the FULL hit collection before cosmic removal
   struct TCEvent {
     geo::TPCID TPCID;
     std::vector<recob::Hit> const* allHits = nullptr;
     std::vector<recob::Hit> const* srcHits = nullptr;
-    //  hit Range for the allHits collection in the current TPCID
-    //   plane      wire             firstHit, lastHit
-    std::vector<std::vector<std::pair<unsigned int, unsigned int>>> wireHitRange;
+    // hits in each plane of the current TPCID
+    std::vector<TCPlaneHits> planeHits;
     // hit range for the srcHits collection
     std::vector<std::pair<unsigned int, unsigned int>> tpcSrcHitRange;
     // list of good wires in the current TPCID
@@ -638,7 +648,7 @@ namespace tca {
     int global3S_UID;
     bool aveHitRMSValid{false}; ///< set true when the average hit RMS is well-known
     bool expectSlicedHits{
-      false}; ///< info passed from the module - used to (not) define wireHitRange
+      false}; ///< info passed from the module - used to (not) define planeHits
   };
 
   struct TCSlice {
@@ -665,6 +675,9 @@ namespace tca {
     // in the range fFirstWire to fLastWire. A value of UINT_MAX indicates that there
     // are no hits on the wire.
     std::vector<std::vector<std::pair<unsigned int, unsigned int>>> wireHitRange;
+    // peak time and RMS (ticks) of each hit in slHits, stored by column
+    std::vector<float> slHitPeakTime;
+    std::vector<float> slHitRMS;
     std::vector<VtxStore> vtxs;   ///< 2D vertices
     std::vector<Vtx3Store> vtx3s; ///< 3D vertices
     std::vector<PFPStruct> pfps;
@@ -1946,14 +1946,13 @@ namespace tca {
     for (unsigned int iht = slc.wireHitRange[pln][wire].first;
          iht <= slc.wireHitRange[pln][wire].second;
          ++iht) {
-      unsigned int ahi = slc.slHits[iht].allHitsIndex;
-      auto& hit = (*evt.allHits)[ahi];
-      if (projTick < hit.PeakTime()) {
-        float loHitTick = hit.PeakTime() - 3 * hit.RMS();
+      float peakTime = slc.slHitPeakTime[iht];
+      if (projTick < peakTime) {
+        float loHitTick = peakTime - 3 * slc.slHitRMS[iht];
         if (hiTpTick > loHitTick) return true;
       }
       else {
-        float hiHitTick = hit.PeakTime() + 3 * hit.RMS();
+        float hiHitTick = peakTime + 3 * slc.slHitRMS[iht];
         if (loTpTick < hiHitTick) return true;
       }
     } // iht
@@ -1969,7 +1968,7 @@ namespace tca {
     tp.Environment[kEnvNearSrcHit] = false;
 
     // just check the hits in the last slice
-    if (evt.wireHitRange.empty()) {
+    if (evt.planeHits.empty()) {
       const auto& slc = slices[slices.size() - 1];
       return SignalAtTpInSlc(slc, tp);
     }
@@ -1994,26 +1993,27 @@ namespace tca {
     float hiTpTick = projTick + tickRange;
 
     // no signal here if there are no hits on this wire
-    if (evt.wireHitRange[pln][wire].first == UINT_MAX) return false;
-
-    for (unsigned int iht = evt.wireHitRange[pln][wire].first;
-         iht <= evt.wireHitRange[pln][wire].second;
-         ++iht) {
-      auto& hit = (*evt.allHits)[iht];
-      // We wouldn't need to make this check if hits were sorted
-      const auto& wid = hit.WireID();
-      if (wid.Cryostat != planeID.Cryostat) continue;
-      if (wid.TPC != planeID.TPC) continue;
-      if (wid.Plane != planeID.Plane) continue;
-      if (projTick < hit.PeakTime()) {
-        float loHitTick = hit.PeakTime() - 3 * hit.RMS();
+    auto const& ph = evt.planeHits[pln];
+    if (ph.wireStart[wire] == ph.wireStart[wire + 1]) return false;
+
+    // The hits are sorted by time on the wire so only those within 3 * the
+    // largest RMS (plus a tick of slack) of the window need to be checked
+    float reach = 3 * ph.maxRMS[wire] + 1;
+    auto wireEnd = ph.peakTime.begin() + ph.wireStart[wire + 1];
+    auto first = std::lower_bound(
+      ph.peakTime.begin() + ph.wireStart[wire], wireEnd, loTpTick - reach);
+    for (auto it = first; it != wireEnd && *it < hiTpTick + reach; ++it) {
+      float peakTime = *it;
+      float rms = ph.rms[it - ph.peakTime.begin()];
+      if (projTick < peakTime) {
+        float loHitTick = peakTime - 3 * rms;
         if (hiTpTick > loHitTick) return true;
       }
       else {
-        float hiHitTick = hit.PeakTime() + 3 * hit.RMS();
+        float hiHitTick = peakTime + 3 * rms;
         if (loTpTick < hiHitTick) return true;
       }
-    } // iht
+    } // it
     // No hit was found near projTick. Search through the source hits collection
     // (if it is defined) for a hit that may have been removed by disambiguation
     // Use the srcHit collection if it is available
@@ -2810,12 +2810,12 @@ namespace tca {
       unsigned int firstHit = slc.wireHitRange[plane][wire].first;
       unsigned int lastHit = slc.wireHitRange[plane][wire].second;
       for (unsigned int iht = firstHit; iht <= lastHit; ++iht) {
-        auto& hit = (*evt.allHits)[slc.slHits[iht].allHitsIndex];
         if (usePeakTime) {
-          if (hit.PeakTime() < minTick) continue;
-          if (hit.PeakTime() > maxTick) break;
+          if (slc.slHitPeakTime[iht] < minTick) continue;
+          if (slc.slHitPeakTime[iht] > maxTick) break;
         }
         else {
+          auto& hit = (*evt.allHits)[slc.slHits[iht].allHitsIndex];
           int hiLo = minTick;
           if (hit.StartTick() > hiLo) hiLo = hit.StartTick();
           int loHi = maxTick;
@@ -2872,8 +2872,7 @@ namespace tca {
       if (hitRequest == kUsedHits && slc.slHits[iht].InTraj > 0) useit = true;
       if (hitRequest == kUnusedHits && slc.slHits[iht].InTraj == 0) useit = true;
       if (!useit) continue;
-      auto& hit = (*evt.allHits)[slc.slHits[iht].allHitsIndex];
-      float ftime = tcc.unitsPerTick * hit.PeakTime();
+      float ftime = tcc.unitsPerTick * slc.slHitPeakTime[iht];
       float delta = PointTrajDOCA(fwire, ftime, tp);
       if (delta < maxDelta) tp.Hits.push_back(iht);
     } // iht
@@ -2969,10 +2968,9 @@ namespace tca {
       for (unsigned int iht = firstHit; iht <= lastHit; ++iht) {
         if (slc.slHits[iht].InTraj <= 0) continue;
         if ((unsigned int)slc.slHits[iht].InTraj > slc.tjs.size()) continue;
-        auto& hit = (*evt.allHits)[slc.slHits[iht].allHitsIndex];
-        if (hit.PeakTime() < minTick) continue;
+        if (slc.slHitPeakTime[iht] < minTick) continue;
         // Hits are sorted by increasing time so we can break when maxTick is reached
-        if (hit.PeakTime() > maxTick) break;
+        if (slc.slHitPeakTime[iht] > maxTick) break;
         if (std::find(tmp.begin(), tmp.end(), slc.slHits[iht].InTraj) != tmp.end()) continue;
         tmp.push_back(slc.slHits[iht].InTraj);
       } // iht
@@ -4357,20 +4355,20 @@ namespace tca {
       } // pln
     }   // don't use channelStatus
 
-    // there is no need to define evt.wireHitRange if the hit collection is not sliced. The function
-    // SignalAtTP will then use the (smaller) slc.WireHitRange instead of evt.wireHitRange
+    // there is no need to define evt.planeHits if the hit collection is not sliced. The function
+    // SignalAtTP will then use the (smaller) slc.WireHitRange instead of evt.planeHits
     if (!evt.expectSlicedHits) return;
 
-    // define the size of evt.wireHitRange
-    evt.wireHitRange.resize(nplanes);
+    // define the size of evt.planeHits
+    evt.planeHits.resize(nplanes);
     for (auto const& id : tcc.wireReadoutGeom->Iterate<geo::PlaneID>(inTPCID)) {
       unsigned int nwires = tcc.wireReadoutGeom->Nwires(id);
-      evt.wireHitRange[id.Plane].resize(nwires);
-      for (unsigned int wire = 0; wire < nwires; ++wire)
-        evt.wireHitRange[id.Plane][wire] = {UINT_MAX, UINT_MAX};
+      auto& ph = evt.planeHits[id.Plane];
+      ph.wireStart.assign(nwires + 1, 0);
+      ph.maxRMS.assign(nwires, 0);
     } // pln
 
-    // next define the wireHitRange values. Make one loop through the allHits collection
+    // count the hits on each wire. Make one loop through the allHits collection
     unsigned int nBadWireFix = 0;
     for (unsigned int iht = 0; iht < (*evt.allHits).size(); ++iht) {
       auto& hit = (*evt.allHits)[iht];
@@ -4384,9 +4382,44 @@ namespace tca {
         evt.goodWire[pln][wire] = true;
         ++nBadWireFix;
       } // not goodWire
-      if (evt.wireHitRange[pln][wire].first == UINT_MAX) evt.wireHitRange[pln][wire].first = iht;
-      evt.wireHitRange[pln][wire].second = iht;
+      ++evt.planeHits[pln].wireStart[wire + 1];
     } // iht
+    // convert the counts into the first hit on each wire
+    for (auto& ph : evt.planeHits) {
+      for (unsigned int wire = 1; wire < ph.wireStart.size(); ++wire)
+        ph.wireStart[wire] += ph.wireStart[wire - 1];
+      ph.allHitsIndex.resize(ph.wireStart.back());
+    } // ph
+    // put the hits in place with a second loop
+    std::vector<std::vector<unsigned int>> nextHit(nplanes);
+    for (unsigned short pln = 0; pln < nplanes; ++pln)
+      nextHit[pln].assign(evt.planeHits[pln].wireStart.begin(),
+                          evt.planeHits[pln].wireStart.end() - 1);
+    for (unsigned int iht = 0; iht < (*evt.allHits).size(); ++iht) {
+      auto const& wid = (*evt.allHits)[iht].WireID();
+      if (static_cast<geo::TPCID const&>(wid) != inTPCID) continue;
+      evt.planeHits[wid.Plane].allHitsIndex[nextHit[wid.Plane][wid.Wire]++] = iht;
+    } // iht
+    // sort by time on each wire and fill the columns
+    for (auto& ph : evt.planeHits) {
+      for (unsigned int wire = 0; wire < ph.maxRMS.size(); ++wire) {
+        std::sort(ph.allHitsIndex.begin() + ph.wireStart[wire],
+                  ph.allHitsIndex.begin() + ph.wireStart[wire + 1],
+                  [](unsigned int a, unsigned int b) {
+                    return (*evt.allHits)[a].PeakTime() < (*evt.allHits)[b].PeakTime();
+                  });
+      } // wire
+      ph.peakTime.resize(ph.allHitsIndex.size());
+      ph.rms.resize(ph.allHitsIndex.size());
+      for (unsigned int wire = 0; wire < ph.maxRMS.size(); ++wire) {
+        for (unsigned int ii = ph.wireStart[wire]; ii < ph.wireStart[wire + 1]; ++ii) {
+          auto& hit = (*evt.allHits)[ph.allHitsIndex[ii]];
+          ph.peakTime[ii] = hit.PeakTime();
+          ph.rms[ii] = hit.RMS();
+          if (ph.rms[ii] > ph.maxRMS[wire]) ph.maxRMS[wire] = ph.rms[ii];
+        } // ii
+      }   // wire
+    }     // ph
     if (nBadWireFix > 0 && tcc.modes[kDebug]) {
       std::cout << "FillWireHitRange found hits on " << nBadWireFix
                 << " wires that were declared not-good by the ChannelStatus service. Fixed it...\n";
@@ -4453,6 +4486,8 @@ namespace tca {
       tcc.maxPos1[plane] = (float)detProp.NumberTimeSamples() * tcc.unitsPerTick;
     }
 
+    slc.slHitPeakTime.resize(slc.slHits.size());
+    slc.slHitRMS.resize(slc.slHits.size());
     unsigned int lastWire = 0, lastPlane = 0;
     for (unsigned int iht = 0; iht < slc.slHits.size(); ++iht) {
       unsigned int ahi = slc.slHits[iht].allHitsIndex;
@@ -4479,6 +4514,8 @@ namespace tca {
         slc.wireHitRange[plane][wire].first = iht;
       slc.wireHitRange[plane][wire].second = iht;
       slc.lastWire[plane] = wire + 1;
+      slc.slHitPeakTime[iht] = hit.PeakTime();
+      slc.slHitRMS[iht] = hit.RMS();
     } // iht
     // check
     unsigned int slhitsSize = slc.slHits.size();
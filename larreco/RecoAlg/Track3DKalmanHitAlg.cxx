@@ -37,6 +37,11 @@
 #include "lardataobj/RecoBase/Hit.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <iterator>
+#include <set>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -75,6 +80,21 @@ namespace {
     }
   }
 
+  //----------------------------------------------------------------------------
+  // Check whether any of the tracks uses one of the given hits.
+  bool usesAnyHit(const std::deque<trkf::KGTrack>& tracks,
+                  const std::set<art::Ptr<recob::Hit>>& claimed)
+  {
+    for (const trkf::KGTrack& trg : tracks) {
+      trkf::Hits track_hits;
+      std::vector<unsigned int> hittpindex;
+      trg.fillHits(track_hits, hittpindex);
+      for (const auto& phit : track_hits)
+        if (claimed.count(phit)) return true;
+    }
+    return false;
+  }
+
 }
 //----------------------------------------------------------------------------
 /// Constructor.
@@ -90,6 +110,7 @@ trkf::Track3DKalmanHitAlg::Track3DKalmanHitAlg(const fhicl::ParameterSet& pset)
   , fMaxSeedChiDF{pset.get<double>("MaxSeedChiDF")}
   , fMinSeedSlope{pset.get<double>("MinSeedSlope")}
   , fInitialMomentum{pset.get<double>("InitialMomentum")}
+  , fParallelSeeds{pset.get<bool>("ParallelSeeds", false)}
   , fKFAlg(pset.get<fhicl::ParameterSet>("KalmanFilterAlg"))
   , fSeedFinderAlg(pset.get<fhicl::ParameterSet>("SeedFinderAlg"))
   , fNumTrack(0)
@@ -175,6 +196,13 @@ void trkf::Track3DKalmanHitAlg::fetchPFParticleSeeds(const art::PtrVector<recob:
 
 //----------------------------------------------------------------------------
 /// Grow Seeds method.
+//
+// With ParallelSeeds, all seeds of the batch are first grown concurrently
+// against the hit pools as they are on entry. The results are then
+// committed in seed order, applying the same disjointness test and hit
+// filtering as the serial loop. A seed whose speculative tracks use a hit
+// claimed by an earlier seed of the batch is grown again against the
+// updated pools, so the outcome does not depend on thread scheduling.
 
 void trkf::Track3DKalmanHitAlg::growSeedsIntoTracks(detinfo::DetectorPropertiesData const& detProp,
                                                     const bool pfseed,
@@ -189,8 +217,53 @@ void trkf::Track3DKalmanHitAlg::growSeedsIntoTracks(detinfo::DetectorPropertiesD
     throw cet::exception("Track3DKalmanHitAlg")
       << "Different size containers for Seeds and Hits/Seed.\n";
   }
+  if (!fParallelSeeds || seeds.size() < 2 || fKFAlg.getGTrace()) {
+    for (size_t i = 0; i < seeds.size(); ++i) {
+      growSeedIntoTracks(detProp, pfseed, seeds[i], hitsperseed[i], unusedhits, hits, kgtracks);
+    }
+    return;
+  }
+
+  // Resolve the hit pointers up front; the tasks below only read them.
+  for (const auto& phit : hits)
+    phit.get();
+  for (const auto& seedhits : hitsperseed)
+    for (const auto& phit : seedhits)
+      phit.get();
+
+  std::vector<Hits> trimmedhits(seeds.size());
+  std::vector<std::deque<KGTrack>> seedtracks(seeds.size());
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, seeds.size()),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t i = range.begin(); i != range.end(); ++i) {
+                        chopHitsOffSeeds(hitsperseed[i], pfseed, trimmedhits[i]);
+                        // Same order as filterHits leaves it in the serial path.
+                        std::stable_sort(trimmedhits[i].begin(), trimmedhits[i].end());
+                        growTrimmedSeed(detProp, seeds[i], trimmedhits[i], hits, seedtracks[i]);
+                      }
+                    });
+
+  std::set<art::Ptr<recob::Hit>> claimed; // Hits used by tracks committed so far.
   for (size_t i = 0; i < seeds.size(); ++i) {
-    growSeedIntoTracks(detProp, pfseed, seeds[i], hitsperseed[i], unusedhits, hits, kgtracks);
+    size_t initial_unusedhits = unusedhits.size();
+    filterHits(unusedhits, trimmedhits[i]);
+    if (!(trimmedhits[i].size() + unusedhits.size() == initial_unusedhits)) continue;
+
+    auto ntracks = kgtracks.size();
+    if (!claimed.empty() && usesAnyHit(seedtracks[i], claimed))
+      growTrimmedSeed(detProp, seeds[i], trimmedhits[i], hits, kgtracks);
+    else
+      std::move(seedtracks[i].begin(), seedtracks[i].end(), std::back_inserter(kgtracks));
+    fNumTrack += kgtracks.size() - ntracks;
+
+    for (unsigned int itrk = ntracks; itrk < kgtracks.size(); ++itrk) {
+      Hits track_used_hits;
+      std::vector<unsigned int> hittpindex;
+      kgtracks[itrk].fillHits(track_used_hits, hittpindex);
+      claimed.insert(track_used_hits.begin(), track_used_hits.end());
+      filterHits(hits, track_used_hits);
+      filterHits(unusedhits, track_used_hits);
+    }
   }
 }
 
@@ -218,6 +291,28 @@ void trkf::Track3DKalmanHitAlg::growSeedIntoTracks(detinfo::DetectorPropertiesDa
   //SS: replace this test with a method with appropriate name
   if (!(trimmedhits.size() + unusedhits.size() == initial_unusedhits)) return;
 
+  auto ntracks = kgtracks.size(); // Remember original track count.
+  growTrimmedSeed(detProp, seed, trimmedhits, hits, kgtracks);
+  fNumTrack += kgtracks.size() - ntracks;
+
+  // Loop over newly added tracks and remove hits contained on
+  // these tracks from hits available for making additional
+  // tracks or track seeds.
+  for (unsigned int itrk = ntracks; itrk < kgtracks.size(); ++itrk) {
+    const KGTrack& trg = kgtracks[itrk];
+    filterHitsOnKalmanTrack(trg, hits, unusedhits);
+  }
+}
+
+//----------------------------------------------------------------------------
+/// Make tracks from a chopped seed, reading but not changing the hit pool.
+
+void trkf::Track3DKalmanHitAlg::growTrimmedSeed(detinfo::DetectorPropertiesData const& detProp,
+                                                const recob::Seed& seed,
+                                                Hits& trimmedhits,
+                                                const Hits& hits,
+                                                std::deque<KGTrack>& kgtracks) const
+{
   // Convert seed into initial KTracks on surface located at seed point,
   // and normal to seed direction.
   double dir[3];
@@ -236,19 +331,10 @@ void trkf::Track3DKalmanHitAlg::growSeedIntoTracks(detinfo::DetectorPropertiesDa
   const bool build_both = fDoDedx;
   const int ninit = 2;
 
-  auto ntracks = kgtracks.size(); // Remember original track count.
   bool ok = makeKalmanTracks(detProp, psurf, Surface::FORWARD, trimmedhits, hits, kgtracks);
   if ((!ok || build_both) && ninit == 2) {
     makeKalmanTracks(detProp, psurf, Surface::BACKWARD, trimmedhits, hits, kgtracks);
   }
-
-  // Loop over newly added tracks and remove hits contained on
-  // these tracks from hits available for making additional
-  // tracks or track seeds.
-  for (unsigned int itrk = ntracks; itrk < kgtracks.size(); ++itrk) {
-    const KGTrack& trg = kgtracks[itrk];
-    filterHitsOnKalmanTrack(trg, hits, unusedhits);
-  }
 }
 
 //----------------------------------------------------------------------------
@@ -277,8 +363,8 @@ bool trkf::Track3DKalmanHitAlg::makeKalmanTracks(detinfo::DetectorPropertiesData
                                                  const std::shared_ptr<trkf::Surface> psurf,
                                                  const Surface::TrackDirection trkdir,
                                                  Hits& seedhits,
-                                                 Hits& hits,
-                                                 std::deque<KGTrack>& kgtracks)
+                                                 const Hits& hits,
+                                                 std::deque<KGTrack>& kgtracks) const
 {
   const int pdg = 13; //SS: FIXME another constant?
   // SS: FIXME
@@ -300,8 +386,8 @@ bool trkf::Track3DKalmanHitAlg::makeKalmanTracks(detinfo::DetectorPropertiesData
   std::unique_ptr<KHitContainer> pseedcont = fillHitContainer(detProp, seedhits);
 
   // Set the preferred plane to be the one with the most hits.
+  // The Kalman filter takes it from the KGTrack.
   unsigned int prefplane = pseedcont->getPreferredPlane();
-  fKFAlg.setPlane(prefplane);
   if (mf::isDebugEnabled())
     mf::LogDebug("Track3DKalmanHit") << "Preferred plane = " << prefplane << "\n";
 
@@ -401,7 +487,7 @@ bool trkf::Track3DKalmanHitAlg::smoothandextendTrack(detinfo::DetectorProperties
                                                      KGTrack& trg0,
                                                      const Hits hits,
                                                      unsigned int prefplane,
-                                                     std::deque<KGTrack>& kalman_tracks)
+                                                     std::deque<KGTrack>& kalman_tracks) const
 {
   KGTrack trg1(prefplane);
   bool ok = fKFAlg.smoothTrack(trg0, &trg1, propagator);
@@ -438,7 +524,6 @@ bool trkf::Track3DKalmanHitAlg::smoothandextendTrack(detinfo::DetectorProperties
 
   if (fDoDedx) { fitnupdateMomentum(propagator, trg1, trg1); }
   // Save this track.
-  ++fNumTrack;
   kalman_tracks.push_back(trg1);
   return true;
 }
@@ -18,6 +18,7 @@
 // MaxSeedChiDF       - Maximum seed track chisquare/dof.
 // MinSeedSlope       - Minimum seed slope (dx/dz).
 // InitialMomentum    - Initial momentum guess.
+// ParallelSeeds      - Grow the seeds of a batch concurrently (default false).
 // KalmanFilterAlg    - Parameter set for KalmanFilterAlg.
 // SeedFinderAlg      - Parameter set for seed finder algorithm object.
 ////////////////////////////////////////////////////////////////////////
@@ -83,6 +84,11 @@ namespace trkf {
                             Hits& unusedhits,
                             Hits& hits,
                             std::deque<KGTrack>& kgtracks);
+    void growTrimmedSeed(detinfo::DetectorPropertiesData const& detProp,
+                         const recob::Seed& seed,
+                         Hits& trimmedhits,
+                         const Hits& hits,
+                         std::deque<KGTrack>& kgtracks) const;
     void chopHitsOffSeeds(Hits const& hpsit, bool pfseed, Hits& seedhits) const;
     bool testSeedSlope(const double* dir) const;
     std::shared_ptr<Surface> makeSurface(const recob::Seed& seed, double* dir) const;
@@ -90,14 +96,14 @@ namespace trkf {
                           const std::shared_ptr<trkf::Surface> psurf,
                           const Surface::TrackDirection trkdir,
                           Hits& seedhits,
-                          Hits& hits,
-                          std::deque<KGTrack>& kalman_tracks);
+                          const Hits& hits,
+                          std::deque<KGTrack>& kalman_tracks) const;
     bool smoothandextendTrack(detinfo::DetectorPropertiesData const& detProp,
                               Propagator const& propagator,
                               KGTrack& trg0,
                               const Hits hits,
                               unsigned int prefplane,
-                              std::deque<KGTrack>& kalman_tracks);
+                              std::deque<KGTrack>& kalman_tracks) const;
     bool extendandsmoothLoop(detinfo::DetectorPropertiesData const& detProp,
                              Propagator const& propagator,
                              KGTrack& trg1,
@@ -123,6 +129,7 @@ namespace trkf {
     double fMaxSeedChiDF;    ///< Maximum seed track chisquare/dof.
     double fMinSeedSlope;    ///< Minimum seed slope (dx/dz).
     double fInitialMomentum; ///< Initial (or constant) momentum.
+    bool fParallelSeeds;     ///< Grow the seeds of a batch concurrently.
 
     // Algorithm objects.
 
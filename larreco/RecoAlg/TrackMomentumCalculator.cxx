@@ -6,6 +6,7 @@
 #include "cetlib/pow.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
@@ -14,22 +15,8 @@
 #include <string>
 #include <tuple>
 
-#include "Math/Functor.h"
-#include "Math/GenVector/PositionVector3D.h"
-#include "Minuit2/Minuit2Minimizer.h"
-#include "Rtypes.h"
-#include "TAxis.h"
-#include "TGraphErrors.h"
-#include "TMath.h"
-#include "TMatrixDSymEigen.h"
-#include "TMatrixDSymfwd.h"
-#include "TMatrixDfwd.h"
-#include "TMatrixT.h"
-#include "TMatrixTSym.h"
-#include "TPolyLine3D.h"
-#include "TSpline.h"
-#include "TVectorDfwd.h"
-#include "TVectorT.h"
+#include "Eigen/Core"
+#include "Eigen/Eigenvalues"
 #include "canvas/Persistency/Common/Ptr.h"
 #include "lardataobj/RecoBase/Track.h"
 
@@ -55,13 +42,210 @@ namespace {
     {10,    14,    20,    30,    40,     80,     100,    140,    200,   300,
      400,   800,   1000,  1400,  2000,   3000,   4000,   8000,   10000, 14000,
      20000, 30000, 40000, 80000, 100000, 140000, 200000, 300000, 400000}};
-  TGraph const KEvsR{29, Range_grampercm.data(), KE_MeV.data()};
-  TSpline3 const KEvsR_spline3{"KEvsRS", &KEvsR};
 
-  TVector3 const basex{1, 0, 0};
-  TVector3 const basey{0, 1, 0};
-  TVector3 const basez{0, 0, 1};
+  /**
+   * @brief Cubic spline through a table of points, with "not-a-knot" end conditions.
+   *
+   * This is the interpolation scheme of ROOT's TSpline3 built from a TGraph without end
+   * conditions (de Boor's CUBSPL), but the coefficients are computed at compile time and
+   * evaluation uses no shared state, so it can be called concurrently.
+   */
+  template <std::size_t N>
+  class NotAKnotSpline {
+  public:
+    constexpr NotAKnotSpline(std::array<float, N> const& xs, std::array<float, N> const& ys)
+    {
+      static_assert(N > 3, "NotAKnotSpline needs at least four points");
+      for (std::size_t i = 0; i < N; ++i) {
+        x_[i] = xs[i];
+        c_[0][i] = ys[i];
+      }
+      // c_[2] holds the intervals and c_[3] the divided differences while solving
+      for (std::size_t m = 1; m < N; ++m) {
+        c_[2][m] = x_[m] - x_[m - 1];
+        c_[3][m] = (c_[0][m] - c_[0][m - 1]) / c_[2][m];
+      }
+      // not-a-knot condition at the left end
+      c_[3][0] = c_[2][2];
+      c_[2][0] = c_[2][1] + c_[2][2];
+      c_[1][0] = ((c_[2][1] + 2. * c_[2][0]) * c_[3][1] * c_[2][2] +
+                  c_[2][1] * c_[2][1] * c_[3][2]) /
+                 c_[2][0];
+      // forward elimination of the tridiagonal system for the slopes
+      for (std::size_t m = 1; m < N - 1; ++m) {
+        double const g = -c_[2][m + 1] / c_[3][m - 1];
+        c_[1][m] = g * c_[1][m - 1] + 3. * (c_[2][m] * c_[3][m + 1] + c_[2][m + 1] * c_[3][m]);
+        c_[3][m] = g * c_[2][m - 1] + 2. * (c_[2][m] + c_[2][m + 1]);
+      }
+      // not-a-knot condition at the right end
+      double g = c_[2][N - 2] + c_[2][N - 1];
+      c_[1][N - 1] = ((c_[2][N - 1] + 2. * g) * c_[3][N - 1] * c_[2][N - 2] +
+                      c_[2][N - 1] * c_[2][N - 1] * (c_[0][N - 2] - c_[0][N - 3]) / c_[2][N - 2]) /
+                     g;
+      g = -g / c_[3][N - 2];
+      c_[3][N - 1] = g * c_[2][N - 2] + c_[2][N - 2];
+      c_[1][N - 1] = (g * c_[1][N - 2] + c_[1][N - 1]) / c_[3][N - 1];
+      // back substitution
+      for (std::size_t j = N - 1; j-- > 0;) {
+        c_[1][j] = (c_[1][j] - c_[2][j] * c_[1][j + 1]) / c_[3][j];
+      }
+      // polynomial coefficients on each interval, stored as in TSpline3 (y + dx*(b + dx*(c + dx*d)))
+      for (std::size_t i = 1; i < N; ++i) {
+        double const dtau = c_[2][i];
+        double const divdf1 = (c_[0][i] - c_[0][i - 1]) / dtau;
+        double const divdf3 = c_[1][i - 1] + c_[1][i] - 2. * divdf1;
+        c_[2][i - 1] = (divdf1 - c_[1][i - 1] - divdf3) / dtau;
+        c_[3][i - 1] = divdf3 / (dtau * dtau);
+      }
+    }
+
+    double Eval(double x) const
+    {
+      // interval lookup; points outside the table are extrapolated with the first/last cubic
+      std::size_t k = std::upper_bound(x_.begin(), x_.end(), x) - x_.begin();
+      k = std::clamp<std::size_t>(k, 1, N - 1) - 1;
+      double const dx = x - x_[k];
+      return c_[0][k] + dx * (c_[1][k] + dx * (c_[2][k] + dx * c_[3][k]));
+    }
+
+  private:
+    std::array<double, N> x_{};
+    std::array<std::array<double, N>, 4> c_{};
+  };
+
+  constexpr NotAKnotSpline<29> KEvsR_spline3{Range_grampercm, KE_MeV};
+
+  /// Minimal 3D vector, enough for the rotations to the scattering frame.
+  struct Vec3 {
+    double x, y, z;
+    constexpr double Dot(Vec3 const& o) const { return x * o.x + y * o.y + z * o.z; }
+    constexpr Vec3 Cross(Vec3 const& o) const
+    {
+      return {y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x};
+    }
+    Vec3 Unit() const
+    {
+      double const tot2 = Dot(*this);
+      double const tot = (tot2 > 0) ? 1.0 / std::sqrt(tot2) : 1.0;
+      return {x * tot, y * tot, z * tot};
+    }
+  };
+
+  constexpr Vec3 basex{1, 0, 0};
+  constexpr Vec3 basez{0, 0, 1};
   constexpr float kcal{0.0024}; // Approximation of dE/dx for mip muon in LAr
+  constexpr double pi{3.14159265358979323846};
+
+  /**
+   * @brief Nelder-Mead minimisation of a function of two bounded variables.
+   *
+   * As Minuit does for limited parameters, the simplex moves in internal variables u mapped
+   * into the limits by x = lower + (upper - lower) (sin(u) + 1) / 2. The simplex is then free
+   * to move and neither leaves the limits nor collapses onto one of them, also when starting
+   * on a limit. The minimisation stops when the function values at the simplex vertices agree
+   * within tolerance, or after maxCalls evaluations, in which case false is returned. On
+   * return x holds the best point found.
+   */
+  template <typename F>
+  bool minimize2D(F&& fcn,
+                  std::array<double, 2>& x,
+                  std::array<double, 2> const& step,
+                  std::array<double, 2> const& lower,
+                  std::array<double, 2> const& upper,
+                  double const tolerance,
+                  int const maxCalls)
+  {
+    using Point = std::array<double, 2>;
+    auto toInternal = [&lower, &upper](Point const& p) {
+      Point u;
+      for (std::size_t k = 0; k < 2; ++k)
+        u[k] = std::asin(std::clamp(2. * (p[k] - lower[k]) / (upper[k] - lower[k]) - 1., -1., 1.));
+      return u;
+    };
+    auto toExternal = [&lower, &upper](Point const& u) {
+      Point p;
+      for (std::size_t k = 0; k < 2; ++k)
+        p[k] = lower[k] + 0.5 * (upper[k] - lower[k]) * (std::sin(u[k]) + 1.);
+      return p;
+    };
+    auto eval = [&fcn, &toExternal](Point const& u) { return fcn(toExternal(u).data()); };
+    auto combine = [](Point const& a, Point const& b, double t) {
+      return Point{a[0] + t * (b[0] - a[0]), a[1] + t * (b[1] - a[1])};
+    };
+
+    std::array<Point, 3> v;
+    v.fill(toInternal(x));
+    for (std::size_t k = 0; k < 2; ++k) {
+      // the initial steps, taken away from the limit when starting on it
+      Point xs = x;
+      xs[k] = (x[k] + step[k] <= upper[k]) ? x[k] + step[k] : x[k] - step[k];
+      v[k + 1][k] = toInternal(xs)[k];
+    }
+    std::array<double, 3> fv{};
+    int ncalls = 0;
+    for (std::size_t i = 0; i < 3; ++i) {
+      fv[i] = eval(v[i]);
+      ++ncalls;
+    }
+
+    bool converged = false;
+    while (ncalls < maxCalls) {
+      // order the vertices: best, middle, worst
+      std::array<std::size_t, 3> o{0, 1, 2};
+      std::sort(o.begin(), o.end(), [&fv](std::size_t a, std::size_t b) { return fv[a] < fv[b]; });
+      std::array<Point, 3> const vs{v[o[0]], v[o[1]], v[o[2]]};
+      std::array<double, 3> const fs{fv[o[0]], fv[o[1]], fv[o[2]]};
+      v = vs;
+      fv = fs;
+      if (std::abs(fv[2] - fv[0]) <= tolerance * (std::abs(fv[0]) + tolerance)) {
+        converged = true;
+        break;
+      }
+
+      Point const centroid{0.5 * (v[0][0] + v[1][0]), 0.5 * (v[0][1] + v[1][1])};
+      Point const xr = combine(centroid, v[2], -1.0);
+      double const fr = eval(xr);
+      ++ncalls;
+      if (fr < fv[0]) {
+        Point const xe = combine(centroid, v[2], -2.0);
+        double const fe = eval(xe);
+        ++ncalls;
+        if (fe < fr) {
+          v[2] = xe;
+          fv[2] = fe;
+        }
+        else {
+          v[2] = xr;
+          fv[2] = fr;
+        }
+      }
+      else if (fr < fv[1]) {
+        v[2] = xr;
+        fv[2] = fr;
+      }
+      else {
+        Point const xc = (fr < fv[2]) ? combine(centroid, xr, 0.5) : combine(centroid, v[2], 0.5);
+        double const fc = eval(xc);
+        ++ncalls;
+        if (fc < std::min(fr, fv[2])) {
+          v[2] = xc;
+          fv[2] = fc;
+        }
+        else {
+          // shrink towards the best vertex
+          for (std::size_t i = 1; i < 3; ++i) {
+            v[i] = combine(v[0], v[i], 0.5);
+            fv[i] = eval(v[i]);
+            ++ncalls;
+          }
+        }
+      }
+    }
+
+    std::size_t const best = std::min_element(fv.begin(), fv.end()) - fv.begin();
+    x = toExternal(v[best]);
+    return converged;
+  }
 
   class FcnWrapper {
   public:
@@ -247,7 +431,7 @@ namespace trkf {
                                                               const bool checkValidPoints,
                                                               const int maxMomentum_MeV,
                                                               const int MomentumStep_MeV,
-                                                              const int max_resolution)
+                                                              const int max_resolution) const
   {
     std::vector<float> recoX;
     std::vector<float> recoY;
@@ -265,8 +449,6 @@ namespace trkf {
 
     if (recoX.size() < 2) return -1.0;
 
-    if (!plotRecoTracks_(recoX, recoY, recoZ)) return -1.0;
-
     double const seg_size{steps_size};
 
     auto const segments = getSegTracks_(recoX, recoY, recoZ, seg_size);
@@ -292,12 +474,17 @@ namespace trkf {
     int const start2{};
     int const end2{max_resolution}; // 800.0;
 
+    // The Highland width of each measurement only depends on the momentum: compute it once per
+    // momentum value and scan the resolution on top of it.
+    std::vector<double> tH0;
+    std::vector<double> DT;
     for (int k = start1; k <= end1; ++k) {
       double const p_test = 0.001 + k * 0.01;
+      llhdTerms_(dEi, dEj, dthij, ind, p_test, tH0, DT);
 
       for (int l = start2; l <= end2; ++l) {
         double const res_test = (start2 == end2) ? 2.0 : 0.001 + l * 1.0; // 0.001+l*1.0;
-        double const fv = my_mcs_llhd(dEi, dEj, dthij, ind, p_test, res_test);
+        double const fv = llhdSum_(tH0, DT, res_test);
 
         if (fv < logL) {
           bf = p_test;
@@ -309,7 +496,8 @@ namespace trkf {
     return bf;
   }
 
-  TVector3 TrackMomentumCalculator::GetMultiScatterStartingPoint(const art::Ptr<recob::Track>& trk)
+  TVector3 TrackMomentumCalculator::GetMultiScatterStartingPoint(
+    const art::Ptr<recob::Track>& trk) const
   {
     double const LLHDp = GetMuMultiScatterLLHD3(trk, true);
     double const LLHDm = GetMuMultiScatterLLHD3(trk, false);
@@ -327,7 +515,7 @@ namespace trkf {
   }
 
   double TrackMomentumCalculator::GetMuMultiScatterLLHD3(art::Ptr<recob::Track> const& trk,
-                                                         bool const dir)
+                                                         bool const dir) const
   {
     std::vector<float> recoX;
     std::vector<float> recoY;
@@ -344,8 +532,6 @@ namespace trkf {
 
     if (recoX.size() < 2) return -1.0;
 
-    if (!plotRecoTracks_(recoX, recoY, recoZ)) return -1.0;
-
     constexpr double seg_size{5.0};
     auto const segments = getSegTracks_(recoX, recoY, recoZ, seg_size);
     if (!segments.has_value()) return -1.0;
@@ -398,9 +584,9 @@ namespace trkf {
       double const dz = segnz.at(i);
 
       // Assumes z as propagation angle
-      TVector3 const vec_z{dx, dy, dz};
-      TVector3 vec_x;
-      TVector3 vec_y;
+      Vec3 const vec_z{dx, dy, dz};
+      Vec3 vec_x{};
+      Vec3 vec_y{};
 
       double const switcher = basex.Dot(vec_z);
       if (std::abs(switcher) <= 0.995) {
@@ -413,9 +599,10 @@ namespace trkf {
         vec_x = vec_y.Cross(vec_z);
       }
 
-      TVector3 const Rx{vec_x.Dot(basex), vec_x.Dot(basey), vec_x.Dot(basez)};
-      TVector3 const Ry{vec_y.Dot(basex), vec_y.Dot(basey), vec_y.Dot(basez)};
-      TVector3 const Rz{vec_z.Dot(basex), vec_z.Dot(basey), vec_z.Dot(basez)};
+      // rows of the rotation to the frame of segment i
+      Vec3 const& Rx = vec_x;
+      Vec3 const& Ry = vec_y;
+      Vec3 const& Rz = vec_z;
 
       double const refL = segL.at(i);
 
@@ -432,12 +619,12 @@ namespace trkf {
           double const here_dy = segny.at(j);
           double const here_dz = segnz.at(j);
 
-          TVector3 const here_vec{here_dx, here_dy, here_dz};
-          TVector3 const rot_here{Rx.Dot(here_vec), Ry.Dot(here_vec), Rz.Dot(here_vec)};
+          Vec3 const here_vec{here_dx, here_dy, here_dz};
+          Vec3 const rot_here{Rx.Dot(here_vec), Ry.Dot(here_vec), Rz.Dot(here_vec)};
 
-          double const scx = rot_here.X();
-          double const scy = rot_here.Y();
-          double const scz = rot_here.Z();
+          double const scx = rot_here.x;
+          double const scy = rot_here.y;
+          double const scz = rot_here.z;
 
           double const azy = find_angle(scz, scy);
           double const azx = find_angle(scz, scx);
@@ -473,7 +660,7 @@ namespace trkf {
 
   double TrackMomentumCalculator::GetMomentumMultiScatterChi2(const art::Ptr<recob::Track>& trk,
                                                               const bool checkValidPoints,
-                                                              const int maxMomentum_MeV)
+                                                              const int maxMomentum_MeV) const
   {
     std::vector<float> recoX;
     std::vector<float> recoY;
@@ -491,8 +678,6 @@ namespace trkf {
 
     if (recoX.size() < 2) return -1.0;
 
-    if (!plotRecoTracks_(recoX, recoY, recoZ)) return -1.0;
-
     double const seg_size{steps_size};
     auto const segments = getSegTracks_(recoX, recoY, recoZ, seg_size);
     if (!segments.has_value()) return -1.0;
@@ -503,9 +688,6 @@ namespace trkf {
     double const recoL = segments->L.at(seg_steps - 1);
     if (recoL < minLength || recoL > maxLength) return -1;
 
-    double ymax = -999.0;
-    double ymin = +999.0;
-
     std::vector<double> xmeas;
     std::vector<double> ymeas;
     std::vector<double> eymeas;
@@ -533,95 +715,50 @@ namespace trkf {
       ymeas.push_back(rms);
       eymeas.push_back(std::sqrt(cet::sum_of_squares(
         rmse, 0.05 * rms))); // <--- conservative syst. error to fix chi^{2} behaviour !!!
-
-      if (ymin > rms) ymin = rms;
-      if (ymax < rms) ymax = rms;
     }
 
     assert(xmeas.size() == ymeas.size());
     assert(xmeas.size() == eymeas.size());
     if (xmeas.empty()) { return -1.0; }
 
-    TGraphErrors gr_meas{n_steps, xmeas.data(), ymeas.data(), nullptr, eymeas.data()};
-
-    gr_meas.SetTitle("(#Delta#theta)_{rms} versus material thickness; Material "
-                     "thickness in cm; (#Delta#theta)_{rms} in mrad");
-
-    gr_meas.SetLineColor(kBlack);
-    gr_meas.SetMarkerColor(kBlack);
-    gr_meas.SetMarkerStyle(20);
-    gr_meas.SetMarkerSize(1.2);
-
-    gr_meas.GetXaxis()->SetLimits(steps.at(0) - steps.at(0), steps.at(n_steps - 1) + steps.at(0));
-    gr_meas.SetMinimum(0.0);
-    gr_meas.SetMaximum(1.80 * ymax);
-
-    ROOT::Minuit2::Minuit2Minimizer mP{};
-    FcnWrapper const wrapper{move(xmeas), move(ymeas), move(eymeas)};
-    ROOT::Math::Functor FCA([&wrapper](double const* xs) { return wrapper.my_mcs_chi2(xs); }, 2);
-
-    mP.SetFunction(FCA);
-    mP.SetLimitedVariable(0, "p_{MCS}", 1.0, 0.01, 0.001, maxMomentum_MeV / 1.e3);
-    mP.SetLimitedVariable(1, "#delta#theta", 0.0, 1.0, 0.0, 45.0);
-    mP.SetMaxFunctionCalls(1.E9);
-    mP.SetMaxIterations(1.E9);
-    mP.SetTolerance(0.01);
-    mP.SetStrategy(2);
-    mP.SetErrorDef(1.0);
-
-    bool const mstatus = mP.Minimize();
-
-    mP.Hesse();
-
-    const double* pars = mP.X();
-    const double* erpars = mP.Errors();
+    std::array<double, 2> pars;
+    bool const mstatus =
+      FitMultiScatterChi2(move(xmeas), move(ymeas), move(eymeas), maxMomentum_MeV, pars);
 
     double const deltap = (recoL * kcal) / 2.0;
 
     double const p_mcs = pars[0] + deltap;
-    double const p_mcs_e [[maybe_unused]] = erpars[0];
     return mstatus ? p_mcs : -1.0;
   }
 
-  bool TrackMomentumCalculator::plotRecoTracks_(std::vector<float> const& xxx,
-                                                std::vector<float> const& yyy,
-                                                std::vector<float> const& zzz)
+  bool TrackMomentumCalculator::FitMultiScatterChi2(std::vector<double> xmeas,
+                                                    std::vector<double> ymeas,
+                                                    std::vector<double> eymeas,
+                                                    const int maxMomentum_MeV,
+                                                    std::array<double, 2>& pars)
   {
-    auto const n = xxx.size();
-    auto const y_size = yyy.size();
-    auto const z_size = zzz.size();
-
-    if (n != y_size || n != z_size) {
-      cout << " ( Get reco tacks ) Error ! " << endl;
-      return false;
-    }
+    FcnWrapper const wrapper{move(xmeas), move(ymeas), move(eymeas)};
 
-    // Here, we perform a const-cast to float* because, sadly,
-    // TPolyLine3D requires a pointer to a non-const object.  We will
-    // trust that ROOT does not mess around with the underlying data.
-    auto xs = const_cast<float*>(xxx.data());
-    auto ys = const_cast<float*>(yyy.data());
-    auto zs = const_cast<float*>(zzz.data());
-
-    auto const narrowed_size = static_cast<int>(n); // ROOT requires a signed integral type
-    delete gr_reco_xyz;
-    gr_reco_xyz = new TPolyLine3D{narrowed_size, zs, xs, ys};
-    gr_reco_yz = TGraph{narrowed_size, zzz.data(), yyy.data()};
-    gr_reco_xz = TGraph{narrowed_size, zzz.data(), xxx.data()};
-    gr_reco_xy = TGraph{narrowed_size, xxx.data(), yyy.data()};
-
-    return true;
+    // fit parameters: p_{MCS} (GeV) and #delta#theta (mrad)
+    pars = {1.0, 0.0};
+    return minimize2D([&wrapper](double const* xs) { return wrapper.my_mcs_chi2(xs); },
+                      pars,
+                      {0.01, 1.0},
+                      {0.001, 0.0},
+                      {maxMomentum_MeV / 1.e3, 45.0},
+                      1.e-8,
+                      100000);
   }
 
-  void TrackMomentumCalculator::compute_max_fluctuation_vector(const std::vector<float> segx,
-                                                               const std::vector<float> segy,
-                                                               const std::vector<float> segz,
+  void TrackMomentumCalculator::compute_max_fluctuation_vector(const std::vector<float>& segx,
+                                                               const std::vector<float>& segy,
+                                                               const std::vector<float>& segz,
                                                                std::vector<float>& segnx,
                                                                std::vector<float>& segny,
                                                                std::vector<float>& segnz,
                                                                std::vector<float>& vx,
                                                                std::vector<float>& vy,
-                                                               std::vector<float>& vz)
+                                                               std::vector<float>& vz) const
   {
     auto const na = vx.size();
 
@@ -643,7 +780,7 @@ namespace trkf {
     std::vector<double> my;
     std::vector<double> mz;
 
-    TMatrixDSym m(3);
+    Eigen::Matrix3d m{Eigen::Matrix3d::Zero()};
 
     for (std::size_t i = 0; i < na; ++i) {
       double const xxw1 = vx.at(i);
@@ -671,14 +808,14 @@ namespace trkf {
       m(2, 2) += zzw0 * zzw0 / na;
     }
 
-    TMatrixDSymEigen me(m);
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> const me(m);
 
-    TVectorD eigenval = me.GetEigenValues();
-    TMatrixD eigenvec = me.GetEigenVectors();
+    Eigen::Vector3d const& eigenval = me.eigenvalues();
+    Eigen::Matrix3d const& eigenvec = me.eigenvectors();
 
     double max1 = -666.0;
 
-    double ind1 = 0;
+    int ind1 = 0;
 
     for (int i = 0; i < 3; ++i) {
       double const p1 = eigenval(i);
@@ -693,6 +830,7 @@ namespace trkf {
     double ay = eigenvec(1, ind1);
     double az = eigenvec(2, ind1);
 
+    int const n_seg = segx.size();
     if (n_seg > 1) {
       if (segx.at(n_seg - 1) - segx.at(n_seg - 2) > 0)
         ax = std::abs(ax);
@@ -722,7 +860,7 @@ namespace trkf {
     std::vector<float> const& xxx,
     std::vector<float> const& yyy,
     std::vector<float> const& zzz,
-    double const seg_size)
+    double const seg_size) const
   {
     double stag = 0.0;
 
@@ -744,7 +882,7 @@ namespace trkf {
 
     int ntot = 0;
 
-    n_seg = 0;
+    int n_seg = 0;
 
     double x0{};
     double y0{};
@@ -774,10 +912,6 @@ namespace trkf {
 
         segL.push_back(stag);
 
-        x_seg[n_seg] = x0;
-        y_seg[n_seg] = y0;
-        z_seg[n_seg] = z0;
-
         n_seg++;
 
         vx.push_back(x0);
@@ -846,10 +980,6 @@ namespace trkf {
         segz.push_back(zp);
 
         segL.push_back(1.0 * n_seg * 1.0 * seg_size + stag);
-
-        x_seg[n_seg] = xp;
-        y_seg[n_seg] = yp;
-        z_seg[n_seg] = zp;
         n_seg++;
 
         x0 = xp;
@@ -893,10 +1023,6 @@ namespace trkf {
         segy.push_back(yp);
         segz.push_back(zp);
         segL.push_back(1.0 * n_seg * 1.0 * seg_size + stag);
-
-        x_seg[n_seg] = xp;
-        y_seg[n_seg] = yp;
-        z_seg[n_seg] = zp;
         n_seg++;
 
         x0 = xp;
@@ -923,12 +1049,6 @@ namespace trkf {
       if (n_seg >= (stopper + 1.0) && seg_stop != -1) break;
     }
 
-    delete gr_seg_xyz;
-    gr_seg_xyz = new TPolyLine3D{n_seg, z_seg, x_seg, y_seg};
-    gr_seg_yz = TGraph{n_seg, z_seg, y_seg};
-    gr_seg_xz = TGraph{n_seg, z_seg, x_seg};
-    gr_seg_xy = TGraph{n_seg, x_seg, y_seg};
-
     return std::make_optional<Segments>(Segments{segx, segnx, segy, segny, segz, segnz, segL});
   }
 
@@ -961,9 +1081,9 @@ namespace trkf {
       double const dy = segny.at(i);
       double const dz = segnz.at(i);
 
-      TVector3 const vec_z{dx, dy, dz};
-      TVector3 vec_x;
-      TVector3 vec_y;
+      Vec3 const vec_z{dx, dy, dz};
+      Vec3 vec_x{};
+      Vec3 vec_y{};
 
       double const switcher = basex.Dot(vec_z);
 
@@ -977,9 +1097,9 @@ namespace trkf {
         vec_x = vec_y.Cross(vec_z);
       }
 
-      TVector3 const Rx{vec_x.Dot(basex), vec_x.Dot(basey), vec_x.Dot(basez)};
-      TVector3 const Ry{vec_y.Dot(basex), vec_y.Dot(basey), vec_y.Dot(basez)};
-      TVector3 const Rz{vec_z.Dot(basex), vec_z.Dot(basey), vec_z.Dot(basez)};
+      Vec3 const& Rx = vec_x;
+      Vec3 const& Ry = vec_y;
+      Vec3 const& Rz = vec_z;
 
       double const refL = segL.at(i);
 
@@ -995,11 +1115,11 @@ namespace trkf {
           double const here_dy = segny.at(j);
           double const here_dz = segnz.at(j);
 
-          TVector3 const here_vec{here_dx, here_dy, here_dz};
-          TVector3 const rot_here{Rx.Dot(here_vec), Ry.Dot(here_vec), Rz.Dot(here_vec)};
+          Vec3 const here_vec{here_dx, here_dy, here_dz};
+          Vec3 const rot_here{Rx.Dot(here_vec), Ry.Dot(here_vec), Rz.Dot(here_vec)};
 
-          double const scx = rot_here.X();
-          double const scz = rot_here.Z();
+          double const scx = rot_here.x;
+          double const scz = rot_here.z;
 
           double const azx = find_angle(scz, scx);
 
@@ -1066,30 +1186,30 @@ namespace trkf {
     else if (vz < 0 && vy > 0) {
       double ratio = std::abs(vy / vz);
       thetayz = std::atan(ratio);
-      thetayz = TMath::Pi() - thetayz;
+      thetayz = pi - thetayz;
     }
 
     else if (vz < 0 && vy < 0) {
       double ratio = std::abs(vy / vz);
       thetayz = std::atan(ratio);
-      thetayz = thetayz + TMath::Pi();
+      thetayz = thetayz + pi;
     }
 
     else if (vz > 0 && vy < 0) {
       double ratio = std::abs(vy / vz);
       thetayz = std::atan(ratio);
-      thetayz = 2.0 * TMath::Pi() - thetayz;
+      thetayz = 2.0 * pi - thetayz;
     }
 
     else if (vz == 0 && vy > 0) {
-      thetayz = TMath::Pi() / 2.0;
+      thetayz = pi / 2.0;
     }
 
     else if (vz == 0 && vy < 0) {
-      thetayz = 3.0 * TMath::Pi() / 2.0;
+      thetayz = 3.0 * pi / 2.0;
     }
 
-    if (thetayz > TMath::Pi()) { thetayz = thetayz - 2.0 * TMath::Pi(); }
+    if (thetayz > pi) { thetayz = thetayz - 2.0 * pi; }
 
     return 1000.0 * thetayz;
   }
@@ -1102,7 +1222,7 @@ namespace trkf {
     }
 
     double const arg = (xx - Q) / s;
-    double const result = -0.5 * std::log(2.0 * TMath::Pi()) - std::log(s) - 0.5 * arg * arg;
+    double const result = -0.5 * std::log(2.0 * pi) - std::log(s) - 0.5 * arg * arg;
 
     if (std::isnan(result) || std::isinf(result)) {
       cout << " Is nan ! my_g ! " << -std::log(s) << ", " << s << endl;
@@ -1111,48 +1231,56 @@ namespace trkf {
     return result;
   }
 
-  double TrackMomentumCalculator::my_mcs_llhd(std::vector<float> const& dEi,
-                                              std::vector<float> const& dEj,
-                                              std::vector<float> const& dthij,
-                                              std::vector<float> const& ind,
-                                              double const x0,
-                                              double const x1) const
+  void TrackMomentumCalculator::llhdTerms_(std::vector<float> const& dEi,
+                                            std::vector<float> const& dEj,
+                                            std::vector<float> const& dthij,
+                                            std::vector<float> const& ind,
+                                            double const p,
+                                            std::vector<double>& tH0,
+                                            std::vector<double>& DT) const
   {
-    double p = x0;
-    double theta0x = x1;
+    tH0.clear();
+    DT.clear();
 
-    double result = 0.0;
-    double nnn1 = dEi.size(); // number of segments of energy
+    int const nnn1 = dEi.size(); // number of segments of energy
 
-    double red_length = (steps_size) / rad_length;
+    double const red_length = (steps_size) / rad_length;
+    double const hl_log = 1.0 + 0.038 * std::log(red_length);
+    double const hl_sqrt = std::sqrt(red_length);
     double addth = 0;
 
     for (int i = 0; i < nnn1; i++) {
-      double Ei = p - dEi.at(i); // Estimated energy at point i
-      double Ej = p - dEj.at(i); // Estimated enery at point j
+      double Ei = p - dEi[i]; // Estimated energy at point i
+      double Ej = p - dEj[i]; // Estimated enery at point j
 
       // If the momentum p choosen allows that the muon stopped inside, add 1 rad to the change in scatter angle (as the particle stops)
       if (Ei > 0 && Ej < 0) addth = 3.14 * 1000.0;
 
+      // only scatters in the xz plane enter the likelihood
+      if (ind[i] != 1) continue;
+
       Ei = std::abs(Ei);
       Ej = std::abs(Ej);
 
       // Highland formula
       // Parameters given at Particle Data Group https://pdg.lbl.gov/2023/web/viewer.html?file=../reviews/rpp2022-rev-passage-particles-matter.pdf
-      double tH0 =
-        (13.6 / std::sqrt(Ei * Ej)) * (1.0 + 0.038 * std::log(red_length)) * std::sqrt(red_length);
-
-      double rms = -1.0;
+      tH0.push_back((13.6 / std::sqrt(Ei * Ej)) * hl_log * hl_sqrt);
+      DT.push_back(dthij[i] + addth);
+    }
+  }
 
-      if (ind.at(i) == 1) {
-        // Computes the rms of angle
-        rms = std::sqrt(tH0 * tH0 + cet::square(theta0x));
+  double TrackMomentumCalculator::llhdSum_(std::vector<double> const& tH0,
+                                           std::vector<double> const& DT,
+                                           double const theta0x) const
+  {
+    double result = 0.0;
+    for (std::size_t i = 0; i < tH0.size(); ++i) {
+      // Computes the rms of angle
+      double const rms = std::sqrt(tH0[i] * tH0[i] + cet::square(theta0x));
 
-        double const DT = dthij.at(i) + addth;
-        double const prob = my_g(DT, 0.0, rms); // Computes log likelihood
+      double const prob = my_g(DT[i], 0.0, rms); // Computes log likelihood
 
-        result = result - 2.0 * prob; // Adds for each segment
-      }
+      result = result - 2.0 * prob; // Adds for each segment
     }
 
     if (std::isnan(result) || std::isinf(result)) {
@@ -1161,4 +1289,17 @@ namespace trkf {
     return result;
   }
 
+  double TrackMomentumCalculator::my_mcs_llhd(std::vector<float> const& dEi,
+                                              std::vector<float> const& dEj,
+                                              std::vector<float> const& dthij,
+                                              std::vector<float> const& ind,
+                                              double const x0,
+                                              double const x1) const
+  {
+    std::vector<double> tH0;
+    std::vector<double> DT;
+    llhdTerms_(dEi, dEj, dthij, ind, x0, tH0, DT);
+    return llhdSum_(tH0, DT, x1);
+  }
+
 } // namespace track
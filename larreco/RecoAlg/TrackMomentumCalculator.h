@@ -7,17 +7,22 @@
 #include "canvas/Persistency/Common/Ptr.h"
 #include "lardataobj/RecoBase/Track.h"
 
-#include "TGraph.h"
 #include "TVector3.h"
 
+#include <array>
 #include <optional>
 #include <tuple>
 #include <vector>
 
-class TPolyLine3D;
-
 namespace trkf {
 
+  /**
+   * @brief Range and multiple Coulomb scattering momentum estimates for tracks.
+   *
+   * All the methods are const and no global or ROOT shared state is used (the range table
+   * is a compile-time spline and the fits use a local minimiser), so a single instance can be
+   * used to compute the momenta of many tracks concurrently.
+   */
   class TrackMomentumCalculator {
   public:
     /**
@@ -47,7 +52,7 @@ namespace trkf {
     */
     double GetMomentumMultiScatterChi2(art::Ptr<recob::Track> const& trk,
                                        const bool checkValidPoints = false,
-                                       const int maxMomentum_MeV = 7500);
+                                       const int maxMomentum_MeV = 7500) const;
     /**
     * @brief  Calculate muon momentum (GeV) using multiple coulomb scattering by log likelihood
     *
@@ -65,15 +70,28 @@ namespace trkf {
                                        const bool checkValidPoints = false,
                                        const int maxMomentum_MeV = 7500,
                                        const int MomentumStep_MeV = 10,
-                                       const int max_resolution = 0);
-    double GetMuMultiScatterLLHD3(art::Ptr<recob::Track> const& trk, bool dir);
-    TVector3 GetMultiScatterStartingPoint(art::Ptr<recob::Track> const& trk);
+                                       const int max_resolution = 0) const;
+    double GetMuMultiScatterLLHD3(art::Ptr<recob::Track> const& trk, bool dir) const;
+    TVector3 GetMultiScatterStartingPoint(art::Ptr<recob::Track> const& trk) const;
 
-  private:
-    bool plotRecoTracks_(std::vector<float> const& xxx,
-                         std::vector<float> const& yyy,
-                         std::vector<float> const& zzz);
+    /**
+    * @brief  Chi2 fit of the Highland formula used by GetMomentumMultiScatterChi2
+    *
+    * @param  xmeas segment sizes (cm)
+    * @param  ymeas RMS of the scattered angle for each segment size (mrad)
+    * @param  eymeas errors of ymeas
+    * @param  maxMomentum_MeV maximum momentum in MeV for the minimization
+    * @param  pars (output) fitted momentum (GeV) and angular resolution (mrad)
+    *
+    * @return whether the fit converged
+    */
+    static bool FitMultiScatterChi2(std::vector<double> xmeas,
+                                    std::vector<double> ymeas,
+                                    std::vector<double> eymeas,
+                                    const int maxMomentum_MeV,
+                                    std::array<double, 2>& pars);
 
+  private:
     /**
     * @brief Computes the vector with most scattering inside a segment with size steps_size
     * @param segx, segy, segz segments points
@@ -81,15 +99,15 @@ namespace trkf {
     * @param vector used to control points to be used at segments
     *
     */
-    void compute_max_fluctuation_vector(const std::vector<float> segx,
-                                        const std::vector<float> segy,
-                                        const std::vector<float> segz,
+    void compute_max_fluctuation_vector(const std::vector<float>& segx,
+                                        const std::vector<float>& segy,
+                                        const std::vector<float>& segz,
                                         std::vector<float>& segnx,
                                         std::vector<float>& segny,
                                         std::vector<float>& segnz,
                                         std::vector<float>& vx,
                                         std::vector<float>& vy,
-                                        std::vector<float>& vz);
+                                        std::vector<float>& vz) const;
     /**
     * \struct Segments
     * @brief Struct to store segments.
@@ -120,7 +138,7 @@ namespace trkf {
     std::optional<Segments> getSegTracks_(std::vector<float> const& xxx,
                                           std::vector<float> const& yyy,
                                           std::vector<float> const& zzz,
-                                          double seg_size);
+                                          double seg_size) const;
 
     /**
     * @brief Gets the scattered angle RMS for a all segments
@@ -185,12 +203,26 @@ namespace trkf {
                        double x0,
                        double x1) const;
 
-    float seg_stop{-1.};
-    int n_seg{};
+    /**
+    * @brief Momentum dependent terms of my_mcs_llhd
+    *
+    * Fills, for the measurements in the xz plane, the Highland width and the scattered angle
+    * (including the stopping penalty) for momentum p.
+    */
+    void llhdTerms_(std::vector<float> const& dEi,
+                    std::vector<float> const& dEj,
+                    std::vector<float> const& dthij,
+                    std::vector<float> const& ind,
+                    double p,
+                    std::vector<double>& tH0,
+                    std::vector<double>& DT) const;
+
+    /// Log likelihood (times -2) from llhdTerms_ output and angular resolution theta0x.
+    double llhdSum_(std::vector<double> const& tH0,
+                    std::vector<double> const& DT,
+                    double theta0x) const;
 
-    float x_seg[50000];
-    float y_seg[50000];
-    float z_seg[50000];
+    float seg_stop{-1.};
 
     /**
     * @brief Gets angle between two vy and vz
@@ -209,26 +241,6 @@ namespace trkf {
     double maxLength;
     double steps_size;
     double rad_length{14.0};
-
-    // The following are objects that are created but not drawn or
-    // saved.  This class should consider accepting a "debug"
-    // parameter where if it is specified, then the graphs will be
-    // created; otherwise, their creation is unnecessary and impedes
-    // efficiency.
-    //
-    // N.B. TPolyLine3D objects are owned by ROOT, and we thus refer
-    // to them by pointer.  It is important that 'delete' is not
-    // called on the TPolyLine3D pointers during destruction of a
-    // TrackMomentumCalculator object.
-    TPolyLine3D* gr_reco_xyz{nullptr};
-    TGraph gr_reco_xy{};
-    TGraph gr_reco_yz{};
-    TGraph gr_reco_xz{};
-
-    TPolyLine3D* gr_seg_xyz{nullptr};
-    TGraph gr_seg_xy{};
-    TGraph gr_seg_yz{};
-    TGraph gr_seg_xz{};
   };
 
 } // namespace trkf
@@ -73,7 +73,7 @@ namespace tca {
     {
       slices.resize(0);
       evt.sptHits.resize(0);
-      evt.wireHitRange.resize(0);
+      evt.planeHits.resize(0);
     }
 
   private:
@@ -9,6 +9,9 @@
 #include "TMatrixDSym.h"
 #include "TMatrixDSymEigen.h"
 
+#include <cmath>
+#include <limits>
+
 using namespace std;
 using namespace trkf;
 using namespace recob::tracking;
@@ -55,9 +58,9 @@ recob::MCSFitResult TrajectoryMCSFitter::fitMcs(const recob::TrackTrajectory& tr
   }
   double detAngResol = DetectorAngularResolution(std::abs(traj.StartDirection().Z()));
   const ScanResult fwdResult =
-    doLikelihoodScan(dtheta, segradlengths, cumLenFwd, true, pid, detAngResol);
+    doLikelihoodScan(makeSegmentTable(dtheta, segradlengths, cumLenFwd, true), pid, detAngResol);
   const ScanResult bwdResult =
-    doLikelihoodScan(dtheta, segradlengths, cumLenBwd, false, pid, detAngResol);
+    doLikelihoodScan(makeSegmentTable(dtheta, segradlengths, cumLenBwd, false), pid, detAngResol);
   //
   return recob::MCSFitResult(pid,
                              fwdResult.p,
@@ -150,6 +153,39 @@ void TrajectoryMCSFitter::breakTrajInSegments(const recob::TrackTrajectory& traj
   return;
 }
 
+namespace {
+  // Momentum uncertainty from the distance to the first point on each side of the minimum
+  // where the likelihood increases by at least 0.5; lnL(j) returns the value at grid point j.
+  template <typename LogL>
+  float scanUncertainty(LogL&& lnL, int best_idx, int npoints, float pstep)
+  {
+    if (best_idx < 0) return -1.;
+    //uncertainty from left side scan
+    float lunc = -1.;
+    if (best_idx > 0) {
+      for (int j = best_idx - 1; j >= 0; j--) {
+        float dLL = lnL(j) - lnL(best_idx);
+        if (dLL >= 0.5) {
+          lunc = (best_idx - j) * pstep;
+          break;
+        }
+      }
+    }
+    //uncertainty from right side scan
+    float runc = -1.;
+    if (best_idx < npoints - 1) {
+      for (int j = best_idx + 1; j < npoints; j++) {
+        float dLL = lnL(j) - lnL(best_idx);
+        if (dLL >= 0.5) {
+          runc = (j - best_idx) * pstep;
+          break;
+        }
+      }
+    }
+    return std::max(lunc, runc);
+  }
+}
+
 const TrajectoryMCSFitter::ScanResult TrajectoryMCSFitter::doLikelihoodScan(
   std::vector<float>& dtheta,
   std::vector<float>& seg_nradlengths,
@@ -161,43 +197,12 @@ const TrajectoryMCSFitter::ScanResult TrajectoryMCSFitter::doLikelihoodScan(
   float pstep,
   float detAngResol) const
 {
-  int best_idx = -1;
-  float best_logL = std::numeric_limits<float>::max();
-  float best_p = -1.0;
-  std::vector<float> vlogL;
-  for (float p_test = pmin; p_test <= pmax; p_test += pstep) {
-    float logL = mcsLikelihood(p_test, detAngResol, dtheta, seg_nradlengths, cumLen, fwdFit, pid);
-    if (logL < best_logL) {
-      best_p = p_test;
-      best_logL = logL;
-      best_idx = vlogL.size();
-    }
-    vlogL.push_back(logL);
-  }
-  //
-  //uncertainty from left side scan
-  float lunc = -1.;
-  if (best_idx > 0) {
-    for (int j = best_idx - 1; j >= 0; j--) {
-      float dLL = vlogL[j] - vlogL[best_idx];
-      if (dLL >= 0.5) {
-        lunc = (best_idx - j) * pstep;
-        break;
-      }
-    }
-  }
-  //uncertainty from right side scan
-  float runc = -1.;
-  if (best_idx < int(vlogL.size() - 1)) {
-    for (unsigned int j = best_idx + 1; j < vlogL.size(); j++) {
-      float dLL = vlogL[j] - vlogL[best_idx];
-      if (dLL >= 0.5) {
-        runc = (j - best_idx) * pstep;
-        break;
-      }
-    }
-  }
-  return ScanResult(best_p, std::max(lunc, runc), best_logL);
+  return doGridScan(makeSegmentTable(dtheta, seg_nradlengths, cumLen, fwdFit),
+                    pid,
+                    pmin,
+                    pmax,
+                    pstep,
+                    detAngResol);
 }
 
 const TrajectoryMCSFitter::ScanResult TrajectoryMCSFitter::doLikelihoodScan(
@@ -208,10 +213,18 @@ const TrajectoryMCSFitter::ScanResult TrajectoryMCSFitter::doLikelihoodScan(
   int pid,
   float detAngResol) const
 {
+  return doLikelihoodScan(
+    makeSegmentTable(dtheta, seg_nradlengths, cumLen, fwdFit), pid, detAngResol);
+}
+
+const TrajectoryMCSFitter::ScanResult TrajectoryMCSFitter::doLikelihoodScan(
+  const SegmentTable& segs,
+  int pid,
+  float detAngResol) const
+{
 
   //do a first, coarse scan
-  const ScanResult& coarseRes = doLikelihoodScan(
-    dtheta, seg_nradlengths, cumLen, fwdFit, pid, pMin_, pMax_, pStepCoarse_, detAngResol);
+  const ScanResult& coarseRes = doGridScan(segs, pid, pMin_, pMax_, pStepCoarse_, detAngResol);
 
   float pmax = std::min(coarseRes.p + fineScanWindow_, pMax_);
   float pmin = std::max(coarseRes.p - fineScanWindow_, pMin_);
@@ -221,10 +234,139 @@ const TrajectoryMCSFitter::ScanResult TrajectoryMCSFitter::doLikelihoodScan(
   }
 
   //do the fine grained scan in a smaller region
-  const ScanResult& refineRes =
-    doLikelihoodScan(dtheta, seg_nradlengths, cumLen, fwdFit, pid, pmin, pmax, pStep_, detAngResol);
+  if (bracketFineScan_) return doBracketScan(segs, pid, pmin, pmax, pStep_, detAngResol);
+  return doGridScan(segs, pid, pmin, pmax, pStep_, detAngResol);
+}
+
+const TrajectoryMCSFitter::ScanResult TrajectoryMCSFitter::doGridScan(const SegmentTable& segs,
+                                                                      int pid,
+                                                                      float pmin,
+                                                                      float pmax,
+                                                                      float pstep,
+                                                                      float detAngResol) const
+{
+  int best_idx = -1;
+  float best_logL = std::numeric_limits<float>::max();
+  float best_p = -1.0;
+  std::vector<float> vlogL;
+  //
+  // momentum values are accumulated exactly as in a scalar scan, and evaluated ScanLanes at a time
+  std::array<double, ScanLanes> lanesP;
+  std::array<double, ScanLanes> lanesLogL;
+  size_t nlanes = 0;
+  auto evalLanes = [&]() {
+    mcsLikelihoodLanes(lanesP.data(), nlanes, detAngResol, segs, pid, lanesLogL.data());
+    for (size_t l = 0; l < nlanes; ++l) {
+      float logL = lanesLogL[l];
+      if (logL < best_logL) {
+        best_p = lanesP[l];
+        best_logL = logL;
+        best_idx = vlogL.size();
+      }
+      vlogL.push_back(logL);
+    }
+    nlanes = 0;
+  };
+  for (float p_test = pmin; p_test <= pmax; p_test += pstep) {
+    lanesP[nlanes++] = p_test;
+    if (nlanes == ScanLanes) evalLanes();
+  }
+  if (nlanes > 0) evalLanes();
+  //
+  const float unc =
+    scanUncertainty([&vlogL](int j) { return vlogL[j]; }, best_idx, vlogL.size(), pstep);
+  return ScanResult(best_p, unc, best_logL);
+}
 
-  return refineRes;
+const TrajectoryMCSFitter::ScanResult TrajectoryMCSFitter::doBracketScan(const SegmentTable& segs,
+                                                                         int pid,
+                                                                         float pmin,
+                                                                         float pmax,
+                                                                         float pstep,
+                                                                         float detAngResol) const
+{
+  //
+  // same momentum grid as doGridScan, but only the points needed are evaluated
+  std::vector<float> grid;
+  for (float p_test = pmin; p_test <= pmax; p_test += pstep)
+    grid.push_back(p_test);
+  if (grid.empty()) return ScanResult(-1.0, -1.0, std::numeric_limits<float>::max());
+  //
+  std::vector<float> vlogL(grid.size(), std::numeric_limits<float>::quiet_NaN());
+  // evaluate the points in idx not yet computed, ScanLanes at a time
+  std::array<double, ScanLanes> lanesP;
+  std::array<double, ScanLanes> lanesLogL;
+  std::array<size_t, ScanLanes> lanesIdx;
+  auto evalPoints = [&](const std::vector<size_t>& idx) {
+    size_t nlanes = 0;
+    auto evalLanes = [&]() {
+      mcsLikelihoodLanes(lanesP.data(), nlanes, detAngResol, segs, pid, lanesLogL.data());
+      for (size_t l = 0; l < nlanes; ++l)
+        vlogL[lanesIdx[l]] = lanesLogL[l];
+      nlanes = 0;
+    };
+    for (size_t i : idx) {
+      if (!std::isnan(vlogL[i])) continue;
+      lanesIdx[nlanes] = i;
+      lanesP[nlanes++] = grid[i];
+      if (nlanes == ScanLanes) evalLanes();
+    }
+    if (nlanes > 0) evalLanes();
+  };
+  //
+  // (ScanLanes+1)-section search: each pass evaluates ScanLanes interior points of the
+  // bracket and keeps the two sections around the lowest one
+  size_t lo = 0;
+  size_t hi = grid.size() - 1;
+  std::vector<size_t> idx;
+  while (hi - lo > ScanLanes + 1) {
+    idx.clear();
+    for (size_t k = 1; k <= ScanLanes; ++k)
+      idx.push_back(lo + k * (hi - lo) / (ScanLanes + 1));
+    evalPoints(idx);
+    size_t kbest = 0;
+    for (size_t k = 1; k < ScanLanes; ++k)
+      if (vlogL[idx[k]] < vlogL[idx[kbest]]) kbest = k;
+    const size_t newlo = (kbest == 0 ? lo : idx[kbest - 1]);
+    const size_t newhi = (kbest == ScanLanes - 1 ? hi : idx[kbest + 1]);
+    lo = newlo;
+    hi = newhi;
+  }
+  idx.clear();
+  for (size_t i = lo; i <= hi; ++i)
+    idx.push_back(i);
+  evalPoints(idx);
+  //
+  int best_idx = -1;
+  float best_logL = std::numeric_limits<float>::max();
+  float best_p = -1.0;
+  for (size_t i = lo; i <= hi; ++i) {
+    if (vlogL[i] < best_logL) {
+      best_p = grid[i];
+      best_logL = vlogL[i];
+      best_idx = i;
+    }
+  }
+  if (best_idx < 0) return ScanResult(best_p, -1.0, best_logL);
+  //
+  // walk away from the minimum, evaluating ScanLanes points ahead on demand
+  auto lnL = [&](int j) {
+    if (std::isnan(vlogL[j])) {
+      idx.clear();
+      if (j < best_idx) {
+        for (int i = j; i >= std::max(0, j - int(ScanLanes) + 1); --i)
+          idx.push_back(i);
+      }
+      else {
+        for (int i = j; i < std::min(int(grid.size()), j + int(ScanLanes)); ++i)
+          idx.push_back(i);
+      }
+      evalPoints(idx);
+    }
+    return vlogL[j];
+  };
+  const float unc = scanUncertainty(lnL, best_idx, grid.size(), pstep);
+  return ScanResult(best_p, unc, best_logL);
 }
 
 void TrajectoryMCSFitter::linearRegression(const recob::TrackTrajectory& traj,
@@ -306,6 +448,32 @@ void TrajectoryMCSFitter::linearRegression(const recob::TrackTrajectory& traj,
   //
 }
 
+TrajectoryMCSFitter::SegmentTable TrajectoryMCSFitter::makeSegmentTable(
+  const std::vector<float>& dthetaij,
+  const std::vector<float>& seg_nradl,
+  const std::vector<float>& cumLen,
+  bool fwd) const
+{
+  //
+  const int beg = (fwd ? 0 : (dthetaij.size() - 1));
+  const int end = (fwd ? dthetaij.size() : -1);
+  const int incr = (fwd ? +1 : -1);
+  //
+  constexpr double HighlandSecondTerm = 0.038;
+  SegmentTable segs;
+  for (int i = beg; i != end; i += incr) {
+    if (dthetaij[i] < 0) {
+      //cout << "skip segment with too few points" << endl;
+      continue;
+    }
+    segs.dtheta.push_back(dthetaij[i]);
+    segs.cumLen.push_back(cumLen[i]);
+    segs.logTerm.push_back(1.0 + HighlandSecondTerm * std::log(seg_nradl[i]));
+    segs.sqrtTerm.push_back(std::sqrt(seg_nradl[i]));
+  }
+  return segs;
+}
+
 double TrajectoryMCSFitter::mcsLikelihood(double p,
                                           double theta0x,
                                           std::vector<float>& dthetaij,
@@ -313,48 +481,66 @@ double TrajectoryMCSFitter::mcsLikelihood(double p,
                                           std::vector<float>& cumLen,
                                           bool fwd,
                                           int pid) const
+{
+  double result = 0;
+  mcsLikelihoodLanes(
+    &p, 1, theta0x, makeSegmentTable(dthetaij, seg_nradl, cumLen, fwd), pid, &result);
+  return result;
+}
+
+void TrajectoryMCSFitter::mcsLikelihoodLanes(const double* p,
+                                             size_t n,
+                                             double theta0x,
+                                             const SegmentTable& segs,
+                                             int pid,
+                                             double* logL) const
 {
   //
-  const int beg = (fwd ? 0 : (dthetaij.size() - 1));
-  const int end = (fwd ? dthetaij.size() : -1);
-  const int incr = (fwd ? +1 : -1);
-  //
-  // bool print = false;
+  // Each lane follows exactly the arithmetic of a single hypothesis; lanes that reach an
+  // unphysical energy are frozen at the maximum value and skipped afterwards.
   //
   const double m = mass(pid);
   const double m2 = m * m;
-  const double Etot = sqrt(p * p + m2); //Initial energy
-  double Eij2 = 0.;
+  std::array<double, ScanLanes> Etot; //Initial energy
+  std::array<double, ScanLanes> Eij;
+  std::array<bool, ScanLanes> done;
+  size_t ndone = 0;
+  for (size_t l = 0; l < n; ++l) {
+    Etot[l] = sqrt(p[l] * p[l] + m2);
+    logL[l] = 0;
+    done[l] = false;
+  }
   //
   double const fixedterm = 0.5 * std::log(2.0 * M_PI);
-  double result = 0;
-  for (int i = beg; i != end; i += incr) {
-    if (dthetaij[i] < 0) {
-      //cout << "skip segment with too few points" << endl;
-      continue;
-    }
+  for (size_t i = 0; i < segs.dtheta.size() && ndone < n; ++i) {
     //
-    const double Eij = GetE(Etot, cumLen[i], m);
-    Eij2 = Eij * Eij;
+    GetELanes(Etot.data(), n, segs.cumLen[i], m, Eij.data());
     //
-    if (Eij2 <= m2) {
-      result = std::numeric_limits<double>::max();
-      break;
-    }
-    const double pij = sqrt(Eij2 - m2); //momentum at this segment
-    const double beta = sqrt(1. - ((m2) / (pij * pij + m2)));
-    constexpr double HighlandSecondTerm = 0.038;
-    const double tH0 = (HighlandFirstTerm(pij) / (pij * beta)) *
-                       (1.0 + HighlandSecondTerm * std::log(seg_nradl[i])) * sqrt(seg_nradl[i]);
-    const double rms = sqrt(2.0 * (tH0 * tH0 + theta0x * theta0x));
-    if (rms == 0.0) {
-      std::cout << " Error : RMS cannot be zero ! " << std::endl;
-      return std::numeric_limits<double>::max();
+    for (size_t l = 0; l < n; ++l) {
+      if (done[l]) continue;
+      const double Eij2 = Eij[l] * Eij[l];
+      if (Eij2 <= m2) {
+        logL[l] = std::numeric_limits<double>::max();
+        done[l] = true;
+        ++ndone;
+        continue;
+      }
+      const double pij = sqrt(Eij2 - m2); //momentum at this segment
+      const double beta = sqrt(1. - ((m2) / (pij * pij + m2)));
+      const double tH0 =
+        (HighlandFirstTerm(pij) / (pij * beta)) * segs.logTerm[i] * segs.sqrtTerm[i];
+      const double rms = sqrt(2.0 * (tH0 * tH0 + theta0x * theta0x));
+      if (rms == 0.0) {
+        std::cout << " Error : RMS cannot be zero ! " << std::endl;
+        logL[l] = std::numeric_limits<double>::max();
+        done[l] = true;
+        ++ndone;
+        continue;
+      }
+      const double arg = segs.dtheta[i] / rms;
+      logL[l] += (std::log(rms) + 0.5 * arg * arg + fixedterm);
     }
-    const double arg = dthetaij[i] / rms;
-    result += (std::log(rms) + 0.5 * arg * arg + fixedterm);
   }
-  return result;
 }
 
 double TrajectoryMCSFitter::energyLossLandau(const double mass2,
@@ -436,3 +622,47 @@ double TrajectoryMCSFitter::GetE(const double initial_E,
   }
   return current_E;
 }
+//
+void TrajectoryMCSFitter::GetELanes(const double* initial_E,
+                                    size_t n,
+                                    const double length_travelled,
+                                    const double m,
+                                    double* E) const
+{
+  //
+  if (eLossMode_ == 1) {
+    // ELoss mode: MIP (constant)
+    constexpr double kcal = 0.002105;
+    for (size_t l = 0; l < n; ++l)
+      E[l] = (initial_E[l] - kcal * length_travelled); //energy at this segment
+    return;
+  }
+  //
+  // Non constant energy loss distribution, stepping all lanes together
+  const double step_size = length_travelled / nElossSteps_;
+  //
+  const double m2 = m * m;
+  std::array<bool, ScanLanes> stopped;
+  for (size_t l = 0; l < n; ++l) {
+    E[l] = initial_E[l];
+    stopped[l] = false;
+  }
+  //
+  for (auto i = 0; i < nElossSteps_; ++i) {
+    for (size_t l = 0; l < n; ++l) {
+      if (stopped[l]) continue;
+      if (eLossMode_ == 2) {
+        double dedx = energyLossBetheBloch(m, E[l]);
+        E[l] -= (dedx * step_size);
+      }
+      else {
+        // MPV of Landau energy loss distribution
+        E[l] -= energyLossLandau(m2, E[l] * E[l], step_size);
+      }
+      if (E[l] <= m) {
+        E[l] = 0.;
+        stopped[l] = true;
+      }
+    }
+  }
+}
@@ -110,6 +110,13 @@ namespace trkf {
         Name("applySCEcorr"),
         Comment("Flag to turn the Space Charge Effect correction on/off."),
         false};
+      fhicl::Atom<bool> bracketFineScan{
+        Name("bracketFineScan"),
+        Comment("If true, the fine grained scan is replaced by a bracketing search on the same "
+                "momentum grid, which narrows the window around the best of 8 points per pass and "
+                "evaluates only the points needed to locate the minimum and its uncertainty. "
+                "Assumes a unimodal likelihood in the window."),
+        false};
     };
     using Parameters = fhicl::Table<Config>;
     //
@@ -127,7 +134,8 @@ namespace trkf {
                         const std::array<double, 5>& angResol,
                         const std::array<double, 5>& hlParams,
                         double segLenTolerance,
-                        bool applySCEcorr)
+                        bool applySCEcorr,
+                        bool bracketFineScan = false)
     {
       pIdHyp_ = pIdHyp;
       minNSegs_ = minNSegs;
@@ -144,6 +152,7 @@ namespace trkf {
       hlParams_ = hlParams;
       segLenTolerance_ = segLenTolerance;
       applySCEcorr_ = applySCEcorr;
+      bracketFineScan_ = bracketFineScan;
     }
     explicit TrajectoryMCSFitter(const Parameters& p)
       : TrajectoryMCSFitter(p().pIdHypothesis(),
@@ -160,7 +169,8 @@ namespace trkf {
                             p().angResol(),
                             p().hlParams(),
                             p().segLenTolerance(),
-                            p().applySCEcorr())
+                            p().applySCEcorr(),
+                            p().bracketFineScan())
     {}
     //
     recob::MCSFitResult fitMcs(const recob::TrackTrajectory& traj) const
@@ -201,6 +211,34 @@ namespace trkf {
                          bool fwd,
                          int pid) const;
     //
+    /// Number of momentum hypotheses evaluated together by mcsLikelihoodLanes.
+    static constexpr size_t ScanLanes = 8;
+    //
+    /**
+     * @brief Per-segment quantities shared by all the momentum hypotheses of a scan.
+     *
+     * Segments with invalid angles are dropped and the remaining ones are stored in the
+     * order they are visited by the fit (reversed for backward fits), together with the
+     * radiation length factors of the Highland formula, which do not depend on momentum.
+     */
+    struct SegmentTable {
+      std::vector<double> dtheta;   ///< scattering angle (mrad)
+      std::vector<double> cumLen;   ///< length travelled before the segment (cm)
+      std::vector<double> logTerm;  ///< 1 + 0.038 * log(nradl)
+      std::vector<double> sqrtTerm; ///< sqrt(nradl)
+    };
+    SegmentTable makeSegmentTable(const std::vector<float>& dthetaij,
+                                  const std::vector<float>& seg_nradl,
+                                  const std::vector<float>& cumLen,
+                                  bool fwd) const;
+    /// Evaluate the likelihood for n <= ScanLanes momentum values at once.
+    void mcsLikelihoodLanes(const double* p,
+                            size_t n,
+                            double theta0x,
+                            const SegmentTable& segs,
+                            int pid,
+                            double* logL) const;
+    //
     struct ScanResult {
     public:
       ScanResult(double ap, double apUnc, double alogL) : p(ap), pUnc(apUnc), logL(alogL) {}
@@ -222,6 +260,12 @@ namespace trkf {
                                       float pmax,
                                       float pstep,
                                       float detAngResol) const;
+    const ScanResult doBracketScan(const SegmentTable& segs,
+                                   int pid,
+                                   float pmin,
+                                   float pmax,
+                                   float pstep,
+                                   float detAngResol) const;
     //
     inline double HighlandFirstTerm(const double p) const
     {
@@ -245,6 +289,12 @@ namespace trkf {
     double energyLossLandau(const double mass2, const double E2, const double x) const;
     //
     double GetE(const double initial_E, const double length_travelled, const double mass) const;
+    /// Same as GetE, for n <= ScanLanes initial energies at the same length travelled.
+    void GetELanes(const double* initial_E,
+                   size_t n,
+                   const double length_travelled,
+                   const double mass,
+                   double* E) const;
     //
     int minNSegs() const { return minNSegs_; }
     double segLen() const { return segLen_; }
@@ -266,6 +316,15 @@ namespace trkf {
     std::array<double, 5> hlParams_;
     double segLenTolerance_;
     bool applySCEcorr_;
+    bool bracketFineScan_;
+    //
+    const ScanResult doLikelihoodScan(const SegmentTable& segs, int pid, float detAngResol) const;
+    const ScanResult doGridScan(const SegmentTable& segs,
+                                int pid,
+                                float pmin,
+                                float pmax,
+                                float pstep,
+                                float detAngResol) const;
   };
 }
 
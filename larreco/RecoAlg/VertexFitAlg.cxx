@@ -8,11 +8,14 @@
 ///
 ////////////////////////////////////////////////////////////////////////
 
-#include "TMinuit.h"
 #include "TVector3.h"
+#include <algorithm>
 #include <array>
 #include <cmath>
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "larcorealg/Geometry/CryostatGeo.h"
 #include "larcorealg/Geometry/TPCGeo.h"
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
@@ -21,64 +24,197 @@
 
 namespace trkf {
 
-  VertexFitMinuitStruct VertexFitAlg::fVtxFitMinStr;
-
   /////////////////////////////////////////
-  void VertexFitAlg::fcnVtxPos(Int_t&, Double_t*, Double_t& fval, double* par, Int_t flag)
+  double VertexFitAlg::VtxPosChiDOF(VertexFitMinuitStruct const& fit,
+                                    std::vector<double> const& par,
+                                    std::vector<double>* res,
+                                    std::vector<double>* jac)
   {
-    // Minuit function for fitting the vertex position and vertex track directions
+    // Function for fitting the vertex position and vertex track directions
 
-    fval = 0;
+    double fval = 0;
     double vWire = 0, DirX, DirY, DirZ, DirU, dX, dU, arg;
     unsigned short ipl, lastpl, indx;
+    std::size_t const npars = par.size();
+
+    if (jac) {
+      res->clear();
+      jac->clear();
+    }
 
-    for (unsigned short itk = 0; itk < fVtxFitMinStr.HitX.size(); ++itk) {
+    for (unsigned short itk = 0; itk < fit.HitX.size(); ++itk) {
       lastpl = 4;
       // index of the track Y direction vector. Z direction is the next one
       indx = 3 + 2 * itk;
-      for (unsigned short iht = 0; iht < fVtxFitMinStr.HitX[itk].size(); ++iht) {
-        ipl = fVtxFitMinStr.Plane[itk][iht];
+      for (unsigned short iht = 0; iht < fit.HitX[itk].size(); ++iht) {
+        ipl = fit.Plane[itk][iht];
         if (ipl != lastpl) {
           // get the vertex position in this plane
           // vertex wire number in the Detector coordinate system (equivalent to WireCoordinate)
           //vtx wir = vtx Y  * OrthY                + vtx Z  * OrthZ                    - wire offset
-          vWire = par[1] * fVtxFitMinStr.OrthY[ipl] + par[2] * fVtxFitMinStr.OrthZ[ipl] -
-                  fVtxFitMinStr.FirstWire[ipl];
+          vWire = par[1] * fit.OrthY[ipl] + par[2] * fit.OrthZ[ipl] - fit.FirstWire[ipl];
           lastpl = ipl;
         } // ipl != lastpl
         DirY = par[indx];
         DirZ = par[indx + 1];
         // rotate the track direction DirY, DirZ into the wire coordinate of this plane. The OrthVectors in WireReadoutStandardGeom
         // are divided by the wire pitch so we need to correct for that here
-        DirU = fVtxFitMinStr.WirePitch *
-               (DirY * fVtxFitMinStr.OrthY[ipl] + DirZ * fVtxFitMinStr.OrthZ[ipl]);
+        DirU = fit.WirePitch * (DirY * fit.OrthY[ipl] + DirZ * fit.OrthZ[ipl]);
         // distance (cm) between the wire and the vertex in the wire coordinate system (U)
-        dU = fVtxFitMinStr.WirePitch * (fVtxFitMinStr.Wire[itk][iht] - vWire);
+        dU = fit.WirePitch * (fit.Wire[itk][iht] - vWire);
+        double* dXdPar = nullptr;
+        if (jac) {
+          jac->resize(jac->size() + npars, 0.);
+          dXdPar = jac->data() + jac->size() - npars;
+          dXdPar[0] = 1;
+        }
         if (std::abs(DirU) < 1E-3 || std::abs(dU) < 1E-3) {
           // vertex is on the wire
-          dX = par[0] - fVtxFitMinStr.HitX[itk][iht];
+          dX = par[0] - fit.HitX[itk][iht];
         }
         else {
           // project from vertex to the wire. We need to find dX/dU so first find DirX
           DirX = 1 - DirY * DirY - DirZ * DirZ;
           // DirX should be > 0 but the bounds on DirY and DirZ are +/- 1 so it is possible for a non-physical result.
-          if (DirX < 0) DirX = 0;
+          bool const physical = (DirX > 0);
+          if (!physical) DirX = 0;
           DirX = sqrt(DirX);
           // Get the DirX sign from the relative X position of the hit and the vertex
-          if (fVtxFitMinStr.HitX[itk][iht] < par[0]) DirX = -DirX;
-          dX = par[0] + (dU * DirX / DirU) - fVtxFitMinStr.HitX[itk][iht];
+          if (fit.HitX[itk][iht] < par[0]) DirX = -DirX;
+          dX = par[0] + (dU * DirX / DirU) - fit.HitX[itk][iht];
+          if (dXdPar) {
+            // derivatives of dU * DirX / DirU
+            dXdPar[1] = -fit.WirePitch * fit.OrthY[ipl] * DirX / DirU;
+            dXdPar[2] = -fit.WirePitch * fit.OrthZ[ipl] * DirX / DirU;
+            double const dDirXdY = physical ? -DirY / DirX : 0;
+            double const dDirXdZ = physical ? -DirZ / DirX : 0;
+            double const ratio = dU / DirU;
+            dXdPar[indx] = ratio * (dDirXdY - DirX * fit.WirePitch * fit.OrthY[ipl] / DirU);
+            dXdPar[indx + 1] = ratio * (dDirXdZ - DirX * fit.WirePitch * fit.OrthZ[ipl] / DirU);
+          }
         }
-        arg = dX / fVtxFitMinStr.HitXErr[itk][iht];
+        arg = dX / fit.HitXErr[itk][iht];
         fval += arg * arg;
+        if (jac) {
+          res->push_back(arg);
+          for (std::size_t ip = 0; ip < npars; ++ip)
+            dXdPar[ip] /= fit.HitXErr[itk][iht];
+        }
       } // iht
     }   //itk
 
-    fval /= fVtxFitMinStr.DoF;
+    return fval / fit.DoF;
 
-    // save the final chisq/dof in the struct on the last call
-    if (flag == 3) fVtxFitMinStr.ChiDoF = fval;
+  } // VtxPosChiDOF
+
+  /////////////////////////////////////////
+  void VertexFitAlg::Minimize(VertexFitMinuitStruct const& fit,
+                              std::vector<double>& par,
+                              std::vector<double>& parerr)
+  {
+    // Gauss-Newton steps on the residuals, damped as in Levenberg-Marquardt when they do not
+    // reduce the chisq. The parameters are kept within the limits that were used with Minuit.
+    std::size_t const npars = par.size();
+    auto clamp = [npars](std::vector<double>& p) {
+      for (unsigned int ip = 0; ip < npars; ++ip) {
+        double const lim = (ip < 3) ? 1E6 : 1.05;
+        p[ip] = std::clamp(p[ip], -lim, lim);
+      }
+    };
+
+    // solves a x = b by Gaussian elimination with partial pivoting; a and b are modified.
+    // Returns false if the matrix is singular
+    auto solve = [npars](std::vector<double>& a, std::vector<double>& b) {
+      for (std::size_t col = 0; col < npars; ++col) {
+        std::size_t piv = col;
+        for (std::size_t row = col + 1; row < npars; ++row)
+          if (std::abs(a[row * npars + col]) > std::abs(a[piv * npars + col])) piv = row;
+        if (std::abs(a[piv * npars + col]) < 1E-300) return false;
+        if (piv != col) {
+          for (std::size_t k = 0; k < npars; ++k)
+            std::swap(a[col * npars + k], a[piv * npars + k]);
+          std::swap(b[col], b[piv]);
+        }
+        for (std::size_t row = col + 1; row < npars; ++row) {
+          double const f = a[row * npars + col] / a[col * npars + col];
+          if (f == 0) continue;
+          for (std::size_t k = col; k < npars; ++k)
+            a[row * npars + k] -= f * a[col * npars + k];
+          b[row] -= f * b[col];
+        }
+      }
+      for (std::size_t col = npars; col-- > 0;) {
+        for (std::size_t k = col + 1; k < npars; ++k)
+          b[col] -= a[col * npars + k] * b[k];
+        b[col] /= a[col * npars + col];
+      }
+      return true;
+    };
+
+    std::vector<double> res, jac, trial(npars), step(npars);
+    std::vector<double> jtj(npars * npars), damped(npars * npars);
+    auto normalEquations = [&]() {
+      std::fill(jtj.begin(), jtj.end(), 0.);
+      std::fill(step.begin(), step.end(), 0.);
+      for (std::size_t ir = 0; ir < res.size(); ++ir) {
+        double const* row = jac.data() + ir * npars;
+        for (std::size_t i = 0; i < npars; ++i) {
+          if (row[i] == 0) continue;
+          step[i] -= row[i] * res[ir];
+          for (std::size_t j = i; j < npars; ++j)
+            jtj[i * npars + j] += row[i] * row[j];
+        }
+      }
+      for (std::size_t i = 0; i < npars; ++i)
+        for (std::size_t j = 0; j < i; ++j)
+          jtj[i * npars + j] = jtj[j * npars + i];
+    };
+
+    clamp(par);
+    double fval = VtxPosChiDOF(fit, par, &res, &jac);
+    double lambda = 1E-3;
+    for (unsigned short iter = 0; iter < 100; ++iter) {
+      normalEquations();
+      std::vector<double> const gradient = step;
+      bool improved = false;
+      double ftrial = fval;
+      while (lambda < 1E10) {
+        damped = jtj;
+        for (std::size_t i = 0; i < npars; ++i)
+          damped[i * npars + i] += lambda * (jtj[i * npars + i] > 0 ? jtj[i * npars + i] : 1);
+        step = gradient;
+        if (solve(damped, step)) {
+          for (std::size_t i = 0; i < npars; ++i)
+            trial[i] = par[i] + step[i];
+          clamp(trial);
+          ftrial = VtxPosChiDOF(fit, trial);
+          if (ftrial < fval) {
+            improved = true;
+            break;
+          }
+        }
+        lambda *= 10;
+      }
+      if (!improved) break;
+      lambda = std::max(lambda / 10, 1E-7);
+      bool const converged = (fval - ftrial) < 1E-6 * fval + 1E-12;
+      par.swap(trial);
+      fval = VtxPosChiDOF(fit, par, &res, &jac);
+      if (converged) break;
+    } // iter
+
+    // parameter errors for the chisq/DOF, as from Minuit with an error definition of 1
+    normalEquations();
+    parerr.assign(npars, 0.);
+    for (std::size_t ip = 0; ip < npars; ++ip) {
+      damped = jtj;
+      std::vector<double> unit(npars, 0.);
+      unit[ip] = 1;
+      if (!solve(damped, unit) || unit[ip] < 0) continue;
+      parerr[ip] = sqrt(fit.DoF * unit[ip]);
+    }
+  } // Minimize
 
-  } // fcnVtxPos
 
   /////////////////////////////////////////
 
@@ -117,95 +253,60 @@ namespace trkf {
     geo::TPCID const& tpcid = hitWID[0][0];
     unsigned int const nplanes = wireReadoutGeom->Nplanes(tpcid);
 
-    fVtxFitMinStr.Cstat = tpcid.Cryostat;
-    fVtxFitMinStr.TPC = tpcid.TPC;
-    fVtxFitMinStr.NPlanes = nplanes;
-    fVtxFitMinStr.WirePitch = wireReadoutGeom->Plane(hitWID[0][0]).WirePitch();
+    // the fit state is local, so that fits can run concurrently
+    VertexFitMinuitStruct fit;
+    fit.Cstat = tpcid.Cryostat;
+    fit.TPC = tpcid.TPC;
+    fit.NPlanes = nplanes;
+    fit.WirePitch = wireReadoutGeom->Plane(hitWID[0][0]).WirePitch();
 
     // Put geometry conversion factors into the struct
     for (unsigned int ipl = 0; ipl < nplanes; ++ipl) {
       auto const& plane = wireReadoutGeom->Plane({tpcid, ipl});
-      fVtxFitMinStr.FirstWire[ipl] = -plane.WireCoordinate(geo::Point_t{0, 0, 0});
-      fVtxFitMinStr.OrthY[ipl] =
-        plane.WireCoordinate(geo::Point_t{0, 1, 0}) + fVtxFitMinStr.FirstWire[ipl];
-      fVtxFitMinStr.OrthZ[ipl] =
-        plane.WireCoordinate(geo::Point_t{0, 0, 1}) + fVtxFitMinStr.FirstWire[ipl];
+      fit.FirstWire[ipl] = -plane.WireCoordinate(geo::Point_t{0, 0, 0});
+      fit.OrthY[ipl] = plane.WireCoordinate(geo::Point_t{0, 1, 0}) + fit.FirstWire[ipl];
+      fit.OrthZ[ipl] = plane.WireCoordinate(geo::Point_t{0, 0, 1}) + fit.FirstWire[ipl];
     }
     // and the vertex starting position
-    fVtxFitMinStr.VtxPos = VtxPos;
+    fit.VtxPos = VtxPos;
 
     // and the track direction and hits
-    fVtxFitMinStr.HitX = hitX;
-    fVtxFitMinStr.HitXErr = hitXErr;
-    fVtxFitMinStr.Plane.resize(ntrks);
-    fVtxFitMinStr.Wire.resize(ntrks);
+    fit.HitX = hitX;
+    fit.HitXErr = hitXErr;
+    fit.Plane.resize(ntrks);
+    fit.Wire.resize(ntrks);
     for (unsigned int itk = 0; itk < ntrks; ++itk) {
-      fVtxFitMinStr.Plane[itk].resize(hitX[itk].size());
-      fVtxFitMinStr.Wire[itk].resize(hitX[itk].size());
+      fit.Plane[itk].resize(hitX[itk].size());
+      fit.Wire[itk].resize(hitX[itk].size());
       for (std::size_t iht = 0; iht < hitWID[itk].size(); ++iht) {
-        fVtxFitMinStr.Plane[itk][iht] = hitWID[itk][iht].Plane;
-        fVtxFitMinStr.Wire[itk][iht] = hitWID[itk][iht].Wire;
+        fit.Plane[itk][iht] = hitWID[itk][iht].Plane;
+        fit.Wire[itk][iht] = hitWID[itk][iht].Wire;
       }
     } // itk
-    fVtxFitMinStr.Dir = TrkDir;
+    fit.Dir = TrkDir;
 
-    fVtxFitMinStr.DoF = npts - npars;
+    fit.DoF = npts - npars;
 
     // define the starting parameters
     std::vector<double> par(npars);
-    std::vector<double> stp(npars);
     std::vector<double> parerr(npars);
 
-    TMinuit* gMin = new TMinuit(npars);
-    gMin->SetFCN(VertexFitAlg::fcnVtxPos);
-    int errFlag = 0;
-    double arglist[10];
-
-    // print level (-1 = none, 1 = yes)
-    arglist[0] = -1;
-    //
-    // ***** remember to delete gMin before returning on an error
-    //
-    gMin->mnexcm("SET PRINT", arglist, 1, errFlag);
-
     // the vertex position
     for (unsigned int ipar = 0; ipar < 3u; ++ipar) {
-      par[ipar] = fVtxFitMinStr.VtxPos[ipar]; // in cm
-      stp[ipar] = 0.1;                        // 1 mm initial step
-      gMin->mnparm(ipar, "", par[ipar], stp[ipar], -1E6, 1E6, errFlag);
+      par[ipar] = fit.VtxPos[ipar]; // in cm
     }
     // use Y, Z track directions. There is no constraint that the direction vector is unit-normalized
-    // since we are only passing two of the components. Minuit could violate this requirement when
-    // fitting. fcnVtxPos prevents non-physical values and Minuit may throw error messages as a result.
+    // since we are only passing two of the components. The fit could violate this requirement, and
+    // VtxPosChiDOF prevents non-physical values.
     for (unsigned int itk = 0; itk < ntrks; ++itk) {
       unsigned int ipar = 3 + 2 * itk;
-      par[ipar] = fVtxFitMinStr.Dir[itk](1);
-      stp[ipar] = 0.03;
-      gMin->mnparm(ipar, "", par[ipar], stp[ipar], -1.05, 1.05, errFlag);
+      par[ipar] = fit.Dir[itk](1);
       ++ipar;
-      par[ipar] = fVtxFitMinStr.Dir[itk](2);
-      stp[ipar] = 0.03;
-      gMin->mnparm(ipar, "", par[ipar], stp[ipar], -1.05, 1.05, errFlag);
+      par[ipar] = fit.Dir[itk](2);
     } // itk
 
-    // set strategy 0 for faster Minuit fitting
-    arglist[0] = 0.;
-    gMin->mnexcm("SET STRATEGY", arglist, 1, errFlag);
-
-    // execute Minuit command: Migrad, max calls, tolerance
-    arglist[0] = 500; // max calls
-    arglist[1] = 1.;  // tolerance on fval in fcn
-    gMin->mnexcm("MIGRAD", arglist, 2, errFlag);
-
-    // call fcn to get final fit values
-    arglist[0] = 3;
-    gMin->mnexcm("CALL", arglist, 1, errFlag);
-    ChiDOF = fVtxFitMinStr.ChiDoF;
-
-    // get the parameters
-    for (unsigned short ip = 0; ip < par.size(); ++ip) {
-      gMin->GetParameter(ip, par[ip], parerr[ip]);
-    }
+    Minimize(fit, par, parerr);
+    ChiDOF = VtxPosChiDOF(fit, par);
 
     // return the vertex position and errors
     for (unsigned int ipar = 0; ipar < 3u; ++ipar) {
@@ -231,8 +332,25 @@ namespace trkf {
       }
     } // itk
 
-    delete gMin;
-
   } // VertexFit()
 
+  /////////////////////////////////////////
+  void VertexFitAlg::VertexFits(std::vector<VertexFitData>& fits) const
+  {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, fits.size()),
+                      [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t ifit = r.begin(); ifit != r.end(); ++ifit) {
+                          auto& f = fits[ifit];
+                          VertexFit(f.hitWID,
+                                    f.hitX,
+                                    f.hitXErr,
+                                    f.VtxPos,
+                                    f.VtxPosErr,
+                                    f.TrkDir,
+                                    f.TrkDirErr,
+                                    f.ChiDOF);
+                        }
+                      });
+  } // VertexFits()
+
 } // namespace trkf
@@ -20,13 +20,24 @@
 #include "larreco/RecoAlg/VertexFitMinuitStruct.h"
 
 // ROOT includes
-#include "RtypesCore.h"
 #include "TVector3.h"
 
 namespace trkf {
 
   class VertexFitAlg {
   public:
+    /// Input and output of one vertex fit, with the same meaning as the VertexFit arguments
+    struct VertexFitData {
+      std::vector<std::vector<geo::WireID>> hitWID;
+      std::vector<std::vector<double>> hitX;
+      std::vector<std::vector<double>> hitXErr;
+      TVector3 VtxPos;
+      TVector3 VtxPosErr;
+      std::vector<TVector3> TrkDir;
+      std::vector<TVector3> TrkDirErr;
+      float ChiDOF = 9999;
+    };
+
     void VertexFit(std::vector<std::vector<geo::WireID>> const& hitWID,
                    std::vector<std::vector<double>> const& hitX,
                    std::vector<std::vector<double>> const& hitXErr,
@@ -36,10 +47,22 @@ namespace trkf {
                    std::vector<TVector3>& TrkDirErr,
                    float& ChiDOF) const;
 
-    // Variables for minuit.
-    static VertexFitMinuitStruct fVtxFitMinStr;
+    /// Fits all the vertices, in parallel
+    void VertexFits(std::vector<VertexFitData>& fits) const;
+
+    /// Chisq/DOF of the parameters par: vertex X, Y, Z and then Y, Z direction of each track.
+    /// If jac is not null, res and jac are filled with the hit residuals in units of their
+    /// error and their derivatives with respect to par (par.size() values per hit)
+    static double VtxPosChiDOF(VertexFitMinuitStruct const& fit,
+                               std::vector<double> const& par,
+                               std::vector<double>* res = nullptr,
+                               std::vector<double>* jac = nullptr);
 
-    static void fcnVtxPos(Int_t&, Double_t*, Double_t& fval, double* par, Int_t flag);
+    /// Levenberg-Marquardt minimization of VtxPosChiDOF starting from par; parerr are the
+    /// parameter errors for the chisq/DOF
+    static void Minimize(VertexFitMinuitStruct const& fit,
+                         std::vector<double>& par,
+                         std::vector<double>& parerr);
 
   private:
     geo::WireReadoutGeom const* wireReadoutGeom = &art::ServiceHandle<geo::WireReadout>()->Get();
@@ -37,10 +37,70 @@
 #include "lardataobj/RecoBase/Track.h"
 #include "lardataobj/RecoBase/Vertex.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <optional>
+#include <span>
+
 namespace sce {
   class SCECorrection;
 }
 
+namespace {
+  // Space points of the event sorted along x, to find the closest one to a
+  // position without scanning all of them
+  class SpacePointXIndex {
+  public:
+    explicit SpacePointXIndex(const std::vector<art::Ptr<recob::SpacePoint>>& sps) : fSPs(sps)
+    {
+      fX.reserve(sps.size());
+      for (std::size_t i = 0; i < sps.size(); ++i)
+        fX.emplace_back(sps[i]->XYZ()[0], i);
+      std::sort(fX.begin(), fX.end());
+    }
+
+    // Closest space point, the first one of the input in case of a tie
+    art::Ptr<recob::SpacePoint> closest(const geo::Point_t& pos) const
+    {
+      double minDist = std::numeric_limits<double>::max();
+      std::size_t best = fSPs.size();
+      auto test = [&](std::size_t i) {
+        const auto& xyz = fSPs[i]->XYZ();
+        const double dist = (pos - geo::Point_t(xyz[0], xyz[1], xyz[2])).Mag2();
+        if (dist < minDist || (dist == minDist && i < best)) {
+          minDist = dist;
+          best = i;
+        }
+      };
+
+      // Walk away from x in both directions until the x distance alone is
+      // larger than the closest distance found
+      const auto start = std::lower_bound(
+        fX.begin(), fX.end(), std::make_pair(pos.X(), std::size_t(0)));
+      for (auto it = start; it != fX.end(); ++it) {
+        const double dx = it->first - pos.X();
+        if (dx * dx > minDist) break;
+        test(it->second);
+      }
+      for (auto it = start; it != fX.begin();) {
+        --it;
+        const double dx = it->first - pos.X();
+        if (dx * dx > minDist) break;
+        test(it->second);
+      }
+      return (best < fSPs.size()) ? fSPs[best] : art::Ptr<recob::SpacePoint>();
+    }
+
+  private:
+    const std::vector<art::Ptr<recob::SpacePoint>>& fSPs;
+    std::vector<std::pair<double, std::size_t>> fX; // (x, index in fSPs)
+  };
+}
+
 class sce::SCECorrection : public art::EDProducer {
 public:
   explicit SCECorrection(fhicl::ParameterSet const& p);
@@ -61,7 +121,7 @@ private:
   art::ServiceHandle<geo::Geometry> fGeom;
   spacecharge::SpaceCharge const* fSCE;
 
-  const bool fCorrectNoT0Tag, fCorrectSCE, fSCEXCorrFlip;
+  const bool fCorrectNoT0Tag, fCorrectSCE, fSCEXCorrFlip, fParallel;
 
   const std::string fPFPLabel, fTrackLabel;
   const std::vector<std::string> fT0Labels;
@@ -69,11 +129,19 @@ private:
 
   geo::Vector_t applyT0Shift(const double& t0, const geo::TPCID& tpcId) const;
 
+  // Applies the T0 shift (if correctT0) and the SCE correction in place, each
+  // position being in the TPC of the same index
+  void correctPositions(std::span<geo::Point_t> positions,
+                        std::span<const geo::TPCID> tpcIds,
+                        double t0Offset,
+                        bool correctT0) const;
+
+  // fmPFPT0s and fmTrackT0s hold the PFP and track T0 associations of each of fT0Labels,
+  // or are empty if there are no such objects in the event
   std::map<art::Ptr<anab::T0>, bool> getSliceT0s(
-    const art::Event& evt,
     const std::vector<art::Ptr<recob::PFParticle>>& slicePFPs,
-    const art::Handle<std::vector<recob::PFParticle>>& pfpHandle,
-    const art::Handle<std::vector<recob::Track>>& trackHandle,
+    const std::vector<art::FindManyP<anab::T0>>& fmPFPT0s,
+    const std::vector<art::FindManyP<anab::T0>>& fmTrackT0s,
     const art::FindManyP<recob::Track>& fmPFPTrack) const;
 
   std::pair<art::Ptr<anab::T0>, bool> getSliceBestT0(
@@ -86,6 +154,7 @@ sce::SCECorrection::SCECorrection(fhicl::ParameterSet const& p)
   , fCorrectNoT0Tag(p.get<bool>("CorrectNoT0Tag"))
   , fCorrectSCE(p.get<bool>("CorrectSCE"))
   , fSCEXCorrFlip(p.get<bool>("SCEXCorrFlip"))
+  , fParallel(p.get<bool>("Parallel", false))
   , fPFPLabel(p.get<std::string>("PFPLabel"))
   , fTrackLabel(p.get<std::string>("TrackLabel"))
   , fT0Labels(p.get<std::vector<std::string>>("T0Labels"))
@@ -176,6 +245,16 @@ void sce::SCECorrection::produce(art::Event& evt)
   art::FindManyP<recob::Hit> fmSliceHit(sliceHandle, evt, fPFPLabel);
   art::FindManyP<larpandoraobj::PFParticleMetadata> fmPFPMeta(pfpHandle, evt, fPFPLabel);
 
+  // The T0 associations of each label, left empty if there is nothing to associate
+  std::vector<art::FindManyP<anab::T0>> fmPFPT0s, fmTrackT0s;
+  for (const std::string& t0Label : fT0Labels) {
+    if (pfpHandle.isValid()) fmPFPT0s.emplace_back(pfpHandle, evt, t0Label);
+    if (trackHandle.isValid()) fmTrackT0s.emplace_back(trackHandle, evt, t0Label);
+  }
+
+  // Only needed for vertices of PFPs without space points
+  std::optional<SpacePointXIndex> allSpacePointIndex;
+
   // Check the assns that are necessary, others are optional and will be checked
   // when they are used to create the new assns
   if (!fmSlicePFP.isValid()) {
@@ -204,7 +283,7 @@ void sce::SCECorrection::produce(art::Event& evt)
     const std::vector<art::Ptr<recob::PFParticle>> slicePFPs = fmSlicePFP.at(slice.key());
 
     const std::map<art::Ptr<anab::T0>, bool> sliceT0CorrectMap =
-      getSliceT0s(evt, slicePFPs, pfpHandle, trackHandle, fmPFPTrack);
+      getSliceT0s(slicePFPs, fmPFPT0s, fmTrackT0s, fmPFPTrack);
 
     const std::pair<art::Ptr<anab::T0>, bool> sliceT0CorrectPair =
       getSliceBestT0(sliceT0CorrectMap);
@@ -229,8 +308,30 @@ void sce::SCECorrection::produce(art::Event& evt)
       }
     }
 
-    // Correct all PFPs in the slice
+    const bool correctT0 = !sliceT0CorrectPair.first.isNull() && sliceT0CorrectPair.second;
+
+    // Correct the space points of all the PFPs in the slice at once
+    std::vector<std::vector<art::Ptr<recob::SpacePoint>>> slicePFPSPs;
+    std::vector<art::Ptr<recob::Hit>> sliceSPHits;
+    std::vector<geo::TPCID> sliceSPTPCs;
+    std::vector<geo::Point_t> sliceSPPositions;
     for (auto const& pfp : slicePFPs) {
+      slicePFPSPs.push_back(fmPFPSP.at(pfp.key()));
+      for (auto const& sp : slicePFPSPs.back()) {
+        // Get the hit so we know what TPC the sp was in
+        // N.B. We can't use SP position to infer the TPC as it could be
+        // shifted into another TPC
+        sliceSPHits.push_back(fmSPHit.at(sp.key()).front());
+        sliceSPTPCs.push_back(sliceSPHits.back()->WireID().asTPCID());
+        sliceSPPositions.emplace_back(sp->XYZ()[0], sp->XYZ()[1], sp->XYZ()[2]);
+      }
+    }
+    correctPositions(sliceSPPositions, sliceSPTPCs, t0Offset, correctT0);
+    std::size_t iSliceSP = 0;
+
+    // Correct all PFPs in the slice
+    for (std::size_t iPFP = 0; iPFP < slicePFPs.size(); ++iPFP) {
+      auto const& pfp = slicePFPs[iPFP];
 
       // Create new PFPs and associate them to the slice
       recob::PFParticle newPFP(*pfp);
@@ -240,7 +341,7 @@ void sce::SCECorrection::produce(art::Event& evt)
 
       if (!newT0Ptr.isNull()) { t0PFPAssn->addSingle(newT0Ptr, newPFPPtr); }
 
-      std::vector<art::Ptr<recob::SpacePoint>> pfpSPs = fmPFPSP.at(pfp.key());
+      const std::vector<art::Ptr<recob::SpacePoint>>& pfpSPs = slicePFPSPs[iPFP];
       // Get the vertex associated to the PFP
       if (fmPFPVertex.isValid()) {
         std::vector<art::Ptr<recob::Vertex>> pfpVertices = fmPFPVertex.at(pfp.key());
@@ -249,18 +350,22 @@ void sce::SCECorrection::produce(art::Event& evt)
           geo::Point_t vtxPos(pfpVertex->position());
           //Find the closest SP to the vertex
           // If the PFP has no space points, look in the whole event
-          std::vector<art::Ptr<recob::SpacePoint>> vtxSPs = pfpSPs.size() ? pfpSPs : allSpacePoints;
-
-          double minVtxSPDist = std::numeric_limits<double>::max();
           art::Ptr<recob::SpacePoint> spPtr;
-          for (auto const& sp : vtxSPs) {
-            geo::Point_t spPos(sp->XYZ()[0], sp->XYZ()[1], sp->XYZ()[2]);
-            geo::Vector_t vtxSPDiff = vtxPos - spPos;
-            if (vtxSPDiff.Mag2() < minVtxSPDist) {
-              spPtr = sp;
-              minVtxSPDist = vtxSPDiff.Mag2();
+          if (pfpSPs.size()) {
+            double minVtxSPDist = std::numeric_limits<double>::max();
+            for (auto const& sp : pfpSPs) {
+              geo::Point_t spPos(sp->XYZ()[0], sp->XYZ()[1], sp->XYZ()[2]);
+              geo::Vector_t vtxSPDiff = vtxPos - spPos;
+              if (vtxSPDiff.Mag2() < minVtxSPDist) {
+                spPtr = sp;
+                minVtxSPDist = vtxSPDiff.Mag2();
+              }
             }
           }
+          else {
+            if (!allSpacePointIndex) allSpacePointIndex.emplace(allSpacePoints);
+            spPtr = allSpacePointIndex->closest(vtxPos);
+          }
 
           if (spPtr.isNull()) continue;
 
@@ -268,16 +373,7 @@ void sce::SCECorrection::produce(art::Event& evt)
           art::Ptr<recob::Hit> spHitPtr = fmSPHit.at(spPtr.key()).front();
           geo::TPCID tpcId = spHitPtr->WireID().asTPCID();
 
-          if (!sliceT0CorrectPair.first.isNull() && sliceT0CorrectPair.second) {
-            geo::Vector_t posOffset = applyT0Shift(t0Offset, tpcId);
-            vtxPos += posOffset;
-          }
-
-          if (fCorrectSCE && fSCE->EnableCalSpatialSCE()) {
-            geo::Vector_t posOffset = fSCE->GetCalPosOffsets(vtxPos, tpcId.TPC);
-            if (fSCEXCorrFlip) { posOffset.SetX(-posOffset.X()); }
-            vtxPos += posOffset;
-          }
+          correctPositions({&vtxPos, 1}, {&tpcId, 1}, t0Offset, correctT0);
 
           // Create a new vertex and associate it to the PFP
           recob::Vertex newVtx(
@@ -290,25 +386,9 @@ void sce::SCECorrection::produce(art::Event& evt)
 
       for (auto const& sp : pfpSPs) {
 
-        //Get the spacepoint position in a nicer form
-        geo::Point_t spPos(sp->XYZ()[0], sp->XYZ()[1], sp->XYZ()[2]);
-
-        // Get the hit so we know what TPC the sp was in
-        // N.B. We can't use SP position to infer the TPC as it could be
-        // shifted into another TPC
-        art::Ptr<recob::Hit> spHitPtr = fmSPHit.at(sp.key()).front();
-        geo::TPCID tpcId = spHitPtr->WireID().asTPCID();
-
-        if (!sliceT0CorrectPair.first.isNull() && sliceT0CorrectPair.second) {
-          geo::Vector_t posOffset = applyT0Shift(t0Offset, tpcId);
-          spPos += posOffset;
-        }
-
-        if (fCorrectSCE && fSCE->EnableCalSpatialSCE()) {
-          geo::Vector_t posOffset = fSCE->GetCalPosOffsets(spPos, tpcId.TPC);
-          if (fSCEXCorrFlip) { posOffset.SetX(-posOffset.X()); }
-          spPos += posOffset;
-        }
+        const geo::Point_t& spPos = sliceSPPositions[iSliceSP];
+        const art::Ptr<recob::Hit>& spHitPtr = sliceSPHits[iSliceSP];
+        ++iSliceSP;
 
         // Create new spacepoint and associate it to the pfp and hit
         Double32_t spXYZ[3] = {spPos.X(), spPos.Y(), spPos.Z()};
@@ -383,11 +463,46 @@ geo::Vector_t sce::SCECorrection::applyT0Shift(const double& t0Offset,
   return {}; // unreachable
 }
 
+void sce::SCECorrection::correctPositions(std::span<geo::Point_t> positions,
+                                          std::span<const geo::TPCID> tpcIds,
+                                          double t0Offset,
+                                          bool correctT0) const
+{
+  if (correctT0) {
+    // The shift only depends on the drift direction of the TPC
+    std::map<geo::TPCID, geo::Vector_t> tpcShifts;
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      auto it = tpcShifts.find(tpcIds[i]);
+      if (it == tpcShifts.end())
+        it = tpcShifts.emplace(tpcIds[i], applyT0Shift(t0Offset, tpcIds[i])).first;
+      positions[i] += it->second;
+    }
+  }
+
+  if (!fCorrectSCE || !fSCE->EnableCalSpatialSCE()) return;
+
+  auto correctSCE = [&](std::size_t i) {
+    geo::Vector_t posOffset = fSCE->GetCalPosOffsets(positions[i], tpcIds[i].TPC);
+    if (fSCEXCorrFlip) { posOffset.SetX(-posOffset.X()); }
+    positions[i] += posOffset;
+  };
+  if (fParallel) {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, positions.size()),
+                      [&](const tbb::blocked_range<std::size_t>& r) {
+                        for (std::size_t i = r.begin(); i != r.end(); ++i)
+                          correctSCE(i);
+                      });
+  }
+  else {
+    for (std::size_t i = 0; i < positions.size(); ++i)
+      correctSCE(i);
+  }
+}
+
 std::map<art::Ptr<anab::T0>, bool> sce::SCECorrection::getSliceT0s(
-  const art::Event& evt,
   const std::vector<art::Ptr<recob::PFParticle>>& slicePFPs,
-  const art::Handle<std::vector<recob::PFParticle>>& pfpHandle,
-  const art::Handle<std::vector<recob::Track>>& trackHandle,
+  const std::vector<art::FindManyP<anab::T0>>& fmPFPT0s,
+  const std::vector<art::FindManyP<anab::T0>>& fmTrackT0s,
   const art::FindManyP<recob::Track>& fmPFPTrack) const
 {
 
@@ -398,12 +513,10 @@ std::map<art::Ptr<anab::T0>, bool> sce::SCECorrection::getSliceT0s(
     // Loop over all of the T0 labels
     // We will take the first label to have a T0, so the order matters
     for (unsigned int i = 0; i < fT0Labels.size(); i++) {
-      std::string t0Label = fT0Labels.at(i);
 
       // Get the T0
-      art::FindManyP<anab::T0> fmPFPT0(pfpHandle, evt, t0Label);
-      if (fmPFPT0.isValid()) {
-        std::vector<art::Ptr<anab::T0>> pfpT0s = fmPFPT0.at(pfp.key());
+      if (i < fmPFPT0s.size() && fmPFPT0s[i].isValid()) {
+        std::vector<art::Ptr<anab::T0>> pfpT0s = fmPFPT0s[i].at(pfp.key());
         if (pfpT0s.size() == 1) {
           pfpT0CorrectMap[pfpT0s.front()] = fT0LabelsCorrectT0.at(i);
           break;
@@ -416,9 +529,8 @@ std::map<art::Ptr<anab::T0>, bool> sce::SCECorrection::getSliceT0s(
       art::Ptr<recob::Track> pfpTrack = pfpTracks.front();
 
       // Check if the track has a T0
-      art::FindManyP<anab::T0> fmTrackT0(trackHandle, evt, t0Label);
-      if (fmTrackT0.isValid()) {
-        std::vector<art::Ptr<anab::T0>> trackT0s = fmTrackT0.at(pfpTrack.key());
+      if (i < fmTrackT0s.size() && fmTrackT0s[i].isValid()) {
+        std::vector<art::Ptr<anab::T0>> trackT0s = fmTrackT0s[i].at(pfpTrack.key());
         if (trackT0s.size() == 1) {
           pfpT0CorrectMap[trackT0s.front()] = fT0LabelsCorrectT0.at(i);
           break;
@@ -58,6 +58,9 @@
 
 #include "range/v3/view.hpp"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 namespace {
   template <typename T, typename U>
   struct AddMany {
@@ -68,6 +71,23 @@ namespace {
     art::Ptr<T> const ptr_;
     art::Assns<T, U>& assns_;
   };
+
+  // What a shower is made of, collected from the event
+  struct ShowerInput {
+    art::PtrVector<recob::Hit> hits;
+    art::PtrVector<recob::Cluster> clusters;
+    art::PtrVector<recob::Track> tracks;
+    art::PtrVector<recob::SpacePoint> spacePoints; // PFParticle mode only
+  };
+
+  // What EMShowerAlg makes of it, before it is put in the event
+  struct ShowerOutput {
+    recob::Shower shower;
+    bool made = false;
+    int iok = 0;                                             // PFParticle mode only
+    std::vector<recob::SpacePoint> spacePoints;              // track mode only
+    std::vector<std::vector<art::Ptr<recob::Hit>>> hitAssns; // track mode only
+  };
 }
 
 using lar::to_element;
@@ -99,6 +119,8 @@ private:
   bool const fUseCNNtoIDEMPFP;
   bool const fUseCNNtoIDEMHit;
   double const fMinTrackLikeScore;
+  bool const fParallel;
+  bool const fAlgMakesPlots; ///< EMShowerAlg draws and saves canvases
 
   art::ServiceHandle<geo::Geometry const> fGeom;
 };
@@ -121,6 +143,9 @@ shower::EMShower::EMShower(fhicl::ParameterSet const& pset)
   , fUseCNNtoIDEMPFP{pset.get<bool>("UseCNNtoIDEMPFP")}
   , fUseCNNtoIDEMHit{pset.get<bool>("UseCNNtoIDEMHit")}
   , fMinTrackLikeScore{pset.get<double>("MinTrackLikeScore")}
+  , fParallel{pset.get<bool>("Parallel", false)}
+  , fAlgMakesPlots{pset.get<bool>("EMShowerAlg.MakeGradientPlot", false) ||
+                   pset.get<bool>("EMShowerAlg.MakeRMSGradientPlot", false)}
 {
   produces<std::vector<recob::Shower>>();
   produces<std::vector<recob::SpacePoint>>();
@@ -176,6 +201,17 @@ void shower::EMShower::produce(art::Event& evt)
   art::FindManyP<recob::SpacePoint> fmsp(trackHandle, evt, fTrackModuleLabel);
   art::FindManyP<recob::Cluster> fmc(hitHandle, evt, fHitsModuleLabel);
 
+  // CNN output, read at the first use
+  std::unique_ptr<anab::MVAReader<recob::Hit, 4>> hitResults;
+  auto const hitMVA = [&]() -> anab::MVAReader<recob::Hit, 4> const& {
+    if (!hitResults) hitResults = anab::MVAReader<recob::Hit, 4>::create(evt, fCNNEMModuleLabel);
+    if (!hitResults) {
+      throw cet::exception("EMShower")
+        << "Cannot get MVA results from " << fCNNEMModuleLabel.encode();
+    }
+    return *hitResults;
+  };
+
   // Make showers
   auto const clockData = art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(evt);
   auto const detProp =
@@ -217,12 +253,9 @@ void shower::EMShower::produce(art::Event& evt)
     for (size_t ipfp = 0; ipfp < pfps.size(); ++ipfp) {
       art::Ptr<recob::PFParticle> pfp = pfps[ipfp];
       if (fCNNEMModuleLabel != "" && fUseCNNtoIDEMPFP) { //use CNN to identify EM pfparticle
-        auto hitResults = anab::MVAReader<recob::Hit, 4>::create(evt, fCNNEMModuleLabel);
-        if (!hitResults) {
-          throw cet::exception("EMShower") << "Cannot get MVA results from " << fCNNEMModuleLabel;
-        }
-        int trkLikeIdx = hitResults->getIndex("track");
-        int emLikeIdx = hitResults->getIndex("em");
+        auto const& hitResults = hitMVA();
+        int trkLikeIdx = hitResults.getIndex("track");
+        int emLikeIdx = hitResults.getIndex("em");
         if ((trkLikeIdx < 0) || (emLikeIdx < 0)) {
           throw cet::exception("EMShower") << "No em/track labeled columns in MVA data products.";
         }
@@ -234,7 +267,7 @@ void shower::EMShower::produce(art::Event& evt)
             pfphits.insert(pfphits.end(), ClusterHits.begin(), ClusterHits.end());
           }
           if (pfphits.size()) { //find hits
-            auto vout = hitResults->getOutput(pfphits);
+            auto vout = hitResults.getOutput(pfphits);
             double trk_like = -1, trk_or_em = vout[trkLikeIdx] + vout[emLikeIdx];
             if (trk_or_em > 0) {
               trk_like = vout[trkLikeIdx] / trk_or_em;
@@ -272,57 +305,46 @@ void shower::EMShower::produce(art::Event& evt)
     }
   }
 
-  // Make output larsoft products
+  // Collect the hits, clusters and tracks of the showers
   int showerNum = 0;
+  std::vector<ShowerInput> showerInputs;
   for (auto const& newShower : newShowers) {
 
     if (showerNum != fShower and fShower != -1) continue;
 
-    // New shower
-    if (fDebug > 0) std::cout << "\n\nStart shower " << showerNum << '\n';
-
-    // New associations
-    art::PtrVector<recob::Hit> showerHits;
-    art::PtrVector<recob::Cluster> showerClusters;
-    art::PtrVector<recob::Track> showerTracks;
-    art::PtrVector<recob::SpacePoint> showerSpacePoints_p;
+    ShowerInput& in = showerInputs.emplace_back();
 
     std::vector<int> associatedTracks;
 
-    // Make showers and associations
     for (int const showerCluster : newShower) {
 
       // Clusters
       art::Ptr<recob::Cluster> const cluster = clusters.at(showerCluster);
-      showerClusters.push_back(cluster);
+      in.clusters.push_back(cluster);
 
       // Hits
       std::vector<art::Ptr<recob::Hit>> const& showerClusterHits = fmh.at(cluster.key());
       if (fCNNEMModuleLabel != "" && fUseCNNtoIDEMHit) { // use CNN to identify EM hits
-        auto hitResults = anab::MVAReader<recob::Hit, 4>::create(evt, fCNNEMModuleLabel);
-        if (!hitResults) {
-          throw cet::exception("EMShower")
-            << "Cannot get MVA results from " << fCNNEMModuleLabel.encode();
-        }
-        int trkLikeIdx = hitResults->getIndex("track");
-        int emLikeIdx = hitResults->getIndex("em");
+        auto const& hitResults = hitMVA();
+        int trkLikeIdx = hitResults.getIndex("track");
+        int emLikeIdx = hitResults.getIndex("em");
         if (trkLikeIdx < 0 || emLikeIdx < 0) {
           throw cet::exception("EMShower") << "No em/track labeled columns in MVA data products.";
         }
         for (auto const& showerHit : showerClusterHits) {
-          auto vout = hitResults->getOutput(showerHit);
+          auto vout = hitResults.getOutput(showerHit);
           double trk_like = -1, trk_or_em = vout[trkLikeIdx] + vout[emLikeIdx];
           if (trk_or_em > 0) {
             trk_like = vout[trkLikeIdx] / trk_or_em;
             if (trk_like < fMinTrackLikeScore) { // EM like
-              showerHits.push_back(showerHit);
+              in.hits.push_back(showerHit);
             }
           }
         }
       }
       else {
         for (auto const& showerClusterHit : showerClusterHits)
-          showerHits.push_back(showerClusterHit);
+          in.hits.push_back(showerClusterHit);
       }
       // Tracks
       if (!pfpHandle.isValid()) { // Only do this for non-pfparticle mode
@@ -335,18 +357,46 @@ void shower::EMShower::produce(art::Event& evt)
     if (!pfpHandle.isValid()) { // For non-pfparticles, get space points from tracks
       // Tracks and space points
       for (int const trackIndex : associatedTracks) {
-        showerTracks.push_back(tracks.at(trackIndex));
+        in.tracks.push_back(tracks.at(trackIndex));
       }
     }
-    else { // For pfparticles, get space points from hits
-      art::FindManyP<recob::SpacePoint> fmspp(showerHits, evt, fPFParticleModuleLabel);
+  }
+
+  // For pfparticles, get space points from hits, with one query for the hits of all the showers
+  if (pfpHandle.isValid()) {
+    std::vector<art::Ptr<recob::Hit>> allShowerHits;
+    for (auto const& in : showerInputs)
+      allShowerHits.insert(allShowerHits.end(), in.hits.begin(), in.hits.end());
+    if (!allShowerHits.empty()) {
+      art::FindManyP<recob::SpacePoint> fmspp(allShowerHits, evt, fPFParticleModuleLabel);
       if (fmspp.isValid()) {
-        for (size_t ihit = 0; ihit < showerHits.size(); ++ihit) {
-          for (auto const& spPtr : fmspp.at(ihit))
-            showerSpacePoints_p.push_back(spPtr);
+        size_t ihit = 0;
+        for (auto& in : showerInputs) {
+          for (size_t i = 0; i < in.hits.size(); ++i, ++ihit) {
+            for (auto const& spPtr : fmspp.at(ihit))
+              in.spacePoints.push_back(spPtr);
+          }
         }
       }
     }
+  }
+
+  // The most upstream vertex, to find the start of the pfparticle showers
+  using recob::tracking::Point_t;
+  Point_t nuvtx{0, 0, DBL_MAX};
+  for (auto const& vtx : vertices) {
+    auto const pos = vtx->position();
+    if (pos.Z() < nuvtx.Z()) { nuvtx = pos; }
+  }
+
+  // Make the showers; they are independent of each other
+  std::vector<ShowerOutput> showerOutputs(showerInputs.size());
+  auto makeShower = [&](size_t ishower) {
+    ShowerInput const& in = showerInputs[ishower];
+    ShowerOutput& out = showerOutputs[ishower];
+
+    // New shower
+    if (fDebug > 0) std::cout << "\n\nStart shower " << showerNum << '\n';
 
     if (!pfpHandle.isValid()) {
 
@@ -354,7 +404,7 @@ void shower::EMShower::produce(art::Event& evt)
       if (fDebug > 1)
         std::cout << " ------------------ Ordering shower hits --------------------\n";
       std::map<int, std::vector<art::Ptr<recob::Hit>>> showerHitsMap =
-        fEMShowerAlg.OrderShowerHits(detProp, showerHits, fPlane);
+        fEMShowerAlg.OrderShowerHits(detProp, in.hits, fPlane);
       if (fDebug > 1)
         std::cout << " ------------------ End ordering shower hits "
                      "--------------------\n";
@@ -365,66 +415,31 @@ void shower::EMShower::produce(art::Event& evt)
       fEMShowerAlg.FindInitialTrack(detProp, showerHitsMap, initialTrack, initialTrackHits);
 
       // Make space points
-      std::vector<std::vector<art::Ptr<recob::Hit>>> hitAssns;
-      std::vector<recob::SpacePoint> showerSpacePoints;
       if (fMakeSpacePoints)
-        showerSpacePoints = fEMShowerAlg.MakeSpacePoints(detProp, showerHitsMap, hitAssns);
+        out.spacePoints = fEMShowerAlg.MakeSpacePoints(detProp, showerHitsMap, out.hitAssns);
       else {
-        for (auto const& trkPtr : showerTracks) {
+        for (auto const& trkPtr : in.tracks) {
           for (auto const& trackSpacePoint :
                fmsp.at(trkPtr.key()) | ranges::views::transform(to_element)) {
-            showerSpacePoints.push_back(trackSpacePoint);
-            hitAssns.push_back(std::vector<art::Ptr<recob::Hit>>());
+            out.spacePoints.push_back(trackSpacePoint);
+            out.hitAssns.push_back(std::vector<art::Ptr<recob::Hit>>());
           }
         }
       }
 
-      // Save space points
-      art::PtrMaker<recob::SpacePoint> const make_space_point_ptr{evt};
-      size_t firstSpacePoint = spacePoints->size(), nSpacePoint = 0;
-      for (auto const& ssp : showerSpacePoints) {
-        spacePoints->emplace_back(ssp.XYZ(), ssp.ErrXYZ(), ssp.Chisq(), spacePoints->size());
-        auto const index = spacePoints->size() - 1;
-        auto const space_point_ptr = make_space_point_ptr(index);
-        cet::for_all(hitAssns.at(nSpacePoint), AddMany{space_point_ptr, *hitSpAssociations});
-      }
-      auto const lastSpacePoint = spacePoints->size();
-
-      // Make shower object and associations
-      recob::Shower shower =
-        fEMShowerAlg.MakeShower(clockData, detProp, showerHits, initialTrack, initialTrackHits);
-      shower.set_id(showerNum);
-      if (fSaveNonCompleteShowers or
-          (!fSaveNonCompleteShowers and shower.ShowerStart() != TVector3{})) {
-        showers->push_back(shower);
-
-        auto const shower_ptr = art::PtrMaker<recob::Shower>{evt}(showers->size() - 1);
-        cet::for_all(showerHits, AddMany{shower_ptr, *hitShowerAssociations});
-        cet::for_all(showerClusters, AddMany{shower_ptr, *clusterAssociations});
-        cet::for_all(showerTracks, AddMany{shower_ptr, *trackAssociations});
-        for (size_t i = firstSpacePoint; i < lastSpacePoint; ++i) {
-          spShowerAssociations->addSingle(shower_ptr, make_space_point_ptr(i));
-        }
-      }
-      else
-        mf::LogInfo("EMShower") << "Discarding shower " << showerNum
-                                << " due to incompleteness (SaveNonCompleteShowers == false)";
+      // Make shower object
+      out.shower =
+        fEMShowerAlg.MakeShower(clockData, detProp, in.hits, initialTrack, initialTrackHits);
+      out.shower.set_id(showerNum);
+      out.made = true;
     }
 
     else { // pfParticle
 
       if (vertices.size()) {
-        // found the most upstream vertex
-        using recob::tracking::Point_t;
-        Point_t nuvtx{0, 0, DBL_MAX};
-        for (auto const& vtx : vertices) {
-          auto const pos = vtx->position();
-          if (pos.Z() < nuvtx.Z()) { nuvtx = pos; }
-        }
-
         Point_t shwvtx{0, 0, 0};
         double mindist2 = DBL_MAX;
-        for (auto const& sp : showerSpacePoints_p | ranges::views::transform(to_element)) {
+        for (auto const& sp : in.spacePoints | ranges::views::transform(to_element)) {
           double const dist2 = cet::sum_of_squares(
             nuvtx.X() - sp.XYZ()[0], nuvtx.Y() - sp.XYZ()[1], nuvtx.Z() - sp.XYZ()[2]);
           if (dist2 < mindist2) {
@@ -445,21 +460,76 @@ void shower::EMShower::produce(art::Event& evt)
           }
         }
 
-        int iok = 0;
-        recob::Shower shower =
-          fEMShowerAlg.MakeShower(clockData, detProp, showerHits, bestvtx, iok);
-        if (iok == 0) {
-          showers->push_back(shower);
-          auto const index = showers->size() - 1;
-          showers->back().set_id(index);
-
-          auto const shower_ptr = art::PtrMaker<recob::Shower>{evt}(index);
-          cet::for_all(showerHits, AddMany{shower_ptr, *hitShowerAssociations});
-          cet::for_all(showerClusters, AddMany{shower_ptr, *clusterAssociations});
-          cet::for_all(showerTracks, AddMany{shower_ptr, *trackAssociations});
-          cet::for_all(showerSpacePoints_p, AddMany{shower_ptr, *spShowerAssociations});
+        out.shower = fEMShowerAlg.MakeShower(clockData, detProp, in.hits, bestvtx, out.iok);
+        out.made = true;
+      }
+    }
+  };
+
+  // Debugging output and the ROOT plots of the algorithm are only sensible serially
+  if (fParallel && fDebug == 0 && !fAlgMakesPlots) {
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, showerInputs.size()),
+                      [&](const tbb::blocked_range<size_t>& r) {
+                        for (size_t ishower = r.begin(); ishower != r.end(); ++ishower)
+                          makeShower(ishower);
+                      });
+  }
+  else {
+    for (size_t ishower = 0; ishower < showerInputs.size(); ++ishower)
+      makeShower(ishower);
+  }
+
+  // Make output larsoft products, in the order of the showers
+  art::PtrMaker<recob::SpacePoint> const make_space_point_ptr{evt};
+  for (size_t ishower = 0; ishower < showerInputs.size(); ++ishower) {
+    ShowerInput const& in = showerInputs[ishower];
+    ShowerOutput const& out = showerOutputs[ishower];
+    if (!out.made) continue;
+
+    if (!pfpHandle.isValid()) {
+
+      // Save space points
+      size_t firstSpacePoint = spacePoints->size(), nSpacePoint = 0;
+      for (auto const& ssp : out.spacePoints) {
+        spacePoints->emplace_back(ssp.XYZ(), ssp.ErrXYZ(), ssp.Chisq(), spacePoints->size());
+        auto const index = spacePoints->size() - 1;
+        auto const space_point_ptr = make_space_point_ptr(index);
+        cet::for_all(out.hitAssns.at(nSpacePoint), AddMany{space_point_ptr, *hitSpAssociations});
+      }
+      auto const lastSpacePoint = spacePoints->size();
+
+      // Shower object and associations
+      recob::Shower const& shower = out.shower;
+      if (fSaveNonCompleteShowers or
+          (!fSaveNonCompleteShowers and shower.ShowerStart() != TVector3{})) {
+        showers->push_back(shower);
+
+        auto const shower_ptr = art::PtrMaker<recob::Shower>{evt}(showers->size() - 1);
+        cet::for_all(in.hits, AddMany{shower_ptr, *hitShowerAssociations});
+        cet::for_all(in.clusters, AddMany{shower_ptr, *clusterAssociations});
+        cet::for_all(in.tracks, AddMany{shower_ptr, *trackAssociations});
+        for (size_t i = firstSpacePoint; i < lastSpacePoint; ++i) {
+          spShowerAssociations->addSingle(shower_ptr, make_space_point_ptr(i));
         }
       }
+      else
+        mf::LogInfo("EMShower") << "Discarding shower " << showerNum
+                                << " due to incompleteness (SaveNonCompleteShowers == false)";
+    }
+
+    else { // pfParticle
+
+      if (out.iok == 0) {
+        showers->push_back(out.shower);
+        auto const index = showers->size() - 1;
+        showers->back().set_id(index);
+
+        auto const shower_ptr = art::PtrMaker<recob::Shower>{evt}(index);
+        cet::for_all(in.hits, AddMany{shower_ptr, *hitShowerAssociations});
+        cet::for_all(in.clusters, AddMany{shower_ptr, *clusterAssociations});
+        cet::for_all(in.tracks, AddMany{shower_ptr, *trackAssociations});
+        cet::for_all(in.spacePoints, AddMany{shower_ptr, *spShowerAssociations});
+      }
     }
   }
 
@@ -6,6 +6,7 @@
 #include "lardataobj/RecoBase/Cluster.h"
 #include "lardataobj/RecoBase/PFParticle.h"
 #include "lardataobj/RecoBase/Shower.h"
+#include "larreco/MCComp/HitTruthIndex.h"
 #include "larsim/MCCheater/BackTrackerService.h"
 #include "larsim/MCCheater/ParticleInventoryService.h"
 #include "nusimdata/SimulationBase/MCParticle.h"
@@ -49,15 +50,12 @@ namespace DUNE {
                     const art::Event& evt,
                     bool& isFiducial);
     void truthMatcher(detinfo::DetectorClocksData const& clockData,
-                      std::vector<art::Ptr<recob::Hit>> all_hits,
-                      std::vector<art::Ptr<recob::Hit>> shower_hits,
+                      std::vector<art::Ptr<recob::Hit>> const& shower_hits,
                       const simb::MCParticle*& MCparticle,
                       double& Efrac,
                       double& Ecomplet);
     template <size_t N>
-    void checkCNNtrkshw(detinfo::DetectorClocksData const& clockData,
-                        const art::Event& evt,
-                        std::vector<art::Ptr<recob::Hit>> all_hits);
+    void checkCNNtrkshw(const art::Event& evt, std::vector<art::Ptr<recob::Hit>> const& all_hits);
     bool insideFV(double vertex[4]);
     void doEfficiencies();
     void reset();
@@ -249,6 +247,8 @@ namespace DUNE {
     float fFidVolZmin;
     float fFidVolZmax;
 
+    btutil::HitTruthIndex fHitTruth; ///< eve back-tracking of all the hits of the event
+
     art::ServiceHandle<geo::Geometry const> geom;
 
   }; // class NeutrinoShowerEff
@@ -952,6 +952,12 @@ namespace DUNE {
     std::vector<art::Ptr<recob::Hit>> all_hits;
     if (event.getByLabel(fHitModuleLabel, hitHandle)) { art::fill_ptr_vector(all_hits, hitHandle); }
 
+    // back-track all the hits once for all the showers
+    art::ServiceHandle<cheat::BackTrackerService const> bt_serv;
+    fHitTruth.Fill(all_hits, [&](art::Ptr<recob::Hit> const& hit) {
+      return bt_serv->HitToEveTrackIDEs(clockData, hit);
+    });
+
     n_recoShowers = showerlist.size();
     //if ( n_recoShowers == 0 || n_recoShowers> MAX_SHOWERS ) return;
     art::FindManyP<recob::Hit> sh_hitsAll(showerHandle, event, fShowerModuleLabel);
@@ -1079,7 +1085,7 @@ namespace DUNE {
 
       int tmp_nHits = sh_hits.size();
 
-      truthMatcher(clockData, all_hits, sh_hits, particle, tmpEfrac_contamination, tmpEcomplet);
+      truthMatcher(clockData, sh_hits, particle, tmpEfrac_contamination, tmpEcomplet);
       if (!particle) continue;
 
       sh_Efrac_contamination[i] = tmpEfrac_contamination;
@@ -1355,13 +1361,12 @@ namespace DUNE {
       } //if(ParticlePDG_HighestShHits>0)
     }   //else if(!MC_isCC&&isFiducial)
 
-    checkCNNtrkshw<4>(clockData, event, all_hits);
+    checkCNNtrkshw<4>(event, all_hits);
   }
 
   //========================================================================
   void NeutrinoShowerEff::truthMatcher(detinfo::DetectorClocksData const& clockData,
-                                       std::vector<art::Ptr<recob::Hit>> all_hits,
-                                       std::vector<art::Ptr<recob::Hit>> shower_hits,
+                                       std::vector<art::Ptr<recob::Hit>> const& shower_hits,
                                        const simb::MCParticle*& MCparticle,
                                        double& Efrac,
                                        double& Ecomplet)
@@ -1402,15 +1407,10 @@ namespace DUNE {
 
     Efrac = 1 - (partial_E / total_E);
 
-    //completeness
-    double totenergy = 0;
-    for (size_t k = 0; k < all_hits.size(); ++k) {
-      art::Ptr<recob::Hit> hit = all_hits[k];
-      std::vector<sim::TrackIDE> TrackIDs = bt_serv->HitToEveTrackIDEs(clockData, hit);
-      for (size_t l = 0; l < TrackIDs.size(); ++l) {
-        if (std::abs(TrackIDs[l].trackID) == TrackID) { totenergy += TrackIDs[l].energy; }
-      }
-    }
+    //completeness; the shower hits may come from another collection than
+    //all the hits, so only the latter are taken from the index
+    double totenergy = fHitTruth.TrackEnergy(TrackID);
+    if (TrackID != 0) totenergy += fHitTruth.TrackEnergy(-TrackID);
     Ecomplet = partial_E / totenergy;
   }
 
@@ -1482,13 +1482,11 @@ namespace DUNE {
   // Check CNN track/shower ID
   //============================================
   template <size_t N>
-  void NeutrinoShowerEff::checkCNNtrkshw(detinfo::DetectorClocksData const& clockData,
-                                         const art::Event& evt,
-                                         std::vector<art::Ptr<recob::Hit>> all_hits)
+  void NeutrinoShowerEff::checkCNNtrkshw(const art::Event& evt,
+                                         std::vector<art::Ptr<recob::Hit>> const& all_hits)
   {
     if (fCNNEMModuleLabel.empty()) return;
 
-    art::ServiceHandle<cheat::BackTrackerService const> bt_serv;
     art::ServiceHandle<cheat::ParticleInventoryService const> pi_serv;
 
     auto hitResults = anab::MVAReader<recob::Hit, N>::create(evt, fCNNEMModuleLabel);
@@ -1504,26 +1502,15 @@ namespace DUNE {
         //find out if the hit was generated by an EM particle
         bool isEMparticle = false;
         int pdg = INT_MAX;
-        std::vector<sim::TrackIDE> TrackIDs = bt_serv->HitToEveTrackIDEs(clockData, all_hits[i]);
-        if (!TrackIDs.size()) continue;
-
-        int trkid = INT_MAX;
-        double maxE = -1;
-        for (size_t k = 0; k < TrackIDs.size(); k++) {
-          if (TrackIDs[k].energy > maxE) {
-            maxE = TrackIDs[k].energy;
-            trkid = TrackIDs[k].trackID;
-          }
-        }
-        if (trkid != INT_MAX) {
-          auto* particle = pi_serv->TrackIdToParticle_P(trkid);
-          if (particle) {
-            pdg = particle->PdgCode();
-            if (std::abs(pdg) == 11 || //electron/positron
-                pdg == 22 ||           //photon
-                pdg == 111) {          //pi0
-              isEMparticle = true;
-            }
+        if (fHitTruth.HitTrackIDEs(i).empty()) continue;
+
+        auto* particle = pi_serv->TrackIdToParticle_P(fHitTruth.DominantTrackID(i));
+        if (particle) {
+          pdg = particle->PdgCode();
+          if (std::abs(pdg) == 11 || //electron/positron
+              pdg == 22 ||           //photon
+              pdg == 111) {          //pi0
+            isEMparticle = true;
           }
         }
         auto vout = hitResults->getOutput(all_hits[i]);
@@ -94,6 +94,8 @@ ShowerReco3D::ShowerReco3D(fhicl::ParameterSet const& p)
 
   fManager.MatchManager().AddPriorityAlgo(fCPAlgoArray);
   fManager.MatchManager().AddMatchAlgo(fCFAlgoTimeOverlap);
+  fManager.MatchManager().SetParallel(p.get<bool>("ParallelMatch", false));
+  fManager.MatchManager().SetBoxPrefilter(p.get<double>("MatchTimePrefilter", -1.));
 
   fShowerAlgo->Verbose(p.get<bool>("Verbosity"));
   fShowerAlgo->SetUseArea(p.get<bool>("UseArea"));
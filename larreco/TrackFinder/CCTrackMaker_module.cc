@@ -801,24 +801,20 @@ namespace trkf {
   void CCTrackMaker::FitVertices(detinfo::DetectorPropertiesData const& detProp,
                                  geo::TPCID const& tpcid)
   {
-    std::vector<std::vector<geo::WireID>> hitWID;
-    std::vector<std::vector<double>> hitX;
-    std::vector<std::vector<double>> hitXErr;
-    TVector3 pos, posErr;
-    std::vector<TVector3> trkDir;
-    std::vector<TVector3> trkDirErr;
-    float ChiDOF;
-
     if (fNVtxTrkHitsFit == 0) return;
 
     unsigned short indx, indx2, iht, nHitsFit;
 
+    // collect the input of all the vertex fits, which are then done together
+    std::vector<VertexFitAlg::VertexFitData> fits;
+    std::vector<unsigned short> fitVtx;
     for (unsigned short ivx = 0; ivx < vtx.size(); ++ivx) {
       if (!vtx[ivx].Neutrino) continue;
-      hitWID.clear();
-      hitX.clear();
-      hitXErr.clear();
-      trkDir.clear();
+      VertexFitAlg::VertexFitData fit;
+      auto& hitWID = fit.hitWID;
+      auto& hitX = fit.hitX;
+      auto& hitXErr = fit.hitXErr;
+      auto& trkDir = fit.TrkDir;
       // find the tracks associated with this vertex
       unsigned int thePln, theTPC, theCst;
       for (unsigned short itk = 0; itk < trk.size(); ++itk) {
@@ -863,15 +859,21 @@ namespace trkf {
         mf::LogVerbatim("CCTM") << "Not enough hits to fit vtx " << ivx;
         continue;
       } // hitX.size() < 2
-      pos(0) = vtx[ivx].X;
-      pos(1) = vtx[ivx].Y;
-      pos(2) = vtx[ivx].Z;
-      fVertexFitAlg.VertexFit(hitWID, hitX, hitXErr, pos, posErr, trkDir, trkDirErr, ChiDOF);
-      if (ChiDOF > 3000) continue;
+      fit.VtxPos = TVector3(vtx[ivx].X, vtx[ivx].Y, vtx[ivx].Z);
+      fits.push_back(std::move(fit));
+      fitVtx.push_back(ivx);
+    } // ivx
+
+    fVertexFitAlg.VertexFits(fits);
+
+    for (std::size_t ifit = 0; ifit < fits.size(); ++ifit) {
+      unsigned short const ivx = fitVtx[ifit];
+      auto const& fit = fits[ifit];
+      if (fit.ChiDOF > 3000) continue;
       // update the vertex position
-      vtx[ivx].X = pos(0);
-      vtx[ivx].Y = pos(1);
-      vtx[ivx].Z = pos(2);
+      vtx[ivx].X = fit.VtxPos(0);
+      vtx[ivx].Y = fit.VtxPos(1);
+      vtx[ivx].Z = fit.VtxPos(2);
       // and the track trajectory
       unsigned short fitTrk = 0;
       for (unsigned short itk = 0; itk < trk.size(); ++itk) {
@@ -879,11 +881,11 @@ namespace trkf {
           if (trk[itk].VtxIndex[end] != ivx) continue;
           unsigned short itj = 0;
           if (end == 1) itj = trk[itk].TrjPos.size() - 1;
-          trk[itk].TrjDir[itj] = trkDir[fitTrk];
+          trk[itk].TrjDir[itj] = fit.TrkDir[fitTrk];
           ++fitTrk;
         } // end
       }   // itk
-    }     // ivx
+    }     // ifit
   }       // FitVertices
 
   ///////////////////////////////////////////////////////////////////////
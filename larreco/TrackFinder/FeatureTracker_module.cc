@@ -171,7 +171,7 @@ namespace trkf {
         bool ThisLineGood = true;
 
         for (size_t p = 0; p != uvw_i.size(); ++p) {
-          TH2F const& RawHist = fCorner.GetWireDataHist(p);
+          corner::WireDataImage const& RawHist = fCorner.GetWireDataImage(p);
 
           double lineint = fCorner.line_integral(
             RawHist, uvw_i.at(p), t_i.at(p), uvw_j.at(p), t_j.at(p), fLineIntThreshold);
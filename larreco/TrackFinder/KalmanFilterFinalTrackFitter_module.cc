@@ -155,7 +155,7 @@ namespace trkf {
     Parameters p_;
     TrackStatePropagator prop;
     trkf::TrackKalmanFitter kalmanFitter;
-    mutable trkf::TrackMomentumCalculator tmc{};
+    trkf::TrackMomentumCalculator const tmc{};
     bool inputFromPF;
 
     art::InputTag pfParticleInputTag;
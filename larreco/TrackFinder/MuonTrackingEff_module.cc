@@ -20,6 +20,7 @@
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
 #include "lardataobj/RecoBase/Track.h"
+#include "larreco/MCComp/HitTruthIndex.h"
 #include "larsim/MCCheater/BackTrackerService.h"
 #include "larsim/MCCheater/ParticleInventoryService.h"
 #include "nusimdata/SimulationBase/MCParticle.h"
@@ -60,9 +61,7 @@ namespace DUNE {
 
     void processEff(const art::Event& evt, bool& isFiducial);
 
-    void truthMatcher(detinfo::DetectorClocksData const& clockData,
-                      std::vector<recob::Hit> const& AllHits,
-                      std::vector<art::Ptr<recob::Hit>> track_hits,
+    void truthMatcher(std::vector<art::Ptr<recob::Hit>> const& track_hits,
                       const simb::MCParticle*& MCparticle,
                       double& Purity,
                       double& Completeness,
@@ -264,6 +263,8 @@ namespace DUNE {
     float fFidVolZmin;
     float fFidVolZmax;
 
+    btutil::HitTruthIndex fHitTruth; ///< back-tracking of all the hits of the event
+
     art::ServiceHandle<geo::Geometry const> geom;
 
     //My histograms
@@ -1227,6 +1228,13 @@ namespace DUNE {
     auto const clockData =
       art::ServiceHandle<detinfo::DetectorClocksService const>()->DataFor(event);
 
+    // back-track all the hits once for all the tracks
+    art::ServiceHandle<cheat::BackTrackerService const> bt_serv;
+    fHitTruth.Fill(
+      AllHits,
+      [&](recob::Hit const& hit) { return bt_serv->HitToTrackIDEs(clockData, hit); },
+      tmp_TrackHits[0].id());
+
     // Loop over reco tracks
     for (int i = 0; i < NRecoTracks; i++) {
       art::Ptr<recob::Track> track = TrackList[i];
@@ -1235,8 +1243,7 @@ namespace DUNE {
       double tmpCompleteness = 0.;
       const simb::MCParticle* particle;
 
-      truthMatcher(
-        clockData, AllHits, TrackHits, particle, tmpPurity, tmpCompleteness, tmpTotalRecoEnergy);
+      truthMatcher(TrackHits, particle, tmpPurity, tmpCompleteness, tmpTotalRecoEnergy);
 
       if (!particle) {
         std::cout << "ERROR: Truth matcher didn't find a particle!" << std::endl;
@@ -1563,35 +1570,17 @@ namespace DUNE {
     }
   }
   //========================================================================
-  void MuonTrackingEff::truthMatcher(detinfo::DetectorClocksData const& clockData,
-                                     std::vector<recob::Hit> const& AllHits,
-                                     std::vector<art::Ptr<recob::Hit>> track_hits,
+  void MuonTrackingEff::truthMatcher(std::vector<art::Ptr<recob::Hit>> const& track_hits,
                                      const simb::MCParticle*& MCparticle,
                                      double& Purity,
                                      double& Completeness,
                                      double& TotalRecoEnergy)
   {
-    art::ServiceHandle<cheat::BackTrackerService const> bt_serv;
     art::ServiceHandle<cheat::ParticleInventoryService const> pi_serv;
-    std::map<int, double> trkID_E; // map that connects TrackID and energy for
-                                   // each hit <trackID, energy>
-    for (size_t j = 0; j < track_hits.size(); ++j) {
-      art::Ptr<recob::Hit> hit = track_hits[j];
-      std::vector<sim::TrackIDE> TrackIDs =
-        bt_serv->HitToTrackIDEs(clockData,
-                                hit); // TrackIDE contains TrackID, energy and energyFrac. A hit can
-      // have several TrackIDs (so this hit is associated with multiple
-      // MC truth track IDs (EM shower IDs are negative). If a hit ahs
-      // multiple trackIDs, "energyFrac" contains the fraction of the
-      // energy of for each ID compared to the total energy of the hit.
-      // "energy" contains only the energy associated with the specific
-      // ID in that case. This requires MC truth info!
-      for (size_t k = 0; k < TrackIDs.size(); k++) {
-        trkID_E[TrackIDs[k].trackID] +=
-          TrackIDs[k].energy; // sum up the energy for each TrackID and store
-                              // <TrackID, energy> in "TrkID_E"
-      }
-    }
+    // map that connects TrackID and energy summed over the track hits
+    // <trackID, energy>; a hit can have several TrackIDs (EM shower IDs are
+    // negative). This requires MC truth info!
+    std::map<int, double> const trkID_E = fHitTruth.EnergyByTrackID(track_hits);
 
     double max_E = -999.0;
     double TotalEnergyTrack = 0.0;
@@ -1606,7 +1595,7 @@ namespace DUNE {
       MCparticle = 0;
       return; // Ghost track???
     }
-    for (std::map<int, double>::iterator ii = trkID_E.begin(); ii != trkID_E.end();
+    for (std::map<int, double>::const_iterator ii = trkID_E.begin(); ii != trkID_E.end();
          ++ii) {                      // trkID_E contains the trackID (first) and corresponding
                                       // energy (second) for a specific track, summed up over all
                                       // events. here looping over all trekID_E's
@@ -1631,16 +1620,8 @@ namespace DUNE {
 
     Purity = PartialEnergyTrackID / TotalEnergyTrack;
 
-    // completeness
-    TotalRecoEnergy = 0;
-    for (recob::Hit const& hit : AllHits) {
-      std::vector<sim::TrackIDE> TrackIDs = bt_serv->HitToTrackIDEs(clockData, hit);
-      for (size_t l = 0; l < TrackIDs.size(); ++l) { // and over all track IDs of the hits
-        if (TrackIDs[l].trackID == TrackID)
-          TotalRecoEnergy += TrackIDs[l].energy; // and sum up the energy fraction of all hits
-                                                 // that correspond ot the saved trackID
-      }
-    }
+    // completeness: energy of the saved trackID in all the hits
+    TotalRecoEnergy = fHitTruth.TrackEnergy(TrackID);
     Completeness = PartialEnergyTrackID / TotalRecoEnergy;
   }
 
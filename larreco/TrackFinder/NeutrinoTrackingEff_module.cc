@@ -19,6 +19,7 @@
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 #include "lardataobj/RecoBase/Track.h"
+#include "larreco/MCComp/HitTruthIndex.h"
 #include "larsim/MCCheater/BackTrackerService.h"
 #include "larsim/MCCheater/ParticleInventoryService.h"
 #include "nusimdata/SimulationBase/MCParticle.h"
@@ -60,9 +61,7 @@ namespace DUNE {
     void analyze(const art::Event& evt);
 
     void processEff(const art::Event& evt);
-    void truthMatcher(detinfo::DetectorClocksData const& clockData,
-                      std::vector<art::Ptr<recob::Hit>> all_hits,
-                      std::vector<art::Ptr<recob::Hit>> track_hits,
+    void truthMatcher(std::vector<art::Ptr<recob::Hit>> const& track_hits,
                       const simb::MCParticle*& MCparticle,
                       double& Efrac,
                       double& Ecomplet);
@@ -707,13 +706,19 @@ namespace DUNE {
       art::fill_ptr_vector(all_hits, hithandle);
     }
 
+    // back-track all the hits once for all the tracks
+    art::ServiceHandle<cheat::BackTrackerService const> bt_serv;
+    fHitTruth.Fill(all_hits, [&](art::Ptr<recob::Hit> const& hit) {
+      return bt_serv->HitToTrackIDEs(clockData, hit);
+    });
+
     for (int i = 0; i < n_recoTrack; i++) {
       art::Ptr<recob::Track> track = tracklist[i];
       std::vector<art::Ptr<recob::Hit>> all_trackHits = track_hits.at(i);
       double tmpEfrac = 0;
       double tmpEcomplet = 0;
       const simb::MCParticle* particle;
-      truthMatcher(clockData, all_hits, all_trackHits, particle, tmpEfrac, tmpEcomplet);
+      truthMatcher(all_trackHits, particle, tmpEfrac, tmpEcomplet);
       if (!particle) continue;
       if ((particle->PdgCode() == fLeptonPDGcode) && (particle->TrackId() == MC_leptonID)) {
         // save the best track ... based on completeness if there is more than
@@ -874,23 +879,13 @@ namespace DUNE {
     }
   }
   //========================================================================
-  void NeutrinoTrackingEff::truthMatcher(detinfo::DetectorClocksData const& clockData,
-                                         std::vector<art::Ptr<recob::Hit>> all_hits,
-                                         std::vector<art::Ptr<recob::Hit>> track_hits,
+  void NeutrinoTrackingEff::truthMatcher(std::vector<art::Ptr<recob::Hit>> const& track_hits,
                                          const simb::MCParticle*& MCparticle,
                                          double& Efrac,
                                          double& Ecomplet)
   {
-    art::ServiceHandle<cheat::BackTrackerService const> bt_serv;
     art::ServiceHandle<cheat::ParticleInventoryService const> pi_serv;
-    std::map<int, double> trkID_E;
-    for (size_t j = 0; j < track_hits.size(); ++j) {
-      art::Ptr<recob::Hit> hit = track_hits[j];
-      std::vector<sim::TrackIDE> TrackIDs = bt_serv->HitToTrackIDEs(clockData, hit);
-      for (size_t k = 0; k < TrackIDs.size(); k++) {
-        trkID_E[TrackIDs[k].trackID] += TrackIDs[k].energy;
-      }
-    }
+    std::map<int, double> const trkID_E = fHitTruth.EnergyByTrackID(track_hits);
     double max_E = -999.0;
     double total_E = 0.0;
     int TrackID = -999;
@@ -904,7 +899,7 @@ namespace DUNE {
       MCparticle = 0;
       return; //Ghost track???
     }
-    for (std::map<int, double>::iterator ii = trkID_E.begin(); ii != trkID_E.end(); ++ii) {
+    for (std::map<int, double>::const_iterator ii = trkID_E.begin(); ii != trkID_E.end(); ++ii) {
       total_E += ii->second;
       if ((ii->second) > max_E) {
         partial_E = ii->second;
@@ -925,14 +920,7 @@ namespace DUNE {
     Efrac = (partial_E) / total_E;
 
     // Completeness
-    double totenergy = 0;
-    for (size_t k = 0; k < all_hits.size(); ++k) {
-      art::Ptr<recob::Hit> hit = all_hits[k];
-      std::vector<sim::TrackIDE> TrackIDs = bt_serv->HitToTrackIDEs(clockData, hit);
-      for (size_t l = 0; l < TrackIDs.size(); ++l) {
-        if (TrackIDs[l].trackID == TrackID) totenergy += TrackIDs[l].energy;
-      }
-    }
+    double const totenergy = fHitTruth.TrackEnergy(TrackID);
     Ecomplet = partial_E / totenergy;
   }
   //========================================================================
@@ -112,6 +112,8 @@ namespace wc {
     bool fSaveMC;
     bool fSaveTrigger;
     bool fSaveJSON;
+    bool fSaveColumnar; // waveforms and trajectories as flat arrays instead of TClonesArray
+    bool fRawDeltaADC;  // columnar raw ADC as differences from the previous sample
     bool fT0_corrected;
     art::ServiceHandle<geo::Geometry const> fGeometry; // pointer to Geometry service
 
@@ -143,6 +145,12 @@ namespace wc {
     // std::vector<std::vector<float> > fCalib_wf;
     TClonesArray* fCalib_wf;
     // std::vector<std::vector<int> > fCalib_wfTDC;
+    // columnar: ROIs of channel i are [fCalib_roiOffset[i], fCalib_roiOffset[i+1]),
+    // the samples of ROI r are fCalib_wfSample[fCalib_wfOffset[r], fCalib_wfOffset[r+1])
+    std::vector<unsigned int> fCalib_roiOffset;
+    std::vector<int> fCalib_roiStart; // first tick of each ROI
+    std::vector<unsigned int> fCalib_wfOffset;
+    std::vector<float> fCalib_wfSample;
 
     int oh_nHits;
     vector<int> oh_channel;
@@ -155,10 +163,14 @@ namespace wc {
     vector<float> of_peTotal;
     vector<int> of_multiplicity;
     TClonesArray* fPEperOpDet;
+    vector<float> of_peOpDet; // columnar: PE of flash f on opdet i at [f * NOpDets + i]
 
     int fRaw_nChannel;
     std::vector<int> fRaw_channelId;
     TClonesArray* fRaw_wf;
+    // columnar: samples of channel i are fRaw_wfADC[fRaw_wfOffset[i], fRaw_wfOffset[i+1])
+    std::vector<unsigned int> fRaw_wfOffset;
+    std::vector<short> fRaw_wfADC;
 
     int fSIMIDE_size;
     vector<int> fSIMIDE_channelIdY;
@@ -180,6 +192,12 @@ namespace wc {
     float mc_endMomentum[MAX_TRACKS][4];        // end momentum of this track; size == mc_Ntrack
     std::vector<std::vector<int>> mc_daughters; // daughters id of this track; vector
     TObjArray* fMC_trackPosition;
+    // columnar: points of track i are [mc_trackPointOffset[i], mc_trackPointOffset[i+1])
+    std::vector<unsigned int> mc_trackPointOffset;
+    std::vector<float> mc_trackPointX;
+    std::vector<float> mc_trackPointY;
+    std::vector<float> mc_trackPointZ;
+    std::vector<float> mc_trackPointT;
 
     int mc_isnu;            // is neutrino interaction
     int mc_nGeniePrimaries; // number of Genie primaries
@@ -233,6 +251,8 @@ namespace wc {
     fSaveSimChannel = p.get<bool>("saveSimChannel");
     fSaveTrigger = p.get<bool>("saveTrigger");
     fSaveJSON = p.get<bool>("saveJSON");
+    fSaveColumnar = p.get<bool>("saveColumnar");
+    fRawDeltaADC = p.get<bool>("rawDeltaADC");
     fT0_corrected = p.get<bool>("t0_corrected");
     opMultPEThresh = p.get<float>("opMultPEThresh");
     drift_speed = p.get<float>("drift_speed"); // mm/us
@@ -250,7 +270,8 @@ namespace wc {
     fOutFile = new TFile(fOutFileName.c_str(), "recreate");
 
     // 3.1: add mc_trackPosition
-    TNamed version("version", "4.0");
+    // 5.0: columnar waveforms, flash PE and trajectories
+    TNamed version("version", fSaveColumnar ? "5.0" : "4.0");
     version.Write();
 
     // init Event TTree
@@ -270,13 +291,27 @@ namespace wc {
     fEventTree->Branch("raw_nChannel", &fRaw_nChannel);   // number of hit channels above threshold
     fEventTree->Branch("raw_channelId", &fRaw_channelId); // hit channel id; size == raw_nChannel
     fRaw_wf = new TClonesArray("TH1F");
-    fEventTree->Branch("raw_wf", &fRaw_wf, 256000, 0); // raw waveform adc of each channel
+    if (fSaveColumnar) {
+      fEventTree->Branch("raw_wf_offset", &fRaw_wfOffset); // size == raw_nChannel + 1
+      fEventTree->Branch("raw_wf_adc", &fRaw_wfADC); // adc of all channels (deltas if rawDeltaADC)
+    }
+    else {
+      fEventTree->Branch("raw_wf", &fRaw_wf, 256000, 0); // raw waveform adc of each channel
+    }
 
     fEventTree->Branch("calib_nChannel",
                        &fCalib_nChannel); // number of hit channels above threshold
     fEventTree->Branch("calib_channelId", &fCalib_channelId); // hit channel id; size == calib_Nhit
     fCalib_wf = new TClonesArray("TH1F");
-    fEventTree->Branch("calib_wf", &fCalib_wf, 256000, 0); // calib waveform adc of each channel
+    if (fSaveColumnar) {
+      fEventTree->Branch("calib_roi_offset", &fCalib_roiOffset); // size == calib_nChannel + 1
+      fEventTree->Branch("calib_roi_start", &fCalib_roiStart);   // first tick of each ROI
+      fEventTree->Branch("calib_wf_offset", &fCalib_wfOffset);   // size == number of ROIs + 1
+      fEventTree->Branch("calib_wf_sample", &fCalib_wfSample);   // samples of all ROIs
+    }
+    else {
+      fEventTree->Branch("calib_wf", &fCalib_wf, 256000, 0); // calib waveform adc of each channel
+    }
     // fCalib_wf->BypassStreamer();
     // fEventTree->Branch("calib_wfTDC", &fCalib_wfTDC);  // calib waveform tdc of each channel
 
@@ -293,7 +328,10 @@ namespace wc {
     fEventTree->Branch("of_multiplicity",
                        &of_multiplicity); // total number of PMTs above threshold for each flash
     fPEperOpDet = new TClonesArray("TH1F");
-    fEventTree->Branch("pe_opdet", &fPEperOpDet, 256000, 0);
+    if (fSaveColumnar)
+      fEventTree->Branch("of_peOpDet", &of_peOpDet); // size == of_nFlash * number of opdets
+    else
+      fEventTree->Branch("pe_opdet", &fPEperOpDet, 256000, 0);
 
     fEventTree->Branch("simide_size", &fSIMIDE_size); // size of stored sim:IDE
     fEventTree->Branch("simide_channelIdY", &fSIMIDE_channelIdY);
@@ -334,7 +372,16 @@ namespace wc {
       "mc_endMomentum[mc_Ntrack][4]/F"); // start momentum of this track; size == mc_Ntrack
     fMC_trackPosition = new TObjArray();
     fMC_trackPosition->SetOwner(kTRUE);
-    fEventTree->Branch("mc_trackPosition", &fMC_trackPosition);
+    if (fSaveColumnar) {
+      fEventTree->Branch("mc_trackPointOffset", &mc_trackPointOffset); // size == mc_Ntrack + 1
+      fEventTree->Branch("mc_trackPointX", &mc_trackPointX);
+      fEventTree->Branch("mc_trackPointY", &mc_trackPointY);
+      fEventTree->Branch("mc_trackPointZ", &mc_trackPointZ);
+      fEventTree->Branch("mc_trackPointT", &mc_trackPointT);
+    }
+    else {
+      fEventTree->Branch("mc_trackPosition", &fMC_trackPosition);
+    }
 
     fEventTree->Branch("mc_isnu", &mc_isnu);
     fEventTree->Branch("mc_nGeniePrimaries", &mc_nGeniePrimaries);
@@ -448,8 +495,15 @@ namespace wc {
     // fRaw_wf->Clear();
     fRaw_wf->Delete();
 
+    fRaw_wfOffset.assign(1, 0);
+    fRaw_wfADC.clear();
+
     fCalib_channelId.clear();
     fCalib_wf->Clear();
+    fCalib_roiOffset.assign(1, 0);
+    fCalib_roiStart.clear();
+    fCalib_wfOffset.assign(1, 0);
+    fCalib_wfSample.clear();
 
     oh_channel.clear();
     oh_bgtime.clear();
@@ -460,6 +514,7 @@ namespace wc {
     of_peTotal.clear();
     of_multiplicity.clear();
     fPEperOpDet->Delete();
+    of_peOpDet.clear();
 
     fSIMIDE_channelIdY.clear();
     fSIMIDE_trackId.clear();
@@ -484,6 +539,11 @@ namespace wc {
     mc_daughters.clear();
     savedMCTrackIdMap.clear();
     fMC_trackPosition->Clear();
+    mc_trackPointOffset.assign(1, 0);
+    mc_trackPointX.clear();
+    mc_trackPointY.clear();
+    mc_trackPointZ.clear();
+    mc_trackPointT.clear();
 
     mc_isnu = 0;
     mc_nGeniePrimaries = -1;
@@ -533,6 +593,16 @@ namespace wc {
       std::vector<short> uncompressed(nSamples);
       raw::Uncompress(wire->ADCs(), uncompressed, wire->Compression());
 
+      if (fSaveColumnar) {
+        short previous = 0;
+        for (short const adc : uncompressed) {
+          fRaw_wfADC.push_back(fRawDeltaADC ? adc - previous : adc);
+          previous = adc;
+        }
+        fRaw_wfOffset.push_back(fRaw_wfADC.size());
+        continue;
+      }
+
       TH1F* h = new ((*fRaw_wf)[i]) TH1F("", "", nRawSamples, 0, nRawSamples);
       for (int j = 1; j <= nSamples; j++) {
         h->SetBinContent(j, uncompressed[j - 1]);
@@ -558,6 +628,20 @@ namespace wc {
     // cout << "\n wires size: " << wires.size() << endl;
     fCalib_nChannel = wires.size();
 
+    if (fSaveColumnar) {
+      // only the regions of interest, the rest of the waveform is zero
+      for (auto const& wire : wires) {
+        fCalib_channelId.push_back(wire->Channel());
+        for (auto const& roi : wire->SignalROI().get_ranges()) {
+          fCalib_roiStart.push_back(roi.begin_index());
+          fCalib_wfSample.insert(fCalib_wfSample.end(), roi.begin(), roi.end());
+          fCalib_wfOffset.push_back(fCalib_wfSample.size());
+        }
+        fCalib_roiOffset.push_back(fCalib_roiStart.size());
+      }
+      return;
+    }
+
     int i = 0;
     for (auto const& wire : wires) {
       std::vector<float> calibwf = wire->Signal();
@@ -611,12 +695,16 @@ namespace wc {
     for (auto const& flash : flashes) {
       of_t.push_back(flash->Time());
       of_peTotal.push_back(flash->TotalPE());
-      TH1F* h = new ((*fPEperOpDet)[a]) TH1F("", "", nOpDet, 0, nOpDet);
+      TH1F* h =
+        fSaveColumnar ? nullptr : new ((*fPEperOpDet)[a]) TH1F("", "", nOpDet, 0, nOpDet);
 
       int mult = 0;
       for (int i = 0; i < nOpDet; ++i) {
         if (flash->PE(i) >= opMultPEThresh) { mult++; }
-        h->SetBinContent(i, flash->PE(i));
+        if (h)
+          h->SetBinContent(i, flash->PE(i));
+        else
+          of_peOpDet.push_back(flash->PE(i));
       }
       of_multiplicity.push_back(mult);
       a++;
@@ -721,7 +809,17 @@ namespace wc {
       momentumStart.GetXYZT(mc_startMomentum[i]);
       momentumEnd.GetXYZT(mc_endMomentum[i]);
 
-      if (fSaveMCTrackPoints) {
+      if (fSaveMCTrackPoints && fSaveColumnar) {
+        for (unsigned int j = 0; j < numberTrajectoryPoints; j++) {
+          const TLorentzVector& position = particle->Position(j);
+          mc_trackPointX.push_back(position.X());
+          mc_trackPointY.push_back(position.Y());
+          mc_trackPointZ.push_back(position.Z());
+          mc_trackPointT.push_back(position.T());
+        }
+        mc_trackPointOffset.push_back(mc_trackPointX.size());
+      }
+      else if (fSaveMCTrackPoints) {
         TClonesArray* Lposition = new TClonesArray("TLorentzVector", numberTrajectoryPoints);
         // Read the position and momentum along this particle track
         for (unsigned int j = 0; j < numberTrajectoryPoints; j++) {
@@ -1067,7 +1165,14 @@ namespace wc {
     }
 
     vector<double> vx, vy, vz;
-    if (fSaveMCTrackPoints) {
+    if (fSaveMCTrackPoints && fSaveColumnar) {
+      for (unsigned int j = mc_trackPointOffset[i]; j < mc_trackPointOffset[i + 1]; j++) {
+        vx.push_back(mc_trackPointX[j]);
+        vy.push_back(mc_trackPointY[j]);
+        vz.push_back(mc_trackPointZ[j]);
+      }
+    }
+    else if (fSaveMCTrackPoints) {
       // fMC_trackPosition->Print();
       TClonesArray* traj = (TClonesArray*)(*fMC_trackPosition)[i];
       int nPoints = traj->GetEntries();
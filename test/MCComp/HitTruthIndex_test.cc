@@ -0,0 +1,180 @@
+#define BOOST_TEST_MODULE (HitTruthIndex_test)
+#include "boost/test/unit_test.hpp"
+
+#include "larreco/MCComp/HitTruthIndex.h"
+
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
+#include "cetlib_except/exception.h"
+#include "lardataobj/RecoBase/Hit.h"
+#include "lardataobj/Simulation/SimChannel.h"
+
+#include <map>
+#include <vector>
+
+namespace {
+
+  recob::Hit MakeHit(raw::ChannelID_t channel, unsigned int plane)
+  {
+    return recob::Hit(channel,
+                      0,     // start tick
+                      20,    // end tick
+                      10.,   // peak time
+                      1.,    // sigma peak time
+                      2.,    // rms
+                      50.,   // peak amplitude
+                      1.,    // sigma peak amplitude
+                      250.,  // ROI summed ADC
+                      250.,  // hit summed ADC
+                      250.,  // integral
+                      5.,    // sigma integral
+                      1,     // multiplicity
+                      0,     // local index
+                      1.,    // goodness of fit
+                      1,     // degrees of freedom
+                      geo::kU,
+                      geo::kInduction,
+                      geo::WireID(0, 0, plane, channel));
+  }
+
+  sim::TrackIDE MakeIDE(int trackID, float energyFrac, float energy)
+  {
+    sim::TrackIDE ide;
+    ide.trackID = trackID;
+    ide.energyFrac = energyFrac;
+    ide.energy = energy;
+    ide.numElectrons = energy * 1000.;
+    return ide;
+  }
+
+}
+
+struct HitTruthIndexFixture {
+
+  HitTruthIndexFixture()
+    : hits{MakeHit(0, 0), MakeHit(1, 1), MakeHit(2, 0), MakeHit(3, 1)}
+    , ides{{0, {MakeIDE(1, 0.75, 3.), MakeIDE(2, 0.25, 1.)}},
+           {1, {MakeIDE(2, 1., 2.)}},
+           {3, {MakeIDE(1, 0.5, 1.), MakeIDE(1, 0.5, 1.)}}}
+  {
+    for (std::size_t i = 0; i < hits.size(); ++i)
+      hitPtrs.emplace_back(hitID, &hits[i], i);
+  }
+
+  std::vector<sim::TrackIDE> TrackIDEsOf(const recob::Hit& hit) const
+  {
+    auto const it = ides.find(hit.Channel());
+    return (it == ides.end()) ? std::vector<sim::TrackIDE>{} : it->second;
+  }
+
+  void FillFromPtrs(btutil::HitTruthIndex& index, std::vector<art::Ptr<recob::Hit>> const& ptrs)
+  {
+    index.Fill(ptrs, [this](art::Ptr<recob::Hit> const& hit) { return TrackIDEsOf(*hit); });
+  }
+
+  art::ProductID const hitID{1};
+  art::ProductID const otherID{2};
+  std::vector<recob::Hit> hits;
+  std::vector<art::Ptr<recob::Hit>> hitPtrs;
+  std::map<raw::ChannelID_t, std::vector<sim::TrackIDE>> ides; ///< by channel
+};
+
+BOOST_FIXTURE_TEST_SUITE(HitTruthIndex_test, HitTruthIndexFixture)
+
+BOOST_AUTO_TEST_CASE(checkHitTables)
+{
+  btutil::HitTruthIndex index;
+  FillFromPtrs(index, hitPtrs);
+
+  BOOST_TEST(index.NHits() == 4U);
+  BOOST_TEST(index.HitProductID() == hitID);
+
+  BOOST_TEST(index.HitTrackIDEs(0).size() == 2U);
+  BOOST_TEST(index.HitTrackIDEs(hitPtrs[1]).size() == 1U);
+  BOOST_TEST(index.HitTrackIDEs(2).empty());
+
+  BOOST_TEST(index.DominantTrackID(0) == 1);
+  BOOST_TEST(index.DominantFraction(0) == 0.75F);
+  BOOST_TEST(index.DominantTrackID(1) == 2);
+  BOOST_TEST(index.DominantTrackID(2) == sim::NoParticleId);
+  BOOST_TEST(index.DominantFraction(2) == 0.F);
+  // the first of equal contributions wins
+  BOOST_TEST(index.DominantFraction(3) == 0.5F);
+}
+
+BOOST_AUTO_TEST_CASE(checkTrackTables)
+{
+  btutil::HitTruthIndex index;
+  FillFromPtrs(index, hitPtrs);
+
+  BOOST_TEST(index.TrackIDs() == (std::vector<int>{1, 2}), boost::test_tools::per_element());
+
+  // track 1 contributes twice to hit 3, which is listed once
+  auto const track1Hits = index.TrackHits(1);
+  BOOST_TEST(std::vector<std::size_t>(track1Hits.begin(), track1Hits.end()) ==
+               (std::vector<std::size_t>{0, 3}),
+             boost::test_tools::per_element());
+  BOOST_TEST(index.TrackHits(3).empty());
+
+  BOOST_TEST(index.TrackEnergy(1) == 5.);
+  BOOST_TEST(index.TrackEnergy(1, 0) == 3.);
+  BOOST_TEST(index.TrackEnergy(1, 1) == 2.);
+  BOOST_TEST(index.TrackEnergy(2) == 3.);
+  BOOST_TEST(index.TrackEnergy(2, 5) == 0.);
+  BOOST_TEST(index.TrackEnergy(3) == 0.);
+
+  auto const energies = index.EnergyByTrackID({hitPtrs[0], hitPtrs[1]});
+  BOOST_TEST(energies.size() == 2U);
+  BOOST_TEST(energies.at(1) == 3.);
+  BOOST_TEST(energies.at(2) == 3.);
+}
+
+BOOST_AUTO_TEST_CASE(checkFillFromHits)
+{
+  btutil::HitTruthIndex index;
+  index.Fill(hits, [this](recob::Hit const& hit) { return TrackIDEsOf(hit); }, hitID);
+
+  BOOST_TEST(index.HitProductID() == hitID);
+  BOOST_TEST(index.TrackEnergy(1) == 5.);
+  BOOST_TEST(index.HitTrackIDEs(hitPtrs[0]).size() == 2U);
+  BOOST_CHECK_THROW(index.HitTrackIDEs(art::Ptr<recob::Hit>(otherID, &hits[0], 0)),
+                    cet::exception);
+
+  // without a product ID the pointers are looked up by key only
+  index.Fill(hits, [this](recob::Hit const& hit) { return TrackIDEsOf(hit); });
+  BOOST_TEST(!index.HitProductID().isValid());
+  BOOST_TEST(index.HitTrackIDEs(art::Ptr<recob::Hit>(otherID, &hits[0], 0)).size() == 2U);
+}
+
+BOOST_AUTO_TEST_CASE(checkOtherProduct)
+{
+  btutil::HitTruthIndex index;
+  FillFromPtrs(index, hitPtrs);
+
+  art::Ptr<recob::Hit> const otherHit(otherID, &hits[0], 0);
+  BOOST_CHECK_THROW(index.HitTrackIDEs(otherHit), cet::exception);
+  BOOST_CHECK_THROW(index.EnergyByTrackID({hitPtrs[0], otherHit}), cet::exception);
+
+  // a key past the indexed hits has no contributions
+  BOOST_TEST(index.HitTrackIDEs(art::Ptr<recob::Hit>(hitID, &hits[0], 10)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(checkFillNeedsWholeProduct)
+{
+  btutil::HitTruthIndex index;
+
+  // missing the first hit
+  std::vector<art::Ptr<recob::Hit>> const subset(hitPtrs.begin() + 1, hitPtrs.end());
+  BOOST_CHECK_THROW(FillFromPtrs(index, subset), cet::exception);
+
+  // mixing products
+  auto mixed = hitPtrs;
+  mixed[2] = art::Ptr<recob::Hit>(otherID, &hits[2], 2);
+  BOOST_CHECK_THROW(FillFromPtrs(index, mixed), cet::exception);
+
+  // refilling starts from scratch
+  FillFromPtrs(index, hitPtrs);
+  BOOST_TEST(index.NHits() == 4U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
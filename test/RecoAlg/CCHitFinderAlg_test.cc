@@ -0,0 +1,195 @@
+/**
+ * @file   CCHitFinderAlg_test.cc
+ * @brief  Test of the bounded multi-Gaussian fit of CCHitFinderAlg
+ * @see    CCHitFinderAlg.h
+ *
+ * The fit is compared with the bounded ROOT fit of a graph ("WNQB" options)
+ * it replaces, on synthetic pulses of one and two Gaussians.
+ */
+
+// C/C++ standard libraries
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// boost test libraries
+#define BOOST_TEST_MODULE (CCHitFinderAlg_test)
+#include "boost/test/unit_test.hpp"
+#include "cetlib/pow.h"
+
+// ROOT libraries
+#include "TF1.h"
+#include "TGraph.h"
+
+// LArSoft libraries
+#include "larreco/RecoAlg/CCHitFinderAlg.h"
+
+using boost::test_tools::tolerance;
+using cet::square;
+
+namespace {
+
+  struct Gaussian_t {
+    double amplitude, mean, sigma;
+  };
+
+  struct FitResult_t {
+    bool ok = false;
+    std::vector<double> params, errors;
+    double chi2 = 0.;
+  };
+
+  /// Sampled sum of the Gaussians, with a fixed ripple playing the noise
+  struct Pulse_t {
+    Pulse_t(unsigned short npt, std::vector<Gaussian_t> const& gaussians)
+    {
+      for (unsigned short i = 0; i < npt; ++i) {
+        double value = 0.5 * std::sin(1.7 * i);
+        for (auto const& g : gaussians)
+          value += g.amplitude * std::exp(-0.5 * square((i - g.mean) / g.sigma));
+        ticks.push_back(i);
+        signl.push_back(value);
+      }
+    }
+
+    unsigned short size() const { return ticks.size(); }
+
+    std::vector<float> ticks, signl;
+  };
+
+  /// The fit under test
+  FitResult_t boundedFit(Pulse_t const& pulse,
+                         std::vector<double> const& start,
+                         std::vector<double> const& parmin,
+                         std::vector<double> const& parmax)
+  {
+    FitResult_t result;
+    result.params = start;
+    result.ok = hit::CCHitFinderAlg::BoundedGaussianFit(start.size() / 3,
+                                                        pulse.size(),
+                                                        pulse.ticks.data(),
+                                                        pulse.signl.data(),
+                                                        result.params,
+                                                        parmin,
+                                                        parmax,
+                                                        result.errors,
+                                                        result.chi2);
+    return result;
+  }
+
+  /// The reference: ROOT fit as CCHitFinderAlg used to do it
+  FitResult_t rootFit(Pulse_t const& pulse,
+                      std::vector<double> const& start,
+                      std::vector<double> const& parmin,
+                      std::vector<double> const& parmax)
+  {
+    std::string eqn = "gaus(0)";
+    for (unsigned short ipar = 3; ipar < start.size(); ipar += 3) {
+      std::ostringstream sstr;
+      sstr << " + gaus(" << ipar << ")";
+      eqn += sstr.str();
+    }
+    TF1 func("CCHitFinderAlgTestFunc", eqn.c_str());
+    for (unsigned short ipar = 0; ipar < start.size(); ++ipar) {
+      func.SetParameter(ipar, start[ipar]);
+      func.SetParLimits(ipar, parmin[ipar], parmax[ipar]);
+    }
+    TGraph graph(pulse.size(), pulse.ticks.data(), pulse.signl.data());
+
+    FitResult_t result;
+    result.ok = (graph.Fit(&func, "WNQB") == 0);
+    for (unsigned short ipar = 0; ipar < start.size(); ++ipar) {
+      result.params.push_back(func.GetParameter(ipar));
+      result.errors.push_back(func.GetParError(ipar));
+    }
+    result.chi2 = func.GetChisquare();
+    return result;
+  }
+
+  /// Limits as CCHitFinderAlg sets them, with sigma up to maxSigma
+  void setLimits(unsigned short npt,
+                 double maxSigma,
+                 std::vector<double>& parmin,
+                 std::vector<double>& parmax)
+  {
+    parmin.insert(parmin.end(), {0., 0., 1.});
+    parmax.insert(parmax.end(), {9999., double(npt), maxSigma});
+  }
+
+  void compareFits(Pulse_t const& pulse,
+                   std::vector<double> const& start,
+                   std::vector<double> const& parmin,
+                   std::vector<double> const& parmax,
+                   bool compareErrors = true)
+  {
+    auto const fit = boundedFit(pulse, start, parmin, parmax);
+    auto const ref = rootFit(pulse, start, parmin, parmax);
+
+    BOOST_TEST(fit.ok);
+    BOOST_TEST(ref.ok);
+    BOOST_TEST(fit.chi2 == ref.chi2, 0.02 % tolerance());
+    // the fit may only improve on the reference
+    BOOST_TEST(fit.chi2 <= ref.chi2 * 1.001);
+    BOOST_TEST_REQUIRE(fit.params.size() == start.size());
+    BOOST_TEST_REQUIRE(fit.errors.size() == start.size());
+    for (unsigned short ipar = 0; ipar < start.size(); ++ipar) {
+      BOOST_TEST_INFO("parameter #" << ipar);
+      BOOST_TEST(fit.params[ipar] >= parmin[ipar]);
+      BOOST_TEST(fit.params[ipar] <= parmax[ipar]);
+      BOOST_TEST(fit.params[ipar] == ref.params[ipar], 0.01 % tolerance());
+      if (compareErrors) BOOST_TEST(fit.errors[ipar] == ref.errors[ipar], 0.1 % tolerance());
+    }
+  }
+
+}
+
+//******************************************************************************
+BOOST_AUTO_TEST_SUITE(BoundedGaussianFitSuite)
+
+BOOST_AUTO_TEST_CASE(SingleGaussian)
+{
+  Pulse_t const pulse(25, {{50., 11.3, 2.5}});
+  std::vector<double> parmin, parmax;
+  setLimits(pulse.size(), 6., parmin, parmax);
+
+  compareFits(pulse, {pulse.signl[11], 11., 2.}, parmin, parmax);
+}
+
+BOOST_AUTO_TEST_CASE(TwoGaussians)
+{
+  Pulse_t const pulse(30, {{40., 10.4, 2.}, {25., 17.8, 2.6}});
+  std::vector<double> parmin, parmax;
+  setLimits(pulse.size(), 6., parmin, parmax);
+  setLimits(pulse.size(), 6., parmin, parmax);
+
+  compareFits(pulse, {pulse.signl[10], 10., 2., pulse.signl[18], 18., 2.}, parmin, parmax);
+}
+
+BOOST_AUTO_TEST_CASE(SigmaAtLimit)
+{
+  // the pulse is wider than allowed: the width sticks to its upper limit
+  Pulse_t const pulse(30, {{45., 14.6, 4.5}});
+  std::vector<double> parmin, parmax;
+  setLimits(pulse.size(), 3., parmin, parmax);
+
+  // the error of a parameter at its limit depends on how the limit is implemented
+  compareFits(pulse, {pulse.signl[15], 15., 2.}, parmin, parmax, false);
+
+  auto const fit = boundedFit(pulse, {pulse.signl[15], 15., 2.}, parmin, parmax);
+  BOOST_TEST(fit.params[2] == 3., 0.001 % tolerance());
+}
+
+BOOST_AUTO_TEST_CASE(TooFewPoints)
+{
+  Pulse_t const pulse(5, {{30., 2., 1.5}, {20., 3., 1.5}});
+  std::vector<double> parmin, parmax;
+  setLimits(pulse.size(), 6., parmin, parmax);
+  setLimits(pulse.size(), 6., parmin, parmax);
+
+  // 6 parameters cannot be fitted on 5 points
+  auto const fit = boundedFit(pulse, {30., 2., 1.5, 20., 3., 1.5}, parmin, parmax);
+  BOOST_TEST(!fit.ok);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
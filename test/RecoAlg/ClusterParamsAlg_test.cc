@@ -0,0 +1,180 @@
+/**
+ * @file   ClusterParamsAlg_test.cc
+ * @brief  Test of the averages of merged clusters in ClusterParamsAlg
+ * @see    ClusterParamsAlg.h
+ *
+ * The averages of a cluster built with SetHits(parents), combined from the
+ * moments of its parents, are compared with the ones recomputed from the
+ * hits of the merged cluster.
+ */
+
+// C/C++ standard libraries
+#include <cmath>
+#include <vector>
+
+// boost test libraries
+#define BOOST_TEST_MODULE (ClusterParamsAlg_test)
+#include "boost/test/unit_test.hpp"
+
+// LArSoft libraries
+#include "lardata/Utilities/PxUtils.h"
+#include "larreco/RecoAlg/ClusterRecoUtil/ClusterParamsAlg.h"
+
+using boost::test_tools::tolerance;
+using Parents_t = std::vector<const cluster::ClusterParamsAlg*>;
+
+namespace {
+
+  /// A track-like row of hits, two on some wires, with varying charge
+  std::vector<util::PxHit> makeHits(unsigned int firstWire,
+                                    unsigned int nWires,
+                                    double t0,
+                                    double slope)
+  {
+    std::vector<util::PxHit> hits;
+    for (unsigned int i = 0; i < nWires; ++i) {
+      unsigned short const nOnWire = (i % 3 == 1) ? 2 : 1;
+      for (unsigned short j = 0; j < nOnWire; ++j) {
+        util::PxHit hit;
+        hit.plane = 2;
+        hit.w = 0.3 * (firstWire + i);
+        hit.t = t0 + slope * i + 0.4 * j + 0.1 * std::sin(1.3 * i);
+        hit.charge = 100. + 20. * std::cos(0.7 * i) + 15. * j;
+        hit.sumADC = 0.8 * hit.charge;
+        hit.peak = 0.2 * hit.charge;
+        hits.push_back(hit);
+      }
+    }
+    return hits;
+  }
+
+  void setup(cluster::ClusterParamsAlg& alg)
+  {
+    alg.SetVerbose(false);
+    alg.SetMinNHits(1);
+  }
+
+  /// Checks the averages of merged against the ones computed from its hits
+  void checkAverages(cluster::ClusterParamsAlg const& merged)
+  {
+    cluster::ClusterParamsAlg recomputed;
+    setup(recomputed);
+    recomputed.SetHits(merged.GetHitVector());
+    recomputed.GetAverages();
+
+    auto const& params = merged.GetParams();
+    auto const& expected = recomputed.GetParams();
+    auto const tol = 1e-9 % tolerance();
+
+    BOOST_TEST(params.N_Hits == expected.N_Hits);
+    BOOST_TEST(params.N_Wires == expected.N_Wires);
+    BOOST_TEST(params.multi_hit_wires == expected.multi_hit_wires);
+    BOOST_TEST(params.sum_charge == expected.sum_charge, tol);
+    BOOST_TEST(params.mean_charge == expected.mean_charge, tol);
+    BOOST_TEST(params.rms_charge == expected.rms_charge, tol);
+    BOOST_TEST(params.sum_ADC == expected.sum_ADC, tol);
+    BOOST_TEST(params.mean_ADC == expected.mean_ADC, tol);
+    BOOST_TEST(params.rms_ADC == expected.rms_ADC, tol);
+    BOOST_TEST(params.mean_x == expected.mean_x, tol);
+    BOOST_TEST(params.mean_y == expected.mean_y, tol);
+    BOOST_TEST(params.charge_wgt_x == expected.charge_wgt_x, tol);
+    BOOST_TEST(params.charge_wgt_y == expected.charge_wgt_y, tol);
+    BOOST_TEST(params.eigenvalue_principal == expected.eigenvalue_principal, tol);
+    BOOST_TEST(params.eigenvalue_secondary == expected.eigenvalue_secondary, tol);
+  }
+
+  struct MergeFixture {
+    MergeFixture()
+    {
+      // the two clusters share wires 8 to 10
+      for (auto* alg : {&first, &second, &merged})
+        setup(*alg);
+      first.SetHits(makeHits(0, 11, 50., 1.5));
+      second.SetHits(makeHits(8, 9, 66., 1.2));
+    }
+
+    cluster::ClusterParamsAlg first, second, merged;
+  };
+
+}
+
+//******************************************************************************
+BOOST_FIXTURE_TEST_SUITE(ClusterParamsAlgMerge, MergeFixture)
+
+BOOST_AUTO_TEST_CASE(TestAveragesFromHits)
+{
+  // the averages of a single cluster, against a direct computation
+  first.GetAverages();
+  auto const& hits = first.GetHitVector();
+  double const n = hits.size();
+  double sumW = 0., sumT = 0., sumQ = 0., sumWQ = 0.;
+  for (auto const& hit : hits) {
+    sumW += hit.w;
+    sumT += hit.t;
+    sumQ += hit.charge;
+    sumWQ += hit.w * hit.charge;
+  }
+  double const meanW = sumW / n, meanT = sumT / n;
+  double cww = 0., ctt = 0., cwt = 0.;
+  for (auto const& hit : hits) {
+    cww += (hit.w - meanW) * (hit.w - meanW);
+    ctt += (hit.t - meanT) * (hit.t - meanT);
+    cwt += (hit.w - meanW) * (hit.t - meanT);
+  }
+  // eigenvalues of the covariance matrix, normalised to its trace
+  double const trace = cww + ctt;
+  double const lambda1 =
+    0.5 * (trace + std::sqrt((cww - ctt) * (cww - ctt) + 4. * cwt * cwt)) / trace;
+
+  auto const& params = first.GetParams();
+  auto const tol = 1e-9 % tolerance();
+  BOOST_TEST(params.N_Hits == n);
+  BOOST_TEST(params.N_Wires == 11);
+  BOOST_TEST(params.multi_hit_wires == 4);
+  BOOST_TEST(params.mean_x == meanW, tol);
+  BOOST_TEST(params.mean_y == meanT, tol);
+  BOOST_TEST(params.sum_charge == sumQ, tol);
+  BOOST_TEST(params.charge_wgt_x == sumWQ / sumQ, tol);
+  BOOST_TEST(params.eigenvalue_principal == lambda1, tol);
+  BOOST_TEST(params.eigenvalue_secondary == 1. - lambda1, tol);
+}
+
+BOOST_AUTO_TEST_CASE(TestCombinedAverages)
+{
+  // the parents have their averages: the merged ones are combined from them
+  first.GetAverages();
+  second.GetAverages();
+  BOOST_TEST(merged.SetHits(Parents_t{&first, &second}) == 15 + 12);
+  checkAverages(merged);
+
+  // the shared wires have hits of both clusters
+  BOOST_TEST(merged.GetParams().N_Wires == 17);
+}
+
+BOOST_AUTO_TEST_CASE(TestRecomputedAverages)
+{
+  // a parent without averages: the merged ones are computed from the hits
+  first.GetAverages();
+  merged.SetHits(Parents_t{&first, &second});
+  merged.GetAverages();
+  checkAverages(merged);
+}
+
+BOOST_AUTO_TEST_CASE(TestMergeAfterReuse)
+{
+  // nothing of the cluster the algorithm was used for before is left over
+  merged.SetHits(makeHits(30, 7, 10., -0.5));
+  merged.GetAverages();
+
+  first.GetAverages();
+  second.GetAverages();
+  merged.SetHits(Parents_t{&first, &second});
+  checkAverages(merged);
+
+  cluster::ClusterParamsAlg merged2;
+  setup(merged2);
+  merged2.SetHits(Parents_t{&merged, &first});
+  checkAverages(merged2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,209 @@
+/**
+ * @file   TrackMomentumCalculator_test.cc
+ * @brief  Test of the range table and of the MCS chi2 fit of TrackMomentumCalculator
+ * @see    TrackMomentumCalculator.h
+ *
+ * The muon range momentum is compared with the one from the TSpline3 of the
+ * CSDA table the calculator used to build, and the Highland formula fit with
+ * the Minuit2 fit it replaces, on synthetic scattered angle measurements.
+ */
+
+// C/C++ standard libraries
+#include <array>
+#include <cmath>
+#include <vector>
+
+// boost test libraries
+#define BOOST_TEST_MODULE (TrackMomentumCalculator_test)
+#include "boost/test/unit_test.hpp"
+#include "cetlib/pow.h"
+
+// ROOT libraries
+#include "Math/Functor.h"
+#include "Minuit2/Minuit2Minimizer.h"
+#include "TGraph.h"
+#include "TSpline.h"
+
+// LArSoft libraries
+#include "larreco/RecoAlg/TrackMomentumCalculator.h"
+
+using boost::test_tools::tolerance;
+using cet::square;
+
+namespace {
+
+  // the muon CSDA table, as TrackMomentumCalculator used to feed it to TSpline3
+  constexpr std::array<float, 29> Range_grampercm{
+    {9.833E-1, 1.786E0, 3.321E0, 6.598E0, 1.058E1, 3.084E1, 4.250E1, 6.732E1, 1.063E2, 1.725E2,
+     2.385E2,  4.934E2, 6.163E2, 8.552E2, 1.202E3, 1.758E3, 2.297E3, 4.359E3, 5.354E3, 7.298E3,
+     1.013E4,  1.469E4, 1.910E4, 3.558E4, 4.326E4, 5.768E4, 7.734E4, 1.060E5, 1.307E5}};
+  constexpr std::array<float, 29> KE_MeV{
+    {10,    14,    20,    30,    40,     80,     100,    140,    200,   300,
+     400,   800,   1000,  1400,  2000,   3000,   4000,   8000,   10000, 14000,
+     20000, 30000, 40000, 80000, 100000, 140000, 200000, 300000, 400000}};
+
+  /// Muon momentum (GeV) from the TSpline3 of the CSDA table
+  struct SplineReference {
+    SplineReference()
+    {
+      for (float& value : range) {
+        value /= 1.396; // convert to cm
+      }
+    }
+
+    double Momentum(double trkrange) const
+    {
+      double const KE = spline.Eval(trkrange);
+      return std::sqrt(KE * KE + 2 * 105.7 * KE) / 1000;
+    }
+
+    std::array<float, 29> range = Range_grampercm;
+    TGraph graph{29, range.data(), KE_MeV.data()};
+    TSpline3 spline{"KEvsRS", &graph};
+  };
+
+  /// Highland formula, with angular resolution theta0 (mrad), for momentum p (GeV)
+  double highland(double length, double p, double theta0)
+  {
+    double const l0 = length / 14.0;
+    double const res = (13.6 / p) * std::sqrt(l0) * (1.0 + 0.038 * std::log(l0));
+    return std::sqrt(res * res + theta0 * theta0);
+  }
+
+  struct Measurements_t {
+    std::vector<double> x, y, ey;
+  };
+
+  /// RMS of the scattered angle for 10 to 100 cm segments, with a fixed ripple
+  Measurements_t makeMeasurements(double p, double theta0)
+  {
+    Measurements_t meas;
+    for (int i = 1; i <= 10; ++i) {
+      double const length = 10. * i;
+      double const rms = highland(length, p, theta0) * (1.0 + 0.03 * std::sin(2.3 * i));
+      meas.x.push_back(length);
+      meas.y.push_back(rms);
+      meas.ey.push_back(std::sqrt(square(0.3) + square(0.05 * rms)));
+    }
+    return meas;
+  }
+
+  /// The chi2 of GetMomentumMultiScatterChi2
+  double chi2(Measurements_t const& meas, double const* x)
+  {
+    double result = 0.0;
+    for (std::size_t i = 0; i < meas.x.size(); ++i)
+      result += square((meas.y[i] - highland(meas.x[i], x[0], x[1])) / meas.ey[i]);
+    return result + 2.0 / (4.6) * x[1];
+  }
+
+  struct FitResult_t {
+    bool ok = false;
+    std::array<double, 2> pars{};
+    double chi2 = 0.;
+  };
+
+  /// The fit under test
+  FitResult_t fit(Measurements_t const& meas, int maxMomentum_MeV)
+  {
+    FitResult_t result;
+    result.ok = trkf::TrackMomentumCalculator::FitMultiScatterChi2(
+      meas.x, meas.y, meas.ey, maxMomentum_MeV, result.pars);
+    result.chi2 = chi2(meas, result.pars.data());
+    return result;
+  }
+
+  /// The reference: Minuit2 fit as GetMomentumMultiScatterChi2 used to do it
+  FitResult_t minuitFit(Measurements_t const& meas, int maxMomentum_MeV)
+  {
+    ROOT::Minuit2::Minuit2Minimizer mP{};
+    ROOT::Math::Functor FCA([&meas](double const* xs) { return chi2(meas, xs); }, 2);
+
+    mP.SetFunction(FCA);
+    mP.SetLimitedVariable(0, "p_{MCS}", 1.0, 0.01, 0.001, maxMomentum_MeV / 1.e3);
+    mP.SetLimitedVariable(1, "#delta#theta", 0.0, 1.0, 0.0, 45.0);
+    mP.SetMaxFunctionCalls(1.E9);
+    mP.SetMaxIterations(1.E9);
+    mP.SetTolerance(0.01);
+    mP.SetStrategy(2);
+    mP.SetErrorDef(1.0);
+    mP.SetPrintLevel(0);
+
+    FitResult_t result;
+    result.ok = mP.Minimize();
+    result.pars = {mP.X()[0], mP.X()[1]};
+    result.chi2 = chi2(meas, mP.X());
+    return result;
+  }
+
+  void compareFits(double p, double theta0, int maxMomentum_MeV = 7500)
+  {
+    BOOST_TEST_INFO("p=" << p << " GeV, theta0=" << theta0 << " mrad");
+    auto const meas = makeMeasurements(p, theta0);
+    auto const result = fit(meas, maxMomentum_MeV);
+    auto const ref = minuitFit(meas, maxMomentum_MeV);
+
+    BOOST_TEST(result.ok);
+    BOOST_TEST(ref.ok);
+    BOOST_TEST(result.chi2 == ref.chi2, 0.001 % tolerance());
+    BOOST_TEST(result.pars[0] == ref.pars[0], 0.5 % tolerance());
+    BOOST_TEST(std::abs(result.pars[1] - ref.pars[1]) < 0.1);
+    BOOST_TEST(result.pars[0] <= maxMomentum_MeV / 1.e3);
+    BOOST_TEST(result.pars[1] >= 0.);
+  }
+
+}
+
+//******************************************************************************
+BOOST_AUTO_TEST_SUITE(RangeMomentumSuite)
+
+BOOST_AUTO_TEST_CASE(MuonRangeTable)
+{
+  trkf::TrackMomentumCalculator const calc;
+  SplineReference const ref;
+
+  // at the nodes of the table, between them and past its ends
+  std::vector<double> ranges{0.5};
+  for (std::size_t i = 0; i < ref.range.size(); ++i) {
+    ranges.push_back(ref.range[i]);
+    if (i + 1 < ref.range.size()) {
+      ranges.push_back(0.5 * (ref.range[i] + ref.range[i + 1]));
+      ranges.push_back(0.9 * ref.range[i] + 0.1 * ref.range[i + 1]);
+    }
+  }
+  ranges.push_back(1.1 * ref.range.back());
+
+  for (double const range : ranges) {
+    BOOST_TEST_INFO("range " << range << " cm");
+    BOOST_TEST(calc.GetTrackMomentum(range, 13) == ref.Momentum(range), 1e-6 % tolerance());
+    BOOST_TEST(calc.GetTrackMomentum(range, -13) == ref.Momentum(range), 1e-6 % tolerance());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//******************************************************************************
+BOOST_AUTO_TEST_SUITE(MultiScatterChi2Suite)
+
+BOOST_AUTO_TEST_CASE(NoResolutionTerm)
+{
+  // the best resolution term is on its lower limit, where the fit starts
+  compareFits(0.3, 0.);
+  compareFits(0.8, 0.);
+  compareFits(2.0, 0.);
+}
+
+BOOST_AUTO_TEST_CASE(ResolutionTerm)
+{
+  // the fit has to move the resolution term away from its lower limit
+  compareFits(2.0, 6.);
+  compareFits(4.0, 4.);
+}
+
+BOOST_AUTO_TEST_CASE(MomentumAtLimit)
+{
+  // the measured momentum is above the allowed one
+  compareFits(5.0, 2., 3000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,194 @@
+/**
+ * @file   VertexFitAlg_test.cc
+ * @brief  Test of the vertex fit of VertexFitAlg
+ * @see    VertexFitAlg.h
+ *
+ * The derivatives of the hit residuals are compared with finite differences,
+ * and the fit with the vertex the hits were generated from, in a three plane
+ * geometry described directly in the fit structure.
+ */
+
+// C/C++ standard libraries
+#include <array>
+#include <cmath>
+#include <vector>
+
+// boost test libraries
+#define BOOST_TEST_MODULE (VertexFitAlg_test)
+#include "boost/test/unit_test.hpp"
+
+// LArSoft libraries
+#include "larreco/RecoAlg/VertexFitAlg.h"
+#include "larreco/RecoAlg/VertexFitMinuitStruct.h"
+
+// ROOT libraries
+#include "TVector3.h"
+
+using boost::test_tools::tolerance;
+
+namespace {
+
+  constexpr double pitch = 0.3; // cm
+
+  /// Hits of tracks from vertex in three planes, with wires at +60, -60 and 0 degrees
+  struct VertexFixture {
+    explicit VertexFixture(double ripple = 0.) : ripple{ripple}
+    {
+      fit.Cstat = 0;
+      fit.TPC = 0;
+      fit.NPlanes = 3;
+      fit.WirePitch = pitch;
+      std::array<double, 3> const angles{M_PI / 3, -M_PI / 3, 0.};
+      for (unsigned short ipl = 0; ipl < 3; ++ipl) {
+        fit.OrthY[ipl] = -std::sin(angles[ipl]) / pitch;
+        fit.OrthZ[ipl] = std::cos(angles[ipl]) / pitch;
+        fit.FirstWire[ipl] = (ipl < 2) ? -1000. : 0.;
+      }
+      fit.VtxPos = vertex;
+
+      for (auto const& dir : dirs)
+        addTrack(dir);
+      fit.DoF = -double(nPars());
+      for (auto const& hitX : fit.HitX)
+        fit.DoF += hitX.size();
+    }
+
+    /// Hits on the 15 wires past the vertex in each plane, with a fixed ripple on X
+    void addTrack(TVector3 const& dir)
+    {
+      std::vector<double> hitX, hitXErr;
+      std::vector<unsigned short> planes, wires;
+      for (unsigned short ipl = 0; ipl < 3; ++ipl) {
+        double const vWire =
+          vertex.Y() * fit.OrthY[ipl] + vertex.Z() * fit.OrthZ[ipl] - fit.FirstWire[ipl];
+        // wires crossed per cm along the track
+        double const rate = dir.Y() * fit.OrthY[ipl] + dir.Z() * fit.OrthZ[ipl];
+        for (int n = 2; n < 17; ++n) {
+          int const wire = std::lround(vWire) + ((rate > 0) ? n : -n);
+          double const t = (wire - vWire) / rate;
+          hitX.push_back(vertex.X() + t * dir.X() + ripple * std::sin(1.7 * wires.size() + ipl));
+          hitXErr.push_back(0.05);
+          planes.push_back(ipl);
+          wires.push_back(wire);
+        }
+      }
+      fit.HitX.push_back(hitX);
+      fit.HitXErr.push_back(hitXErr);
+      fit.Plane.push_back(planes);
+      fit.Wire.push_back(wires);
+      fit.Dir.push_back(dir);
+    }
+
+    std::size_t nPars() const { return 3 + 2 * dirs.size(); }
+
+    /// Parameters with the vertex moved by dVtx and the directions scaled by dirScale
+    std::vector<double> parameters(TVector3 const& dVtx, double dirScale) const
+    {
+      std::vector<double> par{vertex.X() + dVtx.X(), vertex.Y() + dVtx.Y(), vertex.Z() + dVtx.Z()};
+      for (auto const& dir : dirs) {
+        par.push_back(dirScale * dir.Y());
+        par.push_back(dirScale * dir.Z());
+      }
+      return par;
+    }
+
+    double const ripple; ///< amplitude of the ripple on the hit X (cm)
+    TVector3 const vertex{50., 10., 200.};
+    std::array<TVector3, 3> const dirs{TVector3(0.3, 0.2, 0.93).Unit(),
+                                       TVector3(-0.5, -0.3, 0.81).Unit(),
+                                       TVector3(0.2, 0.9, 0.39).Unit()};
+    VertexFitMinuitStruct fit;
+  };
+
+  struct RippleFixture : VertexFixture {
+    RippleFixture() : VertexFixture{0.02} {}
+  };
+
+}
+
+//******************************************************************************
+BOOST_FIXTURE_TEST_SUITE(VertexFitAlgTest, VertexFixture)
+
+BOOST_AUTO_TEST_CASE(ChiDOFOfTrueVertex)
+{
+  BOOST_TEST(fit.DoF == 3 * 3 * 15 - 9);
+  BOOST_TEST(trkf::VertexFitAlg::VtxPosChiDOF(fit, parameters({0., 0., 0.}, 1.)) == 0.,
+             1e-18 % tolerance());
+}
+
+BOOST_AUTO_TEST_CASE(JacobianMatchesFiniteDifferences)
+{
+  std::size_t const npars = nPars();
+  auto const par = parameters({0.5, -0.4, 0.7}, 0.97);
+
+  std::vector<double> res, jac;
+  double const chiDOF = trkf::VertexFitAlg::VtxPosChiDOF(fit, par, &res, &jac);
+  BOOST_TEST_REQUIRE(jac.size() == res.size() * npars);
+
+  // the residuals are the ones of the chisq
+  double chisq = 0.;
+  for (double const r : res)
+    chisq += r * r;
+  BOOST_TEST(chisq / fit.DoF == chiDOF, 1e-10 % tolerance());
+
+  std::vector<double> resUp, resDown, dummy;
+  for (std::size_t ip = 0; ip < npars; ++ip) {
+    double const h = 1e-6 * (1. + std::abs(par[ip]));
+    auto parUp = par, parDown = par;
+    parUp[ip] += h;
+    parDown[ip] -= h;
+    trkf::VertexFitAlg::VtxPosChiDOF(fit, parUp, &resUp, &dummy);
+    trkf::VertexFitAlg::VtxPosChiDOF(fit, parDown, &resDown, &dummy);
+    for (std::size_t ir = 0; ir < res.size(); ++ir) {
+      BOOST_TEST_INFO("parameter #" << ip << ", residual #" << ir);
+      double const diff = (resUp[ir] - resDown[ir]) / (2 * h);
+      BOOST_TEST(std::abs(jac[ir * npars + ip] - diff) < 1e-5 * (1. + std::abs(diff)));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(FitFindsVertex)
+{
+  auto par = parameters({0.05, -0.5, 0.6}, 0.98);
+  std::vector<double> parerr;
+  trkf::VertexFitAlg::Minimize(fit, par, parerr);
+
+  auto const truth = parameters({0., 0., 0.}, 1.);
+  BOOST_TEST_REQUIRE(par.size() == truth.size());
+  for (std::size_t ip = 0; ip < par.size(); ++ip) {
+    BOOST_TEST_INFO("parameter #" << ip);
+    BOOST_TEST(par[ip] == truth[ip], 1e-4 % tolerance());
+  }
+  BOOST_TEST(trkf::VertexFitAlg::VtxPosChiDOF(fit, par) < 1e-8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//******************************************************************************
+BOOST_FIXTURE_TEST_SUITE(VertexFitAlgRippleTest, RippleFixture)
+
+BOOST_AUTO_TEST_CASE(FitWithMeasurementErrors)
+{
+  auto par = parameters({0.05, -0.5, 0.6}, 0.98);
+  std::vector<double> parerr;
+  trkf::VertexFitAlg::Minimize(fit, par, parerr);
+
+  // the vertex is found within its errors, which are those of a chisq/DOF fit
+  double const chiDOF = trkf::VertexFitAlg::VtxPosChiDOF(fit, par);
+  BOOST_TEST(chiDOF < 1.);
+  BOOST_TEST_REQUIRE(parerr.size() == par.size());
+  for (std::size_t ip = 0; ip < 3; ++ip) {
+    BOOST_TEST_INFO("vertex coordinate #" << ip);
+    BOOST_TEST(parerr[ip] > 0.);
+    BOOST_TEST(std::abs(par[ip] - vertex[ip]) < 3. * parerr[ip] / std::sqrt(fit.DoF));
+  }
+
+  // no step of the fit from the minimum reduces the chisq
+  auto const start = par;
+  trkf::VertexFitAlg::Minimize(fit, par, parerr);
+  BOOST_TEST(trkf::VertexFitAlg::VtxPosChiDOF(fit, par) == chiDOF, 1e-6 % tolerance());
+  for (std::size_t ip = 0; ip < par.size(); ++ip)
+    BOOST_TEST(par[ip] == start[ip], 1e-4 % tolerance());
+}
+
+BOOST_AUTO_TEST_SUITE_END()